@@ -10,21 +10,12 @@
 #define INC_SIGNAL_H_
 
 #include <complex.h>
+#include "util/xtype.h"
 
 /* Definition for real signal type, both single and double precision. */
 typedef float realf_t;
 typedef double reald_t;
 
-/* Definition of complex, single-precision signal type. */
-typedef struct {
-	float r;
-	float i;
-} complexf_t;
-
-/* Definition of complex, double-precision signal type. */
-typedef struct {
-	double r;
-	double i;
-} complexd_t;
+/* Complex signal types, complexf_t and complexd_t, are defined in util/xtype.h. */
 
 #endif /* INC_SIGNAL_H_ */
@@ -0,0 +1,55 @@
+/*
+ * sim.h
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: chiong
+ *
+ *  Host simulation of the SPI and GPIO wrappers, hw/spi.h and hw/gpio.h, in place
+ *  of a target implementation such as src/hw/bcm2835. Device drivers are built
+ *  unchanged on a PC, e.g. for rendering tests and benchmarks of st7735-lcd, see
+ *  module/st7735-lcd/st7735sim.h.
+ *
+ *  1. GPIO pins are levels in memory, gpio_read() returns the last level written.
+ *  2. Each SPI transfer is passed to the device model attached to the chip select
+ *     last selected by spi_selectCs(), and dropped if none is attached.
+ */
+
+#ifndef INC_SIM_H_
+#define INC_SIM_H_
+
+#include <stdint.h>
+
+/* Number of simulated SPI buses, chip selects per bus and GPIO pins. */
+#define SIM_SPI_COUNT		(2)
+#define SIM_SPI_CS_COUNT	(3)
+#define SIM_GPIO_COUNT		(64)
+
+/**
+ * @brief Model of a device on a simulated SPI bus, called for each transfer to it.
+ * @param[in] arg Argument given to spi_simAttach().
+ * @param[out] rxBuffer Bytes read from device, NULL if not read. Cleared to 0
+ * 		before the call.
+ * @param[in] txBuffer Bytes written to device.
+ * @param[in] length Number of bytes.
+ */
+typedef void (*spiSimDevice_t)(void *arg, uint8_t *rxBuffer, const uint8_t *txBuffer, uint32_t length);
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Attach a device model to a chip select of a simulated SPI bus.
+ * @param[in] spiIdx Index of SPI.
+ * @param[in] cs Chip select.
+ * @param[in] device Device model, NULL to detach.
+ * @param[in] arg Argument passed to device.
+ * @return STATUS_OK if success, STATUS_ERROR_PARAM if spiIdx or cs is out of range.
+ */
+int32_t spi_simAttach(uint8_t spiIdx, int8_t cs, spiSimDevice_t device, void *arg);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INC_SIM_H_ */
@@ -0,0 +1,83 @@
+/*
+ * chart.h
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: chiong
+ *
+ *  Strip chart of a stream of values, e.g. sensor readings, on top of hardware
+ *  scrolling of the LCD, see lcd_setScrollArea(). Each new value scrolls the
+ *  chart by one line and only that line is drawn, so the cost per value does
+ *  not depend on the length of the chart.
+ *
+ *  The chart runs along the long side of the panel: in landscape, time runs
+ *  from left to right with values upward, and in portrait, time runs from top
+ *  to bottom with values to the right. A chart spans the whole screen across.
+ */
+
+#ifndef INC_CHART_H_
+#define INC_CHART_H_
+
+#include <stdint.h>
+#include "module/st7735-lcd/lcd.h"
+
+typedef struct {
+	lcd_t *lcd;
+	/* First line and number of lines of chart, as for lcd_setScrollArea(). */
+	uint16_t start;
+	uint16_t len;
+	/* Values mapped to the edges of screen, values beyond are clipped. */
+	float min;
+	float max;
+	uint32_t color;
+	uint32_t bgColor;
+	/* Coordinate across screen of the last value, joined to the next value. */
+	uint16_t lastLevel;
+	uint8_t hasLast;
+} chart_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Set up a chart as the scroll area of LCD and clear it.
+ * @param[out] chart Chart to be set up.
+ * @param[in] lcd LCD instance, in the orientation to be used. Its scroll area
+ * 		is taken by the chart.
+ * @param[in] start First line of chart, a row (y) in portrait and a column (x)
+ * 		in landscape.
+ * @param[in] len Number of lines, i.e. of values shown.
+ * @param[in] min Value at the bottom (landscape) or left (portrait) edge.
+ * @param[in] max Value at the opposite edge, must be greater than min.
+ * @param[in] color 24-bit RGB color of trace.
+ * @param[in] bgColor 24-bit RGB color of background.
+ * @return STATUS_OK if success, STATUS_ERROR_PARAM if the lines are beyond
+ * 		screen or min is not less than max.
+ */
+int32_t chart_init(chart_t *chart, lcd_t *lcd, uint16_t start, uint16_t len, float min, float max,
+		uint32_t color, uint32_t bgColor);
+
+/**
+ * @brief Add a value at the end of chart, scrolling the oldest value out.
+ * @details The panel is scrolled by a single command, then one line is drawn,
+ * 		joining the new value to the last one. In frame buffer mode, the scroll
+ * 		and the line are sent to panel together by lcd_flush(), so values may
+ * 		be pushed several at a time between flushes.
+ * @param[in] chart Chart.
+ * @param[in] value New value, NaN is drawn as min.
+ * @return STATUS_OK if success, STATUS_ERROR if the scroll area of LCD has been
+ * 		changed since chart_init().
+ */
+int32_t chart_push(chart_t *chart, float value);
+
+/**
+ * @brief Clear chart to its background color, with no last value to join.
+ * @param[in] chart Chart.
+ */
+void chart_clear(chart_t *chart);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INC_CHART_H_ */
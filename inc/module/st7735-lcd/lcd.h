@@ -14,6 +14,7 @@
 #include <stdint.h>
 #include "module/st7735-lcd/st7735.h"
 #include "module/st7735-lcd/gfxfont.h"
+#include "util/sprite.h"
 
 #define LCD_HOR_LAYOUT_MASK  0x0F
 #define LCD_VER_LAYOUT_MASK  0xF0
@@ -37,6 +38,18 @@ typedef enum {
 #define LCD_COLOR_PURPLE	(0xFF00FF)
 #define LCD_COLOR_YELLOW	(0xFFFF00)
 
+/* Maximum number of dirty rectangles tracked in frame buffer mode. Beyond this,
+ * the closest rectangles are merged. */
+#define LCD_DIRTY_RECT_MAX	(8)
+
+/* Default size, in bytes, of glyph cache, see lcd_setGlyphCacheSize(). */
+#define LCD_GLYPH_CACHE_SIZE	(4096)
+/* Maximum number of glyphs in cache. */
+#define LCD_GLYPH_CACHE_MAX		(32)
+
+/* Maximum number of vertices of lcd_fillPolygon(). */
+#define LCD_POLYGON_VERTEX_MAX	(16)
+
 
 /* Portrait, with the cable/pin end as bottom. */
 #define LCD_ORIENT_PORTRAIT_NORMAL      \
@@ -108,6 +121,18 @@ typedef enum {
 #define LCD_getTextBound(inst, str, w, h)	\
 	lcd_getTextBound(inst, 0, 0, str, -1, NULL, NULL, w, h)
 
+typedef struct lcdGlyphCache_s lcdGlyphCache_t;
+
+/**
+ * @brief Rectangular area on screen, both corners inclusive.
+ */
+typedef struct {
+	uint16_t x0;
+	uint16_t y0;
+	uint16_t x1;
+	uint16_t y1;
+} lcdRect_t;
+
 typedef struct {
 	/** Instance containing hardware pin to use */
 	st7735_t *st7735_inst;
@@ -130,6 +155,31 @@ typedef struct {
     uint8_t textSize;
     /** Flag to wrap char to new line if reach end of screen */
     uint8_t isWrap;
+
+    /** Frame buffer, NULL to draw straight to panel. See lcd_enableFrameBuffer(). */
+    uint8_t *frameBuffer;
+    /** BITMAP_PIXEL_FMT_* of pixels in frame buffer */
+    uint8_t fbFmt;
+    /** Size, in bytes, of a pixel in frame buffer */
+    uint8_t fbPixelSize;
+    /** Number of dirty rectangles */
+    uint8_t nDirty;
+    /** Areas of frame buffer changed since the last lcd_flush() */
+    lcdRect_t dirty[LCD_DIRTY_RECT_MAX];
+
+    /** Glyphs rasterised for opaque text, allocated on first use. */
+    lcdGlyphCache_t *glyphCache;
+    /** Size, in bytes, of pixels in glyph cache, 0 to disable */
+    uint32_t glyphCacheSize;
+
+    /** First line and number of lines of scroll area, 0 lines if not scrolling.
+     *  See lcd_setScrollArea(). */
+    uint16_t scrollStart;
+    uint16_t scrollLen;
+    /** Number of lines scrolled, from 0 to scrollLen - 1 */
+    uint16_t scrollOffset;
+    /** Non-zero if a scroll is yet to be sent by lcd_flush(), in frame buffer mode */
+    uint8_t isScrollPending;
 } lcd_t;
 
 
@@ -156,8 +206,79 @@ int32_t lcd_create(lcd_t **inst, st7735_t *st7735_inst);
 void lcd_destroy(lcd_t **inst);
 
 
+/**
+ * @brief Draw into a frame buffer in RAM instead of straight to panel.
+ * @details Once enabled, all drawing functions only change the frame buffer and
+ * 		record the areas changed as a few dirty rectangles, merging those close
+ * 		to each other. Nothing is sent to panel until lcd_flush(), which writes
+ * 		each dirty rectangle in a single address window and bulk transfers.
+ * 		Drawing is clipped to the screen.
+ *
+ * 		The frame buffer holds a full screen in the current color format of the
+ * 		panel, i.e. 2 bytes per pixel for 12-bit and 16-bit, 3 bytes for 18-bit.
+ * 		It starts black and clean, so areas never drawn are never sent. Change
+ * 		the color format with lcd_setColorFmt() to keep frame buffer in step.
+ * @param[in] inst LCD instance.
+ * @returns STATUS_OK if success, STATUS_ERROR_MALLOC if out of memory.
+ */
+int32_t lcd_enableFrameBuffer(lcd_t *inst);
+
+
+/**
+ * @brief Free frame buffer and draw straight to panel again. Changes not yet
+ * 		flushed are discarded, except a scroll, which is sent.
+ * @param[in] inst LCD instance.
+ */
+void lcd_disableFrameBuffer(lcd_t *inst);
+
+
+/**
+ * @brief Write the dirty rectangles of frame buffer to panel, then the scroll
+ * 		done since the last flush, if any.
+ * @param[in] inst LCD instance.
+ * @returns STATUS_OK if success or if frame buffer is not enabled, STATUS_ERROR
+ * 		if the color format of panel has been changed other than by lcd_setColorFmt().
+ */
+int32_t lcd_flush(lcd_t *inst);
+
+
+/**
+ * @brief Write rectangles of a frame buffer other than the one drawn into, e.g.
+ * 		a frame held by lcdPresenter_t while the next one is drawn.
+ * @details frameBuffer must be laid out as the frame buffer of inst, i.e. in the
+ * 		same orientation and color format. A scroll done since the last flush is
+ * 		sent after the rectangles, as with lcd_flush(). Otherwise, neither inst
+ * 		nor its frame buffer is changed, so another thread may keep drawing
+ * 		meanwhile as long as it does not scroll or send anything to panel itself.
+ * @param[in] inst LCD instance, in frame buffer mode.
+ * @param[in] frameBuffer Frame buffer to be written.
+ * @param[in] rect Rectangles to be written.
+ * @param[in] count Number of rectangles.
+ * @returns STATUS_OK if success, STATUS_ERROR if frame buffer is not enabled
+ * 		or the color format of panel has changed, as for lcd_flush().
+ */
+int32_t lcd_flushFrame(lcd_t *inst, const uint8_t *frameBuffer, const lcdRect_t *rect, uint32_t count);
+
+
+/**
+ * @brief Set the color format of panel, and of frame buffer if enabled.
+ * @details 12-bit and 16-bit take 1.5 and 2 bytes per pixel on SPI bus, instead
+ * 		of 3 bytes for 18-bit, at the cost of color depth. What is on screen is
+ * 		kept. Pixels in frame buffer are converted to the new format, so they
+ * 		lose their low bits when going to fewer bits.
+ * @param[in] inst LCD instance.
+ * @param[in] fmt New color format, ST7735_PANEL_COLOR_12_BIT, 16_BIT or 18_BIT.
+ * @returns STATUS_OK if success, STATUS_ERROR_PARAM if fmt is not supported,
+ * 		STATUS_ERROR_MALLOC if out of memory for frame buffer, STATUS_ERROR if
+ * 		the panel cannot be set.
+ */
+int32_t lcd_setColorFmt(lcd_t *inst, st7735_color_t fmt);
+
+
 /**
  * @brief Set the orientation of screen.
+ * @details In frame buffer mode, the content of frame buffer is kept as is but
+ * 		now laid out in the new orientation, so the whole screen becomes dirty.
  * @param[in] inst LCD instance.
  * @param[in] newOrient New orientation.
  * @returns status code.
@@ -165,6 +286,58 @@ void lcd_destroy(lcd_t **inst);
 int32_t lcd_setOrientation(lcd_t *inst, uint8_t newOrient);
 
 
+/**
+ * @brief Set up hardware scrolling of part of screen.
+ * @details The panel only scrolls along its long side, so lines are rows (y) in
+ * 		portrait and columns (x) in landscape, and each line scrolls across the
+ * 		whole screen. Lines outside of scroll area stay fixed. Scrolling is reset
+ * 		by lcd_setOrientation().
+ * @param[in] inst LCD instance.
+ * @param[in] start First line of scroll area.
+ * @param[in] len Number of lines of scroll area, 0 to stop scrolling.
+ * @returns STATUS_OK if success, STATUS_ERROR_PARAM if the area is beyond screen.
+ */
+int32_t lcd_setScrollArea(lcd_t *inst, uint16_t start, uint16_t len);
+
+
+/**
+ * @brief Scroll the content of scroll area with a single command, without
+ * 		redrawing anything.
+ * @details Content moves towards the start of scroll area, and lines scrolled
+ * 		out at the start come back at the end, where new content is drawn. Use
+ * 		lcd_getScrollLine() to find where to draw into. In frame buffer mode, the
+ * 		command is only sent by lcd_flush(), after the lines drawn meanwhile, so
+ * 		that the panel never shows the lines scrolled in before they are drawn.
+ * @param[in] inst LCD instance.
+ * @param[in] lines Number of lines to scroll, negative towards the end.
+ * @returns STATUS_OK if success, STATUS_ERROR if there is no scroll area.
+ */
+int32_t lcd_scroll(lcd_t *inst, int32_t lines);
+
+
+/**
+ * @brief Get the line to draw into for content shown at a position in scroll area.
+ * @details Drawing functions address the panel memory, which stays in place
+ * 		while the view of it scrolls.
+ * @param[in] inst LCD instance.
+ * @param[in] pos Position from the start of scroll area, e.g. scrollLen - 1
+ * 		for the line just scrolled in by lcd_scroll(inst, 1).
+ * @returns y in portrait or x in landscape, to draw with as usual.
+ */
+uint16_t lcd_getScrollLine(const lcd_t *inst, uint16_t pos);
+
+
+/**
+ * @brief Only show part of screen, leaving the rest blank, e.g. to save power.
+ * @param[in] inst LCD instance.
+ * @param[in] start First line shown, rows (y) in portrait and columns (x) in
+ * 		landscape as for lcd_setScrollArea().
+ * @param[in] len Number of lines shown, 0 to show the whole screen again.
+ * @returns STATUS_OK if success, STATUS_ERROR_PARAM if the area is beyond screen.
+ */
+int32_t lcd_setPartialArea(lcd_t *inst, uint16_t start, uint16_t len);
+
+
 /**
  * @brief Set text wrap.
  * @param[in] inst LCD instance.
@@ -173,6 +346,25 @@ int32_t lcd_setOrientation(lcd_t *inst, uint8_t newOrient);
 void lcd_setTextWrap(lcd_t *inst, uint8_t isWrap);
 
 
+/**
+ * @brief Set the size of glyph cache.
+ * @details Text in the classic font with an opaque background, i.e. isBgOpaque
+ * 		set and bgColor different from textColor, is drawn from glyphs rasterised
+ * 		once for the current text size and colors and kept in a small cache,
+ * 		least recently used first out. A line of text is then written as a single
+ * 		address window and bulk transfer, or copied into the frame buffer.
+ *
+ * 		The cache holds glyphs of a single text size, as many as fit up to
+ * 		LCD_GLYPH_CACHE_MAX, and is emptied when the text size or color format
+ * 		changes. Text sizes too large for a single glyph are drawn without cache.
+ * 		Custom fonts are transparent and always drawn as runs of pixels.
+ * @param[in] inst LCD instance.
+ * @param[in] size Size, in bytes, of cache, 0 to disable. LCD_GLYPH_CACHE_SIZE
+ * 		by default. Memory is allocated on first use.
+ */
+void lcd_setGlyphCacheSize(lcd_t *inst, uint32_t size);
+
+
 /**
  * @brief Set custom font for text rendering.
  * @param[in] inst LCD instance.
@@ -235,6 +427,37 @@ void lcd_drawFastHLine(lcd_t *inst, uint16_t x, uint16_t y, uint16_t len, uint32
 void lcd_drawLine(lcd_t *inst, uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint32_t color);
 
 
+/**
+ * @brief Draw a line of a given width from (x0, y0) to (x1, y1), filled as a
+ * 		polygon, see lcd_fillPolygon().
+ * @details Ends are square, half a pixel beyond (x0, y0) and (x1, y1), so that
+ * 		both end pixels are drawn as with lcd_drawLine().
+ * @param[in] inst LCD instance.
+ * @param[in] x0 Start x address
+ * @param[in] y0 Start y address
+ * @param[in] x1 End x address
+ * @param[in] y1 End y address
+ * @param[in] width Width of line, in number of pixels. 1 is the same as lcd_drawLine().
+ * @param[in] color 24-bit RGB color.
+ */
+void lcd_drawThickLine(lcd_t *inst, uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t width, uint32_t color);
+
+
+/**
+ * @brief Draw an anti-aliased line from (x0, y0) to (x1, y1), blended into the
+ * 		frame buffer.
+ * @details Anti-aliasing needs the pixels already drawn, so without frame
+ * 		buffer this is the same as lcd_drawLine().
+ * @param[in] inst LCD instance.
+ * @param[in] x0 Start x address
+ * @param[in] y0 Start y address
+ * @param[in] x1 End x address
+ * @param[in] y1 End y address
+ * @param[in] color 24-bit RGB color.
+ */
+void lcd_drawLineAA(lcd_t *inst, uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint32_t color);
+
+
 /**
  * @brief Draw a generic polygon with given vertices (x0, y0), (x1, y1), ..., (xn, yn).
  * @param[in] inst LCD instance.
@@ -246,6 +469,31 @@ void lcd_drawLine(lcd_t *inst, uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y
 void lcd_drawPolygon(lcd_t *inst, const uint16_t* x, const uint16_t* y, uint32_t count, uint32_t color);
 
 
+/**
+ * @brief Fill a generic polygon, which may be concave or self-intersecting,
+ * 		with even-odd rule, as a horizontal run per row and crossing.
+ * @details A pixel is filled if its center is inside the polygon, with vertices
+ * 		at pixel centers. Pixels on the right or bottom edges are not filled,
+ * 		so polygons sharing an edge do not overlap.
+ * @param[in] inst LCD instance.
+ * @param[in] x Array containing the x-coordinates for all vertices of a polygon.
+ * @param[in] y Array containing the y-coordinates for all vertices of a polygon.
+ * @param[in] count Number of vertices, from 3 to LCD_POLYGON_VERTEX_MAX, else
+ * 		nothing is drawn.
+ * @param[in] color 24-bit RGB color.
+ */
+void lcd_fillPolygon(lcd_t *inst, const uint16_t* x, const uint16_t* y, uint32_t count, uint32_t color);
+
+
+/**
+ * @brief Fill a triangle with vertices (x0, y0), (x1, y1) and (x2, y2), see
+ * 		lcd_fillPolygon().
+ * @param[in] inst LCD instance.
+ * @param[in] color 24-bit RGB color.
+ */
+void lcd_fillTriangle(lcd_t *inst, uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2, uint32_t color);
+
+
 /**
  * @brief Draw a circle with given radius.
  * @param[in] inst LCD instance.
@@ -256,6 +504,31 @@ void lcd_drawPolygon(lcd_t *inst, const uint16_t* x, const uint16_t* y, uint32_t
 void lcd_drawCircle(lcd_t *inst, uint16_t x0, uint16_t y0, uint16_t r, uint32_t color);
 
 
+/**
+ * @brief Fill a circle, including the pixels of lcd_drawCircle(), as a
+ * 		horizontal run per row.
+ * @param[in] inst LCD instance.
+ * @param[in] x0 X-coordinate of the center of the circle.
+ * @param[in] y0 Y-coordinate of the center of the circle.
+ * @param[in] r Radius, in number of pixels.
+ * @param[in] color 24-bit RGB color.
+ */
+void lcd_fillCircle(lcd_t *inst, uint16_t x0, uint16_t y0, uint16_t r, uint32_t color);
+
+
+/**
+ * @brief Draw an anti-aliased circle, blended into the frame buffer.
+ * @details Anti-aliasing needs the pixels already drawn, so without frame
+ * 		buffer this is the same as lcd_drawCircle().
+ * @param[in] inst LCD instance.
+ * @param[in] x0 X-coordinate of the center of the circle.
+ * @param[in] y0 Y-coordinate of the center of the circle.
+ * @param[in] r Radius, in number of pixels.
+ * @param[in] color 24-bit RGB color.
+ */
+void lcd_drawCircleAA(lcd_t *inst, uint16_t x0, uint16_t y0, uint16_t r, uint32_t color);
+
+
 /**
  * @brief Draw a rectangle.
  * @param[in] inst LCD instance.
@@ -280,6 +553,20 @@ void lcd_drawRect(lcd_t *inst, uint16_t x, uint16_t y, uint16_t width, uint16_t
 void lcd_fillRect(lcd_t *inst, uint16_t x, uint16_t y, uint16_t width, uint16_t height, uint32_t color);
 
 
+/**
+ * @brief Fill a rectangle with rounded corners, as a single window for the
+ * 		straight part and a horizontal run per row of corners.
+ * @param[in] inst LCD instance.
+ * @param[in] x X-coordinate of the 'start' vertex of the rectangle.
+ * @param[in] y Y-coordinate of the 'start' vertex of the rectangle.
+ * @param[in] width Width of rectangle, in number of pixels.
+ * @param[in] height Height of rectangle, in number of pixels.
+ * @param[in] r Radius of corners, limited to half of width and height.
+ * @param[in] color 24-bit RGB color.
+ */
+void lcd_fillRoundRect(lcd_t *inst, uint16_t x, uint16_t y, uint16_t width, uint16_t height, uint16_t r, uint32_t color);
+
+
 /**
  * @brief Draw a single char on screen.
  * @param[in] inst LCD instance.
@@ -388,6 +675,39 @@ uint32_t lcd_getTextBound(lcd_t *inst, uint16_t x, uint16_t y, char* str, int32_
 void lcd_drawBitmap(lcd_t *inst, uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint32_t* color);
 
 
+/**
+ * @brief Draw a BMP file to screen.
+ * @details The file is read a few rows at a time, converted straight into the
+ * 		color format of the panel and written to the panel, so that the image
+ * 		is never held in memory. Parts of the image beyond the screen are clipped.
+ * 		See bitmap_readerOpen() for the supported BMP formats.
+ * @param[in] inst LCD instance.
+ * @param[in] x Start x-coordinate.
+ * @param[in] y Start y-coordinate.
+ * @param[in] filename Filename of BMP file.
+ * @returns STATUS_OK if success, STATUS_ERROR_FILE_OPEN if the file cannot be
+ * 		opened, STATUS_ERROR* otherwise.
+ */
+int32_t lcd_drawBitmapFile(lcd_t *inst, uint16_t x, uint16_t y, const char *filename);
+
+
+/**
+ * @brief Draw a sprite of a precompiled sprite sheet, see sprite.h.
+ * @details The sprite is written in a single address window. RAW sprites are
+ * 		sent straight from the sheet in one transfer, RLE and PALETTE sprites
+ * 		are decoded in parts into a small stack buffer.
+ * @param[in] inst LCD instance.
+ * @param[in] x Start x-coordinate.
+ * @param[in] y Start y-coordinate.
+ * @param[in] sheet Sprite sheet, in the color format of the panel.
+ * @param[in] idx Index of sprite in sheet.
+ * @returns STATUS_OK if success, STATUS_ERROR_PARAM if idx is out of range, the
+ * 		sprite does not fit on screen or the sheet is not in the color format of
+ * 		the panel.
+ */
+int32_t lcd_drawSprite(lcd_t *inst, uint16_t x, uint16_t y, const spriteSheet_t *sheet, uint32_t idx);
+
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,141 @@
+/*
+ * lcdpresenter.h
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: chiong
+ *
+ *  Double-buffered asynchronous flush of an LCD in frame buffer mode. The
+ *  application draws a frame into the frame buffer of lcd_t as usual, then
+ *  hands it to lcdpresenter_present(), which only swaps it with a second frame
+ *  buffer and returns. A flush thread writes the dirty rectangles of the frame
+ *  presented to panel while the application draws the next frame.
+ *
+ *  Application thread:                   Flush thread (internal):
+ *
+ *  	lcd_fillRect(lcd, ...);             	wait for a frame
+ *  	lcd_writeText(lcd, ...);            	wait for the next period, if paced
+ *  	lcdpresenter_present(presenter);    	lcd_flushFrame() of dirty rectangles
+ *  	lcd_fillRect(lcd, ...);             	onFrame(arg, frame)
+ *
+ *  Drawing only changes what has changed since the last frame, as in frame
+ *  buffer mode without presenter. On present, the dirty rectangles are copied
+ *  from the frame presented into the other frame buffer, which becomes the one
+ *  drawn into, so that both hold the same frame before drawing goes on.
+ *
+ *  With periodUs, frames start being written no more often than once every
+ *  periodUs, so that frames are shown at a steady rate. A frame presented while
+ *  the previous one is not yet on panel either waits for it or, with isDropLate,
+ *  is dropped: its changes stay in the frame buffer and go with the next frame
+ *  presented, so nothing drawn is lost. See lcdpresenter_getStats().
+ *
+ *  Drawing and lcdpresenter_present() are to be done by the same thread. While
+ *  a presenter is attached, functions that send to panel themselves, e.g.
+ *  lcd_setOrientation(), lcd_scroll() or st7735_*(), may only be called after
+ *  lcdpresenter_wait(), so that the flush thread is idle. A scroll is sent with
+ *  the next frame presented, as lcd_flush() would. lcd_flush(),
+ *  lcd_setColorFmt() and lcd_enable/disableFrameBuffer() are not to be called
+ *  at all, since the two frame buffers would no longer match.
+ */
+
+#ifndef INC_LCDPRESENTER_H_
+#define INC_LCDPRESENTER_H_
+
+#include <stdint.h>
+#include "util/status.h"
+#include "module/st7735-lcd/lcd.h"
+
+typedef struct lcdPresenter_s lcdPresenter_t;
+
+/**
+ * @brief Called by the flush thread once a frame is on panel, like vertical sync.
+ * @param[in] arg Argument given in lcdPresenterCfg_t.
+ * @param[in] frame Index of frame written, counting from 0.
+ */
+typedef void (*lcdPresenterCallback_t)(void *arg, uint32_t frame);
+
+typedef struct {
+	/* Minimum period, in us, between the starts of two frames. 0 to write each
+	 * frame as soon as presented. */
+	uint32_t periodUs;
+	/* Non-zero to drop a frame presented while the previous one is not yet on
+	 * panel, instead of waiting for it. */
+	uint8_t isDropLate;
+	/* Called from the flush thread after each frame, NULL for none. Must not
+	 * call lcdpresenter_*() other than lcdpresenter_getStats(). */
+	lcdPresenterCallback_t onFrame;
+	void *arg;
+} lcdPresenterCfg_t;
+
+typedef struct {
+	/* Number of calls to lcdpresenter_present(), including frames dropped. */
+	uint32_t nPresent;
+	/* Number of frames written to panel. */
+	uint32_t nFrame;
+	/* Number of frames dropped, i.e. merged into the next frame. */
+	uint32_t nDrop;
+	/* Number of frames that had to wait for the previous frame. */
+	uint32_t nWait;
+	/* Number of frames that took longer than periodUs to write. */
+	uint32_t nLate;
+	/* Number of frames that could not be written, e.g. color format changed. */
+	uint32_t nError;
+	/* Time, in us, taken to write the last frame and the slowest frame. */
+	uint32_t lastFlushUs;
+	uint32_t maxFlushUs;
+} lcdPresenterStats_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Attach a presenter to LCD and start its flush thread.
+ * @details Frame buffer of lcd is enabled if not yet. A second frame buffer of
+ * 		the same size is allocated, holding a copy of the first.
+ * @param[out] ppSelf Address to store the newly created instance.
+ * @param[in] lcd LCD instance, to stay valid until lcdpresenter_destroy().
+ * @param[in] cfg Configuration used to create the instance.
+ * @return STATUS_OK if success, STATUS_ERROR_MALLOC if out of memory,
+ * 		STATUS_ERROR if the thread cannot be started.
+ */
+int32_t lcdpresenter_create(lcdPresenter_t **ppSelf, lcd_t *lcd, const lcdPresenterCfg_t *cfg);
+
+/**
+ * @brief Stop the flush thread once the frames presented are on panel and
+ * 		release the second frame buffer.
+ * @details lcd stays in frame buffer mode, with what has been drawn since the
+ * 		last frame presented left to lcd_flush().
+ * @param[in/out] ppSelf Address of instance to be destroyed. Once destroyed,
+ * 		*ppSelf will be NULL.
+ */
+void lcdpresenter_destroy(lcdPresenter_t **ppSelf);
+
+/**
+ * @brief Hand what has been drawn since the last frame to the flush thread and
+ * 		carry on drawing in the other frame buffer.
+ * @details Returns without writing to panel. If the previous frame is not yet
+ * 		on panel, this waits for it, or drops the frame with isDropLate.
+ * @param[in] pSelf Instance.
+ * @return STATUS_OK if the frame is to be written, STATUS_ERROR if it has been
+ * 		dropped and its changes left for the next frame.
+ */
+int32_t lcdpresenter_present(lcdPresenter_t *pSelf);
+
+/**
+ * @brief Wait until all frames presented are on panel.
+ * @param[in] pSelf Instance.
+ */
+void lcdpresenter_wait(lcdPresenter_t *pSelf);
+
+/**
+ * @brief Get the counters of presenter. The values are a snapshot.
+ * @param[in] pSelf Instance.
+ * @param[out] stats Counters.
+ */
+void lcdpresenter_getStats(lcdPresenter_t *pSelf, lcdPresenterStats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INC_LCDPRESENTER_H_ */
@@ -51,9 +51,11 @@
 #define ST7735_CMD_RGBSET       0x2D    /*< LUT for 4k, 65k, 262k colour */
 #define ST7735_CMD_RAMRD        0x2E    /*< Memory read */
 #define ST7735_CMD_PTLAR        0x30    /*< Partial start/end address set */
+#define ST7735_CMD_SCRLAR       0x33    /*< Scroll area set */
 #define ST7735_CMD_TEOFF        0x34    /*< Tearing effect line off */
 #define ST7735_CMD_TEON         0x35    /*< Tearing effect mode set & on */
 #define ST7735_CMD_MADCTL       0x36    /*< Memory data access control */
+#define ST7735_CMD_VSCSAD       0x37    /*< Vertical scroll start address of RAM */
 #define ST7735_CMD_IDMOFF       0x38    /*< Idle mode off */
 #define ST7735_CMD_IDMON        0x39    /*< Idle mode on */
 #define ST7735_CMD_COLMOD       0x3A    /*< Interface pixel format */
@@ -127,6 +129,25 @@
  */
 #define ST7735_rgb565(r, g, b)	((((r) & 0xF8) << 8) | (((g) & 0xFC) << 3) | ((b) >> 3))
 
+/**
+ * @brief Macro to convert RGB data to 12-bit color format with 4 bits each
+ * 		of R, G and B, as 0x0RGB.
+ * @param[in] r 8-bit unsigned int for red.
+ * @param[in] g 8-bit unsigned int for green.
+ * @param[in] b 8-bit unsigned int for blue.
+ * @returns Packed RGB data in 12-bit 4-4-4 color format.
+ */
+#define ST7735_rgb444(r, g, b)	((((r) & 0xF0) << 4) | ((g) & 0xF0) | ((b) >> 4))
+
+/**
+ * @brief Macro to get the number of bytes of n pixels in a given color format,
+ * 		see st7735_color_t. With 12-bit, 2 pixels take 3 bytes and an odd pixel
+ * 		count is rounded up to the next byte.
+ */
+#define ST7735_getPackedSize(fmt, n)	\
+	((fmt) == ST7735_PANEL_COLOR_12_BIT? ((n) * 3 + 1) / 2 :	\
+	 (fmt) == ST7735_PANEL_COLOR_16_BIT? (n) * 2 : (n) * 3)
+
 
 /* Refer COLMOD command in datasheet */
 typedef enum {
@@ -161,8 +182,45 @@ typedef struct {
      * during startup. If NULL, there will be no delay and the LCD may not
      * be initialised properly. */
     fxnDelay_t delayMs;
+    /* Color format set at initialisation, see st7735_color_t. 0 for
+     * ST7735_PANEL_COLOR_18_BIT. 12-bit and 16-bit take 1.5 and 2 bytes per
+     * pixel on SPI bus, instead of 3 bytes. */
+    st7735_color_t colorFmt;
 } st7735Cfg_t;
 
+/* Size, in bytes, of the buffer of st7735_panel_pushColor() and
+ * st7735_panel_pushColorArray(), a multiple of 6 to hold whole 12-bit pairs. */
+#define ST7735_PUSH_BUFFER_SIZE	(192)
+
+/* Maximum number of command and data segments recorded in a command list before
+ * it is flushed. */
+#define ST7735_CMDLIST_SEGMENT_MAX	(32)
+
+/**
+ * @brief Commands, arguments and pixels recorded to be written to ST7735 in as
+ *      few SPI transfers as possible, see st7735_cmdListInit().
+ * @details Consecutive commands are one segment with DCX LO and consecutive
+ *      arguments and pixels are one segment with DCX HI, so each segment is a
+ *      single SPI transfer and DCX is only written when it changes.
+ */
+typedef struct {
+    const st7735_t *inst;
+    uint8_t *buffer;
+    /* Size, in bytes, of buffer. */
+    uint32_t size;
+    /* Number of bytes recorded. */
+    uint32_t count;
+    /* Offset of the start of each segment. Command and data segments alternate. */
+    uint32_t segmentStart[ST7735_CMDLIST_SEGMENT_MAX];
+    uint32_t nSegment;
+    /* Non-zero if the first segment is data. */
+    uint8_t isFirstData;
+    /* Non-zero if the low half of the last byte is left for the next 12-bit pixel. */
+    uint8_t isHalfByte;
+    /* Level last written to DCX, 0xFF if unknown. */
+    uint8_t dcLevel;
+} st7735CmdList_t;
+
 
 #ifdef __cplusplus
 extern "C" {
@@ -228,8 +286,18 @@ st7735_status_t st7735_panel_setOrientation(st7735_t *inst, const uint8_t newOri
 st7735_status_t st7735_panel_setColorFmt(st7735_t *inst, const st7735_color_t newFmt);
 
 
+/**
+ * @brief Get panel color format settings.
+ * @param[in] inst Pointer to st7735 instance.
+ * @return Current color format, see st7735_color_t.
+ */
+st7735_color_t st7735_panel_getColorFmt(const st7735_t *inst);
+
+
 /**
  * @brief Push the same color for a number of times to ST7735.
+ * @details Pixels are packed in the current color format and written in bursts
+ *      of ST7735_PUSH_BUFFER_SIZE bytes.
  * @param[in] inst Pointer to instance handler.
  * @param[in] color 24-bit RGB color.
  * @param[in] times Number of times/pixels to draw the color.
@@ -239,6 +307,8 @@ st7735_status_t st7735_panel_pushColor(const st7735_t *inst, uint32_t color, uin
 
 /**
  * @brief Push an array of colors to ST7735.
+ * @details Pixels are packed in the current color format, see st7735_packColors(),
+ *      and written in bursts of ST7735_PUSH_BUFFER_SIZE bytes.
  * @param[in] inst Pointer to instance handler.
  * @param[in] color Array of 24-bit RGB color.
  * @param[in] count Number of colors in array color.
@@ -246,6 +316,145 @@ st7735_status_t st7735_panel_pushColor(const st7735_t *inst, uint32_t color, uin
 st7735_status_t st7735_panel_pushColorArray(const st7735_t *inst, uint32_t *color, uint32_t count);
 
 
+/**
+ * @brief Pack 24-bit RGB colors into the wire format of a color format.
+ * @param[in] fmt Color format, see st7735_color_t.
+ * @param[out] dst Packed pixels, of ST7735_getPackedSize(fmt, count) bytes. With
+ *      12-bit, 2 pixels are packed in 3 bytes and the low half of the last byte
+ *      of an odd count is 0.
+ * @param[in] color Array of 24-bit RGB color.
+ * @param[in] count Number of colors in array color.
+ * @return Number of bytes written to dst, 0 if fmt is not supported.
+ */
+uint32_t st7735_packColors(st7735_color_t fmt, uint8_t *dst, const uint32_t *color, uint32_t count);
+
+
+/**
+ * @brief Write pixels already packed in the wire format of the current color
+ *      format, e.g. by bitmap_readRows(), in a single data transfer.
+ * @details Pixels of a large area can be written in parts. Call this function
+ *      for the first part, then st7735_writeData() for the following parts,
+ *      which continue from where the previous part ended.
+ * @param[in] inst Pointer to instance handler.
+ * @param[in] data Packed pixels, 3 bytes per 2 pixels for 12-bit, 2 bytes per
+ *      pixel for 16-bit and 3 bytes per pixel for 18-bit.
+ * @param[in] size Number of bytes in data.
+ * @return ST7355_STATUS_OK if success, ST7735_STATUS_ERROR otherwise.
+ */
+st7735_status_t st7735_panel_writePixels(const st7735_t *inst, const uint8_t *data, uint32_t size);
+
+
+/**
+ * @brief Set vertical scroll area, in rows of frame memory.
+ * @details Rows are along the ST7735_HEIGHT side of panel, regardless of
+ *      orientation, i.e. scrolling is horizontal on screen if
+ *      ST7735_PANEL_EXCHANGE_XY_pos is set.
+ * @param[in] inst Pointer to instance handler.
+ * @param[in] top Number of fixed rows above scroll area.
+ * @param[in] scroll Number of rows in scroll area.
+ * @param[in] bottom Number of fixed rows below scroll area. top, scroll and
+ *      bottom must add up to ST7735_HEIGHT.
+ * @return ST7355_STATUS_OK if success, ST7735_STATUS_ERROR otherwise.
+ */
+st7735_status_t st7735_panel_setScrollArea(const st7735_t *inst, uint16_t top, uint16_t scroll, uint16_t bottom);
+
+
+/**
+ * @brief Set the row of frame memory shown as the first row of scroll area.
+ * @details This is a single command, nothing in frame memory is rewritten.
+ * @param[in] inst Pointer to instance handler.
+ * @param[in] row Row of frame memory, from top to top + scroll - 1 of the
+ *      scroll area, see st7735_panel_setScrollArea().
+ * @return ST7355_STATUS_OK if success, ST7735_STATUS_ERROR otherwise.
+ */
+st7735_status_t st7735_panel_setScrollStart(const st7735_t *inst, uint16_t row);
+
+
+/**
+ * @brief Enter partial mode, where only rows of the partial area are shown and
+ *      the rest of panel is blank.
+ * @param[in] inst Pointer to instance handler.
+ * @param[in] startRow First row of partial area, in rows of frame memory.
+ * @param[in] endRow Last row of partial area.
+ * @return ST7355_STATUS_OK if success, ST7735_STATUS_ERROR otherwise.
+ */
+st7735_status_t st7735_panel_setPartialArea(const st7735_t *inst, uint16_t startRow, uint16_t endRow);
+
+
+/**
+ * @brief Leave partial mode, back to showing the whole panel.
+ * @param[in] inst Pointer to instance handler.
+ * @return ST7355_STATUS_OK if success, ST7735_STATUS_ERROR otherwise.
+ */
+st7735_status_t st7735_panel_setNormalMode(const st7735_t *inst);
+
+/**
+ * @brief Start an empty command list.
+ * @details Recording into the list only writes to panel when buffer is full.
+ *      Nothing else should write to the panel until st7735_cmdListFlush(). A
+ *      list is cheap to set up, e.g. on stack for a single drawing operation.
+ * @param[out] list Command list.
+ * @param[in] inst Pointer to st7735 instance.
+ * @param[in] buffer Buffer for recorded bytes, e.g. 512 bytes. Must stay valid
+ *      while list is in use.
+ * @param[in] size Size, in bytes, of buffer. At least 16.
+ * @return ST7355_STATUS_OK if success, ST7735_STATUS_ERROR if buffer is too small.
+ */
+st7735_status_t st7735_cmdListInit(st7735CmdList_t *list, const st7735_t *inst, uint8_t *buffer, uint32_t size);
+
+/**
+ * @brief Record a command and its arguments.
+ * @param[in/out] list Command list.
+ * @param[in] cmd 1-byte ST7735 command.
+ * @param[in] arg Arguments, NULL if nArg is 0.
+ * @param[in] nArg Number of argument bytes.
+ * @return ST7355_STATUS_OK.
+ */
+st7735_status_t st7735_cmdListCommand(st7735CmdList_t *list, uint8_t cmd, const uint8_t *arg, uint32_t nArg);
+
+/**
+ * @brief Record the address window, i.e. st7735_setAddress(), followed by RAMWR
+ *      for the pixels of the window.
+ * @param[in/out] list Command list.
+ * @param[in] xStart Start column address.
+ * @param[in] yStart Start row address.
+ * @param[in] xEnd End column address.
+ * @param[in] yEnd End row address.
+ * @return ST7355_STATUS_OK.
+ */
+st7735_status_t st7735_cmdListSetWindow(st7735CmdList_t *list, uint16_t xStart, uint16_t yStart, uint16_t xEnd, uint16_t yEnd);
+
+/**
+ * @brief Record the same color for a number of pixels, continuing the pixels
+ *      of the last window.
+ * @param[in/out] list Command list.
+ * @param[in] color 24-bit RGB color.
+ * @param[in] times Number of pixels.
+ * @return ST7355_STATUS_OK.
+ */
+st7735_status_t st7735_cmdListPushColor(st7735CmdList_t *list, uint32_t color, uint32_t times);
+
+/**
+ * @brief Record pixels already converted to the current color format, continuing
+ *      the pixels of the last window.
+ * @param[in/out] list Command list.
+ * @param[in] pixel Pixels of 2 bytes, MSB first, 0x0RGB for 12-bit and RGB565
+ *      for 16-bit, or of 3 bytes, R, G and B, for 18-bit.
+ * @param[in] count Number of pixels.
+ * @return ST7355_STATUS_OK.
+ */
+st7735_status_t st7735_cmdListPushPixels(st7735CmdList_t *list, const uint8_t *pixel, uint32_t count);
+
+/**
+ * @brief Write everything recorded to panel and empty the list.
+ * @details With 12-bit color, a window with an odd number of pixels must be
+ *      complete, as the half byte of the last pixel is sent as is.
+ * @param[in/out] list Command list.
+ * @return ST7355_STATUS_OK.
+ */
+st7735_status_t st7735_cmdListFlush(st7735CmdList_t *list);
+
+
 /**
  * @brief Close ST7735 and all associated peripheral.
  * @param[in] ST7735 handle to be closed.
@@ -0,0 +1,164 @@
+/*
+ * st7735sim.h
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: chiong
+ *
+ *  Virtual ST7735 panel for the host, attached to the simulated SPI bus of
+ *  hw/sim.h. Commands and data written by the st7735 and lcd drivers are decoded
+ *  into an image of display RAM, so rendering is checked and bus traffic is
+ *  measured per primitive without any hardware.
+ *
+ *  Decoded: SWRESET, CASET, RASET, RAMWR, MADCTL, COLMOD (12, 16 and 18-bit),
+ *  SCRLAR, VSCSAD, PTLAR, PTLON, NORON, INVON and INVOFF. Other commands are
+ *  counted and otherwise ignored. Reading from the panel is not supported.
+ *
+ *  Build (host), from repository root, with src/hw/sim in place of the target
+ *  backend:
+ *  	gcc -Iinc app.c src/module/st7735-lcd/st7735sim.c src/hw/sim/spi_sim.c \
+ *  		src/hw/sim/gpio_sim.c <drivers and libraries of app>
+ */
+
+#ifndef INC_ST7735SIM_H_
+#define INC_ST7735SIM_H_
+
+#include <stdint.h>
+#include "util/status.h"
+#include "module/st7735-lcd/st7735.h"
+
+/* Maximum number of arguments of a decoded command. */
+#define ST7735SIM_ARG_MAX	(6)
+
+/**
+ * @brief Macros to get the width and height of screen as seen in a MADCTL
+ * 		orientation, e.g. LCD_ORIENT_*.
+ */
+#define ST7735SIM_getWidth(orient)	\
+	(((orient) & (1u << ST7735_PANEL_EXCHANGE_XY_pos))? ST7735_HEIGHT : ST7735_WIDTH)
+#define ST7735SIM_getHeight(orient)	\
+	(((orient) & (1u << ST7735_PANEL_EXCHANGE_XY_pos))? ST7735_WIDTH : ST7735_HEIGHT)
+
+/**
+ * @brief Bus traffic since st7735sim_resetStat().
+ */
+typedef struct {
+	/* Number of SPI transfers, i.e. bus transactions. */
+	uint32_t nTransfer;
+	/* Number of bytes, commands, arguments and pixels. */
+	uint32_t nByte;
+	/* Number of commands. */
+	uint32_t nCommand;
+	/* Number of RAMWR commands, i.e. address windows written. */
+	uint32_t nWindow;
+	/* Number of pixels written to display RAM. */
+	uint32_t nPixel;
+	/* Number of changes of DCX level seen at the start of a transfer. */
+	uint32_t nDcToggle;
+} st7735simStat_t;
+
+typedef struct {
+	/* Display RAM, 0x00RRGGBB, row by row in the normal orientation of panel. */
+	uint32_t ram[ST7735_HEIGHT][ST7735_WIDTH];
+	st7735simStat_t stat;
+	uint8_t spiIdx;
+	int8_t cs;
+	uint8_t dcxPin;
+	/* DCX level of the last transfer, 0xFF before the first one. */
+	uint8_t dcLevel;
+	/* Last command and the arguments received for it. */
+	uint8_t cmd;
+	uint8_t arg[ST7735SIM_ARG_MAX];
+	uint8_t nArg;
+	/* Bytes received of a pixel not yet complete. */
+	uint8_t pixel[3];
+	uint8_t nPixelByte;
+	/* Address window and address of the next pixel, in the coordinates of MADCTL. */
+	uint16_t xStart;
+	uint16_t xEnd;
+	uint16_t yStart;
+	uint16_t yEnd;
+	uint16_t x;
+	uint16_t y;
+	uint8_t madctl;
+	uint8_t colmod;
+	/* Vertical scrolling, as of SCRLAR and VSCSAD. */
+	uint16_t scrollTop;
+	uint16_t scrollLen;
+	uint16_t scrollStart;
+	/* Partial area, as of PTLAR, and non-zero if in partial mode. */
+	uint16_t partialStart;
+	uint16_t partialEnd;
+	uint8_t isPartial;
+	uint8_t isInverted;
+} st7735sim_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Set up a virtual panel in its reset state and attach it to a chip
+ * 		select of the simulated SPI bus.
+ * @details Display RAM is cleared to black. st7735Cfg_t of the driver must use
+ * 		the same spiIdx, csPin and dcxPin.
+ * @param[out] sim Virtual panel, to stay valid until st7735sim_deinit().
+ * @param[in] spiIdx Index of SPI.
+ * @param[in] cs Chip select.
+ * @param[in] dcxPin GPIO of DCX.
+ * @return STATUS_OK if success, STATUS_ERROR_PARAM if spiIdx, cs or dcxPin is
+ * 		out of the range of simulation.
+ */
+int32_t st7735sim_init(st7735sim_t *sim, uint8_t spiIdx, int8_t cs, uint8_t dcxPin);
+
+
+/**
+ * @brief Detach a virtual panel from the simulated SPI bus.
+ * @param[in] sim Virtual panel.
+ */
+void st7735sim_deinit(st7735sim_t *sim);
+
+
+/**
+ * @brief Clear the counters of bus traffic, e.g. before each operation to be measured.
+ * @param[in] sim Virtual panel.
+ */
+void st7735sim_resetStat(st7735sim_t *sim);
+
+
+/**
+ * @brief Get the color shown by a pixel of panel, after scrolling, partial mode
+ * 		and inversion.
+ * @param[in] sim Virtual panel.
+ * @param[in] orient Orientation the panel is seen in, as MADCTL, e.g. the
+ * 		LCD_ORIENT_* of the drawing. ST7735_PANEL_ORIENT_NORMAL is the order of
+ * 		display RAM, i.e. with the cable end of module at top.
+ * @param[in] x Column, in orientation orient.
+ * @param[in] y Row, in orientation orient.
+ * @return 24-bit RGB color, black outside panel or the partial area.
+ */
+uint32_t st7735sim_getPixel(const st7735sim_t *sim, uint8_t orient, uint16_t x, uint16_t y);
+
+
+/**
+ * @brief Get a hash of what the panel shows, to compare renderings without files.
+ * @param[in] sim Virtual panel.
+ * @return 32-bit FNV-1a hash of every pixel, in the order of display RAM.
+ */
+uint32_t st7735sim_getHash(const st7735sim_t *sim);
+
+
+/**
+ * @brief Write what the panel shows as a binary PPM (P6) image.
+ * @param[in] sim Virtual panel.
+ * @param[in] orient Orientation of image, see st7735sim_getPixel().
+ * @param[in] path Path of image.
+ * @return STATUS_OK if success, STATUS_ERROR_FILE_OPEN if the file cannot be
+ * 		created, STATUS_ERROR if writing fails.
+ */
+int32_t st7735sim_writePpm(const st7735sim_t *sim, uint8_t orient, const char *path);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INC_ST7735SIM_H_ */
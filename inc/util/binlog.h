@@ -0,0 +1,177 @@
+/*
+ * binlog.h
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: chiong
+ *
+ *  Asynchronous binary log writer for sensor streams. Sampling threads hand
+ *  timestamped records to binlog_write(), which only copies the record into a
+ *  lock-free queue and returns: it never blocks, never calls malloc() and never
+ *  touches the file. A background thread drains the queue into a large aligned
+ *  batch buffer and writes it out batchSize bytes at a time, so that SD card
+ *  latency is absorbed by the queue instead of the sampling thread.
+ *
+ *  Sampling threads:                     Writer thread (internal):
+ *
+ *  	binlog_write(log, ID_IMU,          	record -> batch buffer
+ *  			&sample, sizeof(sample));   	batch full -> write()
+ *  	                                    	no record for flushMs -> write()
+ *  	                                    	file too large or old -> next file
+ *
+ *  Any number of threads may call binlog_write() concurrently. The queue is a
+ *  bounded array of nSlot slots of maxRecordSize bytes, each with a sequence
+ *  number claimed by compare-and-swap. If the queue is full, e.g. the card stalls
+ *  for longer than the queue can hold, the record is dropped and counted, see
+ *  binlog_getStats().
+ *
+ *  Structure of file, records back to back, each payload padded to
+ *  BINLOG_RECORD_ALIGN bytes so that headers stay aligned, e.g. when the file is
+ *  read back with file_mapOpen()
+ *
+ *  +-----------------+---------------+-----------------+---------------+---
+ *  | binlogRecord_t  | payload (pad) | binlogRecord_t  | payload (pad) | ...
+ *  +-----------------+---------------+-----------------+---------------+---
+ *
+ *  Files are named by filenameFormat with the file index, e.g. "imu_%04u.bin"
+ *  gives imu_0000.bin, imu_0001.bin, ... A new file is started before a record
+ *  that would take the file over maxFileSize bytes, or once the file is older
+ *  than maxFileMs, so that records are never split across files.
+ *
+ *  With isDirect, files are opened with O_DIRECT (Linux) and bypass the page
+ *  cache, so that logging does not evict the working set of other threads. Only
+ *  whole batches are then written while logging; the last partial batch is
+ *  written when the file is rotated or the log destroyed. If the file system
+ *  does not support O_DIRECT, e.g. tmpfs, normal buffered writes are used.
+ *
+ *  The byte count of binlog_getStats() is a 64-bit atomic, so that it does not
+ *  wrap on long recordings. On 32-bit targets, e.g. ARM of Raspberry Pi, gcc may
+ *  call libatomic for it, so applications must link with -latomic.
+ */
+
+#ifndef INC_BINLOG_H_
+#define INC_BINLOG_H_
+
+#include <stdint.h>
+#include "status.h"
+
+/* Alignment, in bytes, of batch buffer and of batchSize for O_DIRECT. */
+#define BINLOG_ALIGNMENT		(4096)
+/* Alignment, in bytes, of every record in file. */
+#define BINLOG_RECORD_ALIGN		(8)
+/* Assumed cache line size, in bytes. Minimum alignment of each queue slot. */
+#define BINLOG_CACHE_LINE_SIZE	(64)
+
+/**
+ * @brief Macro to get the size, in bytes, of a record in file with payload of size bytes.
+ */
+#define BINLOG_getRecordSize(size)	\
+	(sizeof(binlogRecord_t) + (((size) + BINLOG_RECORD_ALIGN - 1) & ~(BINLOG_RECORD_ALIGN - 1)))
+
+typedef struct binlog_s binlog_t;
+
+/**
+ * @brief Header of each record in file, followed by size bytes of payload.
+ */
+typedef struct {
+	/* Timestamp, in ns, of CLOCK_MONOTONIC unless given to binlog_writeAt(). */
+	uint64_t timestamp;
+	/* Size, in bytes, of payload, excluding padding. */
+	uint32_t size;
+	/* Source of record, defined by the application. */
+	uint16_t id;
+	uint16_t reserved;
+} binlogRecord_t;
+
+typedef struct {
+	/* printf() format of file names, with one unsigned for file index. */
+	const char *filenameFormat;
+	/* Number of slots in queue. Must be power of 2. */
+	uint32_t nSlot;
+	/* Maximum size, in bytes, of the payload of a record. */
+	uint32_t maxRecordSize;
+	/* Size, in bytes, of each write. Must be a multiple of BINLOG_ALIGNMENT. */
+	uint32_t batchSize;
+	/* Start a new file before this size, in bytes, is exceeded. 0 for no limit. */
+	uint64_t maxFileSize;
+	/* Start a new file after this duration, in ms. 0 for no limit. */
+	uint32_t maxFileMs;
+	/* Write out a partial batch after this duration, in ms, without new record. */
+	uint32_t flushMs;
+	/* Non-zero to write with O_DIRECT, if supported. */
+	uint8_t isDirect;
+} binlogCfg_t;
+
+typedef struct {
+	/* Number of records written to file. */
+	uint32_t nRecord;
+	/* Number of records dropped because the queue was full. */
+	uint32_t nDrop;
+	/* Number of write() that failed. Data of the failed write is lost. */
+	uint32_t nError;
+	/* Number of files started, including the first one. */
+	uint32_t nFile;
+	/* Number of files that failed to open on rotation. Writes fail until the
+	 * next rotation, which opens the same file index again. */
+	uint32_t nOpenFail;
+	/* Number of bytes written to files. */
+	uint64_t nByte;
+} binlogStats_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief To create a log writer, open the first file and start the writer thread.
+ * @param[out] ppSelf Address to store the newly created instance.
+ * @param[in] cfg Configuration used to create the instance.
+ * @return STATUS_OK if success, STATUS_ERROR_FILE_OPEN if the first file cannot
+ * 		be created, STATUS_ERROR_PARAM if the configuration is invalid,
+ * 		STATUS_ERROR* otherwise.
+ */
+int32_t binlog_create(binlog_t **ppSelf, const binlogCfg_t *cfg);
+
+/**
+ * @brief To stop the writer thread once all queued records are written, close
+ * 		the file and release the memory. No thread may be calling binlog_write().
+ * @param[in/out] ppSelf Address of instance to be destroyed. Once destroyed,
+ * 		*ppSelf will be NULL.
+ * @return STATUS_OK if success, STATUS_ERROR* otherwise.
+ */
+int32_t binlog_destroy(binlog_t **ppSelf);
+
+/**
+ * @brief Queue a record timestamped now. Lock-free, never blocks.
+ * @param[in/out] pSelf Instance.
+ * @param[in] id Source of record.
+ * @param[in] data Payload, copied into the queue.
+ * @param[in] size Size, in bytes, of payload.
+ * @return STATUS_OK if queued, STATUS_ERROR if dropped because the queue is full,
+ * 		STATUS_ERROR_PARAM if size is more than maxRecordSize.
+ */
+int32_t binlog_write(binlog_t *pSelf, uint16_t id, const void *data, uint32_t size);
+
+/**
+ * @brief Queue a record with the given timestamp, e.g. the capture time of a
+ * 		sample. Lock-free, never blocks.
+ * @param[in/out] pSelf Instance.
+ * @param[in] id Source of record.
+ * @param[in] timestamp Timestamp, in ns.
+ * @param[in] data Payload, copied into the queue.
+ * @param[in] size Size, in bytes, of payload.
+ * @return Same as binlog_write().
+ */
+int32_t binlog_writeAt(binlog_t *pSelf, uint16_t id, uint64_t timestamp, const void *data, uint32_t size);
+
+/**
+ * @brief Get the counters of log. The values are a snapshot.
+ * @param[in] pSelf Instance.
+ * @param[out] stats Counters.
+ */
+void binlog_getStats(const binlog_t *pSelf, binlogStats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INC_BINLOG_H_ */
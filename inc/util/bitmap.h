@@ -20,6 +20,34 @@
 #define BITMAP_COLORMAP_24_BIT		(24)
 #define BITMAP_COLORMAP_32_BIT		(32)
 
+/* Compression methods supported by bitmap_readerOpen() */
+#define BITMAP_COMPRESSION_RGB			(0)
+#define BITMAP_COMPRESSION_BITFIELDS	(3)
+
+/* Output pixel formats of bitmap_readRows().
+ * ARGB32: one uint32_t 0x00RRGGBB per pixel, in host byte order.
+ * RGB444: ST7735 12-bit wire format, 3 bytes per 2 pixels, RRRRGGGG BBBBRRRR GGGGBBBB.
+ * RGB565: ST7735 16-bit wire format, 2 bytes per pixel, RRRRRGGG GGGBBBBB.
+ * RGB666: ST7735 18-bit wire format, 3 bytes per pixel, RRRRRR00 GGGGGG00 BBBBBB00. */
+#define BITMAP_PIXEL_FMT_ARGB32		(0)
+#define BITMAP_PIXEL_FMT_RGB444		(1)
+#define BITMAP_PIXEL_FMT_RGB565		(2)
+#define BITMAP_PIXEL_FMT_RGB666		(3)
+
+/* Size, in bytes, of the buffer for rows read from file. */
+#define BITMAP_READER_CHUNK_SIZE	(4096)
+
+/**
+ * @brief Macro to get the number of bytes of n pixels in a given output format.
+ * 		With RGB444, an odd pixel count is rounded up to the next byte.
+ */
+#define BITMAP_getPackedSize(fmt, n)	\
+	((fmt) == BITMAP_PIXEL_FMT_ARGB32? (n) * 4 :	\
+	 (fmt) == BITMAP_PIXEL_FMT_RGB444? ((n) * 3 + 1) / 2 :	\
+	 (fmt) == BITMAP_PIXEL_FMT_RGB565? (n) * 2 : (n) * 3)
+
+typedef struct bitmapReader_s bitmapReader_t;
+
 
 typedef struct {
 	int16_t type;
@@ -52,13 +80,14 @@ typedef struct {
 
 /**
  * @brief Read bitmap file.
- * @details Read bitmap file into bitmap struct. Only 32-bit BMP format is
- * 		currently supported.
+ * @details Read bitmap file into bitmap struct. Supports the same formats as
+ * 		bitmap_readerOpen(). The image is stored top row first as
+ * 		BITMAP_PIXEL_FMT_ARGB32 and the height in imageHeader is made positive.
  * @param[out] Bitmap struct to be populated in this function. Once done,
  * 		this struct must be freed by calling bitmap_destroy().
  * @param[in] filename Filename of bitmap file to read.
  */
-int32_t bitmap_readFile(bitmap_t **bitmap, char* filename);
+int32_t bitmap_readFile(bitmap_t **bitmap, const char* filename);
 
 
 /**
@@ -68,4 +97,67 @@ int32_t bitmap_readFile(bitmap_t **bitmap, char* filename);
  */
 void bitmap_destroy(bitmap_t **bitmap);
 
+
+/**
+ * @brief Open a bitmap file to be read row by row.
+ * @details Only the headers and palette are read here. Rows are then read with
+ * 		bitmap_readRows(), top row first, regardless of whether the file is stored
+ * 		bottom-up or top-down, and converted straight from the file format into
+ * 		the requested output format. Supports uncompressed 1, 4, 8, 16, 24 and
+ * 		32-bit BMP, and 16 and 32-bit BMP with bit fields.
+ * @param[out] ppReader Address to store the newly opened reader.
+ * @param[in] filename Filename of bitmap file to read.
+ * @return STATUS_OK if success, STATUS_ERROR_FILE_OPEN if the file cannot be
+ * 		opened, STATUS_ERROR if it is not a supported BMP, STATUS_ERROR* otherwise.
+ */
+int32_t bitmap_readerOpen(bitmapReader_t **ppReader, const char *filename);
+
+
+/**
+ * @brief Close the reader and its file.
+ * @param[in/out] ppReader Address of reader to be closed. Once closed, *ppReader
+ * 		will be NULL.
+ */
+void bitmap_readerClose(bitmapReader_t **ppReader);
+
+
+/**
+ * @brief Get the width, in pixels, of image.
+ */
+uint32_t bitmap_readerGetWidth(const bitmapReader_t *pReader);
+
+
+/**
+ * @brief Get the height, in pixels, of image.
+ */
+uint32_t bitmap_readerGetHeight(const bitmapReader_t *pReader);
+
+
+/**
+ * @brief Restrict the columns returned by bitmap_readRows(), e.g. to clip an
+ * 		image wider than the screen. Default is all columns.
+ * @param[in/out] pReader Reader.
+ * @param[in] x First column.
+ * @param[in] width Number of columns.
+ * @return STATUS_OK if success, STATUS_ERROR_PARAM if the columns are not in image.
+ */
+int32_t bitmap_readerSetColumns(bitmapReader_t *pReader, uint32_t x, uint32_t width);
+
+
+/**
+ * @brief Read the next rows of image, converted into the given output format.
+ * @details Rows are packed back to back into dst without padding. With
+ * 		BITMAP_PIXEL_FMT_RGB444, pixels are packed as one continuous stream across
+ * 		rows, so that an odd width only leaves a half byte at the end of dst if
+ * 		the total pixel count is odd.
+ * @param[in/out] pReader Reader.
+ * @param[out] dst Destination, of at least BITMAP_getPackedSize(fmt, width * nRow)
+ * 		bytes. Must be aligned to 4 bytes for BITMAP_PIXEL_FMT_ARGB32.
+ * @param[in] nRow Maximum number of rows to read.
+ * @param[in] fmt Output pixel format, BITMAP_PIXEL_FMT_*.
+ * @return Number of rows read, 0 once all rows are read, STATUS_ERROR if the
+ * 		file is truncated, STATUS_ERROR_PARAM if fmt is invalid.
+ */
+int32_t bitmap_readRows(bitmapReader_t *pReader, void *dst, uint32_t nRow, uint32_t fmt);
+
 #endif /* INC_BITMAP_H_ */
@@ -20,6 +20,74 @@
  *
  *  For this interpretation, the buffer will have non-interleaved data when layout ==
  *  BUFFER2D_LAYOUT_COLUMN_WISE and interleaved data when layout == BUFFER2D_LAYOUT_ROW_WISE
+ *
+ *  A view (buffer2dView_t) describes a rectangular part of a 2D buffer, e.g. a row,
+ *  a column/channel or a block of samples, by the address of its first element and
+ *  the distance in bytes between rows and between columns. Creating a view does not
+ *  copy any data, so a view can be handed to another function in place of a copy.
+ *  The view is only valid as long as the buffer it is taken from.
+ *
+ *  		rowStride = nCol x elemSize (ROW_WISE)
+ *  		<------------------------>
+ *  		+----+----+----+----+----+
+ *  		|    |    |    |    |    |
+ *  		+----+----+----+----+----+
+ *  		|    | v0 | v1 |    |    |     <- view of 2x2 block at (1, 1):
+ *  		+----+----+----+----+----+        data = &(1, 1),
+ *  		|    | v2 | v3 |    |    |        colStride = elemSize
+ *  		+----+----+----+----+----+
+ *
+ *  buffer2dView_copy() and buffer2dView_fill() use a single memcpy() when the
+ *  memory of the view is contiguous, and strided loops with the element size known
+ *  at compile time (1, 2, 4 or 8 bytes) otherwise. Filling a contiguous run is a
+ *  memset() if all bytes of the element are the same, otherwise the element is
+ *  copied once and then doubled with memcpy() up to a cached chunk.
+ *
+ *  The generic put/get functions take the element size at runtime and copy each
+ *  element with memcpy(). For the common element types, typed variants with the
+ *  type as suffix are also provided, e.g. buffer2d_getDataColI16(). Their loops
+ *  use plain typed loads and stores the compiler can unroll and vectorise:
+ *
+ *  		Suffix	Type
+ *  		I16		int16_t
+ *  		I32		int32_t
+ *  		F32		float
+ *  		CF32	complexf_t
+ *
+ *  The element size of the buffer must be the size of the type.
+ *
+ *  Layout conversion, i.e. interleave/deinterleave, is done by buffer2d_copyLayout()
+ *  into another buffer or by buffer2d_setLayout() in place. The out-of-place
+ *  conversion works on blocks of samples that stay in cache, one channel at a
+ *  time, with the number of channels known at compile time for 2, 4, 6, 8 and 16
+ *  channels (and NEON structure loads/stores under __ARM_NEON for 2 and 4).
+ *  buffer2d_convertI16ToF32() and buffer2d_convertF32ToI16() do the same with the
+ *  sample format conversion fused in, so that a captured int16 interleaved frame
+ *  becomes a float non-interleaved frame in one pass. buffer2d_convertI32ToF32() and
+ *  buffer2d_convertF32ToI32() are the same for int32.
+ *
+ *  The bulk operations, i.e. scale, clip and accumulate, work element-wise on the
+ *  whole buffer, so they run over the memory in storage order whatever the layout:
+ *  one loop over all elements, or one per line if the lines are padded.
+ *
+ *  buffer2d_createEx() additionally aligns the first element of every line, i.e.
+ *  row for ROW_WISE and column/channel for COLUMN_WISE, and pads every line with
+ *  unused elements, so that SIMD code can use aligned loads and channels do not
+ *  share cache lines. The distance between lines, in elements, is the leading
+ *  dimension (ld). The memory can also be provided by the caller, e.g. from an
+ *  arena, shared memory or a mmap()-ed file.
+ *
+ *  		ld = nRow + padding (COLUMN_WISE)
+ *  		<----------------------->
+ *  		+----+----+----+----+---+
+ *  		| x0 | x1 | x2 | x3 |   |  channel 0     <- aligned
+ *  		+----+----+----+----+---+
+ *  		| y0 | y1 | y2 | y3 |   |  channel 1     <- aligned
+ *  		+----+----+----+----+---+
+ *
+ *  All accessors, views and conversions honour the leading dimension. Only
+ *  buffer2d_getBuffer() exposes the padding, and buffer2d_setLayout() does not
+ *  support it.
  */
 
 #ifndef INC_BUFFER_H_
@@ -27,6 +95,7 @@
 
 #include <stdint.h>
 #include "status.h"
+#include "xtype.h"
 
 /* 2D buffer internal data layout. */
 #define BUFFER2D_LAYOUT_COLUMN_WISE		(0x00)
@@ -134,6 +203,116 @@
 #define MCBUFFER_getBufferAsType(pSelf, type)	\
 	BUFFER2D_getBufferAsType(pSelf, type)
 
+/**
+ * @brief Macro to interleave or deinterleave a multi-channel buffer in place.
+ * @param[in/out] pSelf Multi-channel buffer instance.
+ * @param[in] layout MCBUFFER_LAYOUT_INTERLEAVED or MCBUFFER_LAYOUT_NON_INTERLEAVED.
+ */
+#define MCBUFFER_setLayout(pSelf, layout)	\
+	buffer2d_setLayout(pSelf, layout)
+
+/**
+ * @brief Macro to put a channel of data with typed variant, e.g.
+ * 		MCBUFFER_putDataAtChannelAs(pSelf, 0, data, F32).
+ * @param[in/out] pSelf Multi-channel buffer instance.
+ * @param[in] channel Index of channel.
+ * @param[in] data Data of all samples of the channel.
+ * @param[in] suffix Type suffix, i.e. I16, I32, F32 or CF32.
+ */
+#define MCBUFFER_putDataAtChannelAs(pSelf, channel, data, suffix)	\
+	buffer2d_putDataCol##suffix(pSelf, channel, data)
+
+/**
+ * @brief Macro to get a channel of data with typed variant.
+ * @param[in] pSelf Multi-channel buffer instance.
+ * @param[in] channel Index of channel.
+ * @param[out] data Buffer for all samples of the channel.
+ * @param[in] suffix Type suffix, i.e. I16, I32, F32 or CF32.
+ */
+#define MCBUFFER_getDataAtChannelAs(pSelf, channel, data, suffix)	\
+	buffer2d_getDataCol##suffix(pSelf, channel, data)
+
+/**
+ * @brief Macro to put all channels at sample index n with typed variant.
+ * @param[in/out] pSelf Multi-channel buffer instance.
+ * @param[in] n Sample index.
+ * @param[in] data Data of all channels.
+ * @param[in] suffix Type suffix, i.e. I16, I32, F32 or CF32.
+ */
+#define MCBUFFER_putDataAtIndexAs(pSelf, n, data, suffix)	\
+	buffer2d_putDataRow##suffix(pSelf, n, data)
+
+/**
+ * @brief Macro to get all channels at sample index n with typed variant.
+ * @param[in] pSelf Multi-channel buffer instance.
+ * @param[in] n Sample index.
+ * @param[out] data Buffer for all channels.
+ * @param[in] suffix Type suffix, i.e. I16, I32, F32 or CF32.
+ */
+#define MCBUFFER_getDataAtIndexAs(pSelf, n, data, suffix)	\
+	buffer2d_getDataRow##suffix(pSelf, n, data)
+
+/**
+ * @brief Macro to declare the typed variants of put/get functions.
+ * @param[in] suffix Suffix of function names.
+ * @param[in] type Element type.
+ */
+#define BUFFER2D_DECLARE_TYPED(suffix, type)	\
+	void buffer2d_putDataSingle##suffix(buffer2d_t *pSelf, uint32_t iRow, uint32_t jCol, type data);	\
+	type buffer2d_getDataSingle##suffix(const buffer2d_t *pSelf, uint32_t iRow, uint32_t jCol);	\
+	void buffer2d_putDataRow##suffix(buffer2d_t *pSelf, uint32_t iRow, const type *data);	\
+	void buffer2d_putDataCol##suffix(buffer2d_t *pSelf, uint32_t jCol, const type *data);	\
+	void buffer2d_getDataRow##suffix(const buffer2d_t *pSelf, uint32_t iRow, type *data);	\
+	void buffer2d_getDataCol##suffix(const buffer2d_t *pSelf, uint32_t jCol, type *data);
+
+/**
+ * @brief Macro to declare the bulk operations on all elements of a type.
+ * @param[in] suffix Suffix of function names.
+ * @param[in] type Element type.
+ */
+#define BUFFER2D_DECLARE_BULK(suffix, type)	\
+	int32_t buffer2d_scale##suffix(buffer2d_t *pSelf, float gain);	\
+	int32_t buffer2d_clip##suffix(buffer2d_t *pSelf, type lo, type hi);	\
+	int32_t buffer2d_accumulate##suffix(buffer2d_t *pDst, const buffer2d_t *pSrc, float gain);
+
+/**
+ * @brief Macro to get a view of all samples of a channel.
+ * @param[in] pSelf Multi-channel buffer instance.
+ * @param[in] channel Index of channel.
+ * @param[out] pView View to be initialised.
+ */
+#define MCBUFFER_getViewChannel(pSelf, channel, pView)	\
+	buffer2d_getViewCol(pSelf, channel, pView)
+
+/**
+ * @brief Macro to get a view of all channels at sample index n.
+ * @param[in] pSelf Multi-channel buffer instance.
+ * @param[in] n Sample index.
+ * @param[out] pView View to be initialised.
+ */
+#define MCBUFFER_getViewIndex(pSelf, n, pView)	\
+	buffer2d_getViewRow(pSelf, n, pView)
+
+/**
+ * @brief Macro to get a view of all channels from sample index n to n + nSample - 1.
+ * @param[in] pSelf Multi-channel buffer instance.
+ * @param[in] n Index of first sample.
+ * @param[in] nSample Number of samples.
+ * @param[out] pView View to be initialised.
+ */
+#define MCBUFFER_getViewWindow(pSelf, n, nSample, pView)	\
+	buffer2d_getViewBlock(pSelf, n, 0, nSample, MCBUFFER_getNumChannel(pSelf), pView)
+
+/**
+ * @brief Macro to get the address of element at row i and column j of a view.
+ * @param[in] pView View.
+ * @param[in] i Index of row.
+ * @param[in] j Index of column.
+ * @return Address of element.
+ */
+#define BUFFER2DVIEW_getElemAddr(pView, i, j)	\
+	((pView)->data + (i) * (pView)->rowStride + (j) * (pView)->colStride)
+
 /**
  * @brief Data struct for 2D buffer stored as 1d array.
  */
@@ -144,6 +323,48 @@ typedef struct buffer2d_s buffer2d_t;
  */
 typedef struct buffer2d_s mcbuffer_t;
 
+/**
+ * @brief Non-owning view of a rectangular part of a 2D buffer or any memory.
+ */
+typedef struct {
+	/** Address of element at row 0, column 0 of the view. */
+	void *data;
+	/** Distance, in bytes, between 2 consecutive rows. */
+	uint32_t rowStride;
+	/** Distance, in bytes, between 2 consecutive columns. */
+	uint32_t colStride;
+	/** Number of rows. */
+	uint32_t nRow;
+	/** Number of columns. */
+	uint32_t nCol;
+	/** Size, in bytes, of each element. */
+	uint32_t elemSize;
+} buffer2dView_t;
+
+/**
+ * @brief Configuration of 2D buffer for buffer2d_createEx().
+ */
+typedef struct {
+	/** Number of rows. */
+	uint32_t nRow;
+	/** Number of columns. */
+	uint32_t nCol;
+	/** Size, in bytes, of each element. */
+	uint32_t elemSize;
+	/** BUFFER2D_LAYOUT_ROW_WISE or BUFFER2D_LAYOUT_COLUMN_WISE. */
+	uint8_t layout;
+	/** Alignment, in bytes, of the first element of every row (ROW_WISE) or
+	 * column (COLUMN_WISE). Must be power of 2. 0 or 1 for none. */
+	uint32_t alignment;
+	/** Minimum number of unused elements after every row (ROW_WISE) or column
+	 * (COLUMN_WISE). More may be added to meet the alignment. */
+	uint32_t pad;
+	/** External memory of at least buffer2d_getMemSize() bytes, aligned to
+	 * alignment. Not cleared, and not freed by buffer2d_destroy(). NULL to
+	 * allocate zeroed memory. */
+	void *mem;
+} buffer2dCfg_t;
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -163,6 +384,24 @@ extern "C" {
  */
 int32_t buffer2d_create(buffer2d_t **ppSelf, uint32_t nRow, uint32_t nCol, uint32_t elemSize, uint8_t layout);
 
+/**
+ * @brief Create a 2D buffer with aligned and padded lines, optionally on external
+ * 		memory.
+ * @param[out] ppSelf Pointer to store newly created 2D buffer instance.
+ * @param[in] cfg Configuration used to create the instance.
+ * @return STATUS_OK if success, STATUS_ERROR_PARAM if cfg is invalid or
+ * 		cfg->mem is not aligned, STATUS_ERROR_MALLOC if out of memory.
+ */
+int32_t buffer2d_createEx(buffer2d_t **ppSelf, const buffer2dCfg_t *cfg);
+
+/**
+ * @brief Get the size of memory needed by buffer2d_createEx(), e.g. to provide
+ * 		external memory.
+ * @param[in] cfg Configuration of 2D buffer.
+ * @return Size, in bytes, including padding but not any alignment of the start.
+ */
+uint32_t buffer2d_getMemSize(const buffer2dCfg_t *cfg);
+
 /**
  * @brief Destroy and free a 2D buffer instance.
  * @param[in/out] ppSelf 2D buffer instance to be destroyed. Once destroyed,
@@ -256,12 +495,195 @@ uint32_t buffer2d_getNumCol(buffer2d_t *pSelf);
 /**
  * @brief Get the address of the internal buffer..
  * @param[in] pSelf 2D buffer instance.
- * @return Address of internal buffer
+ * @return Address of internal buffer. Lines are buffer2d_getLeadingDim() elements
+ * 		apart.
  */
 const void* buffer2d_getBuffer(buffer2d_t *pSelf);
 
 /**
- * @brief Print the content of 2D buffer on stdout.
+ * @brief Get the leading dimension, i.e. the distance, in elements, between the
+ * 		first elements of 2 consecutive rows (ROW_WISE) or columns (COLUMN_WISE).
+ * @param[in] pSelf 2D buffer instance.
+ * @return Leading dimension. nCol (ROW_WISE) or nRow (COLUMN_WISE) if not padded.
+ */
+uint32_t buffer2d_getLeadingDim(const buffer2d_t *pSelf);
+
+/* Typed variants of put/get functions, see top of this file. Same as the
+ * generic functions, except that data is passed by value for single element. */
+BUFFER2D_DECLARE_TYPED(I16, int16_t)
+BUFFER2D_DECLARE_TYPED(I32, int32_t)
+BUFFER2D_DECLARE_TYPED(F32, float)
+BUFFER2D_DECLARE_TYPED(CF32, complexf_t)
+
+/* Bulk operations on all elements, see top of this file. Each returns STATUS_OK
+ * if success, STATUS_ERROR_PARAM if the element size is not the size of the type.
+ * 	scale:		x = x * gain
+ * 	clip:		x = min(max(x, lo), hi), STATUS_ERROR_PARAM if lo > hi
+ * 	accumulate:	dst = dst + src * gain, STATUS_ERROR_PARAM if the dimensions or
+ * 				layouts differ
+ * The integer variants round to nearest and saturate the result. */
+BUFFER2D_DECLARE_BULK(I16, int16_t)
+BUFFER2D_DECLARE_BULK(I32, int32_t)
+BUFFER2D_DECLARE_BULK(F32, float)
+
+/**
+ * @brief Get a view of the whole 2D buffer.
+ * @param[in] pSelf 2D buffer instance.
+ * @param[out] pView View to be initialised.
+ */
+void buffer2d_getView(buffer2d_t *pSelf, buffer2dView_t *pView);
+
+/**
+ * @brief Get a view of a row of 2D buffer, i.e. 1 x nCol.
+ * @param[in] pSelf 2D buffer instance.
+ * @param[in] iRow Index of row.
+ * @param[out] pView View to be initialised.
+ */
+void buffer2d_getViewRow(buffer2d_t *pSelf, uint32_t iRow, buffer2dView_t *pView);
+
+/**
+ * @brief Get a view of a column of 2D buffer, i.e. nRow x 1.
+ * @param[in] pSelf 2D buffer instance.
+ * @param[in] jCol Index of column.
+ * @param[out] pView View to be initialised.
+ */
+void buffer2d_getViewCol(buffer2d_t *pSelf, uint32_t jCol, buffer2dView_t *pView);
+
+/**
+ * @brief Get a view of a block of 2D buffer.
+ * @param[in] pSelf 2D buffer instance.
+ * @param[in] iRow Index of first row of block.
+ * @param[in] jCol Index of first column of block.
+ * @param[in] nRow Number of rows of block. iRow + nRow must be within the number
+ * 		of rows of pSelf.
+ * @param[in] nCol Number of columns of block. jCol + nCol must be within the number
+ * 		of columns of pSelf.
+ * @param[out] pView View to be initialised.
+ */
+void buffer2d_getViewBlock(buffer2d_t *pSelf, uint32_t iRow, uint32_t jCol,
+		uint32_t nRow, uint32_t nCol, buffer2dView_t *pView);
+
+/**
+ * @brief Initialise a view over a plain array, e.g. user buffer.
+ * @param[out] pView View to be initialised.
+ * @param[in] data Address of the array.
+ * @param[in] nRow Number of rows.
+ * @param[in] nCol Number of columns.
+ * @param[in] elemSize Size, in bytes, of each element.
+ * @param[in] layout BUFFER2D_LAYOUT_ROW_WISE if rows are contiguous, or
+ * 		BUFFER2D_LAYOUT_COLUMN_WISE if columns are contiguous.
+ */
+void buffer2dView_init(buffer2dView_t *pView, void *data, uint32_t nRow, uint32_t nCol,
+		uint32_t elemSize, uint8_t layout);
+
+/**
+ * @brief Get a view of a block of another view.
+ * @param[in] pView Parent view.
+ * @param[in] iRow Index of first row of block.
+ * @param[in] jCol Index of first column of block.
+ * @param[in] nRow Number of rows of block.
+ * @param[in] nCol Number of columns of block.
+ * @param[out] pSub View to be initialised. May be the same as pView.
+ */
+void buffer2dView_getBlock(const buffer2dView_t *pView, uint32_t iRow, uint32_t jCol,
+		uint32_t nRow, uint32_t nCol, buffer2dView_t *pSub);
+
+/**
+ * @brief Check if all elements of the view are in one contiguous memory, i.e.
+ * 		without gap between rows or between columns.
+ * @param[in] pView View.
+ * @return Non-zero if contiguous.
+ */
+uint8_t buffer2dView_isContiguous(const buffer2dView_t *pView);
+
+/**
+ * @brief Copy the elements of a view to another view. Both views must have the
+ * 		same number of rows, columns and element size, and must not overlap.
+ * @param[in/out] pDst Destination view.
+ * @param[in] pSrc Source view.
+ */
+void buffer2dView_copy(buffer2dView_t *pDst, const buffer2dView_t *pSrc);
+
+/**
+ * @brief Fill all elements of a view with the given single element.
+ * @param[in/out] pView View.
+ * @param[in] elem Element for filling.
+ */
+void buffer2dView_fill(buffer2dView_t *pView, const void *elem);
+
+/**
+ * @brief Get the layout of 2D buffer.
+ * @param[in] pSelf 2D buffer instance.
+ * @return BUFFER2D_LAYOUT_ROW_WISE or BUFFER2D_LAYOUT_COLUMN_WISE.
+ */
+uint8_t buffer2d_getLayout(const buffer2d_t *pSelf);
+
+/**
+ * @brief Copy all elements of a 2D buffer into another 2D buffer, converting the
+ * 		layout if the two differ, e.g. interleaved to non-interleaved.
+ * @param[out] pDst Destination 2D buffer.
+ * @param[in] pSrc Source 2D buffer, with the same dimension and element size as
+ * 		destination. Must not share memory with destination.
+ * @return STATUS_OK if success, STATUS_ERROR_PARAM if the dimensions or element
+ * 		sizes differ.
+ */
+int32_t buffer2d_copyLayout(buffer2d_t *pDst, const buffer2d_t *pSrc);
+
+/**
+ * @brief Change the layout of 2D buffer in place, keeping the element at each row
+ * 		and column. Uses no extra memory, but is slower than buffer2d_copyLayout().
+ * @param[in/out] pSelf 2D buffer instance.
+ * @param[in] layout New layout, BUFFER2D_LAYOUT_ROW_WISE or BUFFER2D_LAYOUT_COLUMN_WISE.
+ * @return STATUS_OK if success, STATUS_ERROR_PARAM if layout is invalid, the
+ * 		element size is more than 16 bytes or the lines are padded.
+ */
+int32_t buffer2d_setLayout(buffer2d_t *pSelf, uint8_t layout);
+
+/**
+ * @brief Convert an int16_t 2D buffer to a float 2D buffer of any layout.
+ * @param[out] pDst Destination 2D buffer of float.
+ * @param[in] pSrc Source 2D buffer of int16_t, with the same dimension as destination.
+ * @param[in] scale Scale applied to each element, e.g. 1 / 32768 for [-1, 1).
+ * @return STATUS_OK if success, STATUS_ERROR_PARAM if the dimensions or element
+ * 		sizes do not match.
+ */
+int32_t buffer2d_convertI16ToF32(buffer2d_t *pDst, const buffer2d_t *pSrc, float scale);
+
+/**
+ * @brief Convert a float 2D buffer to an int16_t 2D buffer of any layout. Each
+ * 		element is scaled, rounded to nearest and saturated to the int16_t range.
+ * @param[out] pDst Destination 2D buffer of int16_t.
+ * @param[in] pSrc Source 2D buffer of float, with the same dimension as destination.
+ * @param[in] scale Scale applied to each element, e.g. 32768 for [-1, 1).
+ * @return STATUS_OK if success, STATUS_ERROR_PARAM if the dimensions or element
+ * 		sizes do not match.
+ */
+int32_t buffer2d_convertF32ToI16(buffer2d_t *pDst, const buffer2d_t *pSrc, float scale);
+
+/**
+ * @brief Convert an int32_t 2D buffer to a float 2D buffer of any layout.
+ * @param[out] pDst Destination 2D buffer of float.
+ * @param[in] pSrc Source 2D buffer of int32_t, with the same dimension as destination.
+ * @param[in] scale Scale applied to each element, e.g. 1 / 2^31 for [-1, 1).
+ * @return STATUS_OK if success, STATUS_ERROR_PARAM if the dimensions or element
+ * 		sizes do not match.
+ */
+int32_t buffer2d_convertI32ToF32(buffer2d_t *pDst, const buffer2d_t *pSrc, float scale);
+
+/**
+ * @brief Convert a float 2D buffer to an int32_t 2D buffer of any layout. Each
+ * 		element is scaled, rounded to nearest and saturated to the int32_t range.
+ * @param[out] pDst Destination 2D buffer of int32_t.
+ * @param[in] pSrc Source 2D buffer of float, with the same dimension as destination.
+ * @param[in] scale Scale applied to each element.
+ * @return STATUS_OK if success, STATUS_ERROR_PARAM if the dimensions or element
+ * 		sizes do not match.
+ */
+int32_t buffer2d_convertF32ToI32(buffer2d_t *pDst, const buffer2d_t *pSrc, float scale);
+
+/**
+ * @brief Print the content of 2D buffer on stdout, one row per line. Elements of
+ * 		1 or 2 bytes are printed as unsigned, of 4 bytes as signed, others not at all.
  * @param[in] 2D buffer instance.
  */
 void buffer2d_print(buffer2d_t *pSelf);
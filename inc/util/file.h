@@ -6,12 +6,170 @@
  *
  * Utility functions for reading data from file.
  *
+ * file_readBinN() copies the whole file into a buffer the caller has sized in
+ * advance. For large recordings, e.g. multi-GB sensor and audio logs, a file can
+ * instead be memory-mapped read-only with file_mapOpen() and accessed in place,
+ * without copy, through fileMapView_t (address and number of elements):
+ *
+ * 		fileMapCfg_t cfg = { "log.wav", 44, sizeof(int16_t), 2, 0, FILE_MAP_ADVICE_SEQUENTIAL };
+ *
+ * 		file_mapOpen(&map, &cfg);
+ * 		while (file_mapNext(map, &view) == STATUS_OK && view.count > 0) {
+ * 			file_mapViewAsBuffer2d(&view, &frame);		// interleaved, nChannel columns
+ * 			...
+ * 		}
+ * 		file_mapClose(&map);
+ *
+ * With chunkSize 0, the whole file is mapped once and file_mapNext() returns it
+ * as a single view (file_mapGetView() returns the same). Otherwise, or if the
+ * file does not fit in the address space, e.g. a file of more than 2 GB on a
+ * 32-bit Raspberry Pi, only a window of about chunkSize bytes is mapped at a time,
+ * and file_mapNext() moves the window along the file. Views never split a frame
+ * of nChannel elements.
+ *
+ * The mapping is read-only: writing through a view, e.g. with buffer2dView_fill(),
+ * is a segmentation fault.
+ *
+ * Recordings of several sensors, e.g. MPU6050, HMC5883 and audio, are stored
+ * together in a self-describing container of fixed-size blocks, written with
+ * file_recOpen()/file_recWrite()/file_recClose() and read back with the
+ * memory-mapped file_recReaderOpen()/file_recSeek()/file_recNext():
+ *
+ * 		+--------------+---------+---------+-----+---------+-------+--------+
+ * 		| file header  | block 0 | block 1 | ... | block N | index | footer |
+ * 		| + streams    |         |         |     |         |       |        |
+ * 		+--------------+---------+---------+-----+---------+-------+--------+
+ * 		 <- blockSize -> <- blockSize ->
+ *
+ * The first block holds fileRecHeader_t and one fileRecStream_t per stream, i.e.
+ * name, sample type, number of channels, rate and encoding. Every other block
+ * holds consecutive frames of one stream, after a block header with the
+ * timestamp of its first frame. Block k is at (k + 1) x blockSize, and the index
+ * of timestamps at the end allows a reader to seek to a time without scanning the
+ * file. If the recording was cut short, e.g. power loss, and there is no index,
+ * the reader rebuilds it from the block headers.
+ *
+ * With FILE_REC_ENC_DELTA, int16_t samples are stored as the zig-zag varint of
+ * the difference from the previous frame of the same channel, i.e. 1 byte instead
+ * of 2 for slowly changing signals. Each block is decoded on its own.
  */
 
 #ifndef __FILE_H_INCLUDED
 #define __FILE_H_INCLUDED
 
 #include <stdint.h>
+#include "status.h"
+#include "buffer.h"
+
+/* Access pattern hint given to the kernel with madvise(). */
+#define FILE_MAP_ADVICE_NORMAL		(0)
+#define FILE_MAP_ADVICE_SEQUENTIAL	(1)
+#define FILE_MAP_ADVICE_RANDOM		(2)
+
+/* Sample types of a stream of recording. */
+#define FILE_REC_TYPE_U8			(0)
+#define FILE_REC_TYPE_I16			(1)
+#define FILE_REC_TYPE_I32			(2)
+#define FILE_REC_TYPE_F32			(3)
+
+/* Encodings of a stream of recording. DELTA is for FILE_REC_TYPE_I16 only. */
+#define FILE_REC_ENC_RAW			(0)
+#define FILE_REC_ENC_DELTA			(1)
+
+/* Minimum size, in bytes, of each block of recording. */
+#define FILE_REC_BLOCK_SIZE_MIN		(256)
+
+/**
+ * @brief Macro to get the data of a view as const pointer to type.
+ * @param[in] pView View of mapped file.
+ * @param[in] type Type of element, of the size of elemSize.
+ */
+#define FILEMAPVIEW_getDataAsType(pView, type)	\
+	((const type*) (pView)->data)
+
+typedef struct fileMap_s fileMap_t;
+
+typedef struct {
+	/* Name of file to map. */
+	const char *filename;
+	/* Offset, in bytes, of first element, e.g. to skip a header. */
+	uint64_t offset;
+	/* Size, in bytes, of each element. */
+	uint32_t elemSize;
+	/* Number of elements per frame, e.g. channels of interleaved samples. 0 for 1. */
+	uint32_t nChannel;
+	/* Approximate size, in bytes, of each mapped window. 0 to map the whole file. */
+	uint32_t chunkSize;
+	/* FILE_MAP_ADVICE_*. */
+	uint8_t advice;
+} fileMapCfg_t;
+
+typedef struct {
+	/* Address of first element. Read-only. */
+	const void *data;
+	/* Number of elements, a multiple of nChannel. 0 at end of file. */
+	uint64_t count;
+	/* Index, in elements, of first element from the start of data in file. */
+	uint64_t index;
+	/* As configured. */
+	uint32_t elemSize;
+	uint32_t nChannel;
+} fileMapView_t;
+
+typedef struct fileRecWriter_s fileRecWriter_t;
+typedef struct fileRecReader_s fileRecReader_t;
+
+/**
+ * @brief Descriptor of a stream of recording, as stored in file.
+ */
+typedef struct {
+	/* Name of stream, null terminated. */
+	char name[16];
+	/* Number of frames per second. 0 if irregular, with one frame per write. */
+	float rate;
+	/* Number of channels, i.e. samples per frame. */
+	uint16_t nChannel;
+	/* FILE_REC_TYPE_*. */
+	uint8_t type;
+	/* FILE_REC_ENC_*. */
+	uint8_t encoding;
+} fileRecStream_t;
+
+/**
+ * @brief Header of recording, at the start of file.
+ */
+typedef struct {
+	/* "LCRF" */
+	char magic[4];
+	uint16_t version;
+	uint16_t nStream;
+	uint32_t blockSize;
+	uint32_t reserved;
+} fileRecHeader_t;
+
+typedef struct {
+	/* Name of file to create. */
+	const char *filename;
+	/* Size, in bytes, of each block. Multiple of 8, at least FILE_REC_BLOCK_SIZE_MIN. */
+	uint32_t blockSize;
+	/* Number of streams. */
+	uint16_t nStream;
+	/* Descriptor of each stream, copied. */
+	const fileRecStream_t *stream;
+} fileRecCfg_t;
+
+/**
+ * @brief Frames of one block, as returned by file_recNext().
+ */
+typedef struct {
+	/* Timestamp, in ns, of first frame. */
+	uint64_t timestamp;
+	/* Number of frames, 0 at end of stream. */
+	uint32_t nFrame;
+	/* Frames, interleaved. In the mapped file for FILE_REC_ENC_RAW, in the
+	 * caller's buffer otherwise. Read-only. */
+	const void *data;
+} fileRecFrames_t;
 
 #ifdef __cplusplus
 extern "C" {
@@ -37,6 +195,174 @@ extern "C" {
  */
 int32_t file_readBinN(void* buffer, uint32_t size, uint32_t count, const char* filename);
 
+/**
+ * @brief Memory-map a file read-only.
+ * @param[out] ppSelf Address to store the newly created instance.
+ * @param[in] cfg Configuration used to create the instance.
+ * @return STATUS_OK if success, STATUS_ERROR_FILE_OPEN if the file cannot be
+ * 		opened, STATUS_ERROR_PARAM if the configuration is invalid or offset is
+ * 		beyond the end of file, STATUS_ERROR* otherwise.
+ */
+int32_t file_mapOpen(fileMap_t **ppSelf, const fileMapCfg_t *cfg);
+
+/**
+ * @brief Unmap and close a file. All views become invalid.
+ * @param[in/out] ppSelf Address of instance to be closed. Once closed, *ppSelf
+ * 		will be NULL.
+ * @return STATUS_OK if success, STATUS_ERROR* otherwise.
+ */
+int32_t file_mapClose(fileMap_t **ppSelf);
+
+/**
+ * @brief Get the number of elements in file, after offset. A partial frame at
+ * 		the end of file is not counted.
+ * @param[in] pSelf Instance.
+ * @return Number of elements.
+ */
+uint64_t file_mapGetCount(const fileMap_t *pSelf);
+
+/**
+ * @brief Get a view of all elements of a file mapped as a whole.
+ * @param[in] pSelf Instance.
+ * @param[out] pView View of all elements, valid until file_mapClose().
+ * @return STATUS_OK if success, STATUS_ERROR_PARAM if the file is mapped in
+ * 		chunks.
+ */
+int32_t file_mapGetView(const fileMap_t *pSelf, fileMapView_t *pView);
+
+/**
+ * @brief Get a view of the next chunk of elements, mapping it if needed.
+ * @details In chunks, the previous window is unmapped, so the previous view
+ * 		becomes invalid. With FILE_MAP_ADVICE_SEQUENTIAL, the kernel is also asked
+ * 		to read ahead the chunk after.
+ * @param[in/out] pSelf Instance.
+ * @param[out] pView View of next chunk, with count 0 at end of file.
+ * @return STATUS_OK if success, STATUS_ERROR if mapping fails.
+ */
+int32_t file_mapNext(fileMap_t *pSelf, fileMapView_t *pView);
+
+/**
+ * @brief Set the element that the next file_mapNext() starts from.
+ * @param[in/out] pSelf Instance.
+ * @param[in] index Index, in elements, rounded down to a frame. 0 to rewind.
+ * @return STATUS_OK if success, STATUS_ERROR_PARAM if index is beyond the end of file.
+ */
+int32_t file_mapSeek(fileMap_t *pSelf, uint64_t index);
+
+/**
+ * @brief Initialise a 2D buffer view over a view of mapped file, with one row per
+ * 		frame and one column per element of frame, i.e. interleaved, as in file.
+ * @param[in] pView View of mapped file, of less than 2^32 frames.
+ * @param[out] pBuffer2dView 2D buffer view to be initialised. Must not be written to.
+ */
+void file_mapViewAsBuffer2d(const fileMapView_t *pView, buffer2dView_t *pBuffer2dView);
+
+/**
+ * @brief Create a recording file and write its header.
+ * @param[out] ppSelf Address to store the newly created writer.
+ * @param[in] cfg Configuration used to create the writer.
+ * @return STATUS_OK if success, STATUS_ERROR_FILE_OPEN if the file cannot be
+ * 		created, STATUS_ERROR_PARAM if the configuration is invalid, e.g. streams
+ * 		do not fit in a block, STATUS_ERROR* otherwise.
+ */
+int32_t file_recOpen(fileRecWriter_t **ppSelf, const fileRecCfg_t *cfg);
+
+/**
+ * @brief Write all partial blocks, the index and the footer, and close the file.
+ * @param[in/out] ppSelf Address of writer to be closed. Once closed, *ppSelf will
+ * 		be NULL.
+ * @return STATUS_OK if success, STATUS_ERROR if a write failed.
+ */
+int32_t file_recClose(fileRecWriter_t **ppSelf);
+
+/**
+ * @brief Append frames to a stream. Frames are buffered in a block per stream,
+ * 		written out when full.
+ * @param[in/out] pSelf Writer.
+ * @param[in] stream Index of stream.
+ * @param[in] timestamp Timestamp, in ns, of first frame. The others are spaced by
+ * 		1 / rate, or share it for an irregular stream.
+ * @param[in] frames Frames, interleaved, of the stream's type.
+ * @param[in] nFrame Number of frames.
+ * @return STATUS_OK if success, STATUS_ERROR_PARAM if stream is invalid,
+ * 		STATUS_ERROR if a write failed.
+ */
+int32_t file_recWrite(fileRecWriter_t *pSelf, uint16_t stream, uint64_t timestamp,
+		const void *frames, uint32_t nFrame);
+
+/**
+ * @brief Open and map a recording file for reading. Every stream starts at its
+ * 		first block.
+ * @param[out] ppSelf Address to store the newly created reader.
+ * @param[in] filename Name of recording file.
+ * @return STATUS_OK if success, STATUS_ERROR_FILE_OPEN if the file cannot be
+ * 		opened, STATUS_ERROR if it is not a recording, STATUS_ERROR* otherwise.
+ */
+int32_t file_recReaderOpen(fileRecReader_t **ppSelf, const char *filename);
+
+/**
+ * @brief Unmap and close a recording file.
+ * @param[in/out] ppSelf Address of reader to be closed. Once closed, *ppSelf will
+ * 		be NULL.
+ * @return STATUS_OK if success, STATUS_ERROR* otherwise.
+ */
+int32_t file_recReaderClose(fileRecReader_t **ppSelf);
+
+/**
+ * @brief Get the number of streams of recording.
+ * @param[in] pSelf Reader.
+ * @return Number of streams.
+ */
+uint16_t file_recGetNumStream(const fileRecReader_t *pSelf);
+
+/**
+ * @brief Get the descriptor of a stream.
+ * @param[in] pSelf Reader.
+ * @param[in] stream Index of stream.
+ * @return Descriptor, or NULL if stream is invalid.
+ */
+const fileRecStream_t* file_recGetStream(const fileRecReader_t *pSelf, uint16_t stream);
+
+/**
+ * @brief Get the maximum number of frames in a block of a stream, i.e. the size
+ * 		of buffer to decode into.
+ * @param[in] pSelf Reader.
+ * @param[in] stream Index of stream, must be valid.
+ * @return Maximum number of frames.
+ */
+uint32_t file_recGetMaxFrame(const fileRecReader_t *pSelf, uint16_t stream);
+
+/**
+ * @brief Get the number of blocks of a stream.
+ * @param[in] pSelf Reader.
+ * @param[in] stream Index of stream, must be valid.
+ * @return Number of blocks.
+ */
+uint32_t file_recGetNumBlock(const fileRecReader_t *pSelf, uint16_t stream);
+
+/**
+ * @brief Move a stream to the block that contains the given time, i.e. the last
+ * 		block starting at or before it, or the first block if none.
+ * @param[in/out] pSelf Reader.
+ * @param[in] stream Index of stream.
+ * @param[in] timestamp Timestamp, in ns.
+ * @return STATUS_OK if success, STATUS_ERROR_PARAM if stream is invalid.
+ */
+int32_t file_recSeek(fileRecReader_t *pSelf, uint16_t stream, uint64_t timestamp);
+
+/**
+ * @brief Read the frames of the next block of a stream.
+ * @param[in/out] pSelf Reader.
+ * @param[in] stream Index of stream.
+ * @param[out] buffer Buffer of file_recGetMaxFrame() frames to decode into. May be
+ * 		NULL for FILE_REC_ENC_RAW, whose frames are not copied.
+ * @param[out] pFrames Frames of block, with nFrame 0 at end of stream. Valid until
+ * 		the next call or file_recReaderClose().
+ * @return STATUS_OK if success, STATUS_ERROR_PARAM if stream is invalid,
+ * 		STATUS_ERROR_NULL if buffer is needed, STATUS_ERROR if the block is corrupted.
+ */
+int32_t file_recNext(fileRecReader_t *pSelf, uint16_t stream, void *buffer, fileRecFrames_t *pFrames);
+
 #ifdef __cplusplus
 }
 #endif
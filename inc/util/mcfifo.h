@@ -0,0 +1,182 @@
+/*
+ * mcfifo.h
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: chiong
+ *
+ *  Lock-free single-producer/single-consumer FIFO of multi-channel frames, for
+ *  moving audio from a capture thread to a DSP thread. The FIFO owns nSlot frames,
+ *  each one a mcbuffer_t of frameSize samples x nChannel channels. Frames are
+ *  never copied by the FIFO: the producer fills a slot in place and commits it,
+ *  the consumer processes the same slot in place and releases it, like a DMA
+ *  double (or N) buffer.
+ *
+ *  Producer thread:                         Consumer thread:
+ *
+ *  	buf = mcfifo_acquireWrite(fifo);     	buf = mcfifo_acquireRead(fifo);
+ *  	if (buf) {                           	if (buf) {
+ *  		// fill buf                      		// process buf
+ *  		mcfifo_commitWrite(fifo);        		mcfifo_releaseRead(fifo);
+ *  	}                                    	}
+ *
+ *  A NULL from mcfifo_acquireWrite() means all slots are in use and the captured
+ *  frame is lost (overrun). A NULL from mcfifo_acquireRead() means no frame is
+ *  ready (underrun). Both are counted, see mcfifo_getStats(). Only one thread may
+ *  act as producer and only one thread as consumer at any time.
+ *
+ *  Write and read indices are free running counters, each written by one side
+ *  only and kept on separate cache lines to avoid false sharing between the two
+ *  threads.
+ */
+
+#ifndef INC_MCFIFO_H_
+#define INC_MCFIFO_H_
+
+#include <stdint.h>
+#include "status.h"
+#include "buffer.h"
+
+/* Assumed cache line size, in bytes, for separating producer and consumer data. */
+#define MCFIFO_CACHE_LINE_SIZE		(64)
+
+typedef struct mcfifo_s mcfifo_t;
+
+typedef struct {
+	/* Number of frames in FIFO. Must be power of 2, and at least 2. */
+	uint32_t nSlot;
+	/* Number of samples per channel in a frame. */
+	uint32_t frameSize;
+	/* Number of channels. */
+	uint32_t nChannel;
+	/* Size, in bytes, of each sample. */
+	uint32_t elemSize;
+	/* Layout of each frame, either MCBUFFER_LAYOUT_[INTERLEAVED|NON_INTERLEAVED]. */
+	uint8_t layout;
+} mcfifoCfg_t;
+
+typedef struct {
+	/* Number of frames committed by producer. */
+	uint32_t written;
+	/* Number of frames released by consumer. */
+	uint32_t read;
+	/* Number of times the producer found the FIFO full. */
+	uint32_t overrun;
+	/* Number of times the consumer found the FIFO empty. */
+	uint32_t underrun;
+} mcfifoStats_t;
+
+/* Test stand-in for a capture device. */
+typedef struct mcfifoSrc_s mcfifoSrc_t;
+
+typedef struct {
+	/* File with interleaved samples, matching nChannel and elemSize of the FIFO.
+	 * Of a WAV file, only the samples of data chunk are played. */
+	const char *filename;
+	/* Sampling rate, in Hz, used to pace the frames. */
+	uint32_t sampleRate;
+	/* Non-zero to restart from the first sample at end of samples, zero to stop. */
+	uint8_t isLoop;
+} mcfifoSrcCfg_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Create a multi-channel frame FIFO.
+ * @param[out] ppSelf Address to store the newly created FIFO.
+ * @param[in] cfg Configuration used to create the FIFO.
+ * @return STATUS_OK if successful, STATUS_ERROR* otherwise.
+ */
+int32_t mcfifo_create(mcfifo_t **ppSelf, const mcfifoCfg_t *cfg);
+
+/**
+ * @brief Destroy a FIFO and release its frames. Must not be in use by any thread.
+ * @param[in/out] ppSelf FIFO to be destroyed. Once destroyed, *ppSelf will be NULL.
+ * @return STATUS_OK if successful, STATUS_ERROR* otherwise.
+ */
+int32_t mcfifo_destroy(mcfifo_t **ppSelf);
+
+/**
+ * @brief Producer only. Get the next free frame to be filled.
+ * @details Calling this function again before mcfifo_commitWrite() returns the
+ * 		same frame.
+ * @param[in/out] pSelf FIFO instance.
+ * @return Frame to be filled, or NULL if FIFO is full (counted as overrun).
+ */
+mcbuffer_t* mcfifo_acquireWrite(mcfifo_t *pSelf);
+
+/**
+ * @brief Producer only. Make the frame returned by mcfifo_acquireWrite() visible
+ * 		to the consumer.
+ * @param[in/out] pSelf FIFO instance.
+ */
+void mcfifo_commitWrite(mcfifo_t *pSelf);
+
+/**
+ * @brief Consumer only. Get the oldest committed frame.
+ * @details Calling this function again before mcfifo_releaseRead() returns the
+ * 		same frame.
+ * @param[in/out] pSelf FIFO instance.
+ * @return Frame to be processed, or NULL if FIFO is empty (counted as underrun).
+ */
+mcbuffer_t* mcfifo_acquireRead(mcfifo_t *pSelf);
+
+/**
+ * @brief Consumer only. Return the frame returned by mcfifo_acquireRead() to the
+ * 		producer.
+ * @param[in/out] pSelf FIFO instance.
+ */
+void mcfifo_releaseRead(mcfifo_t *pSelf);
+
+/**
+ * @brief Get the number of committed frames not yet released. May be called from
+ * 		either thread; the value is a snapshot.
+ * @param[in] pSelf FIFO instance.
+ * @return Number of frames ready for the consumer.
+ */
+uint32_t mcfifo_getCount(const mcfifo_t *pSelf);
+
+/**
+ * @brief Get the FIFO statistics. The values are a snapshot.
+ * @param[in] pSelf FIFO instance.
+ * @param[out] stats Statistics.
+ */
+void mcfifo_getStats(const mcfifo_t *pSelf, mcfifoStats_t *stats);
+
+/**
+ * @brief Start a thread that acts as capture device, feeding the FIFO from a file
+ * 		at realtime pace, i.e. one frame every frameSize/sampleRate seconds.
+ * @details This is meant for testing the DSP chain without audio hardware. The
+ * 		thread is the producer of the FIFO; no other producer may be used at the
+ * 		same time. Frames that do not fit in the FIFO are dropped and counted as
+ * 		overrun, as a real capture device would. The last partial frame of the
+ * 		file is zero padded.
+ * @param[out] ppSrc Address to store the newly created source.
+ * @param[in] fifo FIFO to be fed.
+ * @param[in] cfg Source configuration.
+ * @return STATUS_OK if successful, STATUS_ERROR_PARAM if the channels or sample
+ * 		size of WAV file do not match the FIFO, STATUS_ERROR* otherwise.
+ */
+int32_t mcfifo_startFileSource(mcfifoSrc_t **ppSrc, mcfifo_t *fifo, const mcfifoSrcCfg_t *cfg);
+
+/**
+ * @brief Check if the file source has reached the end of file. Always 0 if
+ * 		isLoop is set.
+ * @param[in] pSrc File source instance.
+ * @return Non-zero if the source has finished.
+ */
+uint8_t mcfifo_isFileSourceDone(const mcfifoSrc_t *pSrc);
+
+/**
+ * @brief Stop the file source thread and release its resources.
+ * @param[in/out] ppSrc File source to be stopped. Once stopped, *ppSrc will be NULL.
+ * @return STATUS_OK if successful, STATUS_ERROR* otherwise.
+ */
+int32_t mcfifo_stopFileSource(mcfifoSrc_t **ppSrc);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INC_MCFIFO_H_ */
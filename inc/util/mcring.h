@@ -0,0 +1,157 @@
+/*
+ * mcring.h
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: chiong
+ *
+ *  Circular multi-channel buffer along the sample axis, for sensor history, delay
+ *  lines and overlapping analysis windows, in place of shifting a linear buffer
+ *  with memcpy() on every block.
+ *
+ *  Samples are pushed at the write position and popped, or peeked and consumed,
+ *  from the read position, both wrapping around after size samples. To allow any
+ *  window of up to maxWindow consecutive samples to be handed out as a single
+ *  contiguous view, the first maxWindow samples of the storage are duplicated
+ *  after its end, every time they are written:
+ *
+ *  		0          maxWindow               size      size + maxWindow
+ *  		+------------+-----------------------+------------+
+ *  		|  A  ...    |        ...            |  A  ...    |
+ *  		+------------+-----------------------+------------+
+ *  		 <--------------- circular ---------> <- mirror -->
+ *
+ *  A window starting near the end of the circular part simply runs on into the
+ *  mirror. The cost is the extra copy of the mirrored samples, so maxWindow
+ *  should be no larger than the longest window actually used.
+ *
+ *  Typical overlap processing, e.g. hop of H samples, window of L samples:
+ *
+ *  	mcring_push(ring, &newBlock);				// H samples
+ *  	mcring_getLatest(ring, L, &window);			// zero copy, contiguous
+ *  	process(&window);
+ *
+ *  The storage is a 2D buffer of the configured layout, so a view is contiguous
+ *  per channel when non-interleaved, and contiguous as a whole when interleaved.
+ *  Unwritten samples are zero, as for a freshly created mcbuffer_t. A ring is
+ *  not thread safe; see mcfifo.h to pass frames between threads.
+ */
+
+#ifndef INC_MCRING_H_
+#define INC_MCRING_H_
+
+#include <stdint.h>
+#include "status.h"
+#include "buffer.h"
+
+typedef struct mcring_s mcring_t;
+
+typedef struct {
+	/* Capacity, in samples per channel. */
+	uint32_t size;
+	/* Maximum length, in samples, of a contiguous window. At most size, 0 for size. */
+	uint32_t maxWindow;
+	/* Number of channels. */
+	uint32_t nChannel;
+	/* Size, in bytes, of each sample. */
+	uint32_t elemSize;
+	/* Layout of storage, either MCBUFFER_LAYOUT_[INTERLEAVED|NON_INTERLEAVED]. */
+	uint8_t layout;
+	/* Non-zero to let push overwrite the oldest unread samples when full, e.g.
+	 * history or delay line. Zero to fail the push instead. */
+	uint8_t isOverwrite;
+} mcringCfg_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief To create a circular multi-channel buffer.
+ * @param[out] ppSelf Address to store the newly created instance.
+ * @param[in] cfg Configuration used to create the instance.
+ * @return STATUS_OK if success, STATUS_ERROR* otherwise.
+ */
+int32_t mcring_create(mcring_t **ppSelf, const mcringCfg_t *cfg);
+
+/**
+ * @brief To destroy an instance and release its memory.
+ * @param[in/out] ppSelf Address of instance to be destroyed. Once destroyed,
+ * 		*ppSelf will be NULL.
+ * @return STATUS_OK if success, STATUS_ERROR* otherwise.
+ */
+int32_t mcring_destroy(mcring_t **ppSelf);
+
+/**
+ * @brief Discard all unread samples and zero the storage.
+ * @param[in/out] pSelf Instance.
+ */
+void mcring_reset(mcring_t *pSelf);
+
+/**
+ * @brief Get the number of unread samples.
+ * @param[in] pSelf Instance.
+ * @return Number of samples per channel.
+ */
+uint32_t mcring_getCount(const mcring_t *pSelf);
+
+/**
+ * @brief Get the number of samples that can be pushed without overwriting.
+ * @param[in] pSelf Instance.
+ * @return Number of samples per channel.
+ */
+uint32_t mcring_getSpace(const mcring_t *pSelf);
+
+/**
+ * @brief Push samples at the write position.
+ * @param[in/out] pSelf Instance.
+ * @param[in] pSrc View of nSample rows x nChannel columns, of any layout, e.g.
+ * 		from buffer2d_getView() of a mcbuffer_t.
+ * @return STATUS_OK if success, STATUS_ERROR_PARAM if the number of channels or
+ * 		element size differ, STATUS_ERROR if there is not enough space and the
+ * 		ring does not overwrite.
+ */
+int32_t mcring_push(mcring_t *pSelf, const buffer2dView_t *pSrc);
+
+/**
+ * @brief Copy the oldest unread samples out and consume them.
+ * @param[in/out] pSelf Instance.
+ * @param[out] pDst View of nSample rows x nChannel columns, of any layout.
+ * @return STATUS_OK if success, STATUS_ERROR_PARAM if the number of channels or
+ * 		element size differ, STATUS_ERROR if fewer than nSample are unread.
+ */
+int32_t mcring_pop(mcring_t *pSelf, buffer2dView_t *pDst);
+
+/**
+ * @brief Get a contiguous view of the oldest unread samples, without consuming.
+ * @param[in] pSelf Instance.
+ * @param[in] nSample Number of samples, at most maxWindow and the unread count.
+ * @param[out] pView View of nSample rows x nChannel columns, valid until the
+ * 		next push.
+ * @return STATUS_OK if success, STATUS_ERROR_PARAM otherwise.
+ */
+int32_t mcring_peek(const mcring_t *pSelf, uint32_t nSample, buffer2dView_t *pView);
+
+/**
+ * @brief Consume the oldest unread samples, e.g. after mcring_peek().
+ * @param[in/out] pSelf Instance.
+ * @param[in] nSample Number of samples, at most the unread count.
+ * @return STATUS_OK if success, STATUS_ERROR_PARAM otherwise.
+ */
+int32_t mcring_consume(mcring_t *pSelf, uint32_t nSample);
+
+/**
+ * @brief Get a contiguous view of the most recently pushed samples, whether read
+ * 		or not, e.g. the analysis window of a sliding STFT or a delay line tap.
+ * @param[in] pSelf Instance.
+ * @param[in] nSample Number of samples, at most maxWindow.
+ * @param[out] pView View of nSample rows x nChannel columns, oldest first, valid
+ * 		until the next push.
+ * @return STATUS_OK if success, STATUS_ERROR_PARAM otherwise.
+ */
+int32_t mcring_getLatest(const mcring_t *pSelf, uint32_t nSample, buffer2dView_t *pView);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INC_MCRING_H_ */
@@ -0,0 +1,161 @@
+/*
+ * mtstack.h
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: chiong
+ *
+ *  Scratch memory for multi-threaded DSP. A vStack_t is a single bump pointer
+ *  without any synchronisation, so it must not be shared between threads. A
+ *  vMtStack_t owns one backing region that is carved into nStack independent
+ *  stacks (see stack_createInPlace()), one per worker thread, plus an optional
+ *  shared bulk region with a lock-free bump allocator.
+ *
+ *  Structure of backing region
+ *
+ *  +-----+-----------+-----------+-----+-------------+-------------+
+ *  |  X  |  stack 0  |  stack 1  | ... | stack N - 1 |    bulk     |
+ *  +-----+-----------+-----------+-----+-------------+-------------+
+ *
+ *  Each part starts on its own cache line so that threads working on
+ *  neighbouring stacks do not false share. Each stack holds its own vStack_t
+ *  instance in front of its memory, as the instance is written on every
+ *  allocation too.
+ *
+ *  Per-thread stacks are used the same way as a normal vStack_t, with matching
+ *  stack_openFrame() and stack_closeFrame(). A thread gets its stack either by
+ *  index, e.g. the worker number of a thread pool,
+ *
+ *  	stack = mtstack_getStack(mts, workerIndex);
+ *
+ *  or by binding itself to any free stack once, then looking it up cheaply
+ *  from anywhere in the call tree without passing it around,
+ *
+ *  	mtstack_bind(mts);				// at thread start
+ *  	...
+ *  	stack = mtstack_getBound(mts);	// in kernels
+ *  	...
+ *  	mtstack_unbind(mts);			// at thread end
+ *
+ *  The two ways must not be mixed on the same vMtStack_t.
+ *
+ *  The bulk region is for frame-less allocations shared by all threads, e.g.
+ *  per-block buffers handed between pipeline stages. mtstack_bulkAlloc() may be
+ *  called concurrently; memory is only given back by mtstack_bulkReset() once all
+ *  threads are done with it.
+ */
+
+#ifndef INC_MTSTACK_H_
+#define INC_MTSTACK_H_
+
+#include <stdint.h>
+#include "status.h"
+#include "stack.h"
+
+/* Assumed cache line size, in bytes. Minimum alignment of each stack. */
+#define MTSTACK_CACHE_LINE_SIZE		(64)
+
+typedef struct vMtStack_s vMtStack_t;
+
+typedef struct {
+	/* Number of per-thread stacks. */
+	uint32_t nStack;
+	/* Size, in bytes, of each per-thread stack. */
+	uint32_t size;
+	/* Alignment, in bytes, of each per-thread stack. Must be power of 2. */
+	uint32_t alignment;
+	/* Size, in bytes, of shared bulk region. 0 for none. */
+	uint32_t bulkSize;
+} vMtStackCfg_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief To create a multi-threaded stack memory instance.
+ * @param[out] ppMts Address to store the newly created instance.
+ * @param[in] cfg Configuration used to create the instance.
+ * @return STATUS_OK if success, STATUS_ERROR* otherwise.
+ */
+int32_t mtstack_create(vMtStack_t **ppMts, const vMtStackCfg_t *cfg);
+
+/**
+ * @brief To destroy an instance and release its memory. No thread may be using
+ * 		any of its stacks.
+ * @param[in/out] ppMts Address of instance to be destroyed. Once destroyed,
+ * 		*ppMts will be NULL.
+ * @return STATUS_OK if success, STATUS_ERROR* otherwise.
+ */
+int32_t mtstack_destroy(vMtStack_t **ppMts);
+
+/**
+ * @brief Get the number of per-thread stacks.
+ * @param[in] mts Instance.
+ * @return Number of stacks.
+ */
+uint32_t mtstack_getNumStack(const vMtStack_t *mts);
+
+/**
+ * @brief Get a per-thread stack by index. The caller is responsible for using
+ * 		each index from one thread at a time.
+ * @param[in] mts Instance.
+ * @param[in] index Index of stack, from 0 to nStack - 1.
+ * @return The stack, or NULL if index is out of range.
+ */
+vStack_t* mtstack_getStack(vMtStack_t *mts, uint32_t index);
+
+/**
+ * @brief Bind the calling thread to a free stack of mts. Lock-free.
+ * @details A thread can be bound to one instance at a time. Calling this function
+ * 		again on the same instance returns the same stack.
+ * @param[in/out] mts Instance.
+ * @return The stack bound to the calling thread, or NULL if all stacks are
+ * 		bound to other threads, or the calling thread is bound to another instance.
+ */
+vStack_t* mtstack_bind(vMtStack_t *mts);
+
+/**
+ * @brief Get the stack bound to the calling thread by mtstack_bind().
+ * @param[in] mts Instance.
+ * @return The stack, or NULL if the calling thread is not bound to mts.
+ */
+vStack_t* mtstack_getBound(const vMtStack_t *mts);
+
+/**
+ * @brief Reset and return the stack bound to the calling thread, so that it can
+ * 		be bound by another thread. Does nothing if not bound to mts.
+ * @param[in/out] mts Instance.
+ */
+void mtstack_unbind(vMtStack_t *mts);
+
+/**
+ * @brief Allocate an aligned memory from the shared bulk region. Lock-free, may be
+ * 		called from any thread.
+ * @param[in/out] mts Instance.
+ * @param[in] alignment Alignment, in bytes, of the memory to be allocated. Must
+ * 		be power of 2, otherwise undefined behaviour.
+ * @param[in] size Size, in number of elements (not bytes), of memory to allocate,
+ * 		with each element of alignment bytes, as stack_alignedAlloc().
+ * @return The address of the allocated memory. NULL if allocation fails.
+ */
+void* mtstack_bulkAlloc(vMtStack_t *mts, uint32_t alignment, uint32_t size);
+
+/**
+ * @brief Release all memory allocated from the shared bulk region. Not thread
+ * 		safe: no thread may be allocating or using bulk memory.
+ * @param[in/out] mts Instance.
+ */
+void mtstack_bulkReset(vMtStack_t *mts);
+
+/**
+ * @brief Get the currently available/remaining size of the shared bulk region.
+ * @param[in] mts Instance.
+ * @return The available/remaining size, in bytes.
+ */
+uint32_t mtstack_getBulkAvailSize(const vMtStack_t *mts);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INC_MTSTACK_H_ */
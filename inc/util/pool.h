@@ -0,0 +1,135 @@
+/*
+ * pool.h
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: chiong
+ *
+ *  Fixed-size block memory pool. Complements the stack memory (see stack.h) for
+ *  objects whose lifetimes are independent of each other, e.g. driver instances,
+ *  frames in flight or dirty rectangles, where LIFO frames do not fit.
+ *
+ *  All blocks are carved from a single allocation at create time. Free blocks are
+ *  linked through an intrusive free list (the link is stored in the free block
+ *  itself, or in a separate array of count links if thread-safe), so both
+ *  pool_alloc() and pool_free() are O(1) and never call malloc().
+ *
+ *  Structure of pool
+ *
+ *  +-----+---------+---------+---------+-----+---------+
+ *  |  X  | block 0 | block 1 | block 2 | ... | block N |
+ *  +-----+---------+---------+---------+-----+---------+
+ *     ^   ^         <-------->
+ *  baseAddr startAddr  stride = blockSize rounded up to alignment
+ *
+ *  If isThreadSafe is set when created, the free list is a lock-free stack
+ *  (compare-and-swap on a tagged head index to avoid the ABA problem), and blocks
+ *  can be allocated and freed concurrently by any number of threads. Otherwise,
+ *  the pool must only be used by one thread at a time, but avoids the atomic
+ *  operations.
+ *
+ *  The tagged head is a 64-bit atomic. On 32-bit targets, e.g. ARM of Raspberry
+ *  Pi, gcc may call libatomic for it, so applications must link with -latomic.
+ *
+ *  When DEBUG is #defined, free blocks are filled with POOL_POISON_FREE and newly
+ *  allocated blocks with POOL_POISON_ALLOC. A write to a block after it has been
+ *  freed is detected on the next allocation of that block.
+ */
+
+#ifndef INC_POOL_H_
+#define INC_POOL_H_
+
+#include <stdint.h>
+#include "status.h"
+
+/* Fill patterns for debug poisoning. */
+#define POOL_POISON_FREE		(0xDD)
+#define POOL_POISON_ALLOC		(0xCD)
+
+typedef struct vPool_s vPool_t;
+
+typedef struct {
+	/* Size, in bytes, of each block. */
+	uint32_t blockSize;
+	/* Number of blocks. */
+	uint32_t count;
+	/* Alignment, in bytes, of each block. Must be power of 2. Undefined behaviour if not. */
+	uint32_t alignment;
+	/* Non-zero to allow concurrent alloc and free from multiple threads. */
+	uint8_t isThreadSafe;
+} vPoolCfg_t;
+
+typedef struct {
+	/* Total number of blocks. */
+	uint32_t count;
+	/* Number of blocks currently allocated. */
+	uint32_t inUse;
+	/* High-water mark, i.e. maximum number of blocks allocated at the same time. */
+	uint32_t peak;
+	/* Number of pool_alloc() that failed because pool was exhausted. */
+	uint32_t nFail;
+} vPoolStats_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief To create a block memory pool.
+ * @param[out] ppPool Address to store the newly created pool.
+ * @param[in] cfg Configuration used to create the pool.
+ * @return STATUS_OK if success, STATUS_ERROR* otherwise.
+ */
+int32_t pool_create(vPool_t **ppPool, const vPoolCfg_t *cfg);
+
+/**
+ * @brief To destroy a pool and release its memory, including all blocks still
+ * 		allocated.
+ * @param[in/out] ppPool Address of pool to be destroyed. Once destroyed, *ppPool
+ * 		will be NULL.
+ * @return STATUS_OK if success, STATUS_ERROR* otherwise.
+ */
+int32_t pool_destroy(vPool_t **ppPool);
+
+/**
+ * @brief Allocate a block from pool.
+ * @param[in/out] pool Pool instance.
+ * @return Address of the block, aligned as configured. NULL if pool is exhausted.
+ */
+void* pool_alloc(vPool_t *pool);
+
+/**
+ * @brief Return a block to pool.
+ * @param[in/out] pool Pool instance.
+ * @param[in] block Block previously returned by pool_alloc() of the same pool.
+ * 		NULL is ignored.
+ */
+void pool_free(vPool_t *pool, void *block);
+
+/**
+ * @brief Check if an address is a block of the given pool.
+ * @param[in] pool Pool instance.
+ * @param[in] ptr Address to be checked.
+ * @return Non-zero if ptr is the start address of a block in pool.
+ */
+uint8_t pool_isOwner(const vPool_t *pool, const void *ptr);
+
+/**
+ * @brief Get the usable size of each block.
+ * @param[in] pool Pool instance.
+ * @return Block size, in bytes, as configured.
+ */
+uint32_t pool_getBlockSize(const vPool_t *pool);
+
+/**
+ * @brief Get the usage statistics of pool. For thread safe pool, the values are
+ * 		a snapshot.
+ * @param[in] pool Pool instance.
+ * @param[out] stats Usage statistics.
+ */
+void pool_getStats(const vPool_t *pool, vPoolStats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INC_POOL_H_ */
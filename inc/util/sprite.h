@@ -0,0 +1,179 @@
+/*
+ * sprite.h
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: chiong
+ *
+ *  Precompiled sprite sheets for the LCD. Images are converted offline, e.g. by
+ *  tool/spritec, into the wire pixel format of the panel so that nothing is
+ *  parsed or converted at runtime. A sheet is a single block of memory, either
+ *  compiled in as a const array or a file mapped with file_mapOpen(), and is used
+ *  in place without any copy or malloc().
+ *
+ *  Structure of sheet, offsets and sizes in bytes, host byte order:
+ *
+ *  +---------------------+-------------------------------+--------+--------+---
+ *  | spriteSheetHeader_t | spriteEntry_t x nSprite       | data 0 | data 1 | ...
+ *  +---------------------+-------------------------------+--------+--------+---
+ *
+ *  Data of each sprite is encoded as one of:
+ *  1. RAW: pixels packed in the wire format of the sheet, row by row, i.e. the
+ *     exact bytes to be written to the panel.
+ *  2. RLE: a control byte c followed by pixel values. If bit 7 of c is set, the
+ *     single pixel value following it is repeated (c & 0x7F) + 1 times, otherwise
+ *     the c + 1 pixel values following it are literal.
+ *  3. PALETTE: nColor pixel values, followed by indices of 1, 2, 4 or 8 bits
+ *     (bitPerIndex), most significant first, without padding between rows.
+ *
+ *  A pixel value is stored in 2 bytes, MSB first, for RGB444 (0x0RGB) and RGB565,
+ *  and in 3 bytes for RGB666, see SPRITE_getValueSize().
+ */
+
+#ifndef INC_SPRITE_H_
+#define INC_SPRITE_H_
+
+#include <stdint.h>
+#include "status.h"
+#include "bitmap.h"
+
+#define SPRITE_MAGIC			"LCSP"
+#define SPRITE_VERSION			(1)
+
+/* Encodings of sprite data */
+#define SPRITE_ENC_RAW			(0)
+#define SPRITE_ENC_RLE			(1)
+#define SPRITE_ENC_PALETTE		(2)
+
+/* Maximum number of colors of PALETTE encoding. */
+#define SPRITE_PALETTE_MAX		(256)
+/* Maximum number of pixels in a run or literal of RLE encoding. */
+#define SPRITE_RLE_MAX			(128)
+
+/**
+ * @brief Macro to get the size, in bytes, of a pixel value stored in RLE and
+ * 		PALETTE data of a given BITMAP_PIXEL_FMT_* format.
+ */
+#define SPRITE_getValueSize(fmt)	((fmt) == BITMAP_PIXEL_FMT_RGB666? 3 : 2)
+
+typedef struct {
+	/* SPRITE_MAGIC, not NULL terminated. */
+	char magic[4];
+	/* SPRITE_VERSION */
+	uint16_t version;
+	/* Number of sprites. */
+	uint16_t nSprite;
+	/* Wire pixel format, BITMAP_PIXEL_FMT_RGB444, RGB565 or RGB666. */
+	uint8_t fmt;
+	uint8_t reserved[7];
+} spriteSheetHeader_t;
+
+typedef struct {
+	/* Width and height, in pixels. */
+	uint16_t width;
+	uint16_t height;
+	/* Offset, in bytes, of data from start of sheet. */
+	uint32_t offset;
+	/* Size, in bytes, of data. */
+	uint32_t size;
+	/* SPRITE_ENC_* */
+	uint8_t encoding;
+	/* Number of bits of each palette index. PALETTE encoding only. */
+	uint8_t bitPerIndex;
+	/* Number of colors in palette. PALETTE encoding only. */
+	uint16_t nColor;
+} spriteEntry_t;
+
+typedef struct {
+	const spriteSheetHeader_t *header;
+	const spriteEntry_t *entry;
+	/* Start of sheet. */
+	const uint8_t *base;
+} spriteSheet_t;
+
+/**
+ * @brief State to decode a sprite in parts, see sprite_decode().
+ */
+typedef struct {
+	const spriteEntry_t *entry;
+	/* Start of data. */
+	const uint8_t *data;
+	/* Next byte of data to read. RAW and RLE only. */
+	const uint8_t *src;
+	/* Number of pixels not yet decoded, bytes for RAW. */
+	uint32_t nLeft;
+	/* Index of next pixel. PALETTE only. */
+	uint32_t index;
+	/* Pixels left in the current RLE run or literal, and value of run. */
+	uint32_t nRun;
+	uint32_t value;
+	uint8_t isRepeat;
+	uint8_t fmt;
+} spriteDecoder_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Check a sheet and set up access to it. No memory is allocated or copied.
+ * @param[out] pSheet Sheet to be set up.
+ * @param[in] data Start of sheet. Must stay valid while pSheet is in use and be
+ * 		aligned to 4 bytes.
+ * @param[in] size Size, in bytes, of sheet.
+ * @return STATUS_OK if success, STATUS_ERROR if data is not a valid sheet.
+ */
+int32_t sprite_sheetInit(spriteSheet_t *pSheet, const void *data, uint32_t size);
+
+/**
+ * @brief Get the number of sprites in sheet.
+ */
+uint32_t sprite_getNumSprite(const spriteSheet_t *pSheet);
+
+/**
+ * @brief Get the index entry of a sprite, e.g. for its width and height.
+ * @return Entry, NULL if idx is out of range.
+ */
+const spriteEntry_t* sprite_getEntry(const spriteSheet_t *pSheet, uint32_t idx);
+
+/**
+ * @brief Start decoding a sprite.
+ * @param[out] pDec Decoder.
+ * @param[in] pSheet Sheet.
+ * @param[in] idx Index of sprite.
+ * @return STATUS_OK if success, STATUS_ERROR_PARAM if idx is out of range.
+ */
+int32_t sprite_decoderInit(spriteDecoder_t *pDec, const spriteSheet_t *pSheet, uint32_t idx);
+
+/**
+ * @brief Decode the next pixels of sprite into the wire format of sheet.
+ * @details Pixels are decoded in order, as one continuous stream for a single
+ * 		address window. With RGB444, an even number of pixels is decoded in each
+ * 		call, except for the last pixel of an odd-sized sprite.
+ * @param[in/out] pDec Decoder.
+ * @param[out] dst Destination of packed pixels.
+ * @param[in] size Size, in bytes, of dst. Must hold at least 2 pixels.
+ * @return Number of bytes written to dst, 0 once all pixels are decoded.
+ */
+uint32_t sprite_decode(spriteDecoder_t *pDec, uint8_t *dst, uint32_t size);
+
+/**
+ * @brief Encode pixels into sprite data, e.g. by a sheet converter.
+ * @param[out] dst Destination of data, NULL to only get the size.
+ * @param[in] size Size, in bytes, of dst.
+ * @param[in] pixel Pixels, 0x00RRGGBB, top row first.
+ * @param[in] count Number of pixels.
+ * @param[in] fmt Wire pixel format, BITMAP_PIXEL_FMT_RGB444, RGB565 or RGB666.
+ * @param[in/out] entry Encoding is taken from entry. For PALETTE encoding, nColor
+ * 		and bitPerIndex are set.
+ * @return Size, in bytes, of data, STATUS_ERROR if the pixels have more than
+ * 		SPRITE_PALETTE_MAX colors for PALETTE encoding, STATUS_ERROR_PARAM if
+ * 		dst is too small or fmt or encoding is invalid.
+ */
+int32_t sprite_encode(uint8_t *dst, uint32_t size, const uint32_t *pixel, uint32_t count,
+		uint8_t fmt, spriteEntry_t *entry);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INC_SPRITE_H_ */
@@ -47,12 +47,42 @@
  *  currAddr is the current start address to allocate memory is stack. Every time
  *      memory is allocated, currAddr will be updated.
  *
+ *  When DEBUG is #defined, Y is followed by the peak usage of the previous frame
+ *  and the name of the current frame, for checking matching open and close frame
+ *  and for per-frame statistics. See STACK_FRAME_OVERHEAD().
+ *
+ *  Usage statistics (peak, number of allocations, etc.) are always recorded, see
+ *  stack_getStats(). They are meant for sizing the stack of each module exactly:
+ *  run the worst case configuration, then read the peak. When
+ *  STACK_PRINT_STATS_ON_DESTROY is #defined, stack_destroy() prints them on stdout.
+ *
+ *  A stack created by stack_createChained() does not fail once its memory is
+ *  exhausted. Instead, it links an additional segment, from a pool or malloc(),
+ *  and continues there:
+ *
+ *     first segment              segment 1                 segment 2
+ *  +-----------------+--+     +---+-----------+--+     +---+--------+----------+
+ *  |                 |Z |---->| H |           |Z |---->| H |        |          |
+ *  +-----------------+--+     +---+-----------+--+     +---+--------+----------+
+ *                                                                   ^
+ *                                                                currAddr
+ *
+ *  H is a segment header that holds the state of the previous segment. Z is the
+ *  tail of a segment too small for the allocation that caused the growth, and is
+ *  wasted. Allocations in the current segment are as fast as with a single
+ *  segment. When a frame opened in a previous segment is closed, the segments
+ *  after it are released: the last one is kept as spare for the next growth, the
+ *  others are returned to pool or heap. An optional maximum total size bounds the
+ *  memory used on embedded targets.
+ *
  */
 
 #ifndef INC_STACK_H_
 #define INC_STACK_H_
 
 #include <stdint.h>
+#include <string.h>
+#include "pool.h"
 
 /**
  * @brief Macro to open current frame in stack with the name as the calling function
@@ -80,7 +110,39 @@
  * 		fails.
  */
 #define stack_alloc(stack, size)	\
-	stack_alignedAlloc((stack), 1, (size));
+	stack_alignedAlloc((stack), 1, (size))
+
+/**
+ * @brief Macro to get the worst case number of bytes used by
+ * 		stack_alignedAlloc(stack, alignment, size), including padding.
+ * @param[in] alignment Alignment, in bytes.
+ * @param[in] size Size, in number of elements of alignment bytes.
+ * @return Number of bytes.
+ */
+#define STACK_ALIGNED_ALLOC_SIZE(alignment, size)	\
+	((size) * (alignment) + (alignment) - 1)
+
+/**
+ * @brief Macro to get the number of bytes used by opening a frame.
+ * @param[in] name Name of the frame, as given to stack_openFrameWithName(). Only
+ * 		used when DEBUG is #defined. For stack_openFrame(), this is the name of the
+ * 		function that opens the frame, e.g. "apsigm_process".
+ * @return Number of bytes.
+ */
+#ifdef DEBUG
+#define STACK_FRAME_OVERHEAD(name)	\
+	(2 * sizeof(void*) + strlen(name) + 1)
+#else
+#define STACK_FRAME_OVERHEAD(name)	\
+	(sizeof(void*))
+#endif
+
+/* Maximum number of distinct frame names recorded per stack, when DEBUG is
+ * #defined. */
+#define STACK_MAX_FRAME_STATS		(16)
+/* Size of frame name recorded, including null terminator. Longer names are
+ * truncated. */
+#define STACK_FRAME_NAME_SIZE		(32)
 
 typedef struct vStack_s vStack_t;
 
@@ -91,6 +153,45 @@ typedef struct {
 	uint32_t size;
 } vStackCfg_t;
 
+typedef struct {
+	/* Size, in bytes, of each additional segment. Bigger segments are used for
+	 * allocations that do not fit. Ignored if pool is set. */
+	uint32_t segmentSize;
+	/* Maximum total size, in bytes, of first and all additional segments. 0 for no
+	 * limit. */
+	uint32_t maxSize;
+	/* Pool to take additional segments from, whose blocks hold a segment header
+	 * followed by the segment. NULL to use malloc(). Must outlive the stack. */
+	vPool_t *pool;
+} vStackChainCfg_t;
+
+typedef struct {
+	/* Total size, in bytes. */
+	uint32_t size;
+	/* Currently used size, in bytes. */
+	uint32_t used;
+	/* Maximum used size, in bytes, including padding and frame overhead. */
+	uint32_t peak;
+	/* Number of successful allocations. */
+	uint32_t nAlloc;
+	/* Number of allocations and open frames that failed due to insufficient size. */
+	uint32_t nFail;
+	/* Number of times an additional segment is linked, in chained mode. */
+	uint32_t nGrow;
+	/* Maximum frame depth. */
+	uint8_t maxFrameDepth;
+} vStackStats_t;
+
+typedef struct {
+	/* Name of frame. */
+	char name[STACK_FRAME_NAME_SIZE];
+	/* Maximum size, in bytes, used by the frame and its nested frames, including
+	 * the frame overhead. */
+	uint32_t peak;
+	/* Number of times the frame is closed. */
+	uint32_t count;
+} vStackFrameStats_t;
+
 
 #ifdef __cplusplus
 extern "C" {
@@ -104,6 +205,41 @@ extern "C" {
  */
 int32_t stack_create(vStack_t **ppScratch, const vStackCfg_t *cfg);
 
+/**
+ * @brief To get the size of memory needed by stack_createInPlace().
+ * @param[in] cfg Configuration used to create the stack memory instance.
+ * @return Number of bytes, for the instance itself followed by cfg->size bytes
+ * 		of stack memory.
+ */
+uint32_t stack_getInPlaceSize(const vStackCfg_t *cfg);
+
+/**
+ * @brief To create a stack memory instance on memory provided by the caller.
+ * @details The instance is placed at the start of the memory, followed by the
+ * 		stack memory, and nothing is allocated. The stack does not own the
+ * 		memory: stack_destroy() releases nothing, and the memory must stay valid
+ * 		until then. This allows several stacks to be carved from a single
+ * 		region, e.g. one per thread.
+ * @param[in/out] ppScratch Address to store the newly created stack memory instance.
+ * @param[in] cfg Configuration used to create the stack memory instance.
+ * @param[in] mem Memory of at least stack_getInPlaceSize() bytes, aligned to
+ * 		cfg->alignment and to a pointer.
+ * @return STATUS_OK if success, STATUS_ERROR* otherwise.
+ */
+int32_t stack_createInPlace(vStack_t **ppScratch, const vStackCfg_t *cfg, void *mem);
+
+/**
+ * @brief To create a stack memory instance that grows by linking additional
+ * 		segments when exhausted.
+ * @details The first segment is created as stack_create(). See top of this file.
+ * @param[in/out] ppScratch Address to store the newly created stack memory instance.
+ * @param[in] cfg Configuration of the first segment.
+ * @param[in] chainCfg Configuration of the additional segments.
+ * @return STATUS_OK if success, STATUS_ERROR* otherwise.
+ */
+int32_t stack_createChained(vStack_t **ppScratch, const vStackCfg_t *cfg,
+		const vStackChainCfg_t *chainCfg);
+
 /**
  * @brief To destroy and release the resources of a stack memory instance.
  * @param[in/out] ppScratch Address of stack memory instance to be destroyed.
@@ -187,19 +323,53 @@ int32_t stack_reset(vStack_t *stack);
 void* stack_alignedAlloc(vStack_t *stack, uint32_t alignment, uint32_t size);
 
 /**
- * @brief Get the total size of the stack memory.
+ * @brief Get the total size of the stack memory. In chained mode, the size of all
+ * 		segments up to the current one.
  * @param[in] stack Scratch memory instance.
  * @return The total size, in bytes.
  */
 uint32_t stack_getSize(const vStack_t *stack);
 
 /**
- * @brief Get the currently available/remaining size of the stack memory.
+ * @brief Get the currently available/remaining size of the stack memory. In
+ * 		chained mode, the remaining size of the current segment only.
  * @param[in] stack Scratch memory instance.
  * @return The available/remaining size, in bytes.
  */
 uint32_t stack_getAvailSize(const vStack_t *stack);
 
+/**
+ * @brief Get the usage statistics of the stack memory, since created or last
+ * 		stack_resetStats().
+ * @param[in] stack Scratch memory instance.
+ * @param[out] stats Usage statistics.
+ */
+void stack_getStats(const vStack_t *stack, vStackStats_t *stats);
+
+/**
+ * @brief Get the peak usage of each named frame, since created or last
+ * 		stack_resetStats(). Only available when DEBUG is #defined.
+ * @param[in] stack Scratch memory instance.
+ * @param[out] stats Array to store the statistics of each frame, in the order
+ * 		the frames are first closed.
+ * @param[in] maxStats Number of elements in stats.
+ * @return Number of elements stored in stats. Always 0 if DEBUG is not #defined.
+ */
+uint32_t stack_getFrameStats(const vStack_t *stack, vStackFrameStats_t *stats, uint32_t maxStats);
+
+/**
+ * @brief Reset the usage statistics. The peak restarts from the current usage.
+ * @param[in/out] stack Scratch memory instance.
+ * @return STATUS_OK if success, STATUS_ERROR* otherwise.
+ */
+int32_t stack_resetStats(vStack_t *stack);
+
+/**
+ * @brief Print the usage statistics on stdout.
+ * @param[in] stack Scratch memory instance.
+ */
+void stack_printStats(const vStack_t *stack);
+
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,80 @@
+/*
+ * wav.h
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: chiong
+ *
+ *  Minimal RIFF/WAVE header reader and writer. Only the "fmt " and "data" chunks
+ *  are interpreted, all other chunks are skipped. Supported sample formats are
+ *  16-bit PCM and 32-bit IEEE float, both interleaved as per WAV specification.
+ *  All multi-byte fields are little-endian in file, regardless of host.
+ */
+
+#ifndef INC_WAV_H_
+#define INC_WAV_H_
+
+#include <stdint.h>
+#include <stdio.h>
+#include "status.h"
+
+/* Size, in bytes, of the canonical 44-byte header written by wav_writeHeader(). */
+#define WAV_HEADER_SIZE				(44)
+
+/* WAVE format tag, see fmt chunk. */
+#define WAV_FORMAT_PCM				(0x0001)
+#define WAV_FORMAT_IEEE_FLOAT		(0x0003)
+#define WAV_FORMAT_EXTENSIBLE		(0xFFFE)
+
+typedef struct {
+	/* Either WAV_FORMAT_PCM or WAV_FORMAT_IEEE_FLOAT. WAV_FORMAT_EXTENSIBLE is
+	 * resolved to one of these when parsing. */
+	uint16_t format;
+	/* Number of interleaved channels. */
+	uint16_t channel;
+	/* Sampling rate, in Hz. */
+	uint32_t sampleRate;
+	/* Number of bits per sample, per channel. */
+	uint16_t bitsPerSample;
+	/* Offset, in bytes, of first sample from the start of file. */
+	uint32_t dataOffset;
+	/* Size, in bytes, of sample data. */
+	uint32_t dataSize;
+} wavInfo_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Parse the header of a WAV file already in memory.
+ * @param[out] info Parsed header information.
+ * @param[in] data Start of WAV file content.
+ * @param[in] size Size, in bytes, of data. If the data chunk claims more bytes than
+ * 		available (e.g. truncated recording), info->dataSize is clipped to size.
+ * @return STATUS_OK if successful, STATUS_ERROR_PARAM if not a supported WAV file.
+ */
+int32_t wav_parseHeader(wavInfo_t *info, const uint8_t *data, uint32_t size);
+
+/**
+ * @brief Write a canonical 44-byte WAV header at the current position of a file.
+ * @details To finalise a file whose length is not known in advance, write the
+ * 		header once with dataSize == 0, write the samples, then rewind and write
+ * 		the header again with the actual dataSize.
+ * @param[in] f File opened for binary write.
+ * @param[in] info Header information. dataOffset is ignored.
+ * @return STATUS_OK if successful, STATUS_ERROR otherwise.
+ */
+int32_t wav_writeHeader(FILE *f, const wavInfo_t *info);
+
+/**
+ * @brief Get the number of bytes per sample frame, i.e. for all channels.
+ * @param[in] info WAV header information.
+ * @return Size, in bytes.
+ */
+uint32_t wav_getFrameSize(const wavInfo_t *info);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INC_WAV_H_ */
@@ -16,4 +16,16 @@ typedef enum {
 #define HIGH    (1)
 #define LOW     (0)
 
+/* Complex, single-precision. Same layout as float complex of <complex.h>. */
+typedef struct {
+	float r;
+	float i;
+} complexf_t;
+
+/* Complex, double-precision. Same layout as double complex of <complex.h>. */
+typedef struct {
+	double r;
+	double i;
+} complexd_t;
+
 #endif /* INC_XTYPE_H_ */
@@ -0,0 +1,55 @@
+#!/usr/bin/env bash
+# Script to build lcdbench on the host and compare the screen hashes of every
+# color format, with and without frame buffer, in portrait and landscape, with
+# the reference hashes in tool/lcdbench/ref.txt. Run from repository root. The
+# screens of a configuration that differs are written as PPM images to a
+# temporary directory, to be compared with lcdbench -r against those of a good
+# commit. With "update", the reference hashes are written instead, e.g. after an
+# intended change of rendering.
+
+set -o pipefail
+
+MODE="$1"
+REF=tool/lcdbench/ref.txt
+BUILD_DIR=$(mktemp -d)
+BENCH=${BUILD_DIR}/lcdbench
+IMG_DIR=""
+trap 'rm -rf ${BUILD_DIR}' EXIT
+
+# 1. Build, see tool/lcdbench/lcdbench.c
+gcc -O2 -Iinc -o ${BENCH} tool/lcdbench/lcdbench.c src/module/st7735-lcd/st7735.c \
+	src/module/st7735-lcd/st7735sim.c src/module/st7735-lcd/lcd.c \
+	src/module/st7735-lcd/chart.c src/module/st7735-lcd/glcdfont.c \
+	src/hw/sim/spi_sim.c src/hw/sim/gpio_sim.c \
+	src/util/bitmap.c src/util/sprite.c src/util/file.c src/util/buffer.c -lm || exit 1
+
+# 2. Every configuration, named as its options, e.g. f16-b-l for -f 16 -b -l.
+# Each line is "<configuration> <primitive> <hash>".
+FAIL=0
+for BITS in 12 16 18; do
+	for FB in "" "-b"; do
+		for ORIENT in "" "-l"; do
+			NAME="f${BITS}${FB}${ORIENT}"
+			${BENCH} -f ${BITS} ${FB} ${ORIENT} | awk -v name=${NAME} 'NR > 1 { print name, $1, $NF }' \
+				> ${BUILD_DIR}/${NAME}.txt || FAIL=1
+			cat ${BUILD_DIR}/${NAME}.txt >> ${BUILD_DIR}/all.txt
+			if [ "${MODE}" == "update" ]; then
+				continue
+			fi
+			if ! grep "^${NAME} " ${REF} | diff - ${BUILD_DIR}/${NAME}.txt; then
+				[ -z "${IMG_DIR}" ] && IMG_DIR=$(mktemp -d)
+				mkdir -p ${IMG_DIR}/${NAME}
+				${BENCH} -f ${BITS} ${FB} ${ORIENT} -o ${IMG_DIR}/${NAME} > /dev/null
+				echo "${NAME}: FAILED, screens in ${IMG_DIR}/${NAME}"
+				FAIL=1
+			fi
+		done
+	done
+done
+
+if [ "${MODE}" == "update" ] && [ ${FAIL} -eq 0 ]; then
+	echo "# Screen hashes of tool/lcdbench, written by script/lcdbench_check.sh update" > ${REF}
+	cat ${BUILD_DIR}/all.txt >> ${REF}
+fi
+
+exit ${FAIL}
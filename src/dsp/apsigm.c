@@ -118,24 +118,23 @@ int32_t apsigm_create(apsigm_t **ppApsigm, const apsigmCfg_t *cfg) {
 	uint32_t i;
 	uint32_t packedSize;
 
-	apsigm = (apsigm_t*) malloc(sizeof(apsigm_t));
+	/* Zeroed, so that apsigm_destroy() can release a partially created instance */
+	apsigm = (apsigm_t*) calloc(1, sizeof(apsigm_t));
 	if (NULL == apsigm) {
 		return STATUS_ERROR_MALLOC;
 	}
-	*ppApsigm = apsigm;
 
 	/**
-	 * Size for:
+	 * Size for the frame opened in apsigm_process(), with:
 	 * 1. X1 = number of channels
 	 * 2. Ws = number of channels
 	 * 3. XX = (channel * (channel + 1))/2
 	 */
-	stackCfg.size = APSIGM_STACK_ALIGNMENT *
-	        (cfg->channel +
-	         cfg->channel +
-	         (cfg->channel * (cfg->channel + 1))/2 +
-			 8	/* Random value as margin */
-	        );
+	packedSize = cfg->channel * (cfg->channel + 1) / 2;
+	stackCfg.size = STACK_FRAME_OVERHEAD("apsigm_process") +
+			STACK_ALIGNED_ALLOC_SIZE(APSIGM_STACK_ALIGNMENT, cfg->channel) +
+			STACK_ALIGNED_ALLOC_SIZE(APSIGM_STACK_ALIGNMENT, cfg->channel) +
+			STACK_ALIGNED_ALLOC_SIZE(APSIGM_STACK_ALIGNMENT, packedSize);
 	stackCfg.alignment = APSIGM_STACK_ALIGNMENT;
 	status = stack_create(&apsigm->stack, &stackCfg);
 	if (STATUS_OK != status) {
@@ -193,7 +192,10 @@ int32_t apsigm_create(apsigm_t **ppApsigm, const apsigmCfg_t *cfg) {
 	apsigm->infftbuf = (fftwf_complex**) fftwf_malloc(apsigm->channel * sizeof(fftwf_complex*));
 	apsigm->outfftbuf = (fftwf_complex*) fftwf_malloc((apsigm->frameSize + 1) * sizeof(fftwf_complex));
 
-	apsigm->fft_plan = (fftwf_plan*) malloc(sizeof(fftwf_plan) * apsigm->channel);
+	apsigm->fft_plan = (fftwf_plan*) calloc(apsigm->channel, sizeof(fftwf_plan));
+	if (NULL != apsigm->infftbuf) {
+		memset(apsigm->infftbuf, 0, apsigm->channel * sizeof(fftwf_complex*));
+	}
 
 	if (NULL == apsigm->pn ||
 		NULL == apsigm->ps ||
@@ -232,6 +234,7 @@ int32_t apsigm_create(apsigm_t **ppApsigm, const apsigmCfg_t *cfg) {
 	apsigm->count = 0;
 	apsigm->state = APSIGM_INIT;
 
+	*ppApsigm = apsigm;
 	return STATUS_OK;
 }
 
@@ -243,15 +246,17 @@ int32_t apsigm_destroy(apsigm_t **ppApsigm) {
 	if (NULL != apsigm) {
 	    stack_destroy(&apsigm->stack);
 
-	    fftwf_destroy_plan(apsigm->ifft_plan);
+	    if (NULL != apsigm->ifft_plan)
+	    	fftwf_destroy_plan(apsigm->ifft_plan);
 
 	    /* Free per channel memories */
 	    for (i = 0; i < apsigm->channel; i++) {
-	    	if (NULL != apsigm->inbuf[i])
+	    	if (NULL != apsigm->inbuf && NULL != apsigm->inbuf[i])
 	    		free(apsigm->inbuf[i]);
-	    	if (NULL != apsigm->infftbuf[i])
+	    	if (NULL != apsigm->infftbuf && NULL != apsigm->infftbuf[i])
 				fftwf_free(apsigm->infftbuf[i]);
-    		fftwf_destroy_plan(apsigm->fft_plan[i]);
+	    	if (NULL != apsigm->fft_plan && NULL != apsigm->fft_plan[i])
+	    		fftwf_destroy_plan(apsigm->fft_plan[i]);
 	    }
 	    if (NULL != apsigm->inbuf)
 	    	free(apsigm->inbuf);
@@ -262,9 +267,9 @@ int32_t apsigm_destroy(apsigm_t **ppApsigm) {
 
 	    /* Free per sample memories */
 	    for (i = 0; i < apsigm->frameSize+1; i++) {
-			if (NULL != apsigm->Rsd[i])
+			if (NULL != apsigm->Rsd && NULL != apsigm->Rsd[i])
 				free(apsigm->Rsd[i]);
-			if (NULL != apsigm->Rss[i])
+			if (NULL != apsigm->Rss && NULL != apsigm->Rss[i])
 				free(apsigm->Rss[i]);
 		}
 		if (NULL != apsigm->Rsd)
@@ -0,0 +1,28 @@
+/*
+ * gpio_sim.c
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: chiong
+ *
+ *  GPIO wrapper implementation for host simulation, see hw/sim.h.
+ */
+
+#include "util/xtype.h"
+#include "hw/gpio.h"
+#include "hw/sim.h"
+
+static uint8_t gpioSimLevel[SIM_GPIO_COUNT];
+
+void gpio_write(uint32_t pinId, uint8_t value) {
+	if (pinId < SIM_GPIO_COUNT) {
+		gpioSimLevel[pinId] = value? HIGH : LOW;
+	}
+}
+
+uint8_t gpio_read(uint32_t pinId) {
+	return pinId < SIM_GPIO_COUNT? gpioSimLevel[pinId] : LOW;
+}
+
+void gpio_toggle(uint32_t pinId) {
+	gpio_write(pinId, gpio_read(pinId)? LOW : HIGH);
+}
@@ -0,0 +1,61 @@
+/*
+ * spi_sim.c
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: chiong
+ *
+ *  SPI wrapper implementation for host simulation, see hw/sim.h.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "util/status.h"
+#include "hw/spi.h"
+#include "hw/sim.h"
+
+typedef struct {
+	spiSimDevice_t device;
+	void *arg;
+} spiSimSlot_t;
+
+static spiSimSlot_t spiSimSlot[SIM_SPI_COUNT][SIM_SPI_CS_COUNT];
+/* Chip select of each bus, the same as bus index until spi_selectCs(). */
+static int8_t spiSimCs[SIM_SPI_COUNT] = {0, 1};
+
+int32_t spi_simAttach(uint8_t spiIdx, int8_t cs, spiSimDevice_t device, void *arg) {
+	if (spiIdx >= SIM_SPI_COUNT || cs < 0 || cs >= SIM_SPI_CS_COUNT) {
+		return STATUS_ERROR_PARAM;
+	}
+	spiSimSlot[spiIdx][cs].device = device;
+	spiSimSlot[spiIdx][cs].arg = arg;
+	return STATUS_OK;
+}
+
+int32_t spi_selectCs(uint8_t spiIdx, int8_t cs, uint8_t active) {
+	/* Polarity of chip select has no effect on the models. */
+	(void) active;
+
+	if (spiIdx >= SIM_SPI_COUNT || cs >= SIM_SPI_CS_COUNT) {
+		return STATUS_ERROR;
+	}
+	spiSimCs[spiIdx] = cs;
+	return STATUS_OK;
+}
+
+int32_t spi_transfer(uint8_t spiIdx, uint8_t *rxBuffer, const uint8_t *txBuffer, uint32_t length) {
+	const spiSimSlot_t *slot;
+
+	if (spiIdx >= SIM_SPI_COUNT) {
+		return STATUS_ERROR;
+	}
+	if (NULL != rxBuffer) {
+		memset(rxBuffer, 0, length);
+	}
+	if (spiSimCs[spiIdx] >= 0) {
+		slot = &spiSimSlot[spiIdx][spiSimCs[spiIdx]];
+		if (NULL != slot->device) {
+			slot->device(slot->arg, rxBuffer, txBuffer, length);
+		}
+	}
+	return length;
+}
@@ -0,0 +1,148 @@
+/*
+ * chart.c
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: chiong
+ */
+
+#include <stddef.h>
+#include "util/bit.h"
+#include "util/status.h"
+#include "module/st7735-lcd/chart.h"
+
+/* Size, in bytes, of command list to draw a line, i.e. a whole line of 18-bit pixels. */
+#define CHART_CMD_BUFFER_SIZE	(512)
+
+/**
+ * @brief Non-zero if lines of chart are columns, i.e. in landscape.
+ */
+static uint8_t chart_isLandscape(const chart_t *chart) {
+	return BIT_isBitSet(chart->lcd->orientation, ST7735_PANEL_EXCHANGE_XY_pos);
+}
+
+/**
+ * @brief Get the number of pixels across chart.
+ */
+static uint16_t chart_getExtent(const chart_t *chart) {
+	return chart_isLandscape(chart)? chart->lcd->height : chart->lcd->width;
+}
+
+/**
+ * @brief Map a value to a coordinate across screen.
+ */
+static uint16_t chart_toLevel(const chart_t *chart, float value) {
+	uint16_t extent = chart_getExtent(chart);
+	uint16_t level;
+
+	/* NaN fails every comparison, drawn at min */
+	if (!(value > chart->min)) {
+		level = 0;
+	} else if (value >= chart->max) {
+		level = extent - 1;
+	} else {
+		level = (uint16_t) ((value - chart->min) * (extent - 1) / (chart->max - chart->min) + 0.5f);
+	}
+
+	/* Values upward in landscape */
+	return chart_isLandscape(chart)? extent - 1 - level : level;
+}
+
+/**
+ * @brief Draw part of a line of chart, from a coordinate across screen.
+ */
+static void chart_drawRun(const chart_t *chart, uint16_t line, uint16_t from, uint16_t len, uint32_t color) {
+	if (0 == len) {
+		return;
+	}
+	if (chart_isLandscape(chart)) {
+		lcd_drawFastVLine(chart->lcd, line, from, len, color);
+	} else {
+		lcd_drawFastHLine(chart->lcd, from, line, len, color);
+	}
+}
+
+/**
+ * @brief Draw a line of chart with the trace from lo to hi across screen.
+ */
+static void chart_drawLine(const chart_t *chart, uint16_t line, uint16_t lo, uint16_t hi) {
+	st7735CmdList_t list;
+	uint8_t buffer[CHART_CMD_BUFFER_SIZE];
+	uint16_t extent = chart_getExtent(chart);
+
+	if (NULL != chart->lcd->frameBuffer) {
+		chart_drawRun(chart, line, 0, lo, chart->bgColor);
+		chart_drawRun(chart, line, lo, hi - lo + 1, chart->color);
+		chart_drawRun(chart, line, hi + 1, extent - hi - 1, chart->bgColor);
+		return;
+	}
+
+	/* Straight to panel as a single address window */
+	st7735_cmdListInit(&list, chart->lcd->st7735_inst, buffer, sizeof(buffer));
+	if (chart_isLandscape(chart)) {
+		st7735_cmdListSetWindow(&list, line, 0, line, extent - 1);
+	} else {
+		st7735_cmdListSetWindow(&list, 0, line, extent - 1, line);
+	}
+	st7735_cmdListPushColor(&list, chart->bgColor, lo);
+	st7735_cmdListPushColor(&list, chart->color, hi - lo + 1);
+	st7735_cmdListPushColor(&list, chart->bgColor, extent - hi - 1);
+	st7735_cmdListFlush(&list);
+}
+
+int32_t chart_init(chart_t *chart, lcd_t *lcd, uint16_t start, uint16_t len, float min, float max,
+		uint32_t color, uint32_t bgColor) {
+	int32_t status;
+
+	if (0 == len || !(min < max)) {
+		return STATUS_ERROR_PARAM;
+	}
+	status = lcd_setScrollArea(lcd, start, len);
+	if (STATUS_OK != status) {
+		return status;
+	}
+
+	chart->lcd = lcd;
+	chart->start = start;
+	chart->len = len;
+	chart->min = min;
+	chart->max = max;
+	chart->color = color;
+	chart->bgColor = bgColor;
+	chart_clear(chart);
+
+	return STATUS_OK;
+}
+
+int32_t chart_push(chart_t *chart, float value) {
+	uint16_t line, level;
+	uint16_t lo, hi;
+
+	if (chart->lcd->scrollStart != chart->start || chart->lcd->scrollLen != chart->len ||
+		lcd_scroll(chart->lcd, 1) != STATUS_OK) {
+		return STATUS_ERROR;
+	}
+
+	/* The oldest line is now shown last, overwrite it with the new value */
+	line = lcd_getScrollLine(chart->lcd, chart->len - 1);
+	level = chart_toLevel(chart, value);
+	lo = level;
+	hi = level;
+	if (chart->hasLast) {
+		lo = chart->lastLevel < level? chart->lastLevel : level;
+		hi = chart->lastLevel > level? chart->lastLevel : level;
+	}
+	chart_drawLine(chart, line, lo, hi);
+
+	chart->lastLevel = level;
+	chart->hasLast = 1;
+	return STATUS_OK;
+}
+
+void chart_clear(chart_t *chart) {
+	if (chart_isLandscape(chart)) {
+		lcd_fillRect(chart->lcd, chart->start, 0, chart->len, chart->lcd->height, chart->bgColor);
+	} else {
+		lcd_fillRect(chart->lcd, 0, chart->start, chart->lcd->width, chart->len, chart->bgColor);
+	}
+	chart->hasLast = 0;
+}
@@ -10,11 +10,26 @@
 #include "util/util.h"
 #include "util/status.h"
 #include "util/bit.h"
+#include "util/bitmap.h"
 #include "module/st7735-lcd/gfxfont.h"
 #include "module/st7735-lcd/lcd.h"
 #include "module/st7735-lcd/st7735.h"
 
 /* Internal Macros */
+/* Size, in bytes, of buffer for lcd_drawBitmapFile(), 3 full rows in 18-bit color. */
+#define LCD_BITMAP_BUFFER_SIZE	(3 * ST7735_HEIGHT * 3)
+/* Size, in bytes, of buffer for lcd_drawSprite(), a multiple of 2 and 3. */
+#define LCD_SPRITE_BUFFER_SIZE	(384)
+/* Number of pixels worth sending in vain to save an address window, when merging
+ * dirty rectangles. */
+#define LCD_DIRTY_MERGE_SLACK	(32)
+/* Size, in bytes, of buffer of command list for drawing straight to panel. */
+#define LCD_CMD_BUFFER_SIZE		(512)
+/* Maximum number of chars of a line of text drawn at once, more than fit on screen. */
+#define LCD_TEXT_LINE_MAX		(32)
+/* Number of sub-pixels per pixel of polygon vertices, see lcd_fillPolygonSpans(). */
+#define LCD_SUBPIXEL			(16)
+
 #ifndef pgm_read_byte
  #define pgm_read_byte(addr) (*(const unsigned char *)(addr))
 #endif
@@ -33,6 +48,774 @@
 
 extern const unsigned char font[];
 
+typedef struct {
+	uint32_t textColor;
+	uint32_t bgColor;
+	/* Tick of last use, to replace the least recently used */
+	uint32_t lastUse;
+	char c;
+} lcdGlyph_t;
+
+struct lcdGlyphCache_s {
+	/* Pixels of glyphs, one slot of slotSize bytes per glyph */
+	uint8_t *pixel;
+	uint32_t slotSize;
+	/* Number of slots, and of slots in use */
+	uint32_t nSlot;
+	uint32_t nGlyph;
+	uint32_t tick;
+	/* Text size and BITMAP_PIXEL_FMT_* of glyphs cached */
+	uint8_t textSize;
+	uint8_t fmt;
+	lcdGlyph_t glyph[LCD_GLYPH_CACHE_MAX];
+};
+
+/**
+ * @brief Get the BITMAP_PIXEL_FMT_* of a panel color format.
+ */
+static uint8_t lcd_toPixelFmt(st7735_color_t colorFmt) {
+	switch (colorFmt) {
+	case ST7735_PANEL_COLOR_12_BIT:
+		return BITMAP_PIXEL_FMT_RGB444;
+	case ST7735_PANEL_COLOR_16_BIT:
+		return BITMAP_PIXEL_FMT_RGB565;
+	default:
+		return BITMAP_PIXEL_FMT_RGB666;
+	}
+}
+
+/**
+ * @brief Get the BITMAP_PIXEL_FMT_* pixels are drawn in, i.e. of frame buffer
+ * 		if enabled, of panel otherwise.
+ */
+static uint32_t lcd_getPixelFmt(const lcd_t *inst) {
+	if (NULL != inst->frameBuffer) {
+		return inst->fbFmt;
+	}
+	return lcd_toPixelFmt(st7735_panel_getColorFmt(inst->st7735_inst));
+}
+
+/**
+ * @brief Get the address of a pixel in frame buffer.
+ */
+static uint8_t* lcd_fbPixel(const lcd_t *inst, uint32_t x, uint32_t y) {
+	return inst->frameBuffer + (y * inst->width + x) * inst->fbPixelSize;
+}
+
+/**
+ * @brief Convert a 24-bit RGB color into a pixel value of BITMAP_PIXEL_FMT_*,
+ * 		as in frame buffer, MSB first.
+ */
+static void lcd_toValue(uint8_t fmt, uint32_t color, uint8_t *value) {
+	uint16_t color16;
+
+	switch (fmt) {
+	case BITMAP_PIXEL_FMT_RGB444:
+		color16 = ((color >> 12) & 0x0F00) | ((color >> 8) & 0x00F0) | ((color >> 4) & 0x000F);
+		value[0] = color16 >> 8;
+		value[1] = color16 & 0xFF;
+		break;
+	case BITMAP_PIXEL_FMT_RGB565:
+		color16 = ST7735_rgb565((color >> 16) & 0xFF, (color >> 8) & 0xFF, color & 0xFF);
+		value[0] = color16 >> 8;
+		value[1] = color16 & 0xFF;
+		break;
+	default:
+		value[0] = (color >> 16) & 0xFF;
+		value[1] = (color >>  8) & 0xFF;
+		value[2] = (color      ) & 0xFF;
+		break;
+	}
+}
+
+static uint32_t lcd_rectArea(const lcdRect_t *rect) {
+	return (uint32_t) (rect->x1 - rect->x0 + 1) * (rect->y1 - rect->y0 + 1);
+}
+
+static void lcd_rectUnion(lcdRect_t *dst, const lcdRect_t *a, const lcdRect_t *b) {
+	dst->x0 = a->x0 < b->x0? a->x0 : b->x0;
+	dst->y0 = a->y0 < b->y0? a->y0 : b->y0;
+	dst->x1 = a->x1 > b->x1? a->x1 : b->x1;
+	dst->y1 = a->y1 > b->y1? a->y1 : b->y1;
+}
+
+/**
+ * @brief Number of clean pixels sent in vain if two rectangles are merged, less
+ * 		LCD_DIRTY_MERGE_SLACK. Zero or negative if worth merging, e.g. overlapped.
+ */
+static int32_t lcd_rectMergeCost(const lcdRect_t *a, const lcdRect_t *b) {
+	lcdRect_t u;
+
+	lcd_rectUnion(&u, a, b);
+	return (int32_t) lcd_rectArea(&u) - (int32_t) lcd_rectArea(a) - (int32_t) lcd_rectArea(b)
+			- LCD_DIRTY_MERGE_SLACK;
+}
+
+/**
+ * @brief Add an area, within screen, to the dirty rectangles of frame buffer.
+ * @details The area is merged with any dirty rectangle close enough, repeatedly
+ * 		as the merged rectangle grows. If no room is left, it is merged with the
+ * 		closest one anyway.
+ */
+static void lcd_markDirty(lcd_t *inst, uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1) {
+	lcdRect_t rect;
+	int32_t cost, minCost;
+	uint32_t i, iMin;
+
+	/* Most drawing is within an area already dirty, e.g. pixels of text */
+	for (i = 0; i < inst->nDirty; i++) {
+		if (x0 >= inst->dirty[i].x0 && x1 <= inst->dirty[i].x1 &&
+			y0 >= inst->dirty[i].y0 && y1 <= inst->dirty[i].y1) {
+			return;
+		}
+	}
+
+	rect.x0 = x0;
+	rect.y0 = y0;
+	rect.x1 = x1;
+	rect.y1 = y1;
+	for (;;) {
+		iMin = inst->nDirty;
+		minCost = INT32_MAX;
+		for (i = 0; i < inst->nDirty; i++) {
+			cost = lcd_rectMergeCost(&inst->dirty[i], &rect);
+			if (cost < minCost) {
+				minCost = cost;
+				iMin = i;
+			}
+		}
+		if (iMin == inst->nDirty || (minCost > 0 && inst->nDirty < LCD_DIRTY_RECT_MAX)) {
+			break;
+		}
+		lcd_rectUnion(&rect, &rect, &inst->dirty[iMin]);
+		inst->dirty[iMin] = inst->dirty[--inst->nDirty];
+	}
+	inst->dirty[inst->nDirty++] = rect;
+}
+
+/**
+ * @brief Clip a rectangle to screen.
+ * @return Non-zero if any part of the rectangle is on screen.
+ */
+static uint8_t lcd_clip(const lcd_t *inst, int32_t *x, int32_t *y, int32_t *w, int32_t *h) {
+	if (*x < 0) {
+		*w += *x;
+		*x = 0;
+	}
+	if (*y < 0) {
+		*h += *y;
+		*y = 0;
+	}
+	if (*x + *w > (int32_t) inst->width) {
+		*w = inst->width - *x;
+	}
+	if (*y + *h > (int32_t) inst->height) {
+		*h = inst->height - *y;
+	}
+	return *w > 0 && *h > 0;
+}
+
+/**
+ * @brief Fill a rectangle of frame buffer, clipped to screen, and mark it dirty.
+ */
+static void lcd_fbFill(lcd_t *inst, int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color) {
+	uint8_t value[3];
+	uint8_t *row;
+	uint32_t stride;
+	int32_t i;
+
+	if (!lcd_clip(inst, &x, &y, &w, &h)) {
+		return;
+	}
+
+	lcd_toValue(inst->fbFmt, color, value);
+	stride = inst->width * inst->fbPixelSize;
+	row = lcd_fbPixel(inst, x, y);
+	for (i = 0; i < w; i++) {
+		memcpy(row + i * inst->fbPixelSize, value, inst->fbPixelSize);
+	}
+	for (i = 1; i < h; i++) {
+		memcpy(row + i * stride, row, w * inst->fbPixelSize);
+	}
+	lcd_markDirty(inst, x, y, x + w - 1, y + h - 1);
+}
+
+/**
+ * @brief Copy pixels packed in the wire format, e.g. by bitmap_readRows() or
+ * 		sprite_decode(), into a rectangle of frame buffer, continuing from
+ * 		pixel *pIndex of the rectangle. The rectangle must be within screen.
+ * @details With 12-bit color, size must hold an even number of pixels, except
+ * 		for the last part.
+ */
+static void lcd_fbWritePacked(lcd_t *inst, const lcdRect_t *rect, uint32_t *pIndex, const uint8_t *data, uint32_t size) {
+	uint8_t *dst;
+	uint32_t w, col, n;
+
+	w = rect->x1 - rect->x0 + 1;
+	if (BITMAP_PIXEL_FMT_RGB444 == inst->fbFmt) {
+		/* 2 pixels in 3 bytes, the last odd pixel in 2 bytes */
+		while (size >= 2) {
+			dst = lcd_fbPixel(inst, rect->x0 + *pIndex % w, rect->y0 + *pIndex / w);
+			dst[0] = data[0] >> 4;
+			dst[1] = (data[0] << 4) | (data[1] >> 4);
+			(*pIndex)++;
+			if (size < 3) {
+				break;
+			}
+			dst = lcd_fbPixel(inst, rect->x0 + *pIndex % w, rect->y0 + *pIndex / w);
+			dst[0] = data[1] & 0x0F;
+			dst[1] = data[2];
+			(*pIndex)++;
+			data += 3;
+			size -= 3;
+		}
+	} else {
+		/* Whole pixels of a row at a time */
+		while (size >= inst->fbPixelSize) {
+			col = *pIndex % w;
+			n = size / inst->fbPixelSize;
+			if (n > w - col) {
+				n = w - col;
+			}
+			memcpy(lcd_fbPixel(inst, rect->x0 + col, rect->y0 + *pIndex / w), data, n * inst->fbPixelSize);
+			*pIndex += n;
+			data += n * inst->fbPixelSize;
+			size -= n * inst->fbPixelSize;
+		}
+	}
+}
+
+/**
+ * @brief Write a part of the pixels of an address window, RAMWR first.
+ */
+static void lcd_writePart(lcd_t *inst, const uint8_t *data, uint32_t size, uint8_t *isFirst) {
+	if (*isFirst) {
+		st7735_panel_writePixels(inst->st7735_inst, data, size);
+		*isFirst = 0;
+	} else {
+		st7735_writeData(inst->st7735_inst, data, size);
+	}
+}
+
+/**
+ * @brief Fill a rectangle, clipped to screen, into frame buffer if enabled,
+ * 		otherwise recorded into a command list.
+ */
+static void lcd_fillSpan(lcd_t *inst, st7735CmdList_t *list, int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color) {
+	if (NULL != inst->frameBuffer) {
+		lcd_fbFill(inst, x, y, w, h, color);
+	} else if (lcd_clip(inst, &x, &y, &w, &h)) {
+		st7735_cmdListSetWindow(list, x, y, x + w - 1, y + h - 1);
+		st7735_cmdListPushColor(list, color, (uint32_t) w * h);
+	}
+}
+
+/**
+ * @brief Fill a rectangle on panel as a single address window and burst.
+ */
+static void lcd_fillWindow(lcd_t *inst, uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint32_t color) {
+	st7735CmdList_t list;
+	uint8_t buffer[LCD_CMD_BUFFER_SIZE];
+
+	st7735_cmdListInit(&list, inst->st7735_inst, buffer, sizeof(buffer));
+	st7735_cmdListSetWindow(&list, x, y, x + w - 1, y + h - 1);
+	st7735_cmdListPushColor(&list, color, (uint32_t) w * h);
+	st7735_cmdListFlush(&list);
+}
+
+/**
+ * @brief Get the smallest pixel at or after a sub-pixel coordinate, i.e. ceil().
+ */
+static int32_t lcd_subToPixel(int32_t v) {
+	return v >= 0? (v + LCD_SUBPIXEL - 1) / LCD_SUBPIXEL : -(-v / LCD_SUBPIXEL);
+}
+
+/**
+ * @brief Fill a polygon with vertices in sub-pixels, LCD_SUBPIXEL per pixel,
+ * 		with even-odd rule. A pixel is filled if its center is inside the
+ * 		polygon, left and top edges inclusive.
+ */
+static void lcd_fillPolygonSpans(lcd_t *inst, st7735CmdList_t *list, const int32_t *x, const int32_t *y,
+		uint32_t count, uint32_t color) {
+	int32_t cross[LCD_POLYGON_VERTEX_MAX];
+	int32_t yMin, yMax, row, rowEnd, sy;
+	int32_t xStart, xEnd, t;
+	uint32_t i, j, k, n;
+
+	if (count < 3 || count > LCD_POLYGON_VERTEX_MAX) {
+		return;
+	}
+
+	yMin = y[0];
+	yMax = y[0];
+	for (i = 1; i < count; i++) {
+		yMin = y[i] < yMin? y[i] : yMin;
+		yMax = y[i] > yMax? y[i] : yMax;
+	}
+	/* Rows with center within [yMin, yMax), clipped to screen */
+	row = lcd_subToPixel(yMin - LCD_SUBPIXEL / 2);
+	rowEnd = lcd_subToPixel(yMax - LCD_SUBPIXEL / 2);
+	row = row < 0? 0 : row;
+	rowEnd = rowEnd > (int32_t) inst->height? (int32_t) inst->height : rowEnd;
+
+	for (; row < rowEnd; row++) {
+		sy = row * LCD_SUBPIXEL + LCD_SUBPIXEL / 2;
+		n = 0;
+		for (i = 0; i < count; i++) {
+			j = i + 1 < count? i + 1 : 0;
+			if ((y[i] <= sy && sy < y[j]) || (y[j] <= sy && sy < y[i])) {
+				t = x[i] + (sy - y[i]) * (x[j] - x[i]) / (y[j] - y[i]);
+				/* Insertion sort, only a few crossings */
+				for (k = n++; k > 0 && cross[k - 1] > t; k--) {
+					cross[k] = cross[k - 1];
+				}
+				cross[k] = t;
+			}
+		}
+
+		for (i = 0; i + 1 < n; i += 2) {
+			/* Pixels with center within [cross[i], cross[i + 1]) */
+			xStart = lcd_subToPixel(cross[i] - LCD_SUBPIXEL / 2);
+			xEnd = lcd_subToPixel(cross[i + 1] - LCD_SUBPIXEL / 2);
+			if (xEnd > xStart) {
+				lcd_fillSpan(inst, list, xStart, row, xEnd - xStart, 1, color);
+			}
+		}
+	}
+}
+
+/**
+ * @brief Fill the rows of a circle above (corners bit 0) and/or below (bit 1)
+ * 		its middle row, each row once, stretched to the right by delta pixels.
+ */
+static void lcd_fillCircleRows(lcd_t *inst, st7735CmdList_t *list, int32_t x0, int32_t y0, int32_t r,
+		uint8_t corners, int32_t delta, uint32_t color) {
+	int32_t f = 1 - r;
+	int32_t ddF_x = 1;
+	int32_t ddF_y = -2 * r;
+	int32_t x = 0;
+	int32_t y = r;
+	int32_t px = x;
+	int32_t py = y;
+
+	delta++;
+	while (x < y) {
+		if (f >= 0) {
+			y--;
+			ddF_y += 2;
+			f += ddF_y;
+		}
+		x++;
+		ddF_x += 2;
+		f += ddF_x;
+
+		if (x < y + 1) {
+			if (corners & 0x1) {
+				lcd_fillSpan(inst, list, x0 - y, y0 - x, 2 * y + delta, 1, color);
+			}
+			if (corners & 0x2) {
+				lcd_fillSpan(inst, list, x0 - y, y0 + x, 2 * y + delta, 1, color);
+			}
+		}
+		if (y != py) {
+			if (corners & 0x1) {
+				lcd_fillSpan(inst, list, x0 - px, y0 - py, 2 * px + delta, 1, color);
+			}
+			if (corners & 0x2) {
+				lcd_fillSpan(inst, list, x0 - px, y0 + py, 2 * px + delta, 1, color);
+			}
+			py = y;
+		}
+		px = x;
+	}
+}
+
+/**
+ * @brief Draw the points (a, y) to (b, y) of the first octant of a circle,
+ * 		mirrored into all octants, as runs.
+ */
+static void lcd_drawCircleRun(lcd_t *inst, st7735CmdList_t *list, int32_t x0, int32_t y0,
+		int32_t a, int32_t b, int32_t y, uint32_t color) {
+	if (0 == a) {
+		lcd_fillSpan(inst, list, x0 - b, y0 - y, 2 * b + 1, 1, color);
+		lcd_fillSpan(inst, list, x0 - b, y0 + y, 2 * b + 1, 1, color);
+		lcd_fillSpan(inst, list, x0 - y, y0 - b, 1, 2 * b + 1, color);
+		lcd_fillSpan(inst, list, x0 + y, y0 - b, 1, 2 * b + 1, color);
+		return;
+	}
+	lcd_fillSpan(inst, list, x0 - b, y0 - y, b - a + 1, 1, color);
+	lcd_fillSpan(inst, list, x0 + a, y0 - y, b - a + 1, 1, color);
+	lcd_fillSpan(inst, list, x0 - b, y0 + y, b - a + 1, 1, color);
+	lcd_fillSpan(inst, list, x0 + a, y0 + y, b - a + 1, 1, color);
+	lcd_fillSpan(inst, list, x0 - y, y0 - b, 1, b - a + 1, color);
+	lcd_fillSpan(inst, list, x0 - y, y0 + a, 1, b - a + 1, color);
+	lcd_fillSpan(inst, list, x0 + y, y0 - b, 1, b - a + 1, color);
+	lcd_fillSpan(inst, list, x0 + y, y0 + a, 1, b - a + 1, color);
+}
+
+/**
+ * @brief Integer square root, rounded down.
+ */
+static uint32_t lcd_isqrt(uint32_t v) {
+	uint32_t root = 0;
+	uint32_t bit = 1ul << 30;
+
+	while (bit > v) {
+		bit >>= 2;
+	}
+	while (bit != 0) {
+		if (v >= root + bit) {
+			v -= root + bit;
+			root = (root >> 1) + bit;
+		} else {
+			root >>= 1;
+		}
+		bit >>= 2;
+	}
+	return root;
+}
+
+/**
+ * @brief Convert a pixel value of BITMAP_PIXEL_FMT_* back into a 24-bit RGB color.
+ */
+static uint32_t lcd_fromValue(uint8_t fmt, const uint8_t *value) {
+	uint32_t r, g, b;
+	uint16_t color16 = (value[0] << 8) | value[1];
+
+	switch (fmt) {
+	case BITMAP_PIXEL_FMT_RGB444:
+		r = ((color16 >> 8) & 0x0F) * 0x11;
+		g = ((color16 >> 4) & 0x0F) * 0x11;
+		b = (color16 & 0x0F) * 0x11;
+		break;
+	case BITMAP_PIXEL_FMT_RGB565:
+		r = (color16 >> 11) & 0x1F;
+		g = (color16 >> 5) & 0x3F;
+		b = color16 & 0x1F;
+		r = (r << 3) | (r >> 2);
+		g = (g << 2) | (g >> 4);
+		b = (b << 3) | (b >> 2);
+		break;
+	default:
+		r = value[0];
+		g = value[1];
+		b = value[2];
+		break;
+	}
+	return (r << 16) | (g << 8) | b;
+}
+
+/**
+ * @brief Blend a color over a pixel of frame buffer, if on screen, without
+ * 		marking it dirty.
+ * @param[in] alpha Opacity of color, 0 to 255.
+ */
+static void lcd_fbBlend(lcd_t *inst, int32_t x, int32_t y, uint32_t color, uint32_t alpha) {
+	uint8_t *pixel;
+	uint32_t dst, mix;
+	uint8_t shift;
+
+	if (0 == alpha || x < 0 || y < 0 || x >= (int32_t) inst->width || y >= (int32_t) inst->height) {
+		return;
+	}
+
+	pixel = lcd_fbPixel(inst, x, y);
+	if (alpha < 0xFF) {
+		dst = lcd_fromValue(inst->fbFmt, pixel);
+		mix = 0;
+		for (shift = 0; shift < 24; shift += 8) {
+			mix |= ((((color >> shift) & 0xFF) * alpha + ((dst >> shift) & 0xFF) * (0xFF - alpha) + 0x7F) / 0xFF) << shift;
+		}
+		color = mix;
+	}
+	lcd_toValue(inst->fbFmt, color, pixel);
+}
+
+/**
+ * @brief Blend a point (dx, dy) of the first octant of a circle, mirrored into
+ * 		all octants, each pixel once.
+ */
+static void lcd_fbBlendCircle(lcd_t *inst, int32_t x0, int32_t y0, int32_t dx, int32_t dy,
+		uint32_t color, uint32_t alpha) {
+	int32_t i;
+
+	for (i = 0; i < 2; i++) {
+		lcd_fbBlend(inst, x0 + dx, y0 + dy, color, alpha);
+		if (dx != 0) {
+			lcd_fbBlend(inst, x0 - dx, y0 + dy, color, alpha);
+		}
+		if (dy != 0) {
+			lcd_fbBlend(inst, x0 + dx, y0 - dy, color, alpha);
+			if (dx != 0) {
+				lcd_fbBlend(inst, x0 - dx, y0 - dy, color, alpha);
+			}
+		}
+		if (dx == dy) {
+			break;
+		}
+		UTIL_swapInt(dx, dy);
+	}
+}
+
+/**
+ * @brief Mark a rectangle of frame buffer dirty, clipped to screen.
+ */
+static void lcd_markDirtyClipped(lcd_t *inst, int32_t x, int32_t y, int32_t w, int32_t h) {
+	if (lcd_clip(inst, &x, &y, &w, &h)) {
+		lcd_markDirty(inst, x, y, x + w - 1, y + h - 1);
+	}
+}
+
+/**
+ * @brief Get the first row of frame memory of an area of lines of screen, see
+ * 		lcd_setScrollArea(). Memory rows run the other way round if mirrored.
+ */
+static uint16_t lcd_toMemoryRow(const lcd_t *inst, uint16_t start, uint16_t len) {
+	if (BIT_isBitSet(inst->orientation, ST7735_PANEL_MIRROR_Y_pos)) {
+		return ST7735_HEIGHT - start - len;
+	}
+	return start;
+}
+
+/**
+ * @brief Write the first row of scroll area shown for the current scroll offset.
+ */
+static int32_t lcd_writeScrollStart(lcd_t *inst) {
+	uint16_t top, row;
+
+	top = lcd_toMemoryRow(inst, inst->scrollStart, inst->scrollLen);
+	if (BIT_isBitSet(inst->orientation, ST7735_PANEL_MIRROR_Y_pos)) {
+		row = top + (inst->scrollLen - inst->scrollOffset) % inst->scrollLen;
+	} else {
+		row = top + inst->scrollOffset;
+	}
+	if (st7735_panel_setScrollStart(inst->st7735_inst, row) != ST7735_STATUS_OK) {
+		return STATUS_ERROR;
+	}
+
+	return STATUS_OK;
+}
+
+/**
+ * @brief Get glyph cache ready for the current text size and color format.
+ * @return Number of glyphs the cache holds at once, 0 if none.
+ */
+static uint32_t lcd_prepareGlyphCache(lcd_t *inst) {
+	lcdGlyphCache_t *cache;
+	uint8_t fmt;
+
+	if (0 == inst->glyphCacheSize) {
+		return 0;
+	}
+	if (NULL == inst->glyphCache) {
+		cache = (lcdGlyphCache_t*) malloc(sizeof(lcdGlyphCache_t) + inst->glyphCacheSize);
+		if (NULL == cache) {
+			return 0;
+		}
+		cache->pixel = (uint8_t*) (cache + 1);
+		cache->nSlot = 0;
+		cache->nGlyph = 0;
+		cache->tick = 0;
+		cache->textSize = 0;
+		inst->glyphCache = cache;
+	}
+
+	cache = inst->glyphCache;
+	fmt = lcd_getPixelFmt(inst);
+	if (cache->textSize != inst->textSize || cache->fmt != fmt) {
+		cache->textSize = inst->textSize;
+		cache->fmt = fmt;
+		cache->slotSize = 6 * 8 * inst->textSize * inst->textSize * SPRITE_getValueSize(fmt);
+		cache->nSlot = inst->glyphCacheSize / cache->slotSize;
+		if (cache->nSlot > LCD_GLYPH_CACHE_MAX) {
+			cache->nSlot = LCD_GLYPH_CACHE_MAX;
+		}
+		cache->nGlyph = 0;
+	}
+
+	return cache->nSlot;
+}
+
+/**
+ * @brief Get a glyph of classic font in the current text size and colors from
+ * 		cache, rasterising it on a miss. Cache must be prepared.
+ * @return Pixels of 6 x 8 cells of textSize, row by row.
+ */
+static const uint8_t* lcd_getGlyph(lcd_t *inst, char c) {
+	lcdGlyphCache_t *cache = inst->glyphCache;
+	lcdGlyph_t *glyph;
+	uint8_t fg[3], bg[3];
+	uint8_t *dst;
+	uint32_t i, iSlot;
+	uint32_t pixelSize, rowSize;
+	uint32_t s, j, k;
+	uint8_t line;
+
+	for (i = 0; i < cache->nGlyph; i++) {
+		glyph = &cache->glyph[i];
+		if (glyph->c == c && glyph->textColor == inst->textColor && glyph->bgColor == inst->bgColor) {
+			glyph->lastUse = ++cache->tick;
+			return cache->pixel + i * cache->slotSize;
+		}
+	}
+
+	/* Miss, take a free slot or the least recently used */
+	if (cache->nGlyph < cache->nSlot) {
+		iSlot = cache->nGlyph++;
+	} else {
+		iSlot = 0;
+		for (i = 1; i < cache->nGlyph; i++) {
+			if (cache->glyph[i].lastUse < cache->glyph[iSlot].lastUse) {
+				iSlot = i;
+			}
+		}
+	}
+	glyph = &cache->glyph[iSlot];
+	glyph->c = c;
+	glyph->textColor = inst->textColor;
+	glyph->bgColor = inst->bgColor;
+	glyph->lastUse = ++cache->tick;
+
+	/* Rasterise a row of cells of each dot row, then repeat it for the cell height */
+	lcd_toValue(cache->fmt, inst->textColor, fg);
+	lcd_toValue(cache->fmt, inst->bgColor, bg);
+	s = cache->textSize;
+	pixelSize = SPRITE_getValueSize(cache->fmt);
+	rowSize = 6 * s * pixelSize;
+	dst = cache->pixel + iSlot * cache->slotSize;
+	for (j = 0; j < 8; j++) {
+		for (i = 0; i < 6 * s; i++) {
+			line = i / s < 5? pgm_read_byte(font + ((uint8_t) c * 5) + i / s) : 0x0;
+			memcpy(dst + i * pixelSize, (line >> j) & 0x1? fg : bg, pixelSize);
+		}
+		for (k = 1; k < s; k++) {
+			memcpy(dst + k * rowSize, dst, rowSize);
+		}
+		dst += s * rowSize;
+	}
+
+	return cache->pixel + iSlot * cache->slotSize;
+}
+
+/**
+ * @brief Draw a line of chars in classic font with opaque background from glyph
+ * 		cache, as a single address window on panel or into frame buffer.
+ * @return Non-zero if drawn, zero if not possible, i.e. background is not opaque,
+ * 		line is not within screen or there is no cache.
+ */
+static uint8_t lcd_blitText(lcd_t *inst, uint16_t x, uint16_t y, const char *str, uint32_t n) {
+	st7735CmdList_t list;
+	uint8_t buffer[LCD_CMD_BUFFER_SIZE];
+	const uint8_t *glyph[LCD_GLYPH_CACHE_MAX];
+	uint32_t cellW, cellH, rowSize;
+	uint32_t nSlot, done, k;
+	uint32_t i, row;
+
+	cellW = 6 * inst->textSize;
+	cellH = 8 * inst->textSize;
+	if (NULL != inst->gfxFont || !inst->isBgOpaque || inst->bgColor == inst->textColor || 0 == n ||
+		x + cellW * n > inst->width || y + cellH > inst->height) {
+		return 0;
+	}
+	nSlot = lcd_prepareGlyphCache(inst);
+	if (0 == nSlot) {
+		return 0;
+	}
+	rowSize = cellW * SPRITE_getValueSize(inst->glyphCache->fmt);
+
+	st7735_cmdListInit(&list, inst->st7735_inst, buffer, sizeof(buffer));
+	for (done = 0; done < n; done += k) {
+		/* No more glyphs at once than the cache holds */
+		k = n - done < nSlot? n - done : nSlot;
+		for (i = 0; i < k; i++) {
+			glyph[i] = lcd_getGlyph(inst, str[done + i]);
+		}
+
+		if (NULL != inst->frameBuffer) {
+			for (i = 0; i < k; i++) {
+				for (row = 0; row < cellH; row++) {
+					memcpy(lcd_fbPixel(inst, x + (done + i) * cellW, y + row), glyph[i] + row * rowSize, rowSize);
+				}
+			}
+		} else {
+			st7735_cmdListSetWindow(&list, x + done * cellW, y, x + (done + k) * cellW - 1, y + cellH - 1);
+			for (row = 0; row < cellH; row++) {
+				for (i = 0; i < k; i++) {
+					st7735_cmdListPushPixels(&list, glyph[i] + row * rowSize, cellW);
+				}
+			}
+		}
+	}
+
+	if (NULL != inst->frameBuffer) {
+		lcd_markDirty(inst, x, y, x + n * cellW - 1, y + cellH - 1);
+	} else {
+		st7735_cmdListFlush(&list);
+	}
+	return 1;
+}
+
+/**
+ * @brief Write a rectangle of a frame buffer to panel in a single address window.
+ */
+static void lcd_flushRect(lcd_t *inst, const uint8_t *frameBuffer, const lcdRect_t *rect) {
+	uint8_t buffer[LCD_BITMAP_BUFFER_SIZE];
+	const uint8_t *src;
+	uint32_t w, x, y;
+	uint32_t rowSize;
+	uint32_t n;
+	uint8_t isFirst;
+
+	st7735_setAddress(inst->st7735_inst, rect->x0, rect->y0, rect->x1, rect->y1);
+	w = rect->x1 - rect->x0 + 1;
+	rowSize = w * inst->fbPixelSize;
+	isFirst = 1;
+	n = 0;
+
+	if (BITMAP_PIXEL_FMT_RGB444 == inst->fbFmt) {
+		/* Pack 2 pixels into 3 bytes, continuing across rows */
+		for (y = rect->y0; y <= rect->y1; y++) {
+			src = frameBuffer + (y * inst->width + rect->x0) * inst->fbPixelSize;
+			for (x = 0; x < w; x++, src += 2) {
+				if (0 == ((y - rect->y0) * w + x) % 2) {
+					buffer[n++] = (src[0] << 4) | (src[1] >> 4);
+					buffer[n] = src[1] << 4;
+				} else {
+					buffer[n++] |= src[0] & 0x0F;
+					buffer[n++] = src[1];
+					if (n + 3 > sizeof(buffer)) {
+						lcd_writePart(inst, buffer, n, &isFirst);
+						n = 0;
+					}
+				}
+			}
+		}
+		if (lcd_rectArea(rect) % 2) {
+			/* Half byte of the last odd pixel */
+			n++;
+		}
+	} else if (w == inst->width) {
+		/* Full rows are contiguous in frame buffer */
+		n = rowSize * (rect->y1 - rect->y0 + 1);
+		lcd_writePart(inst, frameBuffer + rect->y0 * rowSize, n, &isFirst);
+		return;
+	} else {
+		/* Gather as many rows as fit into a single transfer */
+		for (y = rect->y0; y <= rect->y1; y++) {
+			if (n + rowSize > sizeof(buffer)) {
+				lcd_writePart(inst, buffer, n, &isFirst);
+				n = 0;
+			}
+			memcpy(buffer + n, frameBuffer + (y * inst->width + rect->x0) * inst->fbPixelSize, rowSize);
+			n += rowSize;
+		}
+	}
+
+	if (n > 0) {
+		lcd_writePart(inst, buffer, n, &isFirst);
+	}
+}
+
 int32_t lcd_create(lcd_t **inst, st7735_t *st7735_inst) {
 	lcd_t *pLcd;
 	pLcd = (lcd_t*) malloc(sizeof(lcd_t));
@@ -49,6 +832,12 @@ int32_t lcd_create(lcd_t **inst, st7735_t *st7735_inst) {
 	pLcd->isBgOpaque = 1;
 	pLcd->textSize = 1;
 	pLcd->isWrap = 1;
+	pLcd->frameBuffer = NULL;
+	pLcd->nDirty = 0;
+	pLcd->glyphCache = NULL;
+	pLcd->glyphCacheSize = LCD_GLYPH_CACHE_SIZE;
+	pLcd->scrollLen = 0;
+	pLcd->isScrollPending = 0;
 	if (lcd_setOrientation(pLcd, LCD_ORIENT_PORTRAIT_NORMAL) != STATUS_OK) {
 		return STATUS_ERROR;
 	}
@@ -60,12 +849,121 @@ int32_t lcd_create(lcd_t **inst, st7735_t *st7735_inst) {
 void lcd_destroy(lcd_t **inst) {
 	lcd_t *p = *inst;
 	if (NULL != p) {
+		lcd_disableFrameBuffer(p);
+		free(p->glyphCache);
 		free(p);
-		p = NULL;
+		*inst = NULL;
+	}
+}
+
+
+int32_t lcd_enableFrameBuffer(lcd_t *inst) {
+	uint8_t fmt;
+
+	lcd_disableFrameBuffer(inst);
+
+	/* Pixels are stored as the pixel values of sprite.h */
+	fmt = lcd_toPixelFmt(st7735_panel_getColorFmt(inst->st7735_inst));
+	inst->frameBuffer = (uint8_t*) calloc(ST7735_WIDTH * ST7735_HEIGHT, SPRITE_getValueSize(fmt));
+	if (NULL == inst->frameBuffer) {
+		return STATUS_ERROR_MALLOC;
+	}
+	inst->fbFmt = fmt;
+	inst->fbPixelSize = SPRITE_getValueSize(fmt);
+
+	return STATUS_OK;
+}
+
+
+void lcd_disableFrameBuffer(lcd_t *inst) {
+	if (NULL != inst->frameBuffer) {
+		free(inst->frameBuffer);
+		inst->frameBuffer = NULL;
+	}
+	inst->nDirty = 0;
+
+	/* Panel is to show the lines as scrolled, whatever is drawn next */
+	if (inst->isScrollPending) {
+		inst->isScrollPending = 0;
+		lcd_writeScrollStart(inst);
 	}
 }
 
 
+int32_t lcd_flush(lcd_t *inst) {
+	int32_t status;
+
+	if (NULL == inst->frameBuffer) {
+		return STATUS_OK;
+	}
+
+	status = lcd_flushFrame(inst, inst->frameBuffer, inst->dirty, inst->nDirty);
+	if (STATUS_OK == status) {
+		inst->nDirty = 0;
+	}
+
+	return status;
+}
+
+
+int32_t lcd_flushFrame(lcd_t *inst, const uint8_t *frameBuffer, const lcdRect_t *rect, uint32_t count) {
+	uint32_t i;
+
+	if (NULL == inst->frameBuffer) {
+		return STATUS_ERROR;
+	}
+	if (lcd_toPixelFmt(st7735_panel_getColorFmt(inst->st7735_inst)) != inst->fbFmt) {
+		return STATUS_ERROR;
+	}
+
+	for (i = 0; i < count; i++) {
+		lcd_flushRect(inst, frameBuffer, &rect[i]);
+	}
+
+	/* Lines scrolled in are on panel by now */
+	if (inst->isScrollPending) {
+		inst->isScrollPending = 0;
+		return lcd_writeScrollStart(inst);
+	}
+
+	return STATUS_OK;
+}
+
+
+int32_t lcd_setColorFmt(lcd_t *inst, st7735_color_t fmt) {
+	uint8_t *frameBuffer;
+	uint8_t pixelFmt, pixelSize;
+	uint32_t i;
+
+	if (ST7735_PANEL_COLOR_12_BIT != fmt && ST7735_PANEL_COLOR_16_BIT != fmt && ST7735_PANEL_COLOR_18_BIT != fmt) {
+		return STATUS_ERROR_PARAM;
+	}
+
+	/* Converted before the panel is set, so nothing changes if out of memory */
+	pixelFmt = lcd_toPixelFmt(fmt);
+	if (NULL != inst->frameBuffer && pixelFmt != inst->fbFmt) {
+		pixelSize = SPRITE_getValueSize(pixelFmt);
+		frameBuffer = (uint8_t*) malloc(ST7735_WIDTH * ST7735_HEIGHT * pixelSize);
+		if (NULL == frameBuffer) {
+			return STATUS_ERROR_MALLOC;
+		}
+		for (i = 0; i < ST7735_WIDTH * ST7735_HEIGHT; i++) {
+			lcd_toValue(pixelFmt, lcd_fromValue(inst->fbFmt, inst->frameBuffer + i * inst->fbPixelSize),
+					frameBuffer + i * pixelSize);
+		}
+		free(inst->frameBuffer);
+		inst->frameBuffer = frameBuffer;
+		inst->fbFmt = pixelFmt;
+		inst->fbPixelSize = pixelSize;
+	}
+
+	if (st7735_panel_setColorFmt(inst->st7735_inst, fmt) != ST7735_STATUS_OK) {
+		return STATUS_ERROR;
+	}
+	return STATUS_OK;
+}
+
+
 int32_t lcd_setOrientation(lcd_t *inst, uint8_t newOrient) {
 	if (st7735_panel_setOrientation(inst->st7735_inst, newOrient) != ST7735_STATUS_OK) {
 		return STATUS_ERROR;
@@ -82,10 +980,103 @@ int32_t lcd_setOrientation(lcd_t *inst, uint8_t newOrient) {
 	    inst->height = ST7735_WIDTH;
 	}
 
+	if (NULL != inst->frameBuffer) {
+		inst->nDirty = 0;
+		lcd_markDirty(inst, 0, 0, inst->width - 1, inst->height - 1);
+	}
+
+	/* Lines of scroll area are no longer where they were */
+	if (inst->scrollLen > 0) {
+		return lcd_setScrollArea(inst, 0, 0);
+	}
+
+	return STATUS_OK;
+}
+
+
+int32_t lcd_setScrollArea(lcd_t *inst, uint16_t start, uint16_t len) {
+	uint16_t top, area;
+
+	if (start + len > ST7735_HEIGHT) {
+		return STATUS_ERROR_PARAM;
+	}
+
+	/* Not scrolling is a scroll area of the whole screen, shown from its start */
+	top = lcd_toMemoryRow(inst, start, len);
+	area = len;
+	if (0 == len) {
+		top = 0;
+		area = ST7735_HEIGHT;
+	}
+	if (st7735_panel_setScrollArea(inst->st7735_inst, top, area, ST7735_HEIGHT - top - area) != ST7735_STATUS_OK ||
+		st7735_panel_setScrollStart(inst->st7735_inst, top) != ST7735_STATUS_OK) {
+		return STATUS_ERROR;
+	}
+
+	inst->scrollStart = start;
+	inst->scrollLen = len;
+	inst->scrollOffset = 0;
+	inst->isScrollPending = 0;
+
 	return STATUS_OK;
 }
 
 
+int32_t lcd_scroll(lcd_t *inst, int32_t lines) {
+	int32_t offset;
+
+	if (0 == inst->scrollLen) {
+		return STATUS_ERROR;
+	}
+
+	offset = (inst->scrollOffset + lines) % (int32_t) inst->scrollLen;
+	if (offset < 0) {
+		offset += inst->scrollLen;
+	}
+	inst->scrollOffset = offset;
+
+	if (NULL != inst->frameBuffer) {
+		inst->isScrollPending = 1;
+		return STATUS_OK;
+	}
+	return lcd_writeScrollStart(inst);
+}
+
+
+uint16_t lcd_getScrollLine(const lcd_t *inst, uint16_t pos) {
+	if (0 == inst->scrollLen) {
+		return pos;
+	}
+	return inst->scrollStart + (pos + inst->scrollOffset) % inst->scrollLen;
+}
+
+
+int32_t lcd_setPartialArea(lcd_t *inst, uint16_t start, uint16_t len) {
+	uint16_t top;
+
+	if (0 == len) {
+		return st7735_panel_setNormalMode(inst->st7735_inst) == ST7735_STATUS_OK? STATUS_OK : STATUS_ERROR;
+	}
+	if (start + len > ST7735_HEIGHT) {
+		return STATUS_ERROR_PARAM;
+	}
+
+	top = lcd_toMemoryRow(inst, start, len);
+	if (st7735_panel_setPartialArea(inst->st7735_inst, top, top + len - 1) != ST7735_STATUS_OK) {
+		return STATUS_ERROR;
+	}
+
+	return STATUS_OK;
+}
+
+
+void lcd_setGlyphCacheSize(lcd_t *inst, uint32_t size) {
+	free(inst->glyphCache);
+	inst->glyphCache = NULL;
+	inst->glyphCacheSize = size;
+}
+
+
 void lcd_setFont(lcd_t *inst, const GFXfont *newFont) {
 	inst->gfxFont = newFont;
 }
@@ -105,20 +1096,29 @@ void lcd_setTextStroke(lcd_t *inst, uint32_t color, uint32_t bgColor, uint8_t is
 
 
 void lcd_drawPixel(lcd_t *inst, uint16_t x, uint16_t y, uint32_t color) {
-	st7735_setAddress(inst->st7735_inst, x, y, x+1, y+1);
-	st7735_panel_pushColor(inst->st7735_inst, color, 1);
+	if (NULL != inst->frameBuffer) {
+		lcd_fbFill(inst, x, y, 1, 1, color);
+		return;
+	}
+	lcd_fillWindow(inst, x, y, 1, 1, color);
 }
 
 
 void lcd_drawFastVLine(lcd_t *inst, uint16_t x, uint16_t y, uint16_t len, uint32_t color) {
-	st7735_setAddress(inst->st7735_inst, x, y, x, y+len-1);
-	st7735_panel_pushColor(inst->st7735_inst, color, len);
+	if (NULL != inst->frameBuffer) {
+		lcd_fbFill(inst, x, y, 1, len, color);
+		return;
+	}
+	lcd_fillWindow(inst, x, y, 1, len, color);
 }
 
 
 void lcd_drawFastHLine(lcd_t *inst, uint16_t x, uint16_t y, uint16_t len, uint32_t color) {
-	st7735_setAddress(inst->st7735_inst, x, y, x+len-1, y);
-	st7735_panel_pushColor(inst->st7735_inst, color, len);
+	if (NULL != inst->frameBuffer) {
+		lcd_fbFill(inst, x, y, len, 1, color);
+		return;
+	}
+	lcd_fillWindow(inst, x, y, len, 1, color);
 }
 
 
@@ -131,25 +1131,47 @@ void lcd_drawRect(lcd_t *inst, uint16_t x, uint16_t y, uint16_t width, uint16_t
 
 
 void lcd_fillRect(lcd_t *inst, uint16_t x, uint16_t y, uint16_t width, uint16_t height, uint32_t color) {
-	st7735_setAddress(inst->st7735_inst, x, y, x+width-1, y+height-1);
-	st7735_panel_pushColor(inst->st7735_inst, color, width * height);
+	if (NULL != inst->frameBuffer) {
+		lcd_fbFill(inst, x, y, width, height, color);
+		return;
+	}
+	lcd_fillWindow(inst, x, y, width, height, color);
+}
+
+
+void lcd_fillRoundRect(lcd_t *inst, uint16_t x, uint16_t y, uint16_t width, uint16_t height, uint16_t r, uint32_t color) {
+	st7735CmdList_t list;
+	uint8_t buffer[LCD_CMD_BUFFER_SIZE];
+	uint16_t maxR = (width < height? width : height) / 2;
+
+	if (r > maxR) {
+		r = maxR;
+	}
+
+	st7735_cmdListInit(&list, inst->st7735_inst, buffer, sizeof(buffer));
+	lcd_fillSpan(inst, &list, x, y + r, width, height - 2 * r, color);
+	lcd_fillCircleRows(inst, &list, x + r, y + r, r, 0x1, width - 2 * r - 1, color);
+	lcd_fillCircleRows(inst, &list, x + r, y + height - r - 1, r, 0x2, width - 2 * r - 1, color);
+	st7735_cmdListFlush(&list);
 }
 
 
 void lcd_drawCircle(lcd_t *inst, uint16_t x0, uint16_t y0, uint16_t r, uint32_t color) {
+	st7735CmdList_t list;
+	uint8_t buffer[LCD_CMD_BUFFER_SIZE];
 	int16_t f = 1 - r;
 	int16_t ddF_x = 1;
 	int16_t ddF_y = -2 * r;
 	int16_t x = 0;
 	int16_t y = r;
+	int16_t xRun = 0;
 
-	lcd_drawPixel(inst, x0  , y0+r, color);
-	lcd_drawPixel(inst, x0  , y0-r, color);
-	lcd_drawPixel(inst, x0+r, y0  , color);
-	lcd_drawPixel(inst, x0-r, y0  , color);
-
+	/* Points of an octant on the same row are drawn as a run */
+	st7735_cmdListInit(&list, inst->st7735_inst, buffer, sizeof(buffer));
 	while (x<y) {
 		if (f >= 0) {
+		  lcd_drawCircleRun(inst, &list, x0, y0, xRun, x, y, color);
+		  xRun = x + 1;
 		  y--;
 		  ddF_y += 2;
 		  f += ddF_y;
@@ -157,20 +1179,52 @@ void lcd_drawCircle(lcd_t *inst, uint16_t x0, uint16_t y0, uint16_t r, uint32_t
 		x++;
 		ddF_x += 2;
 		f += ddF_x;
+	}
+	lcd_drawCircleRun(inst, &list, x0, y0, xRun, x, y, color);
+	st7735_cmdListFlush(&list);
+}
+
+
+void lcd_fillCircle(lcd_t *inst, uint16_t x0, uint16_t y0, uint16_t r, uint32_t color) {
+	st7735CmdList_t list;
+	uint8_t buffer[LCD_CMD_BUFFER_SIZE];
+
+	st7735_cmdListInit(&list, inst->st7735_inst, buffer, sizeof(buffer));
+	lcd_fillSpan(inst, &list, x0 - r, y0, 2 * r + 1, 1, color);
+	lcd_fillCircleRows(inst, &list, x0, y0, r, 0x3, 0, color);
+	st7735_cmdListFlush(&list);
+}
 
-		lcd_drawPixel(inst, x0 + x, y0 + y, color);
-		lcd_drawPixel(inst, x0 - x, y0 + y, color);
-		lcd_drawPixel(inst, x0 + x, y0 - y, color);
-		lcd_drawPixel(inst, x0 - x, y0 - y, color);
-		lcd_drawPixel(inst, x0 + y, y0 + x, color);
-		lcd_drawPixel(inst, x0 - y, y0 + x, color);
-		lcd_drawPixel(inst, x0 + y, y0 - x, color);
-		lcd_drawPixel(inst, x0 - y, y0 - x, color);
+
+void lcd_drawCircleAA(lcd_t *inst, uint16_t x0, uint16_t y0, uint16_t r, uint32_t color) {
+	uint32_t yFix, alpha;
+	int32_t x, y;
+
+	/* Radius beyond screen would overflow the fixed point */
+	if (NULL == inst->frameBuffer || r > 0xFF) {
+		lcd_drawCircle(inst, x0, y0, r, color);
+		return;
 	}
+
+	/* The circle passes between y and y + 1, shared by their opacity */
+	for (x = 0; ; x++) {
+		yFix = lcd_isqrt(((uint32_t) r * r - x * x) << 16);
+		y = yFix >> 8;
+		if (x > y) {
+			break;
+		}
+		alpha = yFix & 0xFF;
+		lcd_fbBlendCircle(inst, x0, y0, x, y, color, 0xFF - alpha);
+		lcd_fbBlendCircle(inst, x0, y0, x, y + 1, color, alpha);
+	}
+	lcd_markDirtyClipped(inst, x0 - r - 1, y0 - r - 1, 2 * r + 3, 2 * r + 3);
 }
 
 
 void lcd_drawLine(lcd_t *inst, uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint32_t color) {
+	st7735CmdList_t list;
+	uint8_t buffer[LCD_CMD_BUFFER_SIZE];
+	uint16_t xRun;
 	int16_t steep = abs(y1 - y0) > abs(x1 - x0);
 
 	if (steep) {
@@ -196,18 +1250,114 @@ void lcd_drawLine(lcd_t *inst, uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y
 		ystep = -1;
 	}
 
+	/* Pixels on the same row, or column if steep, are drawn as a run */
+	st7735_cmdListInit(&list, inst->st7735_inst, buffer, sizeof(buffer));
+	xRun = x0;
 	for (; x0<=x1; x0++) {
-		if (steep) {
-			lcd_drawPixel(inst, y0, x0, color);
-		} else {
-			lcd_drawPixel(inst, x0, y0, color);
+		err -= dy;
+		if (err < 0 || x0 == x1) {
+			if (steep) {
+				lcd_fillSpan(inst, &list, y0, xRun, 1, x0 - xRun + 1, color);
+			} else {
+				lcd_fillSpan(inst, &list, xRun, y0, x0 - xRun + 1, 1, color);
+			}
+			xRun = x0 + 1;
 		}
-	err -= dy;
 		if (err < 0) {
 			y0 += ystep;
 			err += dx;
 		}
 	}
+	st7735_cmdListFlush(&list);
+}
+
+
+void lcd_drawThickLine(lcd_t *inst, uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t width, uint32_t color) {
+	st7735CmdList_t list;
+	uint8_t buffer[LCD_CMD_BUFFER_SIZE];
+	int32_t x[4], y[4];
+	int32_t dx, dy, len;
+	int32_t ex, ey, nx, ny;
+
+	if (width <= 1) {
+		lcd_drawLine(inst, x0, y0, x1, y1, color);
+		return;
+	}
+	/* Wider than screen either way, and keeps the fixed point in range */
+	if (width > 2 * ST7735_HEIGHT) {
+		width = 2 * ST7735_HEIGHT;
+	}
+
+	st7735_cmdListInit(&list, inst->st7735_inst, buffer, sizeof(buffer));
+	dx = x1 - x0;
+	dy = y1 - y0;
+	if (0 == dx && 0 == dy) {
+		/* A square dot */
+		lcd_fillSpan(inst, &list, x0 - width / 2, y0 - width / 2, width, width, color);
+		st7735_cmdListFlush(&list);
+		return;
+	}
+
+	/* Length in 1/256 pixel, then half a pixel along and half the width across,
+	 * in sub-pixels */
+	len = lcd_isqrt((uint32_t) (dx * dx + dy * dy) << 16);
+	ex = dx * LCD_SUBPIXEL * 128 / len;
+	ey = dy * LCD_SUBPIXEL * 128 / len;
+	nx = -dy * width * LCD_SUBPIXEL * 128 / len;
+	ny = dx * width * LCD_SUBPIXEL * 128 / len;
+
+	x[0] = x0 * LCD_SUBPIXEL + LCD_SUBPIXEL / 2 - ex + nx;
+	y[0] = y0 * LCD_SUBPIXEL + LCD_SUBPIXEL / 2 - ey + ny;
+	x[1] = x1 * LCD_SUBPIXEL + LCD_SUBPIXEL / 2 + ex + nx;
+	y[1] = y1 * LCD_SUBPIXEL + LCD_SUBPIXEL / 2 + ey + ny;
+	x[2] = x1 * LCD_SUBPIXEL + LCD_SUBPIXEL / 2 + ex - nx;
+	y[2] = y1 * LCD_SUBPIXEL + LCD_SUBPIXEL / 2 + ey - ny;
+	x[3] = x0 * LCD_SUBPIXEL + LCD_SUBPIXEL / 2 - ex - nx;
+	y[3] = y0 * LCD_SUBPIXEL + LCD_SUBPIXEL / 2 - ey - ny;
+	lcd_fillPolygonSpans(inst, &list, x, y, 4, color);
+	st7735_cmdListFlush(&list);
+}
+
+
+void lcd_drawLineAA(lcd_t *inst, uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint32_t color) {
+	int32_t a0, b0, a1, b1;
+	int32_t gradient, yFix;
+	int32_t a, b;
+	uint32_t alpha;
+	uint8_t steep;
+
+	if (NULL == inst->frameBuffer) {
+		lcd_drawLine(inst, x0, y0, x1, y1, color);
+		return;
+	}
+
+	/* Along a, the major axis, with b in 16.16 fixed point shared by the two
+	 * pixels it passes between */
+	steep = abs(y1 - y0) > abs(x1 - x0);
+	a0 = steep? y0 : x0;
+	b0 = steep? x0 : y0;
+	a1 = steep? y1 : x1;
+	b1 = steep? x1 : y1;
+	if (a0 > a1) {
+		UTIL_swapInt(a0, a1);
+		UTIL_swapInt(b0, b1);
+	}
+	gradient = a1 > a0? (b1 - b0) * 65536 / (a1 - a0) : 0;
+	yFix = b0 * 65536;
+
+	for (a = a0; a <= a1; a++, yFix += gradient) {
+		b = yFix >> 16;
+		alpha = (yFix >> 8) & 0xFF;
+		if (steep) {
+			lcd_fbBlend(inst, b, a, color, 0xFF - alpha);
+			lcd_fbBlend(inst, b + 1, a, color, alpha);
+		} else {
+			lcd_fbBlend(inst, a, b, color, 0xFF - alpha);
+			lcd_fbBlend(inst, a, b + 1, color, alpha);
+		}
+	}
+
+	lcd_markDirtyClipped(inst, x0 < x1? x0 : x1, y0 < y1? y0 : y1, abs(x1 - x0) + 2, abs(y1 - y0) + 2);
 }
 
 
@@ -221,8 +1371,47 @@ void lcd_drawPolygon(lcd_t *inst, const uint16_t* x, const uint16_t* y, uint32_t
 }
 
 
+void lcd_fillPolygon(lcd_t *inst, const uint16_t* x, const uint16_t* y, uint32_t count, uint32_t color) {
+	st7735CmdList_t list;
+	uint8_t buffer[LCD_CMD_BUFFER_SIZE];
+	int32_t xSub[LCD_POLYGON_VERTEX_MAX];
+	int32_t ySub[LCD_POLYGON_VERTEX_MAX];
+	uint32_t i;
+
+	if (count < 3 || count > LCD_POLYGON_VERTEX_MAX) {
+		return;
+	}
+
+	/* Vertices at pixel centers */
+	for (i = 0; i < count; i++) {
+		xSub[i] = x[i] * LCD_SUBPIXEL + LCD_SUBPIXEL / 2;
+		ySub[i] = y[i] * LCD_SUBPIXEL + LCD_SUBPIXEL / 2;
+	}
+	st7735_cmdListInit(&list, inst->st7735_inst, buffer, sizeof(buffer));
+	lcd_fillPolygonSpans(inst, &list, xSub, ySub, count, color);
+	st7735_cmdListFlush(&list);
+}
+
+
+void lcd_fillTriangle(lcd_t *inst, uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2, uint32_t color) {
+	const uint16_t x[] = {x0, x1, x2};
+	const uint16_t y[] = {y0, y1, y2};
+
+	lcd_fillPolygon(inst, x, y, 3, color);
+}
+
+
 void lcd_drawChar(lcd_t *inst, uint16_t x, uint16_t y, char c) {
-	uint8_t i, j;
+	st7735CmdList_t list;
+	uint8_t buffer[LCD_CMD_BUFFER_SIZE];
+	uint8_t i, j, k;
+	uint8_t isOpaque;
+	int32_t s, row;
+
+	/* All pixels of a char are recorded into a single command list, as runs
+	 * of the same color */
+	st7735_cmdListInit(&list, inst->st7735_inst, buffer, sizeof(buffer));
+	s = inst->textSize;
 
 	if (NULL == inst->gfxFont) {
 		/* 'Classic' built-in font */
@@ -234,23 +1423,37 @@ void lcd_drawChar(lcd_t *inst, uint16_t x, uint16_t y, char c) {
 
 //		if(!_cp437 && (c >= 176)) c++; // Handle 'classic' charset behavior
 
+		isOpaque = inst->isBgOpaque && (inst->bgColor != inst->textColor);
+		if (isOpaque && lcd_blitText(inst, x, y, &c, 1)) {
+			return;
+		}
+		if (isOpaque && NULL == inst->frameBuffer &&
+			x + 6 * s <= (int32_t) inst->width && y + 8 * s <= (int32_t) inst->height) {
+			/* Without cache, the whole cell as a single window, row by row */
+			st7735_cmdListSetWindow(&list, x, y, x + 6 * s - 1, y + 8 * s - 1);
+			for (row = 0; row < 8 * s; row++) {
+				for (i = 0; i < 6; i++) {
+					uint8_t line = i < 5? pgm_read_byte(font + ((uint8_t) c * 5) + i) : 0x0;
+					st7735_cmdListPushColor(&list, (line >> (row / s)) & 0x1? inst->textColor : inst->bgColor, s);
+				}
+			}
+			st7735_cmdListFlush(&list);
+			return;
+		}
+
+		/* Vertical runs of each column, clipped to screen */
 		for (i = 0; i < 6; i++) {
 			uint8_t line;
 			if (i < 5)
-				line = pgm_read_byte(font + (c*5)+i);
+				line = pgm_read_byte(font + ((uint8_t) c * 5) + i);
 			else
 				line = 0x0;
-			for (j = 0; j < 8; j++, line >>= 1) {
-				if (line & 0x1) {
-					if(inst->textSize == 1)
-						lcd_drawPixel(inst, x+i, y+j, inst->textColor);
-					else
-						lcd_fillRect(inst, x+(i*inst->textSize), y+(j*inst->textSize), inst->textSize, inst->textSize, inst->textColor);
-				} else if(inst->isBgOpaque && (inst->bgColor != inst->textColor)) {
-					if (inst->textSize == 1)
-						lcd_drawPixel(inst, x+i, y+j, inst->bgColor);
-					else
-						lcd_fillRect(inst, x+i*inst->textSize, y+j*inst->textSize, inst->textSize, inst->textSize, inst->bgColor);
+			for (j = 0; j < 8; j = k) {
+				for (k = j + 1; k < 8 && ((line >> k) & 0x1) == ((line >> j) & 0x1); k++);
+				if ((line >> j) & 0x1) {
+					lcd_fillSpan(inst, &list, x + i * s, y + j * s, s, (k - j) * s, inst->textColor);
+				} else if (isOpaque) {
+					lcd_fillSpan(inst, &list, x + i * s, y + j * s, s, (k - j) * s, inst->bgColor);
 				}
 			}
 		}
@@ -261,8 +1464,8 @@ void lcd_drawChar(lcd_t *inst, uint16_t x, uint16_t y, char c) {
 		// directly with 'bad' characters of font may cause mayhem!
 
 		c -= pgm_read_byte(&inst->gfxFont->first);
-		GFXglyph *glyph  = &(((GFXglyph *) (&inst->gfxFont->glyph))[(uint8_t)c]);
-		uint8_t  *bitmap = (uint8_t *) (&inst->gfxFont->bitmap);
+		GFXglyph *glyph  = &inst->gfxFont->glyph[(uint8_t)c];
+		uint8_t  *bitmap = inst->gfxFont->bitmap;
 
 		uint16_t bo = pgm_read_word(&glyph->bitmapOffset);
 		uint8_t  w  = pgm_read_byte(&glyph->width),
@@ -271,15 +1474,9 @@ void lcd_drawChar(lcd_t *inst, uint16_t x, uint16_t y, char c) {
 		int8_t   xo = pgm_read_byte(&glyph->xOffset),
 			 yo = pgm_read_byte(&glyph->yOffset);
 		uint8_t  xx, yy, bits, bit;
-		int16_t  xo16, yo16;
-
-		bits = bit = xo16 = yo16 = 0;
-		if(inst->textSize > 1) {
-			xo16 = xo;
-			yo16 = yo;
-		}
+		int16_t  xRun;
 
-		// Todo: Add character clipping here
+		bits = bit = 0;
 
 		// NOTE: THERE IS NO 'BACKGROUND' COLOR OPTION ON CUSTOM FONTS.
 		// THIS IS ON PURPOSE AND BY DESIGN.  The background color feature
@@ -297,23 +1494,45 @@ void lcd_drawChar(lcd_t *inst, uint16_t x, uint16_t y, char c) {
 		// displays supporting setAddrWindow() and pushColors()), but haven't
 		// implemented this yet.
 
+		/* Horizontal runs of each row, clipped to screen */
 		for(yy=0; yy<h; yy++) {
+			xRun = -1;
 			for(xx=0; xx<w; xx++) {
 				if(!(bit++ & 7)) {
 					bits = pgm_read_byte(&bitmap[bo++]);
 				}
 				if(bits & 0x80) {
-					if(inst->textSize == 1) {
-						lcd_drawPixel(inst, x+xo+xx, y+yo+yy, inst->textColor);
-					} else {
-						lcd_fillRect(inst, x+(xo16+xx)*inst->textSize, y+(yo16+yy)*inst->textSize, inst->textSize, inst->textSize, inst->textColor);
+					if (xRun < 0) {
+						xRun = xx;
 					}
+				} else if (xRun >= 0) {
+					lcd_fillSpan(inst, &list, x + (xo + xRun) * s, y + (yo + yy) * s, (xx - xRun) * s, s, inst->textColor);
+					xRun = -1;
 				}
 				bits <<= 1;
 			}
+			if (xRun >= 0) {
+				lcd_fillSpan(inst, &list, x + (xo + xRun) * s, y + (yo + yy) * s, (w - xRun) * s, s, inst->textColor);
+			}
 		}
 
 	} // End classic vs custom font
+
+	st7735_cmdListFlush(&list);
+}
+
+
+/**
+ * @brief Draw chars of classic font on a line, from glyph cache if possible.
+ */
+static void lcd_writeLine(lcd_t *inst, uint16_t x, uint16_t y, const char *str, uint32_t n) {
+	uint32_t i;
+
+	if (!lcd_blitText(inst, x, y, str, n)) {
+		for (i = 0; i < n; i++) {
+			lcd_drawChar(inst, x + i * 6 * inst->textSize, y, str[i]);
+		}
+	}
 }
 
 
@@ -322,29 +1541,48 @@ uint32_t lcd_writeText(lcd_t *inst, uint16_t x, uint16_t y, char* str, int32_t c
 	char c;
 	uint16_t cursor_x, cursor_y;
 	const GFXfont *gfxFont;
+	char line[LCD_TEXT_LINE_MAX];
+	uint32_t nLine;
+	uint16_t lineX, lineY;
 
 	cursor_x = x;
 	cursor_y = y;
 	if (NULL == inst->gfxFont) { // 'Classic' built-in font
+		/* Chars are collected into lines, each drawn at once */
+		nLine = 0;
+		lineX = lineY = 0;
 		c = *str++;
 		while (c != '\0' && !(count > 0 && numChar >= count)) {
 			if (c == '\n') {
+				lcd_writeLine(inst, lineX, lineY, line, nLine);
+				nLine = 0;
 				cursor_y += inst->textSize * 8;
 				cursor_x  = x;
 			} else if(c == '\r') {
 				// skip em
 			} else {
 			  if(inst->isWrap && ((cursor_x + inst->textSize * 6) > inst->width)) { // Heading off edge?
+				  lcd_writeLine(inst, lineX, lineY, line, nLine);
+				  nLine = 0;
 				  cursor_x  = x;            // Reset x to zero
 				  cursor_y += inst->textSize * 8; // Advance y one line
 			  }
-			  lcd_drawChar(inst, cursor_x, cursor_y, c);
+			  if (LCD_TEXT_LINE_MAX == nLine) {
+				  lcd_writeLine(inst, lineX, lineY, line, nLine);
+				  nLine = 0;
+			  }
+			  if (0 == nLine) {
+				  lineX = cursor_x;
+				  lineY = cursor_y;
+			  }
+			  line[nLine++] = c;
 			  cursor_x += inst->textSize * 6;
 			}
 
 			numChar++;
 			c = *str++;
 		}
+		lcd_writeLine(inst, lineX, lineY, line, nLine);
 
 	} else { // Custom font
 		gfxFont = inst->gfxFont;
@@ -360,7 +1598,7 @@ uint32_t lcd_writeText(lcd_t *inst, uint16_t x, uint16_t y, char* str, int32_t c
 				uint8_t first = pgm_read_byte(&gfxFont->first);
 				if ((c >= first) && (c <= (uint8_t)pgm_read_byte(&gfxFont->last))) {
 					uint8_t   c2    = c - pgm_read_byte(&gfxFont->first);
-					GFXglyph *glyph = &(((GFXglyph *)(&gfxFont->glyph))[c2]);
+					GFXglyph *glyph = &gfxFont->glyph[c2];
 					uint8_t   w     = pgm_read_byte(&glyph->width),
 							  h     = pgm_read_byte(&glyph->height);
 					if ((w > 0) && (h > 0)) { // Is there an associated bitmap?
@@ -518,7 +1756,7 @@ uint32_t lcd_getTextBound(lcd_t *inst, uint16_t x, uint16_t y, char* str, int32_
 	    		   && (c >= first) && (c <= last)	// Char present in current font
 				   ) {
 					c    -= first;
-					glyph = &(((GFXglyph *)(&gfxFont->glyph))[c]);
+					glyph = &gfxFont->glyph[c];
 					gw    = pgm_read_byte(&glyph->width);
 					gh    = pgm_read_byte(&glyph->height);
 					xa    = pgm_read_byte(&glyph->xAdvance);
@@ -591,6 +1829,144 @@ uint32_t lcd_getTextBound(lcd_t *inst, uint16_t x, uint16_t y, char* str, int32_
 
 
 void lcd_drawBitmap(lcd_t *inst, uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint32_t* color) {
+	uint32_t i = 0, j;
+
+	if (NULL != inst->frameBuffer) {
+		if (x >= inst->width || y >= inst->height || 0 == w || 0 == h) {
+			return;
+		}
+		for (j = 0; j < h && y + j < inst->height; j++) {
+			for (i = 0; i < w && x + i < inst->width; i++) {
+				lcd_toValue(inst->fbFmt, color[j * w + i], lcd_fbPixel(inst, x + i, y + j));
+			}
+		}
+		lcd_markDirty(inst, x, y, x + i - 1, y + j - 1);
+		return;
+	}
+
 	st7735_setAddress(inst->st7735_inst, x, y, x+w-1, y+h-1);
 	st7735_panel_pushColorArray(inst->st7735_inst, color, w * h);
 }
+
+
+int32_t lcd_drawBitmapFile(lcd_t *inst, uint16_t x, uint16_t y, const char *filename) {
+	bitmapReader_t *pReader;
+	uint8_t buffer[LCD_BITMAP_BUFFER_SIZE];
+	lcdRect_t rect;
+	uint32_t fmt;
+	uint32_t w, h;
+	uint32_t nRow;
+	uint32_t done;
+	uint32_t index;
+	int32_t n;
+	int32_t status;
+
+	if (x >= inst->width || y >= inst->height) {
+		return STATUS_ERROR_PARAM;
+	}
+
+	status = bitmap_readerOpen(&pReader, filename);
+	if (STATUS_OK != status) {
+		return status;
+	}
+
+	/* Clip to screen */
+	w = bitmap_readerGetWidth(pReader);
+	h = bitmap_readerGetHeight(pReader);
+	if (w > inst->width - x) {
+		w = inst->width - x;
+		bitmap_readerSetColumns(pReader, 0, w);
+	}
+	if (h > inst->height - y) {
+		h = inst->height - y;
+	}
+
+	fmt = lcd_getPixelFmt(inst);
+
+	/* With 12-bit color, 2 pixels share a byte, so each part must hold an even
+	 * number of pixels to continue the previous part. */
+	nRow = sizeof(buffer) / BITMAP_getPackedSize(fmt, w);
+	if (BITMAP_PIXEL_FMT_RGB444 == fmt && (w & 1)) {
+		nRow &= ~1u;
+	}
+
+	rect.x0 = x;
+	rect.y0 = y;
+	rect.x1 = x + w - 1;
+	rect.y1 = y + h - 1;
+	index = 0;
+	if (NULL != inst->frameBuffer) {
+		lcd_markDirty(inst, rect.x0, rect.y0, rect.x1, rect.y1);
+	} else {
+		st7735_setAddress(inst->st7735_inst, rect.x0, rect.y0, rect.x1, rect.y1);
+	}
+	for (done = 0; done < h; done += n) {
+		n = bitmap_readRows(pReader, buffer, nRow < h - done? nRow : h - done, fmt);
+		if (n <= 0) {
+			status = STATUS_ERROR;
+			break;
+		}
+
+		if (NULL != inst->frameBuffer) {
+			lcd_fbWritePacked(inst, &rect, &index, buffer, BITMAP_getPackedSize(fmt, n * w));
+		} else if (0 == done) {
+			st7735_panel_writePixels(inst->st7735_inst, buffer, BITMAP_getPackedSize(fmt, n * w));
+		} else {
+			st7735_writeData(inst->st7735_inst, buffer, BITMAP_getPackedSize(fmt, n * w));
+		}
+	}
+	bitmap_readerClose(&pReader);
+
+	return status;
+}
+
+
+int32_t lcd_drawSprite(lcd_t *inst, uint16_t x, uint16_t y, const spriteSheet_t *sheet, uint32_t idx) {
+	const spriteEntry_t *entry;
+	spriteDecoder_t dec;
+	uint8_t buffer[LCD_SPRITE_BUFFER_SIZE];
+	lcdRect_t rect;
+	uint32_t size;
+	uint32_t index;
+	uint8_t isFirst;
+
+	entry = sprite_getEntry(sheet, idx);
+	if (NULL == entry || 0 == entry->width || 0 == entry->height ||
+		x + entry->width > inst->width || y + entry->height > inst->height ||
+		sheet->header->fmt != lcd_getPixelFmt(inst)) {
+		return STATUS_ERROR_PARAM;
+	}
+
+	rect.x0 = x;
+	rect.y0 = y;
+	rect.x1 = x + entry->width - 1;
+	rect.y1 = y + entry->height - 1;
+	if (NULL != inst->frameBuffer) {
+		index = 0;
+		if (SPRITE_ENC_RAW == entry->encoding) {
+			lcd_fbWritePacked(inst, &rect, &index, sheet->base + entry->offset, entry->size);
+		} else {
+			sprite_decoderInit(&dec, sheet, idx);
+			while ((size = sprite_decode(&dec, buffer, sizeof(buffer))) > 0) {
+				lcd_fbWritePacked(inst, &rect, &index, buffer, size);
+			}
+		}
+		lcd_markDirty(inst, rect.x0, rect.y0, rect.x1, rect.y1);
+		return STATUS_OK;
+	}
+
+	st7735_setAddress(inst->st7735_inst, rect.x0, rect.y0, rect.x1, rect.y1);
+	if (SPRITE_ENC_RAW == entry->encoding) {
+		/* Already the bytes the panel expects */
+		st7735_panel_writePixels(inst->st7735_inst, sheet->base + entry->offset, entry->size);
+		return STATUS_OK;
+	}
+
+	sprite_decoderInit(&dec, sheet, idx);
+	isFirst = 1;
+	while ((size = sprite_decode(&dec, buffer, sizeof(buffer))) > 0) {
+		lcd_writePart(inst, buffer, size, &isFirst);
+	}
+
+	return STATUS_OK;
+}
@@ -0,0 +1,270 @@
+/*
+ * lcdpresenter.c
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: chiong
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <pthread.h>
+#include <time.h>
+#include "util/status.h"
+#include "module/st7735-lcd/lcdpresenter.h"
+
+struct lcdPresenter_s {
+	/* Read-only after create. */
+	lcd_t *lcd;
+	uint64_t periodNs;
+	uint8_t isDropLate;
+	lcdPresenterCallback_t onFrame;
+	void *arg;
+
+	/* Frame buffer not drawn into, i.e. the frame presented last. */
+	uint8_t *front;
+	/* Dirty rectangles of front still to be written. */
+	uint8_t nDirty;
+	lcdRect_t dirty[LCD_DIRTY_RECT_MAX];
+
+	/* Flush thread only. Earliest start of the next frame. */
+	uint64_t nextNs;
+
+	/* Accessed by both threads, with mutex held. */
+	uint8_t isPending;
+	uint8_t isStop;
+	uint8_t isThread;
+	lcdPresenterStats_t stats;
+	pthread_mutex_t mutex;
+	/* Signalled when a frame is presented or the thread is to stop. */
+	pthread_cond_t frameCond;
+	/* Signalled when a frame is on panel. */
+	pthread_cond_t doneCond;
+	pthread_t thread;
+};
+
+static uint64_t lcdpresenter_nowNs(void) {
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t) ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static void lcdpresenter_sleepNs(uint64_t ns) {
+	struct timespec ts;
+
+	ts.tv_sec = ns / 1000000000ull;
+	ts.tv_nsec = ns % 1000000000ull;
+	while (nanosleep(&ts, &ts) != 0 && EINTR == errno) {
+	}
+}
+
+/**
+ * @brief Copy a rectangle between two frame buffers laid out as that of lcd.
+ */
+static void lcdpresenter_copyRect(const lcd_t *lcd, uint8_t *dst, const uint8_t *src, const lcdRect_t *rect) {
+	uint32_t rowSize;
+	uint32_t offset;
+	uint32_t y;
+
+	rowSize = (rect->x1 - rect->x0 + 1) * lcd->fbPixelSize;
+	for (y = rect->y0; y <= rect->y1; y++) {
+		offset = (y * lcd->width + rect->x0) * lcd->fbPixelSize;
+		memcpy(dst + offset, src + offset, rowSize);
+	}
+}
+
+/**
+ * @brief Write a frame to panel, at the start of the next period if paced.
+ * @return Status of lcd_flushFrame().
+ */
+static int32_t lcdpresenter_writeFrame(lcdPresenter_t *pSelf, uint32_t *flushUs) {
+	uint64_t start;
+	int32_t status;
+
+	start = lcdpresenter_nowNs();
+	if (pSelf->periodNs > 0) {
+		if (start < pSelf->nextNs) {
+			lcdpresenter_sleepNs(pSelf->nextNs - start);
+			start = pSelf->nextNs;
+		}
+		/* Late frames push the next period back rather than being caught up */
+		pSelf->nextNs = start + pSelf->periodNs;
+	}
+
+	start = lcdpresenter_nowNs();
+	status = lcd_flushFrame(pSelf->lcd, pSelf->front, pSelf->dirty, pSelf->nDirty);
+	*flushUs = (uint32_t) ((lcdpresenter_nowNs() - start) / 1000);
+
+	return status;
+}
+
+static void* lcdpresenter_flushThread(void *arg) {
+	lcdPresenter_t *pSelf = (lcdPresenter_t*) arg;
+	lcdPresenterStats_t *stats = &pSelf->stats;
+	uint32_t flushUs;
+	uint32_t frame;
+	int32_t status;
+
+	pthread_mutex_lock(&pSelf->mutex);
+	for (;;) {
+		/* Frames presented before stop are written first */
+		while (!pSelf->isPending && !pSelf->isStop) {
+			pthread_cond_wait(&pSelf->frameCond, &pSelf->mutex);
+		}
+		if (!pSelf->isPending) {
+			break;
+		}
+
+		/* front and its dirty rectangles are left alone by present() until done */
+		pthread_mutex_unlock(&pSelf->mutex);
+		status = lcdpresenter_writeFrame(pSelf, &flushUs);
+		pthread_mutex_lock(&pSelf->mutex);
+
+		if (STATUS_OK != status) {
+			stats->nError++;
+		}
+		if (pSelf->periodNs > 0 && (uint64_t) flushUs * 1000 > pSelf->periodNs) {
+			stats->nLate++;
+		}
+		stats->lastFlushUs = flushUs;
+		if (flushUs > stats->maxFlushUs) {
+			stats->maxFlushUs = flushUs;
+		}
+		frame = stats->nFrame++;
+		pSelf->isPending = 0;
+		pthread_cond_broadcast(&pSelf->doneCond);
+
+		if (NULL != pSelf->onFrame) {
+			/* Without lock, so that the application is not held up meanwhile */
+			pthread_mutex_unlock(&pSelf->mutex);
+			pSelf->onFrame(pSelf->arg, frame);
+			pthread_mutex_lock(&pSelf->mutex);
+		}
+	}
+	pthread_mutex_unlock(&pSelf->mutex);
+
+	return NULL;
+}
+
+int32_t lcdpresenter_create(lcdPresenter_t **ppSelf, lcd_t *lcd, const lcdPresenterCfg_t *cfg) {
+	lcdPresenter_t *pSelf;
+	uint32_t size;
+	int32_t status;
+
+	if (NULL == lcd->frameBuffer) {
+		status = lcd_enableFrameBuffer(lcd);
+		if (STATUS_OK != status) {
+			return status;
+		}
+	}
+
+	pSelf = (lcdPresenter_t*) calloc(1, sizeof(lcdPresenter_t));
+	if (NULL == pSelf) {
+		return STATUS_ERROR_MALLOC;
+	}
+	pSelf->lcd = lcd;
+	pSelf->periodNs = (uint64_t) cfg->periodUs * 1000ull;
+	pSelf->isDropLate = cfg->isDropLate;
+	pSelf->onFrame = cfg->onFrame;
+	pSelf->arg = cfg->arg;
+	pthread_mutex_init(&pSelf->mutex, NULL);
+	pthread_cond_init(&pSelf->frameCond, NULL);
+	pthread_cond_init(&pSelf->doneCond, NULL);
+
+	/* Both frame buffers start with the same frame */
+	size = ST7735_WIDTH * ST7735_HEIGHT * lcd->fbPixelSize;
+	pSelf->front = (uint8_t*) malloc(size);
+	if (NULL == pSelf->front) {
+		lcdpresenter_destroy(&pSelf);
+		return STATUS_ERROR_MALLOC;
+	}
+	memcpy(pSelf->front, lcd->frameBuffer, size);
+
+	if (pthread_create(&pSelf->thread, NULL, lcdpresenter_flushThread, pSelf) != 0) {
+		lcdpresenter_destroy(&pSelf);
+		return STATUS_ERROR;
+	}
+	pSelf->isThread = 1;
+
+	*ppSelf = pSelf;
+	return STATUS_OK;
+}
+
+void lcdpresenter_destroy(lcdPresenter_t **ppSelf) {
+	lcdPresenter_t *pSelf = *ppSelf;
+
+	if (NULL != pSelf) {
+		if (pSelf->isThread) {
+			pthread_mutex_lock(&pSelf->mutex);
+			pSelf->isStop = 1;
+			pthread_cond_signal(&pSelf->frameCond);
+			pthread_mutex_unlock(&pSelf->mutex);
+			pthread_join(pSelf->thread, NULL);
+		}
+
+		/* The frame buffer drawn into stays with lcd */
+		free(pSelf->front);
+		pthread_cond_destroy(&pSelf->doneCond);
+		pthread_cond_destroy(&pSelf->frameCond);
+		pthread_mutex_destroy(&pSelf->mutex);
+
+		free(pSelf);
+		*ppSelf = NULL;
+	}
+}
+
+int32_t lcdpresenter_present(lcdPresenter_t *pSelf) {
+	lcd_t *lcd = pSelf->lcd;
+	uint8_t *drawn;
+	uint32_t i;
+
+	pthread_mutex_lock(&pSelf->mutex);
+	pSelf->stats.nPresent++;
+	if (pSelf->isPending) {
+		if (pSelf->isDropLate) {
+			/* Changes stay dirty in the frame buffer drawn into */
+			pSelf->stats.nDrop++;
+			pthread_mutex_unlock(&pSelf->mutex);
+			return STATUS_ERROR;
+		}
+		pSelf->stats.nWait++;
+		while (pSelf->isPending) {
+			pthread_cond_wait(&pSelf->doneCond, &pSelf->mutex);
+		}
+	}
+
+	/* Swap frame buffers and hand the dirty rectangles over */
+	drawn = lcd->frameBuffer;
+	lcd->frameBuffer = pSelf->front;
+	pSelf->front = drawn;
+	pSelf->nDirty = lcd->nDirty;
+	memcpy(pSelf->dirty, lcd->dirty, lcd->nDirty * sizeof(lcdRect_t));
+	lcd->nDirty = 0;
+
+	pSelf->isPending = 1;
+	pthread_cond_signal(&pSelf->frameCond);
+	pthread_mutex_unlock(&pSelf->mutex);
+
+	/* Bring the other frame buffer up to the frame presented. Both threads only
+	 * read front meanwhile. */
+	for (i = 0; i < pSelf->nDirty; i++) {
+		lcdpresenter_copyRect(lcd, lcd->frameBuffer, pSelf->front, &pSelf->dirty[i]);
+	}
+
+	return STATUS_OK;
+}
+
+void lcdpresenter_wait(lcdPresenter_t *pSelf) {
+	pthread_mutex_lock(&pSelf->mutex);
+	while (pSelf->isPending) {
+		pthread_cond_wait(&pSelf->doneCond, &pSelf->mutex);
+	}
+	pthread_mutex_unlock(&pSelf->mutex);
+}
+
+void lcdpresenter_getStats(lcdPresenter_t *pSelf, lcdPresenterStats_t *stats) {
+	pthread_mutex_lock(&pSelf->mutex);
+	*stats = pSelf->stats;
+	pthread_mutex_unlock(&pSelf->mutex);
+}
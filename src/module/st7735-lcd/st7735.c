@@ -6,6 +6,7 @@
  */
 
 #include <stdlib.h>
+#include <string.h>
 #include "util/bit.h"
 #include "hw/spi.h"
 #include "hw/gpio.h"
@@ -115,7 +116,7 @@ static const uint8_t dataB[] = {	/* Initialisation commands for ST7735B panel */
  * @param[in] inst ST7735 handle.
  * @param[in] data Array of initialisation command + data.
  */
-st7735_status_t st7735_initModel(st7735_t *inst, const uint8_t *data, fxnDelay_t delayFxn);
+st7735_status_t st7735_initModel(st7735_t *inst, const uint8_t *data, fxnDelay_t delayFxn, st7735_color_t colorFmt);
 
 
 st7735_status_t st7735_create(st7735_t **inst, const st7735Cfg_t *cfg) {
@@ -133,7 +134,8 @@ st7735_status_t st7735_create(st7735_t **inst, const st7735Cfg_t *cfg) {
 
     switch(cfg->model) {
         case ST7735_MODEL_B:
-            status = st7735_initModel(pInst, dataB, cfg->delayMs);
+            status = st7735_initModel(pInst, dataB, cfg->delayMs,
+                    0 != cfg->colorFmt? cfg->colorFmt : ST7735_PANEL_COLOR_18_BIT);
             break;
 
         case ST7735_MODEL_R:
@@ -148,7 +150,7 @@ st7735_status_t st7735_create(st7735_t **inst, const st7735Cfg_t *cfg) {
 }
 
 
-st7735_status_t st7735_initModel(st7735_t *inst, const uint8_t *data, fxnDelay_t delayFxn) {
+st7735_status_t st7735_initModel(st7735_t *inst, const uint8_t *data, fxnDelay_t delayFxn, st7735_color_t colorFmt) {
 	uint8_t ncmd;
 	uint8_t narg;
 	uint8_t delay;
@@ -165,14 +167,17 @@ st7735_status_t st7735_initModel(st7735_t *inst, const uint8_t *data, fxnDelay_t
 		st7735_writeData(inst, p, narg);
 		p += narg;
 
-		if (hasDelay && delayFxn) {
+		/* Delay byte is skipped even without delay function */
+		if (hasDelay) {
 			delay = *p++;
-			delayFxn(delay);
+			if (NULL != delayFxn) {
+				delayFxn(delay);
+			}
 		}
 	}
 
     st7735_panel_setOrientation(inst, ST7735_PANEL_ORIENT_NORMAL);
-    st7735_panel_setColorFmt(inst, ST7735_PANEL_COLOR_18_BIT);
+    st7735_panel_setColorFmt(inst, colorFmt);
 
     return ST7735_STATUS_OK;
 }
@@ -256,77 +261,436 @@ st7735_status_t st7735_panel_setColorFmt(st7735_t *inst, const st7735_color_t ne
 }
 
 
+st7735_color_t st7735_panel_getColorFmt(const st7735_t *inst) {
+    return inst->colorFmt;
+}
+
+
+st7735_status_t st7735_panel_writePixels(const st7735_t *inst, const uint8_t *data, uint32_t size) {
+    st7735_status_t status;
+
+    status = st7735_writeCommand(inst, ST7735_CMD_RAMWR);
+    if (ST7735_STATUS_OK == status) {
+        status = st7735_writeData(inst, data, size);
+    }
+
+    return status;
+}
+
+
+st7735_status_t st7735_panel_setScrollArea(const st7735_t *inst, uint16_t top, uint16_t scroll, uint16_t bottom) {
+    st7735_status_t status;
+    uint8_t buffer[6];
+
+    /* Frame memory of 128 x 160 as used by this driver */
+    if (top + scroll + bottom != ST7735_HEIGHT) {
+        return ST7735_STATUS_ERROR;
+    }
+
+    buffer[0] = (top >> 8) & 0xFF;
+    buffer[1] = top & 0xFF;
+    buffer[2] = (scroll >> 8) & 0xFF;
+    buffer[3] = scroll & 0xFF;
+    buffer[4] = (bottom >> 8) & 0xFF;
+    buffer[5] = bottom & 0xFF;
+    status = st7735_writeCommand(inst, ST7735_CMD_SCRLAR);
+    if (ST7735_STATUS_OK == status) {
+        status = st7735_writeData(inst, buffer, 6);
+    }
+
+    return status;
+}
+
+
+st7735_status_t st7735_panel_setScrollStart(const st7735_t *inst, uint16_t row) {
+    st7735_status_t status;
+    uint8_t buffer[2];
+
+    if (row >= ST7735_HEIGHT) {
+        return ST7735_STATUS_ERROR;
+    }
+
+    buffer[0] = (row >> 8) & 0xFF;
+    buffer[1] = row & 0xFF;
+    status = st7735_writeCommand(inst, ST7735_CMD_VSCSAD);
+    if (ST7735_STATUS_OK == status) {
+        status = st7735_writeData(inst, buffer, 2);
+    }
+
+    return status;
+}
+
+
+st7735_status_t st7735_panel_setPartialArea(const st7735_t *inst, uint16_t startRow, uint16_t endRow) {
+    st7735_status_t status;
+    uint8_t buffer[4];
+
+    if (startRow > endRow || endRow >= ST7735_HEIGHT) {
+        return ST7735_STATUS_ERROR;
+    }
+
+    buffer[0] = (startRow >> 8) & 0xFF;
+    buffer[1] = startRow & 0xFF;
+    buffer[2] = (endRow >> 8) & 0xFF;
+    buffer[3] = endRow & 0xFF;
+    status = st7735_writeCommand(inst, ST7735_CMD_PTLAR);
+    if (ST7735_STATUS_OK == status) {
+        status = st7735_writeData(inst, buffer, 4);
+    }
+    if (ST7735_STATUS_OK == status) {
+        status = st7735_writeCommand(inst, ST7735_CMD_PTLON);
+    }
+
+    return status;
+}
+
+
+st7735_status_t st7735_panel_setNormalMode(const st7735_t *inst) {
+    return st7735_writeCommand(inst, ST7735_CMD_NORON);
+}
+
+
 st7735_status_t st7735_panel_pushColorArray(const st7735_t *inst, uint32_t *color, uint32_t count) {
-	uint8_t buffer[3];
-	uint32_t i;
-	uint16_t color16;
-	st7735_status_t status;
-
-	status = st7735_writeCommand(inst, ST7735_CMD_RAMWR);
-	if (ST7735_STATUS_OK == status) {
-		switch(inst->colorFmt) {
-		case ST7735_PANEL_COLOR_12_BIT:
-			/* Not supported yet */
-			break;
-		case ST7735_PANEL_COLOR_16_BIT:
-			for (i = 0; i < count; i++) {
-				color16 = ST7735_rgb565((color[i] >> 16) & 0xFF, (color[i] >> 8) & 0xFF, color[i] & 0xFF);
-				buffer[0] = color16 >> 8;
-				buffer[1] = color16 & 0xFF;
-				status = st7735_writeData(inst, buffer, 2);
-			}
-			break;
-
-		case ST7735_PANEL_COLOR_18_BIT:
-			for (i = 0; i < count; i++) {
-				buffer[0] = (color[i] >> 16) & 0xFF;
-				buffer[1] = (color[i] >>  8) & 0xFF;
-				buffer[2] = (color[i]      ) & 0xFF;
-				status = st7735_writeData(inst, buffer, 3);
-			}
-			break;
-		default:
-			/* Do nothing */
-			break;
-		}
-	}
+    uint8_t buffer[ST7735_PUSH_BUFFER_SIZE];
+    uint32_t n, nMax, size;
+    st7735_status_t status;
+
+    status = st7735_writeCommand(inst, ST7735_CMD_RAMWR);
+
+    /* Even number of pixels per burst, so 12-bit pairs are not split */
+    nMax = ST7735_PUSH_BUFFER_SIZE * 2 / ST7735_getPackedSize(inst->colorFmt, 2);
+    while (ST7735_STATUS_OK == status && count > 0) {
+        n = count < nMax? count : nMax;
+        size = st7735_packColors(inst->colorFmt, buffer, color, n);
+        if (0 == size) {
+            break;
+        }
+        status = st7735_writeData(inst, buffer, size);
+        color += n;
+        count -= n;
+    }
 
-	return status;
+    return status;
 }
 
 
 st7735_status_t st7735_panel_pushColor(const st7735_t *inst, uint32_t color, uint32_t times) {
-    st7735_status_t status = ST7735_STATUS_ERROR;
-    uint8_t buffer[3];
+    st7735CmdList_t list;
+    uint8_t buffer[ST7735_PUSH_BUFFER_SIZE];
+
+    st7735_cmdListInit(&list, inst, buffer, sizeof(buffer));
+    st7735_cmdListCommand(&list, ST7735_CMD_RAMWR, NULL, 0);
+    st7735_cmdListPushColor(&list, color, times);
+
+    return st7735_cmdListFlush(&list);
+}
+
+
+uint32_t st7735_packColors(st7735_color_t fmt, uint8_t *dst, const uint32_t *color, uint32_t count) {
+    uint16_t c0, c1;
+    uint32_t i;
+
+    switch(fmt) {
+        case ST7735_PANEL_COLOR_12_BIT:
+            /* 2 pixels in 3 bytes, i.e. RG, BR, GB */
+            for (i = 0; i + 1 < count; i += 2, dst += 3) {
+                c0 = ST7735_rgb444((color[i] >> 16) & 0xFF, (color[i] >> 8) & 0xFF, color[i] & 0xFF);
+                c1 = ST7735_rgb444((color[i + 1] >> 16) & 0xFF, (color[i + 1] >> 8) & 0xFF, color[i + 1] & 0xFF);
+                dst[0] = c0 >> 4;
+                dst[1] = ((c0 & 0x0F) << 4) | (c1 >> 8);
+                dst[2] = c1 & 0xFF;
+            }
+            if (count & 1) {
+                c0 = ST7735_rgb444((color[i] >> 16) & 0xFF, (color[i] >> 8) & 0xFF, color[i] & 0xFF);
+                dst[0] = c0 >> 4;
+                dst[1] = (c0 & 0x0F) << 4;
+            }
+            break;
+
+        case ST7735_PANEL_COLOR_16_BIT:
+            for (i = 0; i < count; i++, dst += 2) {
+                c0 = ST7735_rgb565((color[i] >> 16) & 0xFF, (color[i] >> 8) & 0xFF, color[i] & 0xFF);
+                dst[0] = c0 >> 8;
+                dst[1] = c0 & 0xFF;
+            }
+            break;
+
+        case ST7735_PANEL_COLOR_18_BIT:
+            for (i = 0; i < count; i++, dst += 3) {
+                dst[0] = (color[i] >> 16) & 0xFF;
+                dst[1] = (color[i] >>  8) & 0xFF;
+                dst[2] = (color[i]      ) & 0xFF;
+            }
+            break;
+
+        default:
+            return 0;
+    }
+
+    return ST7735_getPackedSize(fmt, count);
+}
+
+
+
+/**
+ * @brief Type of the last segment of command list, non-zero for data.
+ */
+static uint8_t st7735_cmdListIsData(const st7735CmdList_t *list) {
+    return list->isFirstData ^ ((list->nSegment - 1) & 1);
+}
+
+
+/**
+ * @brief Write recorded segments to panel. A half byte left for the next 12-bit
+ *      pixel is kept as the start of the list.
+ */
+static void st7735_cmdListSend(st7735CmdList_t *list) {
+    const st7735_t *inst = list->inst;
+    uint32_t end;
+    uint32_t start, stop;
+    uint32_t i;
+    uint8_t isData;
+
+    end = list->isHalfByte? list->count - 1 : list->count;
+    if (end > 0) {
+        spi_selectCs(inst->spiIdx, inst->csPin, LOW);
+        isData = list->isFirstData;
+        for (i = 0; i < list->nSegment; i++, isData ^= 1) {
+            start = list->segmentStart[i];
+            stop = i + 1 < list->nSegment? list->segmentStart[i + 1] : end;
+            if (stop <= start) {
+                continue;
+            }
+            if (isData != list->dcLevel) {
+                gpio_write(inst->dcxPin, isData? HIGH : LOW);
+                list->dcLevel = isData;
+            }
+            spi_transfer(inst->spiIdx, NULL, list->buffer + start, stop - start);
+        }
+    }
+
+    if (list->isHalfByte) {
+        list->buffer[0] = list->buffer[list->count - 1];
+        list->count = 1;
+        list->segmentStart[0] = 0;
+        list->nSegment = 1;
+        list->isFirstData = 1;
+    } else {
+        list->count = 0;
+        list->nSegment = 0;
+    }
+}
+
+
+/**
+ * @brief Make room for a byte in a segment of the given type.
+ */
+static void st7735_cmdListReserve(st7735CmdList_t *list, uint8_t isData) {
+    if (list->count == list->size) {
+        st7735_cmdListSend(list);
+    }
+    if (list->nSegment > 0 && st7735_cmdListIsData(list) == isData) {
+        return;
+    }
+
+    if (ST7735_CMDLIST_SEGMENT_MAX == list->nSegment) {
+        st7735_cmdListSend(list);
+    }
+    if (0 == list->nSegment) {
+        list->isFirstData = isData;
+    }
+    list->segmentStart[list->nSegment++] = list->count;
+}
+
+
+/**
+ * @brief Record bytes, repeated a number of times.
+ * @details As many repeats as fit in buffer are copied at once, doubling the
+ *      bytes copied each time. A repeat that does not fit is split across sends.
+ */
+static void st7735_cmdListPut(st7735CmdList_t *list, uint8_t isData, const uint8_t *data, uint32_t size, uint32_t times) {
+    uint8_t *dst;
+    uint32_t n, total, done;
     uint32_t i;
+
+    while (size > 0 && times > 0) {
+        st7735_cmdListReserve(list, isData);
+        n = (list->size - list->count) / size;
+        if (0 == n) {
+            for (i = 0; i < size; i += n) {
+                st7735_cmdListReserve(list, isData);
+                n = list->size - list->count < size - i? list->size - list->count : size - i;
+                memcpy(list->buffer + list->count, data + i, n);
+                list->count += n;
+            }
+            times--;
+            continue;
+        }
+
+        if (n > times) {
+            n = times;
+        }
+        dst = list->buffer + list->count;
+        total = n * size;
+        memcpy(dst, data, size);
+        for (done = size; done < total; done += n) {
+            n = done < total - done? done : total - done;
+            memcpy(dst + done, dst, n);
+        }
+        list->count += total;
+        times -= total / size;
+    }
+}
+
+
+st7735_status_t st7735_cmdListInit(st7735CmdList_t *list, const st7735_t *inst, uint8_t *buffer, uint32_t size) {
+    if (size < 16) {
+        return ST7735_STATUS_ERROR;
+    }
+
+    list->inst = inst;
+    list->buffer = buffer;
+    list->size = size;
+    list->count = 0;
+    list->nSegment = 0;
+    list->isFirstData = 0;
+    list->isHalfByte = 0;
+    list->dcLevel = 0xFF;
+
+    return ST7735_STATUS_OK;
+}
+
+
+st7735_status_t st7735_cmdListCommand(st7735CmdList_t *list, uint8_t cmd, const uint8_t *arg, uint32_t nArg) {
+    /* A pending half byte is the last pixel of the previous window */
+    list->isHalfByte = 0;
+    st7735_cmdListPut(list, 0, &cmd, 1, 1);
+    st7735_cmdListPut(list, 1, arg, nArg, 1);
+
+    return ST7735_STATUS_OK;
+}
+
+
+st7735_status_t st7735_cmdListSetWindow(st7735CmdList_t *list, uint16_t xStart, uint16_t yStart, uint16_t xEnd, uint16_t yEnd) {
+    uint8_t buffer[4];
+
+    buffer[0] = (xStart >> 8) & 0xFF;
+    buffer[1] = xStart & 0xFF;
+    buffer[2] = (xEnd >> 8) & 0xFF;
+    buffer[3] = xEnd & 0xFF;
+    st7735_cmdListCommand(list, ST7735_CMD_CASET, buffer, 4);
+
+    buffer[0] = (yStart >> 8) & 0xFF;
+    buffer[1] = yStart & 0xFF;
+    buffer[2] = (yEnd >> 8) & 0xFF;
+    buffer[3] = yEnd & 0xFF;
+    st7735_cmdListCommand(list, ST7735_CMD_RASET, buffer, 4);
+
+    return st7735_cmdListCommand(list, ST7735_CMD_RAMWR, NULL, 0);
+}
+
+
+st7735_status_t st7735_cmdListPushColor(st7735CmdList_t *list, uint32_t color, uint32_t times) {
+    uint8_t buffer[3];
     uint16_t color16;
 
-    status = st7735_writeCommand(inst, ST7735_CMD_RAMWR);
-    switch(inst->colorFmt) {
+    switch(list->inst->colorFmt) {
         case ST7735_PANEL_COLOR_12_BIT:
-            /* Not supported yet */
+            /* 2 pixels in 3 bytes, i.e. RG, BR, GB */
+            color16 = ST7735_rgb444((color >> 16) & 0xFF, (color >> 8) & 0xFF, color & 0xFF);
+            if (times > 0 && list->isHalfByte) {
+                list->buffer[list->count - 1] |= color16 >> 8;
+                list->isHalfByte = 0;
+                buffer[0] = color16 & 0xFF;
+                st7735_cmdListPut(list, 1, buffer, 1, 1);
+                times--;
+            }
+            buffer[0] = color16 >> 4;
+            buffer[1] = ((color16 & 0x0F) << 4) | (color16 >> 8);
+            buffer[2] = color16 & 0xFF;
+            st7735_cmdListPut(list, 1, buffer, 3, times / 2);
+            if (times & 1) {
+                st7735_cmdListPut(list, 1, buffer, 2, 1);
+                list->buffer[list->count - 1] &= 0xF0;
+                list->isHalfByte = 1;
+            }
             break;
+
         case ST7735_PANEL_COLOR_16_BIT:
             color16 = ST7735_rgb565((color >> 16) & 0xFF, (color >> 8) & 0xFF, color & 0xFF);
             buffer[0] = color16 >> 8;
             buffer[1] = color16 & 0xFF;
-            for (i = 0; i < times; i++) {
-            	status = st7735_writeData(inst, buffer, 2);
-            }
+            st7735_cmdListPut(list, 1, buffer, 2, times);
             break;
 
         case ST7735_PANEL_COLOR_18_BIT:
             buffer[0] = (color >> 16) & 0xFF;
             buffer[1] = (color >>  8) & 0xFF;
             buffer[2] = (color      ) & 0xFF;
-            for (i = 0; i < times; i++) {
-                status = st7735_writeData(inst, buffer, 3);
+            st7735_cmdListPut(list, 1, buffer, 3, times);
+            break;
+
+        default:
+            /* Do nothing */
+            break;
+    }
+
+    return ST7735_STATUS_OK;
+}
+
+
+st7735_status_t st7735_cmdListPushPixels(st7735CmdList_t *list, const uint8_t *pixel, uint32_t count) {
+    uint8_t packed[ST7735_PUSH_BUFFER_SIZE];
+    uint32_t i, n;
+
+    switch(list->inst->colorFmt) {
+        case ST7735_PANEL_COLOR_12_BIT:
+            if (count > 0 && list->isHalfByte) {
+                list->buffer[list->count - 1] |= pixel[0] & 0x0F;
+                list->isHalfByte = 0;
+                st7735_cmdListPut(list, 1, pixel + 1, 1, 1);
+                pixel += 2;
+                count--;
+            }
+            /* Pairs of 0x0RGB values into 3 bytes, a burst at a time */
+            while (count >= 2) {
+                n = count / 2 < sizeof(packed) / 3? count / 2 : sizeof(packed) / 3;
+                for (i = 0; i < n; i++, pixel += 4) {
+                    packed[i * 3] = (pixel[0] << 4) | (pixel[1] >> 4);
+                    packed[i * 3 + 1] = (pixel[1] << 4) | (pixel[2] & 0x0F);
+                    packed[i * 3 + 2] = pixel[3];
+                }
+                st7735_cmdListPut(list, 1, packed, n * 3, 1);
+                count -= n * 2;
+            }
+            if (count > 0) {
+                packed[0] = (pixel[0] << 4) | (pixel[1] >> 4);
+                packed[1] = pixel[1] << 4;
+                st7735_cmdListPut(list, 1, packed, 2, 1);
+                list->isHalfByte = 1;
             }
             break;
+
+        case ST7735_PANEL_COLOR_16_BIT:
+            st7735_cmdListPut(list, 1, pixel, count * 2, 1);
+            break;
+
+        case ST7735_PANEL_COLOR_18_BIT:
+            st7735_cmdListPut(list, 1, pixel, count * 3, 1);
+            break;
+
         default:
             /* Do nothing */
             break;
     }
 
-    return status;
+    return ST7735_STATUS_OK;
+}
+
+
+st7735_status_t st7735_cmdListFlush(st7735CmdList_t *list) {
+    list->isHalfByte = 0;
+    st7735_cmdListSend(list);
+
+    return ST7735_STATUS_OK;
 }
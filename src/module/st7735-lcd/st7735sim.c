@@ -0,0 +1,365 @@
+/*
+ * st7735sim.c
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: chiong
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "util/bit.h"
+#include "util/xtype.h"
+#include "hw/gpio.h"
+#include "hw/sim.h"
+#include "module/st7735-lcd/st7735sim.h"
+
+#define ST7735SIM_FNV_OFFSET	(0x811C9DC5u)
+#define ST7735SIM_FNV_PRIME		(0x01000193u)
+
+/**
+ * @brief Registers as of power on or SWRESET. Display RAM is left as is.
+ */
+static void st7735sim_resetPanel(st7735sim_t *sim) {
+	sim->nArg = 0;
+	sim->nPixelByte = 0;
+	sim->xStart = 0;
+	sim->xEnd = ST7735_WIDTH - 1;
+	sim->yStart = 0;
+	sim->yEnd = ST7735_HEIGHT - 1;
+	sim->x = 0;
+	sim->y = 0;
+	sim->madctl = 0;
+	sim->colmod = ST7735_PANEL_COLOR_18_BIT;
+	sim->scrollTop = 0;
+	sim->scrollLen = ST7735_HEIGHT;
+	sim->scrollStart = 0;
+	sim->partialStart = 0;
+	sim->partialEnd = ST7735_HEIGHT - 1;
+	sim->isPartial = 0;
+	sim->isInverted = 0;
+}
+
+/**
+ * @brief Map a pixel in the coordinates of the given MADCTL orientation to
+ * 		display RAM. Beyond RAM when mirrored wraps to a large unsigned value.
+ */
+static void st7735sim_toRam(uint8_t orient, uint16_t x, uint16_t y, uint16_t *row, uint16_t *col) {
+	if (BIT_isBitSet(orient, ST7735_PANEL_EXCHANGE_XY_pos)) {
+		*row = x;
+		*col = y;
+	} else {
+		*row = y;
+		*col = x;
+	}
+	if (BIT_isBitSet(orient, ST7735_PANEL_MIRROR_Y_pos)) {
+		*row = ST7735_HEIGHT - 1 - *row;
+	}
+	if (BIT_isBitSet(orient, ST7735_PANEL_MIRROR_X_pos)) {
+		*col = ST7735_WIDTH - 1 - *col;
+	}
+}
+
+/**
+ * @brief Write a pixel at the current address and move to the next one, back
+ * 		to the start of window after its end.
+ */
+static void st7735sim_putPixel(st7735sim_t *sim, uint32_t color) {
+	uint16_t row, col;
+
+	st7735sim_toRam(sim->madctl, sim->x, sim->y, &row, &col);
+	if (row < ST7735_HEIGHT && col < ST7735_WIDTH) {
+		sim->ram[row][col] = color;
+	}
+	sim->stat.nPixel++;
+
+	if (++sim->x > sim->xEnd) {
+		sim->x = sim->xStart;
+		if (++sim->y > sim->yEnd) {
+			sim->y = sim->yStart;
+		}
+	}
+}
+
+/**
+ * @brief Expand RGB565 to 24-bit, the high bits of each channel repeated in its low bits.
+ */
+static uint32_t st7735sim_fromRgb565(uint16_t value) {
+	uint32_t r, g, b;
+
+	r = (value >> 11) & 0x1F;
+	g = (value >> 5) & 0x3F;
+	b = value & 0x1F;
+	return (((r << 3) | (r >> 2)) << 16) | (((g << 2) | (g >> 4)) << 8) | ((b << 3) | (b >> 2));
+}
+
+/**
+ * @brief Collect a byte of RAMWR, writing a pixel once complete.
+ */
+static void st7735sim_writeRam(st7735sim_t *sim, uint8_t value) {
+	const uint8_t *p = sim->pixel;
+
+	sim->pixel[sim->nPixelByte++] = value;
+	switch (sim->colmod & 0x07) {
+	case ST7735_PANEL_COLOR_12_BIT:
+		/* 2 pixels in 3 bytes, i.e. RG, BR, GB */
+		if (2 == sim->nPixelByte) {
+			st7735sim_putPixel(sim, ((p[0] >> 4) * 0x110000) | ((p[0] & 0x0F) * 0x1100) | ((p[1] >> 4) * 0x11));
+		} else if (3 == sim->nPixelByte) {
+			st7735sim_putPixel(sim, ((p[1] & 0x0F) * 0x110000) | ((p[2] >> 4) * 0x1100) | ((p[2] & 0x0F) * 0x11));
+			sim->nPixelByte = 0;
+		}
+		break;
+
+	case ST7735_PANEL_COLOR_16_BIT:
+		if (2 == sim->nPixelByte) {
+			st7735sim_putPixel(sim, st7735sim_fromRgb565((p[0] << 8) | p[1]));
+			sim->nPixelByte = 0;
+		}
+		break;
+
+	default:
+		/* 18-bit, the 6 bits of each channel in the upper bits of a byte */
+		if (3 == sim->nPixelByte) {
+			st7735sim_putPixel(sim, ((uint32_t) ((p[0] & 0xFC) | (p[0] >> 6)) << 16) |
+					((uint32_t) ((p[1] & 0xFC) | (p[1] >> 6)) << 8) | ((p[2] & 0xFC) | (p[2] >> 6)));
+			sim->nPixelByte = 0;
+		}
+		break;
+	}
+}
+
+/**
+ * @brief Act on a command once all its arguments are received.
+ */
+static void st7735sim_writeArg(st7735sim_t *sim, uint8_t value) {
+	const uint8_t *a = sim->arg;
+
+	if (ST7735_CMD_RAMWR == sim->cmd) {
+		st7735sim_writeRam(sim, value);
+		return;
+	}
+	if (sim->nArg >= ST7735SIM_ARG_MAX) {
+		return;
+	}
+	sim->arg[sim->nArg++] = value;
+
+	switch (sim->cmd) {
+	case ST7735_CMD_CASET:
+		if (4 == sim->nArg) {
+			sim->xStart = (a[0] << 8) | a[1];
+			sim->xEnd = (a[2] << 8) | a[3];
+		}
+		break;
+
+	case ST7735_CMD_RASET:
+		if (4 == sim->nArg) {
+			sim->yStart = (a[0] << 8) | a[1];
+			sim->yEnd = (a[2] << 8) | a[3];
+		}
+		break;
+
+	case ST7735_CMD_PTLAR:
+		if (4 == sim->nArg) {
+			sim->partialStart = (a[0] << 8) | a[1];
+			sim->partialEnd = (a[2] << 8) | a[3];
+		}
+		break;
+
+	case ST7735_CMD_SCRLAR:
+		/* Bottom fixed area is what is left of the top and scroll areas */
+		if (6 == sim->nArg) {
+			sim->scrollTop = (a[0] << 8) | a[1];
+			sim->scrollLen = (a[2] << 8) | a[3];
+		}
+		break;
+
+	case ST7735_CMD_VSCSAD:
+		if (2 == sim->nArg) {
+			sim->scrollStart = (a[0] << 8) | a[1];
+		}
+		break;
+
+	case ST7735_CMD_MADCTL:
+		sim->madctl = value;
+		break;
+
+	case ST7735_CMD_COLMOD:
+		sim->colmod = value;
+		break;
+
+	default:
+		/* Arguments of other commands are ignored */
+		break;
+	}
+}
+
+static void st7735sim_writeCommand(st7735sim_t *sim, uint8_t cmd) {
+	sim->cmd = cmd;
+	sim->nArg = 0;
+	sim->nPixelByte = 0;
+	sim->stat.nCommand++;
+
+	switch (cmd) {
+	case ST7735_CMD_SWRESET:
+		st7735sim_resetPanel(sim);
+		break;
+	case ST7735_CMD_RAMWR:
+		sim->x = sim->xStart;
+		sim->y = sim->yStart;
+		sim->stat.nWindow++;
+		break;
+	case ST7735_CMD_PTLON:
+		sim->isPartial = 1;
+		break;
+	case ST7735_CMD_NORON:
+		sim->isPartial = 0;
+		break;
+	case ST7735_CMD_INVON:
+		sim->isInverted = 1;
+		break;
+	case ST7735_CMD_INVOFF:
+		sim->isInverted = 0;
+		break;
+	default:
+		/* Do nothing */
+		break;
+	}
+}
+
+/**
+ * @brief Device model of hw/sim.h, DCX is read at the start of each transfer.
+ */
+static void st7735sim_transfer(void *arg, uint8_t *rxBuffer, const uint8_t *txBuffer, uint32_t length) {
+	st7735sim_t *sim = (st7735sim_t*) arg;
+	uint8_t dcLevel;
+	uint32_t i;
+
+	(void) rxBuffer;
+
+	dcLevel = gpio_read(sim->dcxPin);
+	if (0xFF != sim->dcLevel && dcLevel != sim->dcLevel) {
+		sim->stat.nDcToggle++;
+	}
+	sim->dcLevel = dcLevel;
+	sim->stat.nTransfer++;
+	sim->stat.nByte += length;
+
+	for (i = 0; i < length; i++) {
+		if (LOW == dcLevel) {
+			st7735sim_writeCommand(sim, txBuffer[i]);
+		} else {
+			st7735sim_writeArg(sim, txBuffer[i]);
+		}
+	}
+}
+
+
+int32_t st7735sim_init(st7735sim_t *sim, uint8_t spiIdx, int8_t cs, uint8_t dcxPin) {
+	if (dcxPin >= SIM_GPIO_COUNT) {
+		return STATUS_ERROR_PARAM;
+	}
+
+	memset(sim, 0, sizeof(st7735sim_t));
+	sim->spiIdx = spiIdx;
+	sim->cs = cs;
+	sim->dcxPin = dcxPin;
+	sim->dcLevel = 0xFF;
+	sim->cmd = ST7735_CMD_NOP;
+	st7735sim_resetPanel(sim);
+
+	return spi_simAttach(spiIdx, cs, st7735sim_transfer, sim);
+}
+
+
+void st7735sim_deinit(st7735sim_t *sim) {
+	spi_simAttach(sim->spiIdx, sim->cs, NULL, NULL);
+}
+
+
+void st7735sim_resetStat(st7735sim_t *sim) {
+	memset(&sim->stat, 0, sizeof(st7735simStat_t));
+}
+
+
+uint32_t st7735sim_getPixel(const st7735sim_t *sim, uint8_t orient, uint16_t x, uint16_t y) {
+	uint32_t color;
+	uint16_t row, col;
+
+	st7735sim_toRam(orient, x, y, &row, &col);
+	if (row >= ST7735_HEIGHT || col >= ST7735_WIDTH) {
+		return 0;
+	}
+	if (sim->isPartial && (row < sim->partialStart || row > sim->partialEnd)) {
+		return 0;
+	}
+
+	/* Rows of scroll area are shown from VSCSAD on, wrapping within the area */
+	if (sim->scrollLen > 0 && (uint32_t) sim->scrollTop + sim->scrollLen <= ST7735_HEIGHT &&
+		row >= sim->scrollTop && row < sim->scrollTop + sim->scrollLen &&
+		sim->scrollStart >= sim->scrollTop && sim->scrollStart < sim->scrollTop + sim->scrollLen) {
+		row = sim->scrollTop + (row - sim->scrollTop + sim->scrollStart - sim->scrollTop) % sim->scrollLen;
+	}
+
+	color = sim->ram[row][col];
+	if (BIT_isBitSet(sim->madctl, ST7735_PANEL_RGB_ORDER_pos)) {
+		color = ((color & 0xFF) << 16) | (color & 0xFF00) | ((color >> 16) & 0xFF);
+	}
+	if (sim->isInverted) {
+		color ^= 0xFFFFFF;
+	}
+	return color;
+}
+
+
+uint32_t st7735sim_getHash(const st7735sim_t *sim) {
+	uint32_t hash = ST7735SIM_FNV_OFFSET;
+	uint32_t color;
+	uint16_t x, y;
+
+	for (y = 0; y < ST7735_HEIGHT; y++) {
+		for (x = 0; x < ST7735_WIDTH; x++) {
+			color = st7735sim_getPixel(sim, ST7735_PANEL_ORIENT_NORMAL, x, y);
+			hash = (hash ^ ((color >> 16) & 0xFF)) * ST7735SIM_FNV_PRIME;
+			hash = (hash ^ ((color >> 8) & 0xFF)) * ST7735SIM_FNV_PRIME;
+			hash = (hash ^ (color & 0xFF)) * ST7735SIM_FNV_PRIME;
+		}
+	}
+	return hash;
+}
+
+
+int32_t st7735sim_writePpm(const st7735sim_t *sim, uint8_t orient, const char *path) {
+	uint8_t line[ST7735_HEIGHT * 3];
+	uint16_t width, height;
+	uint32_t color;
+	uint16_t x, y;
+	int32_t status = STATUS_OK;
+	FILE *f;
+
+	width = ST7735SIM_getWidth(orient);
+	height = ST7735SIM_getHeight(orient);
+	f = fopen(path, "wb");
+	if (NULL == f) {
+		return STATUS_ERROR_FILE_OPEN;
+	}
+
+	if (fprintf(f, "P6\n%u %u\n255\n", width, height) < 0) {
+		status = STATUS_ERROR;
+	}
+	for (y = 0; y < height && STATUS_OK == status; y++) {
+		for (x = 0; x < width; x++) {
+			color = st7735sim_getPixel(sim, orient, x, y);
+			line[x * 3] = (color >> 16) & 0xFF;
+			line[x * 3 + 1] = (color >> 8) & 0xFF;
+			line[x * 3 + 2] = color & 0xFF;
+		}
+		if (fwrite(line, 3, width, f) != width) {
+			status = STATUS_ERROR;
+		}
+	}
+
+	if (fclose(f) != 0) {
+		status = STATUS_ERROR;
+	}
+	return status;
+}
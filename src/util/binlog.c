@@ -0,0 +1,435 @@
+/*
+ * binlog.c
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: chiong
+ */
+
+/* For O_DIRECT */
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <time.h>
+#include "util/status.h"
+#include "util/binlog.h"
+
+/* Period, in ns, at which the writer thread polls the queue. */
+#define BINLOG_POLL_NS			(2000000ull)
+/* Maximum length of a file name, including terminating null character. */
+#define BINLOG_FILENAME_MAX		(256)
+
+/**
+ * @brief Queue slot. seq is the index of the record the slot is free for, or that
+ * 		index + 1 once the record is in.
+ */
+typedef struct {
+	uint32_t seq;
+	uint32_t reserved;
+	binlogRecord_t rec;
+	uint8_t payload[];
+} binlogSlot_t;
+
+struct binlog_s {
+	/* Read-only after create. Raw address as returned by malloc(), used for free-ing only. */
+	void *slotBase;
+	/* Read-only after create. Slot 0, aligned to cache line. */
+	void *slotAddr;
+	/* Read-only after create. Distance, in bytes, between two consecutive slots. */
+	uint32_t slotStride;
+	/* Read-only after create. nSlot - 1 */
+	uint32_t mask;
+	uint32_t maxRecordSize;
+	uint8_t pad0[BINLOG_CACHE_LINE_SIZE];
+
+	/* Written by producers. Free running count of claimed slots. */
+	uint32_t enqIdx;
+	/* Written by producers. */
+	uint32_t nDrop;
+	uint8_t pad1[BINLOG_CACHE_LINE_SIZE - 2 * sizeof(uint32_t)];
+
+	/* Writer thread only. Free running count of records taken from queue. */
+	uint32_t deqIdx;
+	/* Writer thread only. Batch buffer, aligned to BINLOG_ALIGNMENT. */
+	void *batchBase;
+	uint8_t *batch;
+	uint32_t batchSize;
+	uint32_t batchLen;
+	/* Writer thread only. Current file, -1 if none. */
+	int fd;
+	uint8_t isDirect;
+	uint32_t fileIndex;
+	/* Writer thread only. Size, in bytes, of current file including batch. */
+	uint64_t fileSize;
+	uint64_t fileStartNs;
+	uint64_t lastRecordNs;
+
+	/* Read-only after create. As configured. */
+	char filenameFormat[BINLOG_FILENAME_MAX];
+	uint64_t maxFileSize;
+	uint64_t maxFileNs;
+	uint64_t flushNs;
+	uint8_t isDirectCfg;
+
+	/* Written by writer thread only. */
+	uint32_t nRecord;
+	uint32_t nError;
+	uint32_t nFile;
+	uint32_t nOpenFail;
+	uint64_t nByte;
+
+	/* Accessed by both threads. */
+	uint8_t isStop;
+	uint8_t isThread;
+	pthread_t thread;
+};
+
+static inline binlogSlot_t* binlog_getSlot(const binlog_t *pSelf, uint32_t index) {
+	return (binlogSlot_t*) (pSelf->slotAddr + (uintptr_t) (index & pSelf->mask) * pSelf->slotStride);
+}
+
+static uint64_t binlog_nowNs(void) {
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t) ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+/**
+ * @brief Turn O_DIRECT off for the rest of file.
+ */
+static void binlog_clearDirect(binlog_t *pSelf) {
+#ifdef O_DIRECT
+	if (pSelf->isDirect) {
+		fcntl(pSelf->fd, F_SETFL, fcntl(pSelf->fd, F_GETFL) & ~O_DIRECT);
+		pSelf->isDirect = 0;
+	}
+#endif
+}
+
+/**
+ * @brief Write the first len bytes of batch to file and empty the batch.
+ */
+static void binlog_writeBatch(binlog_t *pSelf, uint32_t len) {
+	uint32_t done = 0;
+	ssize_t n;
+
+	while (done < len) {
+		n = write(pSelf->fd, pSelf->batch + done, len - done);
+		if (n < 0 && EINTR == errno) {
+			continue;
+		} else if (n <= 0) {
+			__atomic_store_n(&pSelf->nError, pSelf->nError + 1, __ATOMIC_RELAXED);
+			break;
+		}
+		done += n;
+		if (done < len) {
+			/* The rest is neither at an aligned offset nor of aligned size */
+			binlog_clearDirect(pSelf);
+		}
+	}
+
+	__atomic_store_n(&pSelf->nByte, pSelf->nByte + done, __ATOMIC_RELAXED);
+	pSelf->batchLen = 0;
+}
+
+/**
+ * @brief Write out the partial batch. With O_DIRECT, the size would not be a
+ * 		multiple of the block size, so O_DIRECT is turned off for the rest of file.
+ */
+static void binlog_flushBatch(binlog_t *pSelf) {
+	if (0 == pSelf->batchLen) {
+		return;
+	}
+
+	binlog_clearDirect(pSelf);
+	binlog_writeBatch(pSelf, pSelf->batchLen);
+}
+
+static int32_t binlog_openFile(binlog_t *pSelf) {
+	char filename[BINLOG_FILENAME_MAX];
+	int flags = O_WRONLY | O_CREAT | O_TRUNC;
+
+	snprintf(filename, sizeof(filename), pSelf->filenameFormat, pSelf->fileIndex);
+
+	/* Also on failure, so that the next attempt is one file later */
+	pSelf->fileSize = 0;
+	pSelf->fileStartNs = binlog_nowNs();
+	pSelf->fd = -1;
+	pSelf->isDirect = 0;
+#ifdef O_DIRECT
+	if (pSelf->isDirectCfg) {
+		pSelf->fd = open(filename, flags | O_DIRECT, 0644);
+		pSelf->isDirect = (pSelf->fd >= 0);
+	}
+#endif
+	if (pSelf->fd < 0) {
+		/* Not supported by file system, or not asked for */
+		pSelf->fd = open(filename, flags, 0644);
+		if (pSelf->fd < 0) {
+			return STATUS_ERROR_FILE_OPEN;
+		}
+	}
+
+	pSelf->fileIndex++;
+	__atomic_store_n(&pSelf->nFile, pSelf->nFile + 1, __ATOMIC_RELAXED);
+	return STATUS_OK;
+}
+
+static void binlog_closeFile(binlog_t *pSelf) {
+	/* Without file, the write fails and is counted */
+	binlog_flushBatch(pSelf);
+	if (pSelf->fd >= 0) {
+		close(pSelf->fd);
+		pSelf->fd = -1;
+	}
+}
+
+/**
+ * @brief Append bytes to batch, writing out every full batch.
+ */
+static void binlog_append(binlog_t *pSelf, const void *src, uint32_t len) {
+	uint32_t n;
+
+	while (len > 0) {
+		n = pSelf->batchSize - pSelf->batchLen;
+		if (n > len) {
+			n = len;
+		}
+		memcpy(pSelf->batch + pSelf->batchLen, src, n);
+		pSelf->batchLen += n;
+		src += n;
+		len -= n;
+
+		if (pSelf->batchLen == pSelf->batchSize) {
+			binlog_writeBatch(pSelf, pSelf->batchSize);
+		}
+	}
+}
+
+static void binlog_putRecord(binlog_t *pSelf, const binlogSlot_t *slot, uint64_t now) {
+	static const uint8_t zero[BINLOG_RECORD_ALIGN] = { 0 };
+	uint64_t recSize;
+
+	/* Records are never split across files */
+	recSize = BINLOG_getRecordSize(slot->rec.size);
+	if (pSelf->fileSize > 0 &&
+		((0 != pSelf->maxFileSize && pSelf->fileSize + recSize > pSelf->maxFileSize) ||
+		(0 != pSelf->maxFileNs && now - pSelf->fileStartNs >= pSelf->maxFileNs))) {
+		binlog_closeFile(pSelf);
+		if (binlog_openFile(pSelf) != STATUS_OK) {
+			/* Every write until the next rotation fails and is counted */
+			__atomic_store_n(&pSelf->nOpenFail, pSelf->nOpenFail + 1, __ATOMIC_RELAXED);
+		}
+	}
+
+	binlog_append(pSelf, &slot->rec, sizeof(slot->rec));
+	binlog_append(pSelf, slot->payload, slot->rec.size);
+	binlog_append(pSelf, zero, recSize - sizeof(slot->rec) - slot->rec.size);
+	pSelf->fileSize += recSize;
+	__atomic_store_n(&pSelf->nRecord, pSelf->nRecord + 1, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Move all records in queue to batch.
+ * @return Number of records moved.
+ */
+static uint32_t binlog_drain(binlog_t *pSelf) {
+	binlogSlot_t *slot;
+	uint64_t now;
+	uint32_t n = 0;
+
+	now = binlog_nowNs();
+	for (;;) {
+		slot = binlog_getSlot(pSelf, pSelf->deqIdx);
+		/* Pairs with release in binlog_writeAt(), so that the record is complete */
+		if (__atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE) != pSelf->deqIdx + 1) {
+			break;
+		}
+
+		binlog_putRecord(pSelf, slot, now);
+		/* Free for the record one lap later */
+		__atomic_store_n(&slot->seq, pSelf->deqIdx + pSelf->mask + 1, __ATOMIC_RELEASE);
+		pSelf->deqIdx++;
+		n++;
+	}
+
+	return n;
+}
+
+static void* binlog_writerThread(void *arg) {
+	binlog_t *pSelf = (binlog_t*) arg;
+	struct timespec period;
+	uint64_t now;
+	uint8_t isStop;
+
+	period.tv_sec = 0;
+	period.tv_nsec = BINLOG_POLL_NS;
+	pSelf->lastRecordNs = binlog_nowNs();
+
+	for (;;) {
+		/* Read before draining, so that records queued before stop are written */
+		isStop = __atomic_load_n(&pSelf->isStop, __ATOMIC_ACQUIRE);
+
+		now = binlog_nowNs();
+		if (binlog_drain(pSelf) > 0) {
+			pSelf->lastRecordNs = now;
+		} else if (pSelf->batchLen > 0 && !pSelf->isDirect && now - pSelf->lastRecordNs >= pSelf->flushNs) {
+			binlog_writeBatch(pSelf, pSelf->batchLen);
+		}
+
+		if (isStop) {
+			break;
+		}
+		nanosleep(&period, NULL);
+	}
+
+	binlog_closeFile(pSelf);
+	return NULL;
+}
+
+int32_t binlog_create(binlog_t **ppSelf, const binlogCfg_t *cfg) {
+	binlog_t *pSelf;
+	uintptr_t ptr;
+	uint32_t nSlot;
+	uint32_t i;
+	int32_t status;
+
+	nSlot = cfg->nSlot;
+	if (NULL == cfg->filenameFormat || strlen(cfg->filenameFormat) >= BINLOG_FILENAME_MAX ||
+		nSlot < 2 || (nSlot & (nSlot - 1)) != 0 ||
+		0 == cfg->batchSize || (cfg->batchSize % BINLOG_ALIGNMENT) != 0) {
+		return STATUS_ERROR_PARAM;
+	}
+
+	pSelf = (binlog_t*) calloc(1, sizeof(binlog_t));
+	if (NULL == pSelf) {
+		return STATUS_ERROR_MALLOC;
+	}
+	pSelf->fd = -1;
+	pSelf->mask = nSlot - 1;
+	pSelf->maxRecordSize = cfg->maxRecordSize;
+	pSelf->batchSize = cfg->batchSize;
+	strcpy(pSelf->filenameFormat, cfg->filenameFormat);
+	pSelf->maxFileSize = cfg->maxFileSize;
+	pSelf->maxFileNs = (uint64_t) cfg->maxFileMs * 1000000ull;
+	pSelf->flushNs = (uint64_t) cfg->flushMs * 1000000ull;
+	pSelf->isDirectCfg = cfg->isDirect;
+
+	/* Each slot starts on its own cache line, so producers do not false share */
+	pSelf->slotStride = (sizeof(binlogSlot_t) + cfg->maxRecordSize + BINLOG_CACHE_LINE_SIZE - 1) &
+			~(BINLOG_CACHE_LINE_SIZE - 1);
+	pSelf->slotBase = malloc((size_t) pSelf->slotStride * nSlot + BINLOG_CACHE_LINE_SIZE - 1);
+	pSelf->batchBase = malloc(cfg->batchSize + BINLOG_ALIGNMENT - 1);
+	if (NULL == pSelf->slotBase || NULL == pSelf->batchBase) {
+		binlog_destroy(&pSelf);
+		return STATUS_ERROR_MALLOC;
+	}
+
+	/* Perform manual alignment */
+	ptr = ((uintptr_t) pSelf->slotBase + BINLOG_CACHE_LINE_SIZE - 1) & ~((uintptr_t) BINLOG_CACHE_LINE_SIZE - 1);
+	pSelf->slotAddr = (void*) ptr;
+	ptr = ((uintptr_t) pSelf->batchBase + BINLOG_ALIGNMENT - 1) & ~((uintptr_t) BINLOG_ALIGNMENT - 1);
+	pSelf->batch = (uint8_t*) ptr;
+
+	for (i = 0; i < nSlot; i++) {
+		binlog_getSlot(pSelf, i)->seq = i;
+	}
+
+	status = binlog_openFile(pSelf);
+	if (STATUS_OK != status) {
+		binlog_destroy(&pSelf);
+		return status;
+	}
+
+	if (pthread_create(&pSelf->thread, NULL, binlog_writerThread, pSelf) != 0) {
+		binlog_destroy(&pSelf);
+		return STATUS_ERROR;
+	}
+	pSelf->isThread = 1;
+
+	*ppSelf = pSelf;
+	return STATUS_OK;
+}
+
+int32_t binlog_destroy(binlog_t **ppSelf) {
+	binlog_t *pSelf = *ppSelf;
+
+	if (NULL != pSelf) {
+		if (pSelf->isThread) {
+			/* The writer thread drains the queue and closes the file */
+			__atomic_store_n(&pSelf->isStop, 1, __ATOMIC_RELEASE);
+			pthread_join(pSelf->thread, NULL);
+		} else {
+			binlog_closeFile(pSelf);
+		}
+
+		if (NULL != pSelf->slotBase)
+			free(pSelf->slotBase);
+		if (NULL != pSelf->batchBase)
+			free(pSelf->batchBase);
+
+		free(pSelf);
+		*ppSelf = NULL;
+	}
+
+	return STATUS_OK;
+}
+
+int32_t binlog_write(binlog_t *pSelf, uint16_t id, const void *data, uint32_t size) {
+	return binlog_writeAt(pSelf, id, binlog_nowNs(), data, size);
+}
+
+int32_t binlog_writeAt(binlog_t *pSelf, uint16_t id, uint64_t timestamp, const void *data, uint32_t size) {
+	binlogSlot_t *slot;
+	uint32_t idx;
+	int32_t diff;
+
+	if (size > pSelf->maxRecordSize) {
+		return STATUS_ERROR_PARAM;
+	}
+
+	/* Claim the slot at enqIdx if it is free for this lap */
+	idx = __atomic_load_n(&pSelf->enqIdx, __ATOMIC_RELAXED);
+	for (;;) {
+		slot = binlog_getSlot(pSelf, idx);
+		diff = (int32_t) (__atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE) - idx);
+		if (0 == diff) {
+			if (__atomic_compare_exchange_n(&pSelf->enqIdx, &idx, idx + 1, 1,
+					__ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+				break;
+			}
+		} else if (diff < 0) {
+			/* Still holding the record of the previous lap, i.e. queue full */
+			__atomic_fetch_add(&pSelf->nDrop, 1, __ATOMIC_RELAXED);
+			return STATUS_ERROR;
+		} else {
+			/* Claimed by another producer meanwhile */
+			idx = __atomic_load_n(&pSelf->enqIdx, __ATOMIC_RELAXED);
+		}
+	}
+
+	slot->rec.timestamp = timestamp;
+	slot->rec.size = size;
+	slot->rec.id = id;
+	slot->rec.reserved = 0;
+	memcpy(slot->payload, data, size);
+	/* Publish the record to the writer thread */
+	__atomic_store_n(&slot->seq, idx + 1, __ATOMIC_RELEASE);
+
+	return STATUS_OK;
+}
+
+void binlog_getStats(const binlog_t *pSelf, binlogStats_t *stats) {
+	stats->nRecord = __atomic_load_n(&pSelf->nRecord, __ATOMIC_RELAXED);
+	stats->nDrop = __atomic_load_n(&pSelf->nDrop, __ATOMIC_RELAXED);
+	stats->nError = __atomic_load_n(&pSelf->nError, __ATOMIC_RELAXED);
+	stats->nFile = __atomic_load_n(&pSelf->nFile, __ATOMIC_RELAXED);
+	stats->nOpenFail = __atomic_load_n(&pSelf->nOpenFail, __ATOMIC_RELAXED);
+	stats->nByte = __atomic_load_n(&pSelf->nByte, __ATOMIC_RELAXED);
+}
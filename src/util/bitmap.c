@@ -11,50 +11,493 @@
 #include "util/bitmap.h"
 #include "util/util.h"
 
+/* Size, in bytes, of the bit field masks following BITMAPINFOHEADER. */
+#define BITMAP_MASK_SIZE			(12)
+/* Largest header read, BITMAPV5HEADER. Only the BITMAPINFOHEADER part is used. */
+#define BITMAP_IMAGE_HEADER_MAX		(124)
+/* Largest width or height accepted, to keep sizes in 32 bits. */
+#define BITMAP_DIMENSION_MAX		(0x7FFF)
 
-int32_t bitmap_readFile(bitmap_t **bitmap, char* filename) {
-	bitmap_t *pBitmap;
-	uint8_t *image;
-	FILE *pFile;
-	int32_t size;
+struct bitmapReader_s {
+	FILE *file;
+	bitmap_file_t fileHeader;
+	bitmap_image_t imageHeader;
+	uint32_t width;
+	uint32_t height;
+	uint8_t isBottomUp;
+	uint16_t bitCount;
+	/* Size, in bytes, of a row in file, including padding to 4 bytes. */
+	uint32_t stride;
+	/* Palette for 1, 4 and 8-bit, as 0x00RRGGBB. */
+	uint32_t palette[256];
+	/* Bit fields of red, green and blue for 16 and 32-bit. */
+	uint8_t shift[3];
+	uint8_t bits[3];
+	/* Columns returned by bitmap_readRows(). */
+	uint32_t x;
+	uint32_t w;
+	/* Next row to read, counted from top. */
+	uint32_t row;
+	/* Rows read from file, in file order. */
+	uint8_t *raw;
+	uint32_t rawRow;
+	/* One row of w pixels as 0x00RRGGBB, for formats other than ARGB32. */
+	uint32_t *line;
+};
 
-	pBitmap = (bitmap_t*) malloc(sizeof(bitmap_t));
-	if (NULL == pBitmap) {
+static uint16_t bitmap_le16(const uint8_t *p) {
+	return (uint16_t) (p[0] | (p[1] << 8));
+}
+
+static uint32_t bitmap_le32(const uint8_t *p) {
+	return (uint32_t) p[0] | ((uint32_t) p[1] << 8) | ((uint32_t) p[2] << 16) | ((uint32_t) p[3] << 24);
+}
+
+/**
+ * @brief Convert a contiguous bit field mask into its shift and width.
+ * @return STATUS_OK if success, STATUS_ERROR if the mask is not contiguous.
+ */
+static int32_t bitmap_parseMask(uint32_t mask, uint8_t *shift, uint8_t *bits) {
+	*shift = 0;
+	*bits = 0;
+	if (0 == mask) {
+		return STATUS_OK;
+	}
+
+	while (!(mask & 1)) {
+		mask >>= 1;
+		(*shift)++;
+	}
+	while (mask & 1) {
+		mask >>= 1;
+		(*bits)++;
+	}
+
+	return 0 == mask? STATUS_OK : STATUS_ERROR;
+}
+
+/**
+ * @brief Extract a bit field and scale it to 8 bits by bit replication, so that
+ * 		full scale in the field is full scale in 8 bits.
+ */
+static inline uint32_t bitmap_expand(uint32_t px, uint8_t shift, uint8_t bits) {
+	uint32_t v;
+	uint32_t n;
+
+	if (0 == bits) {
+		return 0;
+	}
+
+	v = (px >> shift) & (0xFFFFFFFFu >> (32 - bits));
+	if (bits >= 8) {
+		return v >> (bits - 8);
+	}
+
+	v <<= 8 - bits;
+	for (n = bits; n < 8; n += n) {
+		v |= v >> n;
+	}
+
+	return v & 0xFF;
+}
+
+/**
+ * @brief Decode pixel x to x + w - 1 of a row in file into 0x00RRGGBB.
+ */
+static void bitmap_decodeRow(const bitmapReader_t *pReader, const uint8_t *src, uint32_t *dst) {
+	const uint8_t *p;
+	uint32_t x, end;
+	uint32_t px;
+	uint32_t bit;
+
+	x = pReader->x;
+	end = x + pReader->w;
+	switch (pReader->bitCount) {
+	case 1:
+		for (; x < end; x++) {
+			*dst++ = pReader->palette[(src[x >> 3] >> (7 - (x & 7))) & 0x01];
+		}
+		break;
+
+	case 4:
+		for (; x < end; x++) {
+			bit = (x & 1)? 0 : 4;
+			*dst++ = pReader->palette[(src[x >> 1] >> bit) & 0x0F];
+		}
+		break;
+
+	case 8:
+		for (; x < end; x++) {
+			*dst++ = pReader->palette[src[x]];
+		}
+		break;
+
+	case 16:
+		for (p = src + x * 2; x < end; x++, p += 2) {
+			px = bitmap_le16(p);
+			*dst++ = (bitmap_expand(px, pReader->shift[0], pReader->bits[0]) << 16) |
+					(bitmap_expand(px, pReader->shift[1], pReader->bits[1]) << 8) |
+					bitmap_expand(px, pReader->shift[2], pReader->bits[2]);
+		}
+		break;
+
+	case 24:
+		for (p = src + x * 3; x < end; x++, p += 3) {
+			*dst++ = ((uint32_t) p[2] << 16) | ((uint32_t) p[1] << 8) | p[0];
+		}
+		break;
+
+	case 32:
+		p = src + x * 4;
+		if (16 == pReader->shift[0] && 8 == pReader->shift[1] && 0 == pReader->shift[2] &&
+			8 == pReader->bits[0] && 8 == pReader->bits[1] && 8 == pReader->bits[2]) {
+			/* Common BGRX layout */
+			for (; x < end; x++, p += 4) {
+				*dst++ = ((uint32_t) p[2] << 16) | ((uint32_t) p[1] << 8) | p[0];
+			}
+		} else {
+			for (; x < end; x++, p += 4) {
+				px = bitmap_le32(p);
+				*dst++ = (bitmap_expand(px, pReader->shift[0], pReader->bits[0]) << 16) |
+						(bitmap_expand(px, pReader->shift[1], pReader->bits[1]) << 8) |
+						bitmap_expand(px, pReader->shift[2], pReader->bits[2]);
+			}
+		}
+		break;
+
+	default:
+		/* Rejected in bitmap_readerOpen() */
+		break;
+	}
+}
+
+/**
+ * @brief Pack count pixels into the RGB444 stream dst, starting from pixel index
+ * 		start of the stream.
+ */
+static void bitmap_packRgb444(uint8_t *dst, const uint32_t *src, uint32_t count, uint32_t start) {
+	uint8_t *p;
+	uint32_t c0, c1;
+
+	p = dst + (start >> 1) * 3;
+	if (count > 0 && (start & 1)) {
+		/* Second half of a pair started by the previous row */
+		c1 = *src++;
+		p[1] = (p[1] & 0xF0) | ((c1 >> 20) & 0x0F);
+		p[2] = ((c1 >> 8) & 0xF0) | ((c1 >> 4) & 0x0F);
+		p += 3;
+		count--;
+	}
+
+	for (; count >= 2; count -= 2, p += 3) {
+		c0 = *src++;
+		c1 = *src++;
+		p[0] = ((c0 >> 16) & 0xF0) | ((c0 >> 12) & 0x0F);
+		p[1] = (c0 & 0xF0) | ((c1 >> 20) & 0x0F);
+		p[2] = ((c1 >> 8) & 0xF0) | ((c1 >> 4) & 0x0F);
+	}
+
+	if (count > 0) {
+		c0 = *src;
+		p[0] = ((c0 >> 16) & 0xF0) | ((c0 >> 12) & 0x0F);
+		p[1] = c0 & 0xF0;
+	}
+}
+
+static void bitmap_packRgb565(uint8_t *dst, const uint32_t *src, uint32_t count) {
+	uint32_t c;
+	uint32_t i;
+
+	for (i = 0; i < count; i++) {
+		c = src[i];
+		*dst++ = ((c >> 16) & 0xF8) | ((c >> 13) & 0x07);
+		*dst++ = ((c >> 5) & 0xE0) | ((c >> 3) & 0x1F);
+	}
+}
+
+static void bitmap_packRgb666(uint8_t *dst, const uint32_t *src, uint32_t count) {
+	uint32_t c;
+	uint32_t i;
+
+	for (i = 0; i < count; i++) {
+		c = src[i];
+		*dst++ = (c >> 16) & 0xFC;
+		*dst++ = (c >> 8) & 0xFC;
+		*dst++ = c & 0xFC;
+	}
+}
+
+int32_t bitmap_readerOpen(bitmapReader_t **ppReader, const char *filename) {
+	bitmapReader_t *pReader;
+	uint8_t header[BITMAP_FILE_HEADER_SIZE + BITMAP_IMAGE_HEADER_SIZE + BITMAP_MASK_SIZE];
+	uint8_t entry[4];
+	bitmap_file_t *fh;
+	bitmap_image_t *ih;
+	uint32_t mask[3];
+	uint32_t nColor;
+	uint32_t i;
+	int32_t status;
+
+	pReader = (bitmapReader_t*) calloc(1, sizeof(bitmapReader_t));
+	if (NULL == pReader) {
 		return STATUS_ERROR_MALLOC;
 	}
 
-	pFile = fopen(filename, "r");
-	if (NULL == pFile) {
-		bitmap_destroy(&pBitmap);
+	pReader->file = fopen(filename, "rb");
+	if (NULL == pReader->file) {
+		free(pReader);
 		return STATUS_ERROR_FILE_OPEN;
 	}
 
-	/* Need to do this because of struct auto memory alignment for packing of
-	 * different sized elements. So need to skip the auto padding.
-	 */
-	fread(&pBitmap->fileHeader.type, 1, 2, pFile);
-	fread(&pBitmap->fileHeader.size, 1, BITMAP_HEADER_SIZE - 2, pFile);
+	/* Parse field by field, struct layout differs from file because of padding */
+	if (fread(header, 1, BITMAP_HEADER_SIZE, pReader->file) != BITMAP_HEADER_SIZE) {
+		bitmap_readerClose(&pReader);
+		return STATUS_ERROR;
+	}
+	fh = &pReader->fileHeader;
+	fh->type = (int16_t) bitmap_le16(header);
+	fh->size = (int32_t) bitmap_le32(header + 2);
+	fh->reserved = (int32_t) bitmap_le32(header + 6);
+	fh->offBits = (int32_t) bitmap_le32(header + 10);
+	ih = &pReader->imageHeader;
+	ih->size = (int32_t) bitmap_le32(header + 14);
+	ih->width = (int32_t) bitmap_le32(header + 18);
+	ih->height = (int32_t) bitmap_le32(header + 22);
+	ih->planes = (int16_t) bitmap_le16(header + 26);
+	ih->bitCount = (int16_t) bitmap_le16(header + 28);
+	ih->compression = (int32_t) bitmap_le32(header + 30);
+	ih->imageSize = (int32_t) bitmap_le32(header + 34);
+	ih->xPixelPerMeter = (int32_t) bitmap_le32(header + 38);
+	ih->yPixelPerMeter = (int32_t) bitmap_le32(header + 42);
+	ih->colorUsed = (int32_t) bitmap_le32(header + 46);
+	ih->colorImportant = (int32_t) bitmap_le32(header + 50);
+
+	if (0x4D42 != (uint16_t) fh->type ||
+		ih->size < BITMAP_IMAGE_HEADER_SIZE || ih->size > BITMAP_IMAGE_HEADER_MAX ||
+		ih->width <= 0 || ih->width > BITMAP_DIMENSION_MAX || 0 == ih->height ||
+		ih->height > BITMAP_DIMENSION_MAX || ih->height < -BITMAP_DIMENSION_MAX || 1 != ih->planes ||
+		fh->offBits < BITMAP_FILE_HEADER_SIZE + ih->size) {
+		bitmap_readerClose(&pReader);
+		return STATUS_ERROR;
+	}
 
-	size = pBitmap->fileHeader.size - BITMAP_HEADER_SIZE;
-	image = (uint8_t*) malloc((size_t) size);
-	if (NULL == image) {
-		fclose(pFile);
+	pReader->bitCount = (uint16_t) ih->bitCount;
+	switch (pReader->bitCount) {
+	case 1:
+	case 4:
+	case 8:
+	case 24:
+		status = BITMAP_COMPRESSION_RGB == ih->compression? STATUS_OK : STATUS_ERROR;
+		break;
+	case 16:
+	case 32:
+		status = (BITMAP_COMPRESSION_RGB == ih->compression ||
+				BITMAP_COMPRESSION_BITFIELDS == ih->compression)? STATUS_OK : STATUS_ERROR;
+		break;
+	default:
+		status = STATUS_ERROR;
+		break;
+	}
+	if (STATUS_OK != status) {
+		bitmap_readerClose(&pReader);
+		return status;
+	}
+
+	pReader->width = (uint32_t) ih->width;
+	pReader->isBottomUp = ih->height > 0;
+	pReader->height = pReader->isBottomUp? (uint32_t) ih->height : (uint32_t) -ih->height;
+	pReader->stride = (pReader->width * pReader->bitCount + 31) / 32 * 4;
+	pReader->x = 0;
+	pReader->w = pReader->width;
+
+	/* Bit fields follow BITMAPINFOHEADER, or are part of the larger headers */
+	if (BITMAP_COMPRESSION_BITFIELDS == ih->compression) {
+		if (fread(header + BITMAP_HEADER_SIZE, 1, BITMAP_MASK_SIZE, pReader->file) != BITMAP_MASK_SIZE) {
+			bitmap_readerClose(&pReader);
+			return STATUS_ERROR;
+		}
+		for (i = 0; i < 3; i++) {
+			mask[i] = bitmap_le32(header + BITMAP_HEADER_SIZE + i * 4);
+		}
+	} else if (16 == pReader->bitCount) {
+		mask[0] = 0x7C00;
+		mask[1] = 0x03E0;
+		mask[2] = 0x001F;
+	} else {
+		mask[0] = 0x00FF0000;
+		mask[1] = 0x0000FF00;
+		mask[2] = 0x000000FF;
+	}
+	for (i = 0; i < 3; i++) {
+		if (bitmap_parseMask(mask[i], &pReader->shift[i], &pReader->bits[i]) != STATUS_OK) {
+			bitmap_readerClose(&pReader);
+			return STATUS_ERROR;
+		}
+	}
+
+	/* Palette of BGRX entries, unused entries stay black */
+	if (pReader->bitCount <= 8) {
+		nColor = (uint32_t) ih->colorUsed;
+		if (0 == nColor || nColor > (1u << pReader->bitCount)) {
+			nColor = 1u << pReader->bitCount;
+		}
+		fseek(pReader->file, BITMAP_FILE_HEADER_SIZE + ih->size, SEEK_SET);
+		for (i = 0; i < nColor; i++) {
+			if (fread(entry, 1, 4, pReader->file) != 4) {
+				bitmap_readerClose(&pReader);
+				return STATUS_ERROR;
+			}
+			pReader->palette[i] = ((uint32_t) entry[2] << 16) | ((uint32_t) entry[1] << 8) | entry[0];
+		}
+	}
+
+	/* Rows are read in chunks of whole rows, at least one */
+	pReader->rawRow = BITMAP_READER_CHUNK_SIZE / pReader->stride;
+	if (0 == pReader->rawRow) {
+		pReader->rawRow = 1;
+	}
+	pReader->raw = (uint8_t*) malloc((size_t) pReader->rawRow * pReader->stride);
+	pReader->line = (uint32_t*) malloc((size_t) pReader->width * sizeof(uint32_t));
+	if (NULL == pReader->raw || NULL == pReader->line) {
+		bitmap_readerClose(&pReader);
+		return STATUS_ERROR_MALLOC;
+	}
+
+	*ppReader = pReader;
+	return STATUS_OK;
+}
+
+void bitmap_readerClose(bitmapReader_t **ppReader) {
+	bitmapReader_t *pReader = *ppReader;
+
+	if (NULL != pReader) {
+		if (NULL != pReader->file) {
+			fclose(pReader->file);
+		}
+		free(pReader->raw);
+		free(pReader->line);
+		free(pReader);
+		*ppReader = NULL;
+	}
+}
+
+uint32_t bitmap_readerGetWidth(const bitmapReader_t *pReader) {
+	return pReader->width;
+}
+
+uint32_t bitmap_readerGetHeight(const bitmapReader_t *pReader) {
+	return pReader->height;
+}
+
+int32_t bitmap_readerSetColumns(bitmapReader_t *pReader, uint32_t x, uint32_t width) {
+	if (0 == width || x >= pReader->width || width > pReader->width - x) {
+		return STATUS_ERROR_PARAM;
+	}
+
+	pReader->x = x;
+	pReader->w = width;
+	return STATUS_OK;
+}
+
+int32_t bitmap_readRows(bitmapReader_t *pReader, void *dst, uint32_t nRow, uint32_t fmt) {
+	const uint8_t *src;
+	uint8_t *pDst;
+	uint32_t *pLine;
+	uint32_t nPixel;
+	uint32_t done;
+	uint32_t n;
+	uint32_t i;
+	long offset;
+
+	if (fmt > BITMAP_PIXEL_FMT_RGB666) {
+		return STATUS_ERROR_PARAM;
+	}
+
+	if (nRow > pReader->height - pReader->row) {
+		nRow = pReader->height - pReader->row;
+	}
+
+	pDst = (uint8_t*) dst;
+	nPixel = 0;
+	for (done = 0; done < nRow; done += n) {
+		n = nRow - done;
+		if (n > pReader->rawRow) {
+			n = pReader->rawRow;
+		}
+
+		/* The n rows from the current row down are contiguous in file, in reverse
+		 * order if the file is bottom-up. */
+		if (pReader->isBottomUp) {
+			offset = (long) (pReader->height - pReader->row - n) * pReader->stride;
+		} else {
+			offset = (long) pReader->row * pReader->stride;
+		}
+		if (fseek(pReader->file, pReader->fileHeader.offBits + offset, SEEK_SET) != 0 ||
+			fread(pReader->raw, pReader->stride, n, pReader->file) != n) {
+			return STATUS_ERROR;
+		}
+
+		for (i = 0; i < n; i++) {
+			src = pReader->raw + (size_t) (pReader->isBottomUp? n - 1 - i : i) * pReader->stride;
+			if (BITMAP_PIXEL_FMT_ARGB32 == fmt) {
+				bitmap_decodeRow(pReader, src, (uint32_t*) pDst + nPixel);
+			} else {
+				pLine = pReader->line;
+				bitmap_decodeRow(pReader, src, pLine);
+				switch (fmt) {
+				case BITMAP_PIXEL_FMT_RGB444:
+					bitmap_packRgb444(pDst, pLine, pReader->w, nPixel);
+					break;
+				case BITMAP_PIXEL_FMT_RGB565:
+					bitmap_packRgb565(pDst + nPixel * 2, pLine, pReader->w);
+					break;
+				default:
+					bitmap_packRgb666(pDst + nPixel * 3, pLine, pReader->w);
+					break;
+				}
+			}
+			nPixel += pReader->w;
+		}
+		pReader->row += n;
+	}
+
+	return (int32_t) nRow;
+}
+
+int32_t bitmap_readFile(bitmap_t **bitmap, const char* filename) {
+	bitmap_t *pBitmap;
+	bitmapReader_t *pReader;
+	int32_t status;
+
+	status = bitmap_readerOpen(&pReader, filename);
+	if (STATUS_OK != status) {
+		return status;
+	}
+
+	pBitmap = (bitmap_t*) malloc(sizeof(bitmap_t));
+	if (NULL == pBitmap) {
+		bitmap_readerClose(&pReader);
+		return STATUS_ERROR_MALLOC;
+	}
+	pBitmap->fileHeader = pReader->fileHeader;
+	pBitmap->imageHeader = pReader->imageHeader;
+	pBitmap->imageHeader.height = (int32_t) pReader->height;
+
+	pBitmap->image = (uint32_t*) malloc((size_t) pReader->width * pReader->height * sizeof(uint32_t));
+	if (NULL == pBitmap->image) {
+		bitmap_readerClose(&pReader);
 		bitmap_destroy(&pBitmap);
 		return STATUS_ERROR_MALLOC;
 	}
 
-	if (BITMAP_COLORMAP_32_BIT == pBitmap->imageHeader.bitCount) {
-		fread(image, 1, (size_t) size, pFile);
-	} else {
-		fprintf(stderr, "Only support 32-bit BMP format!\n");
+	if (bitmap_readRows(pReader, pBitmap->image, pReader->height, BITMAP_PIXEL_FMT_ARGB32) < 0) {
+		bitmap_readerClose(&pReader);
+		bitmap_destroy(&pBitmap);
+		return STATUS_ERROR;
 	}
-	fclose(pFile);
+	bitmap_readerClose(&pReader);
 
-	pBitmap->imageHeader.width = pBitmap->imageHeader.width < 0? -pBitmap->imageHeader.width : pBitmap->imageHeader.width;
-	pBitmap->imageHeader.height = pBitmap->imageHeader.height < 0? -pBitmap->imageHeader.height : pBitmap->imageHeader.height;
-	pBitmap->image = (uint32_t*) image;
 	*bitmap = pBitmap;
-
 	return STATUS_OK;
 }
 
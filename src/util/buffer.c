@@ -9,6 +9,16 @@
 #include <stdlib.h>
 #include <string.h>
 #include "util/buffer.h"
+#ifdef __ARM_NEON
+#include <arm_neon.h>
+#endif
+
+/* Size, in bytes, up to which buffer2d_fillRun() doubles the filled part. */
+#define BUFFER2D_FILL_CHUNK_SIZE	(4096)
+
+/* Size of local buffer of buffer2d_print(), and of the longest "%d, ". */
+#define BUFFER2D_PRINT_BUFFER_SIZE	(1024)
+#define BUFFER2D_PRINT_ELEM_MAX		(13)
 
 /**
  * @brief Data struct for 2D buffer stored as 1d array.
@@ -24,8 +34,128 @@ struct buffer2d_s {
 	uint32_t nCol;
 	/** 2D buffer layout, either row or column wise. */
 	uint32_t layout;
+	/** Distance, in elements, between 2 consecutive rows (ROW_WISE) or columns
+	 * (COLUMN_WISE), including padding. */
+	uint32_t ld;
+	/** Address as returned by calloc(), used for free-ing only. NULL if the memory
+	 * is external. */
+	void *baseAddr;
 };
 
+/**
+ * @brief Get the distance, in number of elements, between 2 consecutive rows and
+ * 		between 2 consecutive columns.
+ */
+static inline void buffer2d_getElemStrides(const buffer2d_t *pSelf, uint32_t *rowStride, uint32_t *colStride) {
+	if (BUFFER2D_LAYOUT_ROW_WISE == pSelf->layout) {
+		*rowStride = pSelf->ld;
+		*colStride = 1;
+	} else {
+		*rowStride = 1;
+		*colStride = pSelf->ld;
+	}
+}
+
+/**
+ * @brief Get the leading dimension, in elements, for the given configuration.
+ */
+static uint32_t buffer2d_calcLeadingDim(const buffer2dCfg_t *cfg) {
+	uint32_t ld;
+
+	ld = ((BUFFER2D_LAYOUT_ROW_WISE == cfg->layout) ? cfg->nCol : cfg->nRow) + cfg->pad;
+	if (cfg->alignment > 1) {
+		/* Smallest ld so that every line starts aligned, at most alignment more */
+		while (((ld * cfg->elemSize) & (cfg->alignment - 1)) != 0) {
+			ld++;
+		}
+	}
+
+	return ld;
+}
+
+/**
+ * @brief Macro to define the typed variants of put/get functions. The element size
+ * 		is known at compile time, so strided loops need no memcpy() per element.
+ * 		Contiguous rows/columns are copied with a single memcpy().
+ */
+#define BUFFER2D_DEFINE_TYPED(suffix, type)	\
+void buffer2d_putDataSingle##suffix(buffer2d_t *pSelf, uint32_t iRow, uint32_t jCol, type data) {	\
+	uint32_t rowStride, colStride;	\
+	buffer2d_getElemStrides(pSelf, &rowStride, &colStride);	\
+	((type*) pSelf->data)[iRow * rowStride + jCol * colStride] = data;	\
+}	\
+	\
+type buffer2d_getDataSingle##suffix(const buffer2d_t *pSelf, uint32_t iRow, uint32_t jCol) {	\
+	uint32_t rowStride, colStride;	\
+	buffer2d_getElemStrides(pSelf, &rowStride, &colStride);	\
+	return ((const type*) pSelf->data)[iRow * rowStride + jCol * colStride];	\
+}	\
+	\
+void buffer2d_putDataRow##suffix(buffer2d_t *pSelf, uint32_t iRow, const type *data) {	\
+	type * restrict pData;	\
+	uint32_t rowStride, colStride;	\
+	uint32_t i;	\
+	buffer2d_getElemStrides(pSelf, &rowStride, &colStride);	\
+	pData = (type*) pSelf->data + iRow * rowStride;	\
+	if (1 == colStride) {	\
+		memcpy(pData, data, pSelf->nCol * sizeof(type));	\
+		return;	\
+	}	\
+	for (i = 0; i < pSelf->nCol; i++) {	\
+		pData[i * colStride] = data[i];	\
+	}	\
+}	\
+	\
+void buffer2d_putDataCol##suffix(buffer2d_t *pSelf, uint32_t jCol, const type *data) {	\
+	type * restrict pData;	\
+	uint32_t rowStride, colStride;	\
+	uint32_t i;	\
+	buffer2d_getElemStrides(pSelf, &rowStride, &colStride);	\
+	pData = (type*) pSelf->data + jCol * colStride;	\
+	if (1 == rowStride) {	\
+		memcpy(pData, data, pSelf->nRow * sizeof(type));	\
+		return;	\
+	}	\
+	for (i = 0; i < pSelf->nRow; i++) {	\
+		pData[i * rowStride] = data[i];	\
+	}	\
+}	\
+	\
+void buffer2d_getDataRow##suffix(const buffer2d_t *pSelf, uint32_t iRow, type *data) {	\
+	const type * restrict pData;	\
+	uint32_t rowStride, colStride;	\
+	uint32_t i;	\
+	buffer2d_getElemStrides(pSelf, &rowStride, &colStride);	\
+	pData = (const type*) pSelf->data + iRow * rowStride;	\
+	if (1 == colStride) {	\
+		memcpy(data, pData, pSelf->nCol * sizeof(type));	\
+		return;	\
+	}	\
+	for (i = 0; i < pSelf->nCol; i++) {	\
+		data[i] = pData[i * colStride];	\
+	}	\
+}	\
+	\
+void buffer2d_getDataCol##suffix(const buffer2d_t *pSelf, uint32_t jCol, type *data) {	\
+	const type * restrict pData;	\
+	uint32_t rowStride, colStride;	\
+	uint32_t i;	\
+	buffer2d_getElemStrides(pSelf, &rowStride, &colStride);	\
+	pData = (const type*) pSelf->data + jCol * colStride;	\
+	if (1 == rowStride) {	\
+		memcpy(data, pData, pSelf->nRow * sizeof(type));	\
+		return;	\
+	}	\
+	for (i = 0; i < pSelf->nRow; i++) {	\
+		data[i] = pData[i * rowStride];	\
+	}	\
+}
+
+BUFFER2D_DEFINE_TYPED(I16, int16_t)
+BUFFER2D_DEFINE_TYPED(I32, int32_t)
+BUFFER2D_DEFINE_TYPED(F32, float)
+BUFFER2D_DEFINE_TYPED(CF32, complexf_t)
+
 int32_t buffer2d_create(buffer2d_t **ppSelf, uint32_t nRow, uint32_t nCol, uint32_t elemSize, uint8_t layout) {
 	buffer2d_t *pSelf;
 
@@ -37,21 +167,74 @@ int32_t buffer2d_create(buffer2d_t **ppSelf, uint32_t nRow, uint32_t nCol, uint3
 	pSelf->nRow = nRow;
 	pSelf->nCol = nCol;
 	pSelf->data = (void*) calloc(pSelf->nRow * pSelf->nCol, pSelf->elemSize);
+	pSelf->baseAddr = pSelf->data;
 	if (NULL == pSelf->data) {
 		buffer2d_destroy(&pSelf);
 		return STATUS_ERROR_MALLOC;
 	}
 	pSelf->layout = layout;
+	pSelf->ld = (BUFFER2D_LAYOUT_ROW_WISE == layout) ? nCol : nRow;
 	*ppSelf = pSelf;
 
 	return STATUS_OK;
 }
 
+int32_t buffer2d_createEx(buffer2d_t **ppSelf, const buffer2dCfg_t *cfg) {
+	buffer2d_t *pSelf;
+	uintptr_t mask;
+	uint32_t size;
+
+	if (0 == cfg->elemSize ||
+		(BUFFER2D_LAYOUT_ROW_WISE != cfg->layout && BUFFER2D_LAYOUT_COLUMN_WISE != cfg->layout) ||
+		(cfg->alignment & (cfg->alignment - 1)) != 0) {
+		return STATUS_ERROR_PARAM;
+	}
+
+	mask = (cfg->alignment > 1) ? (uintptr_t) (cfg->alignment - 1) : 0;
+	if (((uintptr_t) cfg->mem & mask) != 0) {
+		return STATUS_ERROR_PARAM;
+	}
+
+	pSelf = (buffer2d_t*) calloc(1, sizeof(buffer2d_t));
+	if (NULL == pSelf) {
+		return STATUS_ERROR_MALLOC;
+	}
+	pSelf->elemSize = cfg->elemSize;
+	pSelf->nRow = cfg->nRow;
+	pSelf->nCol = cfg->nCol;
+	pSelf->layout = cfg->layout;
+	pSelf->ld = buffer2d_calcLeadingDim(cfg);
+
+	if (NULL != cfg->mem) {
+		pSelf->data = cfg->mem;
+	} else {
+		size = buffer2d_getMemSize(cfg);
+		pSelf->baseAddr = calloc(1, size + mask);
+		if (NULL == pSelf->baseAddr) {
+			buffer2d_destroy(&pSelf);
+			return STATUS_ERROR_MALLOC;
+		}
+
+		/* Perform manual alignment */
+		pSelf->data = (void*) (((uintptr_t) pSelf->baseAddr + mask) & ~mask);
+	}
+
+	*ppSelf = pSelf;
+	return STATUS_OK;
+}
+
+uint32_t buffer2d_getMemSize(const buffer2dCfg_t *cfg) {
+	uint32_t nLine;
+
+	nLine = (BUFFER2D_LAYOUT_ROW_WISE == cfg->layout) ? cfg->nRow : cfg->nCol;
+	return buffer2d_calcLeadingDim(cfg) * nLine * cfg->elemSize;
+}
+
 int32_t buffer2d_destroy(buffer2d_t **ppSelf) {
 	buffer2d_t *pSelf = *ppSelf;
 	if (NULL != pSelf) {
-		if (NULL != pSelf->data) {
-			free(pSelf->data);
+		if (NULL != pSelf->baseAddr) {
+			free(pSelf->baseAddr);
 		}
 
 		free(pSelf);
@@ -64,11 +247,11 @@ int32_t buffer2d_destroy(buffer2d_t **ppSelf) {
 void buffer2d_putDataSingle(buffer2d_t *pSelf, uint32_t iRow, uint32_t jCol, const void *data) {
 	switch(pSelf->layout) {
 	case BUFFER2D_LAYOUT_ROW_WISE:
-		memcpy(pSelf->data + (iRow * pSelf->nCol + jCol) * pSelf->elemSize, data, pSelf->elemSize);
+		memcpy(pSelf->data + (iRow * pSelf->ld + jCol) * pSelf->elemSize, data, pSelf->elemSize);
 		break;
 
 	case BUFFER2D_LAYOUT_COLUMN_WISE:
-		memcpy(pSelf->data + (jCol * pSelf->nRow + iRow) * pSelf->elemSize, data, pSelf->elemSize);
+		memcpy(pSelf->data + (jCol * pSelf->ld + iRow) * pSelf->elemSize, data, pSelf->elemSize);
 		break;
 
 	default:
@@ -78,21 +261,29 @@ void buffer2d_putDataSingle(buffer2d_t *pSelf, uint32_t iRow, uint32_t jCol, con
 }
 
 void buffer2d_putDataRow(buffer2d_t *pSelf, uint32_t iRow, void *data) {
-	uint32_t i;
-	uint32_t jump;
-	void *pData;
+	buffer2dView_t dst, src;
+
+	buffer2d_getViewRow(pSelf, iRow, &dst);
+	buffer2dView_init(&src, data, 1, dst.nCol, pSelf->elemSize, BUFFER2D_LAYOUT_ROW_WISE);
+	buffer2dView_copy(&dst, &src);
+}
+
+void buffer2d_putDataCol(buffer2d_t *pSelf, uint32_t jCol, void *data) {
+	buffer2dView_t dst, src;
+
+	buffer2d_getViewCol(pSelf, jCol, &dst);
+	buffer2dView_init(&src, data, dst.nRow, 1, pSelf->elemSize, BUFFER2D_LAYOUT_COLUMN_WISE);
+	buffer2dView_copy(&dst, &src);
+}
 
+void buffer2d_getDataSingle(const buffer2d_t *pSelf, uint32_t iRow, uint32_t jCol, void *data) {
 	switch(pSelf->layout) {
 	case BUFFER2D_LAYOUT_ROW_WISE:
-		memcpy(pSelf->data + (iRow * pSelf->nCol) * pSelf->elemSize, data, pSelf->elemSize * pSelf->nCol);
+		memcpy(data, pSelf->data + (iRow * pSelf->ld + jCol) * pSelf->elemSize, pSelf->elemSize);
 		break;
 
 	case BUFFER2D_LAYOUT_COLUMN_WISE:
-		jump = pSelf->nRow * pSelf->elemSize;
-		pData = pSelf->data + iRow * pSelf->elemSize;
-		for (i = 0; i < pSelf->nCol; i++, data += pSelf->elemSize, pData += jump) {
-			memcpy(pData, data, pSelf->elemSize);
-		}
+		memcpy(data, pSelf->data + (jCol * pSelf->ld + iRow) * pSelf->elemSize, pSelf->elemSize);
 		break;
 
 	default:
@@ -101,157 +292,931 @@ void buffer2d_putDataRow(buffer2d_t *pSelf, uint32_t iRow, void *data) {
 	}
 }
 
-void buffer2d_putDataCol(buffer2d_t *pSelf, uint32_t jCol, void *data) {
-	uint32_t i;
-	uint32_t jump;
-	void *pData;
+void buffer2d_getDataRow(buffer2d_t *pSelf, uint32_t iRow, void *data) {
+	buffer2dView_t dst, src;
 
-	switch(pSelf->layout) {
+	buffer2d_getViewRow(pSelf, iRow, &src);
+	buffer2dView_init(&dst, data, 1, src.nCol, pSelf->elemSize, BUFFER2D_LAYOUT_ROW_WISE);
+	buffer2dView_copy(&dst, &src);
+}
+
+void buffer2d_getDataCol(buffer2d_t *pSelf, uint32_t jCol, void *data) {
+	buffer2dView_t dst, src;
+
+	buffer2d_getViewCol(pSelf, jCol, &src);
+	buffer2dView_init(&dst, data, src.nRow, 1, pSelf->elemSize, BUFFER2D_LAYOUT_COLUMN_WISE);
+	buffer2dView_copy(&dst, &src);
+}
+
+void buffer2d_fill(buffer2d_t *pSelf, void *elem) {
+	buffer2dView_t view;
+
+	/* Through a view, so that padding is left untouched */
+	buffer2d_getView(pSelf, &view);
+	buffer2dView_fill(&view, elem);
+}
+
+uint32_t buffer2d_getElemSize(const buffer2d_t *pSelf) {
+	return pSelf->elemSize;
+}
+
+uint32_t buffer2d_getNumRow(buffer2d_t *pSelf) {
+	return pSelf->nRow;
+}
+
+uint32_t buffer2d_getNumCol(buffer2d_t *pSelf) {
+	return pSelf->nCol;
+}
+
+const void* buffer2d_getBuffer(buffer2d_t *pSelf) {
+	return pSelf->data;
+}
+
+uint32_t buffer2d_getLeadingDim(const buffer2d_t *pSelf) {
+	return pSelf->ld;
+}
+
+void buffer2dView_init(buffer2dView_t *pView, void *data, uint32_t nRow, uint32_t nCol,
+		uint32_t elemSize, uint8_t layout) {
+	pView->data = data;
+	pView->nRow = nRow;
+	pView->nCol = nCol;
+	pView->elemSize = elemSize;
+
+	switch(layout) {
 	case BUFFER2D_LAYOUT_ROW_WISE:
-		jump = pSelf->nCol * pSelf->elemSize;
-		pData = pSelf->data + jCol * pSelf->elemSize;
-		for (i = 0; i < pSelf->nRow; i++, data += pSelf->elemSize, pData += jump) {
-			memcpy(pData, data, pSelf->elemSize);
-		}
+		pView->rowStride = nCol * elemSize;
+		pView->colStride = elemSize;
 		break;
 
 	case BUFFER2D_LAYOUT_COLUMN_WISE:
-		memcpy(pSelf->data + (jCol * pSelf->nRow) * pSelf->elemSize, data, pSelf->elemSize * pSelf->nRow);
+		pView->rowStride = elemSize;
+		pView->colStride = nRow * elemSize;
 		break;
 
 	default:
-		/* Do nothing */
+		/* Empty view */
+		pView->rowStride = 0;
+		pView->colStride = 0;
+		pView->nRow = 0;
+		pView->nCol = 0;
 		break;
 	}
 }
 
-void buffer2d_getDataSingle(const buffer2d_t *pSelf, uint32_t iRow, uint32_t jCol, void *data) {
-	switch(pSelf->layout) {
-	case BUFFER2D_LAYOUT_ROW_WISE:
-		memcpy(data, pSelf->data + (iRow * pSelf->nCol + jCol) * pSelf->elemSize, pSelf->elemSize);
+void buffer2d_getView(buffer2d_t *pSelf, buffer2dView_t *pView) {
+	buffer2dView_init(pView, pSelf->data, pSelf->nRow, pSelf->nCol, pSelf->elemSize, pSelf->layout);
+
+	/* Distance between lines includes padding */
+	if (BUFFER2D_LAYOUT_ROW_WISE == pSelf->layout) {
+		pView->rowStride = pSelf->ld * pSelf->elemSize;
+	} else if (BUFFER2D_LAYOUT_COLUMN_WISE == pSelf->layout) {
+		pView->colStride = pSelf->ld * pSelf->elemSize;
+	}
+}
+
+void buffer2d_getViewRow(buffer2d_t *pSelf, uint32_t iRow, buffer2dView_t *pView) {
+	buffer2d_getViewBlock(pSelf, iRow, 0, 1, pSelf->nCol, pView);
+}
+
+void buffer2d_getViewCol(buffer2d_t *pSelf, uint32_t jCol, buffer2dView_t *pView) {
+	buffer2d_getViewBlock(pSelf, 0, jCol, pSelf->nRow, 1, pView);
+}
+
+void buffer2d_getViewBlock(buffer2d_t *pSelf, uint32_t iRow, uint32_t jCol,
+		uint32_t nRow, uint32_t nCol, buffer2dView_t *pView) {
+	buffer2d_getView(pSelf, pView);
+	buffer2dView_getBlock(pView, iRow, jCol, nRow, nCol, pView);
+}
+
+void buffer2dView_getBlock(const buffer2dView_t *pView, uint32_t iRow, uint32_t jCol,
+		uint32_t nRow, uint32_t nCol, buffer2dView_t *pSub) {
+	if (0 == pView->nRow || 0 == pView->nCol) {
+		/* Empty view, e.g. of unknown layout, stays empty */
+		*pSub = *pView;
+		return;
+	}
+
+	pSub->data = BUFFER2DVIEW_getElemAddr(pView, iRow, jCol);
+	pSub->rowStride = pView->rowStride;
+	pSub->colStride = pView->colStride;
+	pSub->elemSize = pView->elemSize;
+	pSub->nRow = nRow;
+	pSub->nCol = nCol;
+}
+
+uint8_t buffer2dView_isContiguous(const buffer2dView_t *pView) {
+	/* Either rows are contiguous and packed one after another, or columns */
+	return ((pView->colStride == pView->elemSize || pView->nCol <= 1) &&
+			(pView->rowStride == pView->nCol * pView->elemSize || pView->nRow <= 1)) ||
+		   ((pView->rowStride == pView->elemSize || pView->nRow <= 1) &&
+			(pView->colStride == pView->nRow * pView->elemSize || pView->nCol <= 1));
+}
+
+/**
+ * @brief Copy n elements of type from src to dst with the given strides, in bytes.
+ * 		memcpy() of a constant size is inlined by the compiler, and avoids breaking
+ * 		strict aliasing rules for the type of data actually stored.
+ */
+#define BUFFER2D_COPY_STRIDED(type, dst, dstStride, src, srcStride, n)	\
+	do {	\
+		uint32_t k = (n);	\
+		for (; k >= 4; k -= 4) {	\
+			memcpy((dst), (src), sizeof(type));	\
+			memcpy((dst) + (dstStride), (src) + (srcStride), sizeof(type));	\
+			memcpy((dst) + 2 * (dstStride), (src) + 2 * (srcStride), sizeof(type));	\
+			memcpy((dst) + 3 * (dstStride), (src) + 3 * (srcStride), sizeof(type));	\
+			(dst) += 4 * (dstStride);	\
+			(src) += 4 * (srcStride);	\
+		}	\
+		for (; k > 0; k--) {	\
+			memcpy((dst), (src), sizeof(type));	\
+			(dst) += (dstStride);	\
+			(src) += (srcStride);	\
+		}	\
+	} while (0)
+
+/**
+ * @brief Copy a run of n elements with the given strides, in bytes.
+ */
+static void buffer2d_copyRun(void *dst, uint32_t dstStride, const void *src, uint32_t srcStride,
+		uint32_t n, uint32_t elemSize) {
+	uint32_t k;
+
+	if (dstStride == elemSize && srcStride == elemSize) {
+		memcpy(dst, src, n * elemSize);
+		return;
+	}
+
+	switch (elemSize) {
+	case 1:
+		BUFFER2D_COPY_STRIDED(uint8_t, dst, dstStride, src, srcStride, n);
 		break;
 
-	case BUFFER2D_LAYOUT_COLUMN_WISE:
-		memcpy(data, pSelf->data + (jCol * pSelf->nRow + iRow) * pSelf->elemSize, pSelf->elemSize);
+	case 2:
+		BUFFER2D_COPY_STRIDED(uint16_t, dst, dstStride, src, srcStride, n);
+		break;
+
+	case 4:
+		BUFFER2D_COPY_STRIDED(uint32_t, dst, dstStride, src, srcStride, n);
+		break;
+
+	case 8:
+		BUFFER2D_COPY_STRIDED(uint64_t, dst, dstStride, src, srcStride, n);
 		break;
 
 	default:
-		/* Do nothing */
+		for (k = 0; k < n; k++, dst += dstStride, src += srcStride) {
+			memcpy(dst, src, elemSize);
+		}
 		break;
 	}
 }
 
-void buffer2d_getDataRow(buffer2d_t *pSelf, uint32_t iRow, void *data) {
+void buffer2dView_copy(buffer2dView_t *pDst, const buffer2dView_t *pSrc) {
 	uint32_t i;
-	uint32_t jump;
-	void *pData;
+	uint32_t elemSize = pSrc->elemSize;
 
-	switch(pSelf->layout) {
-	case BUFFER2D_LAYOUT_ROW_WISE:
-		memcpy(data, pSelf->data + (iRow * pSelf->nCol) * pSelf->elemSize, pSelf->elemSize * pSelf->nCol);
-		break;
+	if (0 == pSrc->nRow || 0 == pSrc->nCol) {
+		return;
+	}
 
-	case BUFFER2D_LAYOUT_COLUMN_WISE:
-		jump = pSelf->nRow * pSelf->elemSize;
-		pData = pSelf->data + iRow * pSelf->elemSize;
-		for (i = 0; i < pSelf->nCol; i++, data += pSelf->elemSize, pData += jump) {
-			memcpy(data, pData, pSelf->elemSize);
+	if (buffer2dView_isContiguous(pDst) && buffer2dView_isContiguous(pSrc) &&
+		(pDst->nRow <= 1 || pDst->nCol <= 1 ||
+		 (pDst->colStride == pSrc->colStride && pDst->rowStride == pSrc->rowStride))) {
+		/* Same order of elements in memory */
+		memcpy(pDst->data, pSrc->data, pSrc->nRow * pSrc->nCol * elemSize);
+	} else if (pDst->colStride == elemSize || (pSrc->colStride == elemSize && pDst->rowStride != elemSize)) {
+		/* Copy row by row, as rows are contiguous in destination or source */
+		for (i = 0; i < pSrc->nRow; i++) {
+			buffer2d_copyRun(BUFFER2DVIEW_getElemAddr(pDst, i, 0), pDst->colStride,
+					BUFFER2DVIEW_getElemAddr(pSrc, i, 0), pSrc->colStride, pSrc->nCol, elemSize);
 		}
-		break;
+	} else {
+		/* Copy column by column */
+		for (i = 0; i < pSrc->nCol; i++) {
+			buffer2d_copyRun(BUFFER2DVIEW_getElemAddr(pDst, 0, i), pDst->rowStride,
+					BUFFER2DVIEW_getElemAddr(pSrc, 0, i), pSrc->rowStride, pSrc->nRow, elemSize);
+		}
+	}
+}
 
-	default:
-		/* Do nothing */
-		break;
+/**
+ * @brief Fill n contiguous elements with the given element. A repeated byte,
+ * 		e.g. 0 or -1, is a memset(). Otherwise, the element is copied once and the
+ * 		filled part doubled with memcpy() until BUFFER2D_FILL_CHUNK_SIZE, which is
+ * 		then copied repeatedly while it stays in cache.
+ */
+static void buffer2d_fillRun(void *dst, const void *elem, uint32_t n, uint32_t elemSize) {
+	const uint8_t *pElem = (const uint8_t*) elem;
+	uint32_t size, done, chunk, len;
+	uint32_t i;
+
+	size = n * elemSize;
+	if (0 == size) {
+		return;
+	}
+
+	for (i = 1; i < elemSize && pElem[i] == pElem[0]; i++) {
+	}
+	if (i == elemSize) {
+		memset(dst, pElem[0], size);
+		return;
+	}
+
+	memcpy(dst, elem, elemSize);
+	done = elemSize;
+	while (done < size && done <= BUFFER2D_FILL_CHUNK_SIZE / 2) {
+		len = (size - done < done) ? size - done : done;
+		memcpy(dst + done, dst, len);
+		done += len;
+	}
+
+	/* A multiple of elemSize */
+	chunk = done;
+	while (done < size) {
+		len = (size - done < chunk) ? size - done : chunk;
+		memcpy(dst + done, dst, len);
+		done += len;
 	}
 }
 
-void buffer2d_getDataCol(buffer2d_t *pSelf, uint32_t jCol, void *data) {
+void buffer2dView_fill(buffer2dView_t *pView, const void *elem) {
 	uint32_t i;
-	uint32_t jump;
-	void *pData;
 
-	switch(pSelf->layout) {
-	case BUFFER2D_LAYOUT_ROW_WISE:
-		jump = pSelf->nCol * pSelf->elemSize;
-		pData = pSelf->data + jCol * pSelf->elemSize;
-		for (i = 0; i < pSelf->nRow; i++, data += pSelf->elemSize, pData += jump) {
-			memcpy(data, pData, pSelf->elemSize);
+	if (0 == pView->nRow || 0 == pView->nCol) {
+		return;
+	}
+
+	if (buffer2dView_isContiguous(pView)) {
+		buffer2d_fillRun(pView->data, elem, pView->nRow * pView->nCol, pView->elemSize);
+	} else if (pView->colStride == pView->elemSize) {
+		/* Contiguous rows, e.g. padded interleaved buffer */
+		for (i = 0; i < pView->nRow; i++) {
+			buffer2d_fillRun(BUFFER2DVIEW_getElemAddr(pView, i, 0), elem, pView->nCol, pView->elemSize);
 		}
-		break;
+	} else if (pView->rowStride == pView->elemSize) {
+		for (i = 0; i < pView->nCol; i++) {
+			buffer2d_fillRun(BUFFER2DVIEW_getElemAddr(pView, 0, i), elem, pView->nRow, pView->elemSize);
+		}
+	} else if (pView->colStride <= pView->rowStride) {
+		/* The same element is copied again and again, i.e. source stride of 0,
+		 * along the shorter stride */
+		for (i = 0; i < pView->nRow; i++) {
+			buffer2d_copyRun(BUFFER2DVIEW_getElemAddr(pView, i, 0), pView->colStride,
+					elem, 0, pView->nCol, pView->elemSize);
+		}
+	} else {
+		for (i = 0; i < pView->nCol; i++) {
+			buffer2d_copyRun(BUFFER2DVIEW_getElemAddr(pView, 0, i), pView->rowStride,
+					elem, 0, pView->nRow, pView->elemSize);
+		}
+	}
+}
 
-	case BUFFER2D_LAYOUT_COLUMN_WISE:
-		memcpy(data, pSelf->data + (jCol * pSelf->nRow) * pSelf->elemSize, pSelf->elemSize * pSelf->nRow);
-		break;
+/* Kinds of element conversion during layout conversion. */
+#define BUFFER2D_CONV_COPY		(0)
+#define BUFFER2D_CONV_I16_F32	(1)
+#define BUFFER2D_CONV_F32_I16	(2)
+#define BUFFER2D_CONV_I32_F32	(3)
+#define BUFFER2D_CONV_F32_I32	(4)
+
+/* Conversion of a single element. */
+#define BUFFER2D_CONV_NONE(x, scale)	(x)
+#define BUFFER2D_CONV_TO_F32(x, scale)	((float) (x) * (scale))
+#define BUFFER2D_CONV_TO_I16(x, scale)	buffer2d_floatToI16((x) * (scale))
+#define BUFFER2D_CONV_TO_I32(x, scale)	buffer2d_doubleToI32((double) (x) * (scale))
+
+/**
+ * @brief Round to nearest and saturate a float to int16_t.
+ */
+static inline int16_t buffer2d_floatToI16(float x) {
+	if (x >= 32767.0f) {
+		return 32767;
+	} else if (x <= -32768.0f) {
+		return -32768;
+	}
+
+	return (int16_t) (x >= 0.0f ? x + 0.5f : x - 0.5f);
+}
+
+/**
+ * @brief Round to nearest and saturate a double to int32_t.
+ */
+static inline int32_t buffer2d_doubleToI32(double x) {
+	if (x >= 2147483647.0) {
+		return INT32_MAX;
+	} else if (x <= -2147483648.0) {
+		return INT32_MIN;
+	}
+
+	return (int32_t) (x >= 0.0 ? x + 0.5 : x - 0.5);
+}
+
+/* Number of samples per block of layout conversion. One cache line per sample of
+ * the interleaved side, i.e. 16 KiB with 64-byte lines, must fit in L1 cache. */
+#define BUFFER2D_LAYOUT_BLOCK_SIZE	(256)
+
+/* Copy/convert a run of n elements with constant strides, unrolled by 4. */
+#define BUFFER2D_CONVERT_STRIDED(CONV, dc, dstStride, sc, srcStride, n)	\
+	for (i = (n); i >= 4; i -= 4) {	\
+		(dc)[0] = CONV((sc)[0], scale);	\
+		(dc)[(dstStride)] = CONV((sc)[(srcStride)], scale);	\
+		(dc)[2 * (dstStride)] = CONV((sc)[2 * (srcStride)], scale);	\
+		(dc)[3 * (dstStride)] = CONV((sc)[3 * (srcStride)], scale);	\
+		(dc) += 4 * (dstStride);	\
+		(sc) += 4 * (srcStride);	\
+	}	\
+	for (; i > 0; i--) {	\
+		*(dc) = CONV(*(sc), scale);	\
+		(dc) += (dstStride);	\
+		(sc) += (srcStride);	\
+	}
+
+/* Deinterleave a block of samples at a time, channel by channel, so that the
+ * source frames of the block stay in cache while each channel is picked out and
+ * each inner loop has a constant stride. For packed frames of 2, 4, 6, 8 or 16
+ * channels, NCH and SRC_LD are the same compile time constant. */
+#define BUFFER2D_DEINTERLEAVE_BLOCKED(tDst, tSrc, CONV, NCH, SRC_LD)	\
+	for (i0 = 0; i0 < nSample; i0 += BUFFER2D_LAYOUT_BLOCK_SIZE) {	\
+		iEnd = (nSample - i0 > BUFFER2D_LAYOUT_BLOCK_SIZE) ? BUFFER2D_LAYOUT_BLOCK_SIZE : nSample - i0;	\
+		for (c = 0; c < (NCH); c++) {	\
+			tDst *dc = d + c * dstLd + i0;	\
+			const tSrc *sc = s + i0 * (SRC_LD) + c;	\
+			BUFFER2D_CONVERT_STRIDED(CONV, dc, 1, sc, (SRC_LD), iEnd);	\
+		}	\
+	}
+
+/* Interleave a block of samples at a time, see BUFFER2D_DEINTERLEAVE_BLOCKED(). */
+#define BUFFER2D_INTERLEAVE_BLOCKED(tDst, tSrc, CONV, NCH, DST_LD)	\
+	for (i0 = 0; i0 < nSample; i0 += BUFFER2D_LAYOUT_BLOCK_SIZE) {	\
+		iEnd = (nSample - i0 > BUFFER2D_LAYOUT_BLOCK_SIZE) ? BUFFER2D_LAYOUT_BLOCK_SIZE : nSample - i0;	\
+		for (c = 0; c < (NCH); c++) {	\
+			tDst *dc = d + i0 * (DST_LD) + c;	\
+			const tSrc *sc = s + c * srcLd + i0;	\
+			BUFFER2D_CONVERT_STRIDED(CONV, dc, (DST_LD), sc, 1, iEnd);	\
+		}	\
+	}
+
+/**
+ * @brief Macro to define the kernels of layout conversion from tSrc to tDst.
+ * 		In the kernels, the interleaved side has sample i of channel c at
+ * 		i * ld + c and the non-interleaved side at c * ld + i, ld in elements.
+ */
+#define BUFFER2D_DEFINE_LAYOUT_KERNEL(suffix, tDst, tSrc, CONV)	\
+static void buffer2d_deinterleave##suffix(void *dst, uint32_t dstLd, const void *src, uint32_t srcLd,	\
+		uint32_t nSample, uint32_t nCh, float scale) {	\
+	tDst *d = (tDst*) dst;	\
+	const tSrc *s = (const tSrc*) src;	\
+	uint32_t i, c, i0, iEnd;	\
+	\
+	/* Ignored by CONV of plain copy kernels */	\
+	(void) scale;	\
+	switch ((srcLd == nCh) ? nCh : 0) {	\
+	case 2: BUFFER2D_DEINTERLEAVE_BLOCKED(tDst, tSrc, CONV, 2, 2); break;	\
+	case 4: BUFFER2D_DEINTERLEAVE_BLOCKED(tDst, tSrc, CONV, 4, 4); break;	\
+	case 6: BUFFER2D_DEINTERLEAVE_BLOCKED(tDst, tSrc, CONV, 6, 6); break;	\
+	case 8: BUFFER2D_DEINTERLEAVE_BLOCKED(tDst, tSrc, CONV, 8, 8); break;	\
+	case 16: BUFFER2D_DEINTERLEAVE_BLOCKED(tDst, tSrc, CONV, 16, 16); break;	\
+	default:	\
+		BUFFER2D_DEINTERLEAVE_BLOCKED(tDst, tSrc, CONV, nCh, srcLd);	\
+		break;	\
+	}	\
+}	\
+	\
+static void buffer2d_interleave##suffix(void *dst, uint32_t dstLd, const void *src, uint32_t srcLd,	\
+		uint32_t nSample, uint32_t nCh, float scale) {	\
+	tDst *d = (tDst*) dst;	\
+	const tSrc *s = (const tSrc*) src;	\
+	uint32_t i, c, i0, iEnd;	\
+	\
+	/* Ignored by CONV of plain copy kernels */	\
+	(void) scale;	\
+	switch ((dstLd == nCh) ? nCh : 0) {	\
+	case 2: BUFFER2D_INTERLEAVE_BLOCKED(tDst, tSrc, CONV, 2, 2); break;	\
+	case 4: BUFFER2D_INTERLEAVE_BLOCKED(tDst, tSrc, CONV, 4, 4); break;	\
+	case 6: BUFFER2D_INTERLEAVE_BLOCKED(tDst, tSrc, CONV, 6, 6); break;	\
+	case 8: BUFFER2D_INTERLEAVE_BLOCKED(tDst, tSrc, CONV, 8, 8); break;	\
+	case 16: BUFFER2D_INTERLEAVE_BLOCKED(tDst, tSrc, CONV, 16, 16); break;	\
+	default:	\
+		BUFFER2D_INTERLEAVE_BLOCKED(tDst, tSrc, CONV, nCh, dstLd);	\
+		break;	\
+	}	\
+}	\
+	\
+static void buffer2d_convertRun##suffix(void *dst, const void *src, uint32_t n, float scale) {	\
+	tDst * restrict d = (tDst*) dst;	\
+	const tSrc * restrict s = (const tSrc*) src;	\
+	uint32_t i;	\
+	\
+	(void) scale;	\
+	for (i = 0; i < n; i++) {	\
+		d[i] = CONV(s[i], scale);	\
+	}	\
+}	\
+	\
+static const buffer2dLayoutKernel_t buffer2d_layoutKernel##suffix = {	\
+	buffer2d_deinterleave##suffix, buffer2d_interleave##suffix, buffer2d_convertRun##suffix	\
+};
+
+/**
+ * @brief Kernels of layout conversion for one pair of element types.
+ */
+typedef struct {
+	void (*deinterleave)(void *dst, uint32_t dstLd, const void *src, uint32_t srcLd,
+			uint32_t nSample, uint32_t nCh, float scale);
+	void (*interleave)(void *dst, uint32_t dstLd, const void *src, uint32_t srcLd,
+			uint32_t nSample, uint32_t nCh, float scale);
+	void (*convertRun)(void *dst, const void *src, uint32_t n, float scale);
+} buffer2dLayoutKernel_t;
+
+BUFFER2D_DEFINE_LAYOUT_KERNEL(U8, uint8_t, uint8_t, BUFFER2D_CONV_NONE)
+BUFFER2D_DEFINE_LAYOUT_KERNEL(U16, uint16_t, uint16_t, BUFFER2D_CONV_NONE)
+BUFFER2D_DEFINE_LAYOUT_KERNEL(U32, uint32_t, uint32_t, BUFFER2D_CONV_NONE)
+BUFFER2D_DEFINE_LAYOUT_KERNEL(U64, uint64_t, uint64_t, BUFFER2D_CONV_NONE)
+BUFFER2D_DEFINE_LAYOUT_KERNEL(I16F32, float, int16_t, BUFFER2D_CONV_TO_F32)
+BUFFER2D_DEFINE_LAYOUT_KERNEL(F32I16, int16_t, float, BUFFER2D_CONV_TO_I16)
+BUFFER2D_DEFINE_LAYOUT_KERNEL(I32F32, float, int32_t, BUFFER2D_CONV_TO_F32)
+BUFFER2D_DEFINE_LAYOUT_KERNEL(F32I32, int32_t, float, BUFFER2D_CONV_TO_I32)
+
+/**
+ * @brief Get the kernels for a conversion and element size of source.
+ * @return The kernels, or NULL if none, i.e. copy of unusual element size.
+ */
+static const buffer2dLayoutKernel_t* buffer2d_getLayoutKernel(uint32_t conv, uint32_t elemSize) {
+	switch (conv) {
+	case BUFFER2D_CONV_COPY:
+		switch (elemSize) {
+		case 1: return &buffer2d_layoutKernelU8;
+		case 2: return &buffer2d_layoutKernelU16;
+		case 4: return &buffer2d_layoutKernelU32;
+		case 8: return &buffer2d_layoutKernelU64;
+		default: return NULL;
+		}
+
+	case BUFFER2D_CONV_I16_F32:
+		return &buffer2d_layoutKernelI16F32;
+
+	case BUFFER2D_CONV_F32_I16:
+		return &buffer2d_layoutKernelF32I16;
+
+	case BUFFER2D_CONV_I32_F32:
+		return &buffer2d_layoutKernelI32F32;
+
+	case BUFFER2D_CONV_F32_I32:
+		return &buffer2d_layoutKernelF32I32;
 
 	default:
-		/* Do nothing */
-		break;
+		return NULL;
 	}
 }
 
-void buffer2d_fill(buffer2d_t *pSelf, void *elem) {
-	uint32_t i, count;
-	void *pData;
+#ifdef __ARM_NEON
+/**
+ * @brief Widen 8 int16_t to float, scale and store.
+ */
+static inline void buffer2d_storeI16AsF32Neon(float *d, int16x8_t v, float scale) {
+	vst1q_f32(d, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(v))), scale));
+	vst1q_f32(d + 4, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(v))), scale));
+}
 
-	pData = (void*) buffer2d_getBuffer(pSelf);
-	count = pSelf->nRow * pSelf->nCol;
-	for (i = 0; i < count; i++) {
-		memcpy(pData, elem, pSelf->elemSize);
-		pData += pSelf->elemSize;
+/**
+ * @brief Deinterleave whole groups of 8 (4 for 4-byte copy) samples of 2 or 4
+ * 		channels with NEON structure loads. The interleaved source must be packed,
+ * 		i.e. srcLd == nCh.
+ * @return Number of samples done. The remaining are left to the scalar kernel.
+ */
+static uint32_t buffer2d_deinterleaveNeon(uint32_t conv, uint32_t elemSize, void *dst, uint32_t dstLd,
+		const void *src, uint32_t nSample, uint32_t nCh, float scale) {
+	uint32_t i = 0;
+	uint32_t c;
+
+	if (BUFFER2D_CONV_COPY == conv && 2 == elemSize) {
+		int16_t *d = (int16_t*) dst;
+		const int16_t *s = (const int16_t*) src;
+		if (2 == nCh) {
+			for (; i + 8 <= nSample; i += 8) {
+				int16x8x2_t v = vld2q_s16(s + 2 * i);
+				vst1q_s16(d + i, v.val[0]);
+				vst1q_s16(d + dstLd + i, v.val[1]);
+			}
+		} else if (4 == nCh) {
+			for (; i + 8 <= nSample; i += 8) {
+				int16x8x4_t v = vld4q_s16(s + 4 * i);
+				for (c = 0; c < 4; c++) {
+					vst1q_s16(d + c * dstLd + i, v.val[c]);
+				}
+			}
+		}
+	} else if (BUFFER2D_CONV_COPY == conv && 4 == elemSize) {
+		uint32_t *d = (uint32_t*) dst;
+		const uint32_t *s = (const uint32_t*) src;
+		if (2 == nCh) {
+			for (; i + 4 <= nSample; i += 4) {
+				uint32x4x2_t v = vld2q_u32(s + 2 * i);
+				vst1q_u32(d + i, v.val[0]);
+				vst1q_u32(d + dstLd + i, v.val[1]);
+			}
+		} else if (4 == nCh) {
+			for (; i + 4 <= nSample; i += 4) {
+				uint32x4x4_t v = vld4q_u32(s + 4 * i);
+				for (c = 0; c < 4; c++) {
+					vst1q_u32(d + c * dstLd + i, v.val[c]);
+				}
+			}
+		}
+	} else if (BUFFER2D_CONV_I16_F32 == conv) {
+		float *d = (float*) dst;
+		const int16_t *s = (const int16_t*) src;
+		if (2 == nCh) {
+			for (; i + 8 <= nSample; i += 8) {
+				int16x8x2_t v = vld2q_s16(s + 2 * i);
+				buffer2d_storeI16AsF32Neon(d + i, v.val[0], scale);
+				buffer2d_storeI16AsF32Neon(d + dstLd + i, v.val[1], scale);
+			}
+		} else if (4 == nCh) {
+			for (; i + 8 <= nSample; i += 8) {
+				int16x8x4_t v = vld4q_s16(s + 4 * i);
+				for (c = 0; c < 4; c++) {
+					buffer2d_storeI16AsF32Neon(d + c * dstLd + i, v.val[c], scale);
+				}
+			}
+		}
 	}
+
+	return i;
 }
 
-uint32_t buffer2d_getElemSize(const buffer2d_t *pSelf) {
-	return pSelf->elemSize;
+/**
+ * @brief Interleave whole groups of samples of 2 or 4 channels with NEON structure
+ * 		stores, copy only. The interleaved destination must be packed, i.e.
+ * 		dstLd == nCh.
+ * @return Number of samples done. The remaining are left to the scalar kernel.
+ */
+static uint32_t buffer2d_interleaveNeon(uint32_t conv, uint32_t elemSize, void *dst,
+		const void *src, uint32_t srcLd, uint32_t nSample, uint32_t nCh) {
+	uint32_t i = 0;
+	uint32_t c;
+
+	if (BUFFER2D_CONV_COPY == conv && 2 == elemSize) {
+		int16_t *d = (int16_t*) dst;
+		const int16_t *s = (const int16_t*) src;
+		if (2 == nCh) {
+			for (; i + 8 <= nSample; i += 8) {
+				int16x8x2_t v;
+				v.val[0] = vld1q_s16(s + i);
+				v.val[1] = vld1q_s16(s + srcLd + i);
+				vst2q_s16(d + 2 * i, v);
+			}
+		} else if (4 == nCh) {
+			for (; i + 8 <= nSample; i += 8) {
+				int16x8x4_t v;
+				for (c = 0; c < 4; c++) {
+					v.val[c] = vld1q_s16(s + c * srcLd + i);
+				}
+				vst4q_s16(d + 4 * i, v);
+			}
+		}
+	} else if (BUFFER2D_CONV_COPY == conv && 4 == elemSize) {
+		uint32_t *d = (uint32_t*) dst;
+		const uint32_t *s = (const uint32_t*) src;
+		if (2 == nCh) {
+			for (; i + 4 <= nSample; i += 4) {
+				uint32x4x2_t v;
+				v.val[0] = vld1q_u32(s + i);
+				v.val[1] = vld1q_u32(s + srcLd + i);
+				vst2q_u32(d + 2 * i, v);
+			}
+		} else if (4 == nCh) {
+			for (; i + 4 <= nSample; i += 4) {
+				uint32x4x4_t v;
+				for (c = 0; c < 4; c++) {
+					v.val[c] = vld1q_u32(s + c * srcLd + i);
+				}
+				vst4q_u32(d + 4 * i, v);
+			}
+		}
+	}
+
+	return i;
 }
+#endif
 
-uint32_t buffer2d_getNumRow(buffer2d_t *pSelf) {
-	return pSelf->nRow;
+/**
+ * @brief Copy/convert all elements of src into dst, with any combination of layouts.
+ */
+static int32_t buffer2d_convertLayout(buffer2d_t *pDst, const buffer2d_t *pSrc, uint32_t conv,
+		uint32_t dstElemSize, uint32_t srcElemSize, float scale) {
+	const buffer2dLayoutKernel_t *kernel;
+	buffer2dView_t dstView, srcView;
+	uint32_t dstRs, dstCs, srcRs, srcCs;
+	uint32_t nLine, nRun, dstLd, srcLd;
+	uint32_t i, n;
+
+	if (pDst->nRow != pSrc->nRow || pDst->nCol != pSrc->nCol ||
+		pDst->elemSize != dstElemSize || pSrc->elemSize != srcElemSize ||
+		(BUFFER2D_LAYOUT_ROW_WISE != pDst->layout && BUFFER2D_LAYOUT_COLUMN_WISE != pDst->layout) ||
+		(BUFFER2D_LAYOUT_ROW_WISE != pSrc->layout && BUFFER2D_LAYOUT_COLUMN_WISE != pSrc->layout)) {
+		return STATUS_ERROR_PARAM;
+	}
+
+	kernel = buffer2d_getLayoutKernel(conv, srcElemSize);
+	if (NULL == kernel) {
+		/* Copy of unusual element size, strided copy is good enough */
+		buffer2d_getView(pDst, &dstView);
+		buffer2d_getView((buffer2d_t*) pSrc, &srcView);
+		buffer2dView_copy(&dstView, &srcView);
+		return STATUS_OK;
+	}
+
+	buffer2d_getElemStrides(pDst, &dstRs, &dstCs);
+	buffer2d_getElemStrides(pSrc, &srcRs, &srcCs);
+
+	if (pDst->layout == pSrc->layout) {
+		/* Same order of elements, line by line */
+		if (BUFFER2D_LAYOUT_ROW_WISE == pSrc->layout) {
+			nLine = pSrc->nRow;
+			nRun = pSrc->nCol;
+			dstLd = dstRs;
+			srcLd = srcRs;
+		} else {
+			nLine = pSrc->nCol;
+			nRun = pSrc->nRow;
+			dstLd = dstCs;
+			srcLd = srcCs;
+		}
+		for (i = 0; i < nLine; i++) {
+			if (BUFFER2D_CONV_COPY == conv) {
+				memcpy(pDst->data + i * dstLd * dstElemSize, pSrc->data + i * srcLd * srcElemSize,
+						nRun * srcElemSize);
+			} else {
+				kernel->convertRun(pDst->data + i * dstLd * dstElemSize,
+						pSrc->data + i * srcLd * srcElemSize, nRun, scale);
+			}
+		}
+	} else if (BUFFER2D_LAYOUT_ROW_WISE == pSrc->layout) {
+		/* Interleaved to non-interleaved */
+		n = 0;
+#ifdef __ARM_NEON
+		if (srcRs == pSrc->nCol) {
+			n = buffer2d_deinterleaveNeon(conv, srcElemSize, pDst->data, dstCs, pSrc->data,
+					pSrc->nRow, pSrc->nCol, scale);
+		}
+#endif
+		kernel->deinterleave(pDst->data + n * dstElemSize, dstCs,
+				pSrc->data + n * srcRs * srcElemSize, srcRs, pSrc->nRow - n, pSrc->nCol, scale);
+	} else {
+		/* Non-interleaved to interleaved */
+		n = 0;
+#ifdef __ARM_NEON
+		if (dstRs == pDst->nCol) {
+			n = buffer2d_interleaveNeon(conv, srcElemSize, pDst->data, pSrc->data, srcCs,
+					pSrc->nRow, pSrc->nCol);
+		}
+#endif
+		kernel->interleave(pDst->data + n * dstRs * dstElemSize, dstRs,
+				pSrc->data + n * srcElemSize, srcCs, pSrc->nRow - n, pSrc->nCol, scale);
+	}
+
+	return STATUS_OK;
 }
 
-uint32_t buffer2d_getNumCol(buffer2d_t *pSelf) {
-	return pSelf->nCol;
+uint8_t buffer2d_getLayout(const buffer2d_t *pSelf) {
+	return (uint8_t) pSelf->layout;
 }
 
-const void* buffer2d_getBuffer(buffer2d_t *pSelf) {
-	return pSelf->data;
+int32_t buffer2d_copyLayout(buffer2d_t *pDst, const buffer2d_t *pSrc) {
+	return buffer2d_convertLayout(pDst, pSrc, BUFFER2D_CONV_COPY, pSrc->elemSize, pSrc->elemSize, 1.0f);
+}
+
+int32_t buffer2d_convertI16ToF32(buffer2d_t *pDst, const buffer2d_t *pSrc, float scale) {
+	return buffer2d_convertLayout(pDst, pSrc, BUFFER2D_CONV_I16_F32, sizeof(float), sizeof(int16_t), scale);
+}
+
+int32_t buffer2d_convertF32ToI16(buffer2d_t *pDst, const buffer2d_t *pSrc, float scale) {
+	return buffer2d_convertLayout(pDst, pSrc, BUFFER2D_CONV_F32_I16, sizeof(int16_t), sizeof(float), scale);
+}
+
+int32_t buffer2d_convertI32ToF32(buffer2d_t *pDst, const buffer2d_t *pSrc, float scale) {
+	return buffer2d_convertLayout(pDst, pSrc, BUFFER2D_CONV_I32_F32, sizeof(float), sizeof(int32_t), scale);
+}
+
+int32_t buffer2d_convertF32ToI32(buffer2d_t *pDst, const buffer2d_t *pSrc, float scale) {
+	return buffer2d_convertLayout(pDst, pSrc, BUFFER2D_CONV_F32_I32, sizeof(int32_t), sizeof(float), scale);
+}
+
+/**
+ * @brief Get the elements of buffer as runs of contiguous elements, one run for
+ * 		the whole buffer if the lines are not padded, one run per line otherwise.
+ * 		Run i starts i * ld elements after the first element.
+ */
+static inline void buffer2d_getRuns(const buffer2d_t *pSelf, uint32_t *nRun, uint32_t *runLen) {
+	uint32_t nLine, lineLen;
+
+	nLine = (BUFFER2D_LAYOUT_ROW_WISE == pSelf->layout) ? pSelf->nRow : pSelf->nCol;
+	lineLen = (BUFFER2D_LAYOUT_ROW_WISE == pSelf->layout) ? pSelf->nCol : pSelf->nRow;
+	if (pSelf->ld == lineLen) {
+		*nRun = 1;
+		*runLen = nLine * lineLen;
+	} else {
+		*nRun = nLine;
+		*runLen = lineLen;
+	}
+}
+
+/* Saturation of the intermediate result of bulk operations. */
+#define BUFFER2D_SAT_F32(x)		(x)
+#define BUFFER2D_SAT_I16(x)		buffer2d_floatToI16(x)
+#define BUFFER2D_SAT_I32(x)		buffer2d_doubleToI32(x)
+
+/**
+ * @brief Macro to define the bulk operations of a type. The operations are
+ * 		element-wise, so each run of contiguous elements is processed in one
+ * 		loop whatever the layout. tCalc is the type of intermediate result,
+ * 		saturated to type by SAT.
+ */
+#define BUFFER2D_DEFINE_BULK(suffix, type, tCalc, SAT)	\
+int32_t buffer2d_scale##suffix(buffer2d_t *pSelf, float gain) {	\
+	type *p;	\
+	uint32_t nRun, runLen;	\
+	uint32_t i, k;	\
+	\
+	if (pSelf->elemSize != sizeof(type)) {	\
+		return STATUS_ERROR_PARAM;	\
+	}	\
+	buffer2d_getRuns(pSelf, &nRun, &runLen);	\
+	for (k = 0; k < nRun; k++) {	\
+		p = (type*) pSelf->data + k * pSelf->ld;	\
+		for (i = 0; i < runLen; i++) {	\
+			p[i] = SAT((tCalc) p[i] * gain);	\
+		}	\
+	}	\
+	\
+	return STATUS_OK;	\
+}	\
+	\
+int32_t buffer2d_clip##suffix(buffer2d_t *pSelf, type lo, type hi) {	\
+	type *p;	\
+	uint32_t nRun, runLen;	\
+	uint32_t i, k;	\
+	\
+	if (pSelf->elemSize != sizeof(type) || lo > hi) {	\
+		return STATUS_ERROR_PARAM;	\
+	}	\
+	buffer2d_getRuns(pSelf, &nRun, &runLen);	\
+	for (k = 0; k < nRun; k++) {	\
+		p = (type*) pSelf->data + k * pSelf->ld;	\
+		for (i = 0; i < runLen; i++) {	\
+			p[i] = (p[i] < lo) ? lo : ((p[i] > hi) ? hi : p[i]);	\
+		}	\
+	}	\
+	\
+	return STATUS_OK;	\
+}	\
+	\
+int32_t buffer2d_accumulate##suffix(buffer2d_t *pDst, const buffer2d_t *pSrc, float gain) {	\
+	type *d;	\
+	const type *s;	\
+	uint32_t nRun, runLen;	\
+	uint32_t i, k;	\
+	\
+	if (pDst->elemSize != sizeof(type) || pSrc->elemSize != sizeof(type) ||	\
+		pDst->nRow != pSrc->nRow || pDst->nCol != pSrc->nCol || pDst->layout != pSrc->layout) {	\
+		return STATUS_ERROR_PARAM;	\
+	}	\
+	/* Runs of source are the same as destination unless padded differently */	\
+	if (pDst->ld != pSrc->ld) {	\
+		nRun = (BUFFER2D_LAYOUT_ROW_WISE == pDst->layout) ? pDst->nRow : pDst->nCol;	\
+		runLen = (BUFFER2D_LAYOUT_ROW_WISE == pDst->layout) ? pDst->nCol : pDst->nRow;	\
+	} else {	\
+		buffer2d_getRuns(pDst, &nRun, &runLen);	\
+	}	\
+	for (k = 0; k < nRun; k++) {	\
+		d = (type*) pDst->data + k * pDst->ld;	\
+		s = (const type*) pSrc->data + k * pSrc->ld;	\
+		for (i = 0; i < runLen; i++) {	\
+			d[i] = SAT((tCalc) d[i] + (tCalc) s[i] * gain);	\
+		}	\
+	}	\
+	\
+	return STATUS_OK;	\
+}
+
+BUFFER2D_DEFINE_BULK(I16, int16_t, float, BUFFER2D_SAT_I16)
+BUFFER2D_DEFINE_BULK(I32, int32_t, double, BUFFER2D_SAT_I32)
+BUFFER2D_DEFINE_BULK(F32, float, float, BUFFER2D_SAT_F32)
+
+int32_t buffer2d_setLayout(buffer2d_t *pSelf, uint8_t layout) {
+	uint64_t tmp[2][2];
+	uint64_t count, mul, start, k, next;
+	uint32_t elemSize = pSelf->elemSize;
+
+	if (layout == pSelf->layout) {
+		return STATUS_OK;
+	}
+	if ((BUFFER2D_LAYOUT_ROW_WISE != layout && BUFFER2D_LAYOUT_COLUMN_WISE != layout) ||
+		elemSize > sizeof(tmp[0]) ||
+		pSelf->ld != ((BUFFER2D_LAYOUT_ROW_WISE == pSelf->layout) ? pSelf->nCol : pSelf->nRow)) {
+		return STATUS_ERROR_PARAM;
+	}
+
+	/* In-place transposition by following the cycles of the permutation. The
+	 * element at index k moves to k * mul mod (count - 1), where mul is the number
+	 * of elements per line of the new layout; first and last never move. */
+	count = (uint64_t) pSelf->nRow * pSelf->nCol;
+	mul = (BUFFER2D_LAYOUT_ROW_WISE == pSelf->layout) ? pSelf->nRow : pSelf->nCol;
+	for (start = 1; start + 1 < count; start++) {
+		/* Move each cycle once, from its smallest index */
+		next = (start * mul) % (count - 1);
+		while (next > start) {
+			next = (next * mul) % (count - 1);
+		}
+		if (next != start) {
+			continue;
+		}
+
+		memcpy(tmp[0], pSelf->data + start * elemSize, elemSize);
+		k = start;
+		do {
+			next = (k * mul) % (count - 1);
+			memcpy(tmp[1], pSelf->data + next * elemSize, elemSize);
+			memcpy(pSelf->data + next * elemSize, tmp[0], elemSize);
+			memcpy(tmp[0], tmp[1], elemSize);
+			k = next;
+		} while (k != start);
+	}
+
+	pSelf->layout = layout;
+	pSelf->ld = (BUFFER2D_LAYOUT_ROW_WISE == layout) ? pSelf->nCol : pSelf->nRow;
+	return STATUS_OK;
+}
+
+/**
+ * @brief Format val as "%d, " without printf().
+ * @return Number of characters written, at most BUFFER2D_PRINT_ELEM_MAX.
+ */
+static uint32_t buffer2d_formatInt(char *str, int32_t val) {
+	char digit[10];
+	uint32_t u;
+	uint32_t n = 0;
+	uint32_t len = 0;
+
+	u = (val < 0) ? 0u - (uint32_t) val : (uint32_t) val;
+	do {
+		digit[n++] = (char) ('0' + u % 10);
+		u /= 10;
+	} while (0 != u);
+
+	if (val < 0) {
+		str[len++] = '-';
+	}
+	while (n > 0) {
+		str[len++] = digit[--n];
+	}
+	str[len++] = ',';
+	str[len++] = ' ';
+
+	return len;
 }
 
 void buffer2d_print(buffer2d_t *pSelf) {
+	char line[BUFFER2D_PRINT_BUFFER_SIZE];
+	buffer2dView_t view;
+	const void *pElem;
+	int32_t val;
+	uint32_t len = 0;
 	uint32_t i, j;
-	uint8_t val8;
-	uint16_t val16;
-	uint32_t val32;
 
-	switch(pSelf->elemSize) {
-	case 1:
-		for (i = 0; i < pSelf->nRow; i++) {
-			for (j = 0; j < pSelf->nCol; j++) {
-				buffer2d_getDataSingle(pSelf, i, j, &val8);
-				fprintf(stdout, "%d, ", val8);
-			}
-			fprintf(stdout, "\n");
-		}
-		break;
+	if (1 != pSelf->elemSize && 2 != pSelf->elemSize && 4 != pSelf->elemSize) {
+		return;
+	}
 
-	case 2:
-		for (i = 0; i < pSelf->nRow; i++) {
-			for (j = 0; j < pSelf->nCol; j++) {
-				buffer2d_getDataSingle(pSelf, i, j, &val16);
-				fprintf(stdout, "%d, ", val16);
+	/* Formatted into a local buffer, written out when full */
+	buffer2d_getView(pSelf, &view);
+	for (i = 0; i < view.nRow; i++) {
+		for (j = 0; j < view.nCol; j++) {
+			pElem = BUFFER2DVIEW_getElemAddr(&view, i, j);
+			switch(pSelf->elemSize) {
+			case 1:
+				val = *(const uint8_t*) pElem;
+				break;
+
+			case 2:
+				val = *(const uint16_t*) pElem;
+				break;
+
+			default:
+				val = *(const int32_t*) pElem;
+				break;
 			}
-			fprintf(stdout, "\n");
-		}
-		break;
 
-	case 4:
-		for (i = 0; i < pSelf->nRow; i++) {
-			for (j = 0; j < pSelf->nCol; j++) {
-				buffer2d_getDataSingle(pSelf, i, j, &val32);
-				fprintf(stdout, "%d, ", val32);
+			if (len + BUFFER2D_PRINT_ELEM_MAX + 1 > sizeof(line)) {
+				fwrite(line, 1, len, stdout);
+				len = 0;
 			}
-			fprintf(stdout, "\n");
+			len += buffer2d_formatInt(line + len, val);
 		}
-		break;
+		line[len++] = '\n';
 	}
+	fwrite(line, 1, len, stdout);
 }
@@ -5,10 +5,132 @@
  *      Author: chiong
  */
 
+/* 64-bit off_t, so that files of more than 2 GB can be mapped in chunks on 32-bit. */
+#define _FILE_OFFSET_BITS	64
+
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include "util/file.h"
 #include "util/status.h"
 
+/* Size, in bytes, of each window if the whole file cannot be mapped. */
+#define FILE_MAP_CHUNK_DEFAULT		(64u << 20)
+
+struct fileMap_s {
+	/* -1 if not opened. */
+	int fd;
+	/* Read-only. As configured. */
+	uint64_t offset;
+	uint32_t elemSize;
+	uint32_t nChannel;
+	int advice;
+	/* Read-only. Number of elements after offset, whole frames only. */
+	uint64_t count;
+	/* Read-only. Number of elements per window, whole frames only. */
+	uint64_t chunkCount;
+	/* Read-only. Non-zero if the whole file is mapped once. */
+	uint8_t isWhole;
+	/* Current mapping, of the whole file or of a window, NULL if none. */
+	void *mapAddr;
+	size_t mapLen;
+	/* Index, in elements, of first element of next file_mapNext(). */
+	uint64_t next;
+};
+
+/* FILE_MAP_ADVICE_* to madvise() advice. */
+static const int file_mapAdvice[] = { MADV_NORMAL, MADV_SEQUENTIAL, MADV_RANDOM };
+
+/* Identification of recording, block and index. */
+#define FILE_REC_MAGIC			"LCRF"
+#define FILE_REC_BLOCK_MAGIC	"LCRB"
+#define FILE_REC_INDEX_MAGIC	"LCRI"
+#define FILE_REC_VERSION		(1)
+/* Maximum size, in bytes, of the varint of a zig-zag int16_t difference. */
+#define FILE_REC_VARINT_MAX		(3)
+/* Initial number of entries of index, doubled when full. */
+#define FILE_REC_INDEX_INIT		(64)
+
+/**
+ * @brief Header of each block of recording, followed by payloadSize bytes of frames.
+ */
+typedef struct {
+	char magic[4];
+	uint16_t stream;
+	uint16_t reserved;
+	uint32_t nFrame;
+	uint32_t payloadSize;
+	/* Timestamp, in ns, of first frame. */
+	uint64_t timestamp;
+} fileRecBlock_t;
+
+/**
+ * @brief Entry of index of recording, one per block in order of file.
+ */
+typedef struct {
+	uint64_t timestamp;
+	uint32_t block;
+	uint16_t stream;
+	uint16_t reserved;
+} fileRecIndex_t;
+
+/**
+ * @brief Footer of recording, at the end of file after index.
+ */
+typedef struct {
+	char magic[4];
+	uint32_t nBlock;
+	uint64_t indexOffset;
+} fileRecFooter_t;
+
+/**
+ * @brief Block being filled, one per stream.
+ */
+typedef struct {
+	/* blockSize bytes, starting with fileRecBlock_t. */
+	uint8_t *block;
+	/* Size, in bytes, of frames in block. */
+	uint32_t used;
+	uint32_t nFrame;
+	/* Size, in bytes, of a frame not encoded. */
+	uint32_t frameSize;
+	/* Last frame written, for FILE_REC_ENC_DELTA. */
+	int16_t *last;
+} fileRecPending_t;
+
+struct fileRecWriter_s {
+	FILE *file;
+	uint32_t blockSize;
+	uint16_t nStream;
+	fileRecStream_t *stream;
+	fileRecPending_t *pending;
+	/* Index of all blocks written, grown as needed. */
+	fileRecIndex_t *index;
+	uint32_t nBlock;
+	uint32_t nIndexMax;
+	uint8_t isError;
+};
+
+struct fileRecReader_s {
+	fileMap_t *map;
+	/* Address of block 0 if the whole file is mapped, NULL if mapped in chunks. */
+	const uint8_t *blockAddr;
+	/* Chunk mapped last, reused while blocks looked up fall in it. */
+	fileMapView_t window;
+	uint32_t blockSize;
+	uint16_t nStream;
+	fileRecStream_t *stream;
+	/* Index entries of each stream, in order of time. */
+	fileRecIndex_t **index;
+	uint32_t *nIndex;
+	/* Position in index of next block of each stream. */
+	uint32_t *cursor;
+};
+
 int32_t file_readBinN(void* buffer, uint32_t size, uint32_t count, const char* filename) {
 	FILE *f;
 	uint32_t nRead;
@@ -29,3 +151,802 @@ int32_t file_readBinN(void* buffer, uint32_t size, uint32_t count, const char* f
 
 	return nRead;
 }
+
+int32_t file_mapOpen(fileMap_t **ppSelf, const fileMapCfg_t *cfg) {
+	fileMap_t *pSelf;
+	struct stat st;
+	uint64_t size;
+	uint64_t frameSize;
+	uint32_t chunkSize;
+	void *addr;
+
+	if (0 == cfg->elemSize || cfg->advice >= sizeof(file_mapAdvice) / sizeof(file_mapAdvice[0])) {
+		return STATUS_ERROR_PARAM;
+	}
+
+	pSelf = (fileMap_t*) calloc(1, sizeof(fileMap_t));
+	if (NULL == pSelf) {
+		return STATUS_ERROR_MALLOC;
+	}
+	pSelf->offset = cfg->offset;
+	pSelf->elemSize = cfg->elemSize;
+	pSelf->nChannel = (0 == cfg->nChannel) ? 1 : cfg->nChannel;
+	pSelf->advice = file_mapAdvice[cfg->advice];
+
+	pSelf->fd = open(cfg->filename, O_RDONLY);
+	if (pSelf->fd < 0) {
+		free(pSelf);
+		return STATUS_ERROR_FILE_OPEN;
+	}
+	if (fstat(pSelf->fd, &st) != 0) {
+		file_mapClose(&pSelf);
+		return STATUS_ERROR;
+	}
+	size = (uint64_t) st.st_size;
+	if (cfg->offset > size) {
+		file_mapClose(&pSelf);
+		return STATUS_ERROR_PARAM;
+	}
+	frameSize = (uint64_t) pSelf->elemSize * pSelf->nChannel;
+	pSelf->count = (size - cfg->offset) / frameSize * pSelf->nChannel;
+
+	chunkSize = cfg->chunkSize;
+	if (0 == chunkSize) {
+		if (0 == pSelf->count) {
+			/* Nothing to map, mmap() of 0 byte fails */
+			pSelf->isWhole = 1;
+		} else if (size <= SIZE_MAX) {
+			addr = mmap(NULL, (size_t) size, PROT_READ, MAP_PRIVATE, pSelf->fd, 0);
+			if (MAP_FAILED != addr) {
+				pSelf->mapAddr = addr;
+				pSelf->mapLen = (size_t) size;
+				pSelf->isWhole = 1;
+				madvise(addr, pSelf->mapLen, pSelf->advice);
+			}
+		}
+		/* Windows are used if the whole file cannot be mapped, e.g. too large
+		 * for address space */
+		chunkSize = FILE_MAP_CHUNK_DEFAULT;
+	}
+	pSelf->chunkCount = chunkSize / frameSize * pSelf->nChannel;
+	if (0 == pSelf->chunkCount) {
+		pSelf->chunkCount = pSelf->nChannel;
+	}
+
+	*ppSelf = pSelf;
+	return STATUS_OK;
+}
+
+int32_t file_mapClose(fileMap_t **ppSelf) {
+	fileMap_t *pSelf = *ppSelf;
+
+	if (NULL != pSelf) {
+		if (NULL != pSelf->mapAddr)
+			munmap(pSelf->mapAddr, pSelf->mapLen);
+		if (pSelf->fd >= 0)
+			close(pSelf->fd);
+
+		free(pSelf);
+		*ppSelf = NULL;
+	}
+
+	return STATUS_OK;
+}
+
+uint64_t file_mapGetCount(const fileMap_t *pSelf) {
+	return pSelf->count;
+}
+
+/**
+ * @brief Fill a view of count elements from element index, at address data.
+ */
+static void file_mapSetView(const fileMap_t *pSelf, fileMapView_t *pView, const void *data,
+		uint64_t index, uint64_t count) {
+	pView->data = data;
+	pView->count = count;
+	pView->index = index;
+	pView->elemSize = pSelf->elemSize;
+	pView->nChannel = pSelf->nChannel;
+}
+
+int32_t file_mapGetView(const fileMap_t *pSelf, fileMapView_t *pView) {
+	if (!pSelf->isWhole) {
+		return STATUS_ERROR_PARAM;
+	}
+
+	file_mapSetView(pSelf, pView, (NULL == pSelf->mapAddr) ? NULL : pSelf->mapAddr + pSelf->offset,
+			0, pSelf->count);
+	return STATUS_OK;
+}
+
+int32_t file_mapNext(fileMap_t *pSelf, fileMapView_t *pView) {
+	uint64_t pos, start, n;
+	long pageSize;
+	void *addr;
+
+	if (pSelf->next >= pSelf->count) {
+		file_mapSetView(pSelf, pView, NULL, pSelf->count, 0);
+		return STATUS_OK;
+	}
+
+	pos = pSelf->offset + pSelf->next * pSelf->elemSize;
+	if (pSelf->isWhole) {
+		/* Rest of file in one view */
+		n = pSelf->count - pSelf->next;
+		file_mapSetView(pSelf, pView, pSelf->mapAddr + pos, pSelf->next, n);
+		pSelf->next += n;
+		return STATUS_OK;
+	}
+
+	n = pSelf->count - pSelf->next;
+	if (n > pSelf->chunkCount) {
+		n = pSelf->chunkCount;
+	}
+
+	if (NULL != pSelf->mapAddr) {
+		munmap(pSelf->mapAddr, pSelf->mapLen);
+		pSelf->mapAddr = NULL;
+	}
+
+	/* mmap() offset must be a multiple of page size */
+	pageSize = sysconf(_SC_PAGESIZE);
+	start = pos - pos % (uint64_t) pageSize;
+	pSelf->mapLen = (size_t) (pos - start + n * pSelf->elemSize);
+	addr = mmap(NULL, pSelf->mapLen, PROT_READ, MAP_PRIVATE, pSelf->fd, (off_t) start);
+	if (MAP_FAILED == addr) {
+		return STATUS_ERROR;
+	}
+	pSelf->mapAddr = addr;
+	madvise(addr, pSelf->mapLen, pSelf->advice);
+
+#ifdef POSIX_FADV_WILLNEED
+	/* Start reading the next window while this one is processed */
+	if (MADV_SEQUENTIAL == pSelf->advice && pSelf->next + n < pSelf->count) {
+		posix_fadvise(pSelf->fd, (off_t) (pos + n * pSelf->elemSize),
+				(off_t) (pSelf->chunkCount * pSelf->elemSize), POSIX_FADV_WILLNEED);
+	}
+#endif
+
+	file_mapSetView(pSelf, pView, addr + (pos - start), pSelf->next, n);
+	pSelf->next += n;
+	return STATUS_OK;
+}
+
+int32_t file_mapSeek(fileMap_t *pSelf, uint64_t index) {
+	if (index > pSelf->count) {
+		return STATUS_ERROR_PARAM;
+	}
+
+	pSelf->next = index - index % pSelf->nChannel;
+	return STATUS_OK;
+}
+
+void file_mapViewAsBuffer2d(const fileMapView_t *pView, buffer2dView_t *pBuffer2dView) {
+	/* Mapping is read-only, the caller must not write through the 2D buffer view */
+	buffer2dView_init(pBuffer2dView, (void*) pView->data, (uint32_t) (pView->count / pView->nChannel),
+			pView->nChannel, pView->elemSize, BUFFER2D_LAYOUT_ROW_WISE);
+}
+
+static uint32_t file_recGetElemSize(uint8_t type) {
+	switch(type) {
+	case FILE_REC_TYPE_U8:
+		return 1;
+
+	case FILE_REC_TYPE_I16:
+		return sizeof(int16_t);
+
+	case FILE_REC_TYPE_I32:
+	case FILE_REC_TYPE_F32:
+		return sizeof(int32_t);
+
+	default:
+		return 0;
+	}
+}
+
+/**
+ * @brief Get the maximum size, in bytes, of a frame in block.
+ */
+static uint32_t file_recGetMaxFrameSize(const fileRecStream_t *desc) {
+	if (FILE_REC_ENC_DELTA == desc->encoding) {
+		return desc->nChannel * FILE_REC_VARINT_MAX;
+	}
+
+	return desc->nChannel * file_recGetElemSize(desc->type);
+}
+
+/**
+ * @brief Check a stream descriptor, given or read from file.
+ * @return Non-zero if valid for blocks of capacity bytes.
+ */
+static uint8_t file_recIsStreamValid(const fileRecStream_t *desc, uint32_t capacity) {
+	return 0 != file_recGetElemSize(desc->type) && 0 != desc->nChannel &&
+			(FILE_REC_ENC_RAW == desc->encoding ||
+			(FILE_REC_ENC_DELTA == desc->encoding && FILE_REC_TYPE_I16 == desc->type)) &&
+			file_recGetMaxFrameSize(desc) <= capacity;
+}
+
+/**
+ * @brief Encode a frame as zig-zag varints of the difference from prev, or from
+ * 		0 if prev is NULL.
+ * @return Number of bytes written.
+ */
+static uint32_t file_recEncodeDelta(uint8_t *dst, const int16_t *frame, const int16_t *prev, uint16_t nChannel) {
+	uint8_t *p = dst;
+	uint32_t z;
+	int32_t d;
+	uint16_t c;
+
+	for (c = 0; c < nChannel; c++) {
+		d = (int32_t) frame[c] - ((NULL == prev) ? 0 : prev[c]);
+		z = ((uint32_t) d << 1) ^ (uint32_t) (d >> 31);
+		while (z >= 0x80) {
+			*p++ = (uint8_t) (z | 0x80);
+			z >>= 7;
+		}
+		*p++ = (uint8_t) z;
+	}
+
+	return (uint32_t) (p - dst);
+}
+
+/**
+ * @brief Decode nFrame frames encoded by file_recEncodeDelta() from size bytes.
+ */
+static int32_t file_recDecodeDelta(int16_t *dst, const uint8_t *src, uint32_t size, uint32_t nFrame,
+		uint16_t nChannel) {
+	const uint8_t *end = src + size;
+	uint32_t i, n, z, shift;
+	uint8_t b;
+	int32_t d;
+
+	n = nFrame * nChannel;
+	for (i = 0; i < n; i++) {
+		z = 0;
+		shift = 0;
+		do {
+			if (src >= end || shift > 7 * (FILE_REC_VARINT_MAX - 1)) {
+				return STATUS_ERROR;
+			}
+			b = *src++;
+			z |= (uint32_t) (b & 0x7F) << shift;
+			shift += 7;
+		} while (b & 0x80);
+
+		d = (int32_t) (z >> 1) ^ -(int32_t) (z & 1);
+		dst[i] = (int16_t) (((i >= nChannel) ? dst[i - nChannel] : 0) + d);
+	}
+
+	return STATUS_OK;
+}
+
+/**
+ * @brief Write the block of a stream, if not empty, and add it to index.
+ */
+static int32_t file_recFlushBlock(fileRecWriter_t *pSelf, uint16_t stream) {
+	fileRecPending_t *pending = &pSelf->pending[stream];
+	fileRecBlock_t *header = (fileRecBlock_t*) pending->block;
+	fileRecIndex_t *index;
+	uint32_t nFrame;
+
+	nFrame = pending->nFrame;
+	if (0 == nFrame) {
+		return STATUS_OK;
+	}
+
+	header->nFrame = nFrame;
+	header->payloadSize = pending->used;
+	memset(pending->block + sizeof(fileRecBlock_t) + pending->used, 0,
+			pSelf->blockSize - sizeof(fileRecBlock_t) - pending->used);
+	pending->nFrame = 0;
+	pending->used = 0;
+
+	if (fwrite(pending->block, pSelf->blockSize, 1, pSelf->file) != 1) {
+		pSelf->isError = 1;
+		return STATUS_ERROR;
+	}
+
+	if (pSelf->nBlock == pSelf->nIndexMax) {
+		index = (fileRecIndex_t*) realloc(pSelf->index, 2 * pSelf->nIndexMax * sizeof(fileRecIndex_t));
+		if (NULL == index) {
+			/* The block is in file, but the index will not be. Readers rebuild it. */
+			pSelf->isError = 1;
+			return STATUS_ERROR_MALLOC;
+		}
+		pSelf->index = index;
+		pSelf->nIndexMax *= 2;
+	}
+	index = &pSelf->index[pSelf->nBlock++];
+	index->timestamp = header->timestamp;
+	index->block = pSelf->nBlock - 1;
+	index->stream = stream;
+	index->reserved = 0;
+
+	return STATUS_OK;
+}
+
+int32_t file_recOpen(fileRecWriter_t **ppSelf, const fileRecCfg_t *cfg) {
+	fileRecWriter_t *pSelf;
+	fileRecHeader_t *header;
+	fileRecPending_t *pending;
+	uint8_t *block;
+	uint32_t capacity;
+	uint16_t i;
+	size_t nWritten;
+
+	if (NULL == cfg->filename || NULL == cfg->stream || 0 == cfg->nStream ||
+		cfg->blockSize < FILE_REC_BLOCK_SIZE_MIN || (cfg->blockSize & 7) != 0 ||
+		sizeof(fileRecHeader_t) + (uint64_t) cfg->nStream * sizeof(fileRecStream_t) > cfg->blockSize) {
+		return STATUS_ERROR_PARAM;
+	}
+
+	capacity = cfg->blockSize - sizeof(fileRecBlock_t);
+	for (i = 0; i < cfg->nStream; i++) {
+		if (!file_recIsStreamValid(&cfg->stream[i], capacity)) {
+			return STATUS_ERROR_PARAM;
+		}
+	}
+
+	pSelf = (fileRecWriter_t*) calloc(1, sizeof(fileRecWriter_t));
+	if (NULL == pSelf) {
+		return STATUS_ERROR_MALLOC;
+	}
+	pSelf->blockSize = cfg->blockSize;
+	pSelf->nStream = cfg->nStream;
+	pSelf->nIndexMax = FILE_REC_INDEX_INIT;
+	pSelf->stream = (fileRecStream_t*) malloc(cfg->nStream * sizeof(fileRecStream_t));
+	pSelf->pending = (fileRecPending_t*) calloc(cfg->nStream, sizeof(fileRecPending_t));
+	pSelf->index = (fileRecIndex_t*) malloc(pSelf->nIndexMax * sizeof(fileRecIndex_t));
+	block = (uint8_t*) calloc(1, cfg->blockSize);
+	if (NULL == pSelf->stream || NULL == pSelf->pending || NULL == pSelf->index || NULL == block) {
+		free(block);
+		file_recClose(&pSelf);
+		return STATUS_ERROR_MALLOC;
+	}
+	memcpy(pSelf->stream, cfg->stream, cfg->nStream * sizeof(fileRecStream_t));
+
+	for (i = 0; i < cfg->nStream; i++) {
+		pending = &pSelf->pending[i];
+		pending->frameSize = cfg->stream[i].nChannel * file_recGetElemSize(cfg->stream[i].type);
+		pending->block = (uint8_t*) calloc(1, cfg->blockSize);
+		if (FILE_REC_ENC_DELTA == cfg->stream[i].encoding) {
+			pending->last = (int16_t*) malloc(pending->frameSize);
+		}
+		if (NULL == pending->block || (FILE_REC_ENC_DELTA == cfg->stream[i].encoding && NULL == pending->last)) {
+			free(block);
+			file_recClose(&pSelf);
+			return STATUS_ERROR_MALLOC;
+		}
+	}
+
+	pSelf->file = fopen(cfg->filename, "wb");
+	if (NULL == pSelf->file) {
+		free(block);
+		file_recClose(&pSelf);
+		return STATUS_ERROR_FILE_OPEN;
+	}
+
+	/* Header and descriptors take the whole first block */
+	header = (fileRecHeader_t*) block;
+	memcpy(header->magic, FILE_REC_MAGIC, sizeof(header->magic));
+	header->version = FILE_REC_VERSION;
+	header->nStream = cfg->nStream;
+	header->blockSize = cfg->blockSize;
+	memcpy(block + sizeof(fileRecHeader_t), cfg->stream, cfg->nStream * sizeof(fileRecStream_t));
+	nWritten = fwrite(block, cfg->blockSize, 1, pSelf->file);
+	free(block);
+	if (nWritten != 1) {
+		file_recClose(&pSelf);
+		return STATUS_ERROR;
+	}
+
+	*ppSelf = pSelf;
+	return STATUS_OK;
+}
+
+int32_t file_recClose(fileRecWriter_t **ppSelf) {
+	fileRecWriter_t *pSelf = *ppSelf;
+	fileRecFooter_t footer;
+	int32_t status = STATUS_OK;
+	uint16_t i;
+
+	if (NULL != pSelf) {
+		if (NULL != pSelf->file) {
+			for (i = 0; i < pSelf->nStream; i++) {
+				file_recFlushBlock(pSelf, i);
+			}
+
+			/* Index right after the last block */
+			memcpy(footer.magic, FILE_REC_INDEX_MAGIC, sizeof(footer.magic));
+			footer.nBlock = pSelf->nBlock;
+			footer.indexOffset = (uint64_t) (pSelf->nBlock + 1) * pSelf->blockSize;
+			if (!pSelf->isError && (fwrite(pSelf->index, sizeof(fileRecIndex_t), pSelf->nBlock, pSelf->file) != pSelf->nBlock ||
+				fwrite(&footer, sizeof(footer), 1, pSelf->file) != 1)) {
+				pSelf->isError = 1;
+			}
+			if (fclose(pSelf->file) != 0 || pSelf->isError) {
+				status = STATUS_ERROR;
+			}
+		}
+
+		if (NULL != pSelf->pending) {
+			for (i = 0; i < pSelf->nStream; i++) {
+				free(pSelf->pending[i].block);
+				free(pSelf->pending[i].last);
+			}
+			free(pSelf->pending);
+		}
+		free(pSelf->stream);
+		free(pSelf->index);
+
+		free(pSelf);
+		*ppSelf = NULL;
+	}
+
+	return status;
+}
+
+int32_t file_recWrite(fileRecWriter_t *pSelf, uint16_t stream, uint64_t timestamp,
+		const void *frames, uint32_t nFrame) {
+	const fileRecStream_t *desc;
+	fileRecPending_t *pending;
+	fileRecBlock_t *header;
+	uint8_t *payload;
+	uint32_t capacity, maxFrameSize, n, i;
+	int32_t status;
+
+	if (stream >= pSelf->nStream) {
+		return STATUS_ERROR_PARAM;
+	}
+	desc = &pSelf->stream[stream];
+	pending = &pSelf->pending[stream];
+	header = (fileRecBlock_t*) pending->block;
+	payload = pending->block + sizeof(fileRecBlock_t);
+	capacity = pSelf->blockSize - sizeof(fileRecBlock_t);
+	maxFrameSize = file_recGetMaxFrameSize(desc);
+
+	for (i = 0; i < nFrame; i += n) {
+		if (pending->used + maxFrameSize > capacity) {
+			status = file_recFlushBlock(pSelf, stream);
+			if (STATUS_OK != status) {
+				return status;
+			}
+		}
+
+		if (0 == pending->nFrame) {
+			memcpy(header->magic, FILE_REC_BLOCK_MAGIC, sizeof(header->magic));
+			header->stream = stream;
+			header->reserved = 0;
+			header->timestamp = timestamp;
+			if (desc->rate > 0.0f) {
+				header->timestamp += (uint64_t) ((double) i * 1e9 / desc->rate);
+			}
+		}
+
+		if (FILE_REC_ENC_DELTA == desc->encoding) {
+			/* One frame at a time, as the size varies */
+			n = 1;
+			pending->used += file_recEncodeDelta(payload + pending->used, (const int16_t*) frames,
+					(0 == pending->nFrame) ? NULL : pending->last, desc->nChannel);
+			memcpy(pending->last, frames, pending->frameSize);
+		} else {
+			/* As many frames as fit */
+			n = (capacity - pending->used) / pending->frameSize;
+			if (n > nFrame - i) {
+				n = nFrame - i;
+			}
+			memcpy(payload + pending->used, frames, n * pending->frameSize);
+			pending->used += n * pending->frameSize;
+		}
+		pending->nFrame += n;
+		frames += n * pending->frameSize;
+	}
+
+	return STATUS_OK;
+}
+
+/**
+ * @brief Get the address of block k of recording, mapping it if needed.
+ * @return Address of block, NULL if it cannot be mapped.
+ */
+static const uint8_t* file_recGetBlock(fileRecReader_t *pSelf, uint32_t k) {
+	fileMapView_t view;
+
+	if (NULL != pSelf->blockAddr) {
+		return pSelf->blockAddr + (uintptr_t) k * pSelf->blockSize;
+	}
+
+	view = pSelf->window;
+	if (k < view.index || k - view.index >= view.count) {
+		/* Mapping a chunk is costly, so blocks near each other share one */
+		pSelf->window.count = 0;
+		if (file_mapSeek(pSelf->map, k) != STATUS_OK || file_mapNext(pSelf->map, &view) != STATUS_OK ||
+			0 == view.count) {
+			return NULL;
+		}
+		pSelf->window = view;
+	}
+
+	return (const uint8_t*) view.data + (uintptr_t) (k - view.index) * pSelf->blockSize;
+}
+
+/**
+ * @brief Read the index at the end of file if there is a valid one, otherwise
+ * 		rebuild it from the block headers.
+ * @return Index of all blocks, to be freed by caller, or NULL if failed.
+ */
+static fileRecIndex_t* file_recLoadIndex(fileRecReader_t *pSelf, FILE *file, uint32_t *nBlock) {
+	const fileRecBlock_t *block;
+	fileRecIndex_t *index;
+	fileRecFooter_t footer;
+	uint64_t size, nInFile;
+	uint32_t k;
+
+	fseeko(file, 0, SEEK_END);
+	size = (uint64_t) ftello(file);
+	nInFile = file_mapGetCount(pSelf->map);
+
+	if (size >= sizeof(footer) && fseeko(file, (off_t) (size - sizeof(footer)), SEEK_SET) == 0 &&
+		fread(&footer, sizeof(footer), 1, file) == 1 &&
+		memcmp(footer.magic, FILE_REC_INDEX_MAGIC, sizeof(footer.magic)) == 0 &&
+		footer.indexOffset == (uint64_t) (footer.nBlock + 1) * pSelf->blockSize &&
+		footer.indexOffset + (uint64_t) footer.nBlock * sizeof(fileRecIndex_t) + sizeof(footer) == size) {
+		/* + 1 so that an empty recording is not a failure of malloc() */
+		index = (fileRecIndex_t*) malloc((footer.nBlock + 1) * sizeof(fileRecIndex_t));
+		if (NULL != index && fseeko(file, (off_t) footer.indexOffset, SEEK_SET) == 0 &&
+			fread(index, sizeof(fileRecIndex_t), footer.nBlock, file) == footer.nBlock) {
+			/* A corrupt entry would point past the blocks mapped */
+			for (k = 0; k < footer.nBlock && index[k].block < nInFile; k++) {
+			}
+			if (k == footer.nBlock) {
+				*nBlock = footer.nBlock;
+				return index;
+			}
+		}
+		free(index);
+	}
+
+	/* No index, e.g. recording cut short. Blocks are complete up to the first bad magic. */
+	index = (fileRecIndex_t*) malloc((nInFile + 1) * sizeof(fileRecIndex_t));
+	if (NULL == index) {
+		return NULL;
+	}
+	for (k = 0; k < nInFile; k++) {
+		block = (const fileRecBlock_t*) file_recGetBlock(pSelf, k);
+		if (NULL == block || memcmp(block->magic, FILE_REC_BLOCK_MAGIC, sizeof(block->magic)) != 0) {
+			break;
+		}
+		index[k].timestamp = block->timestamp;
+		index[k].block = k;
+		index[k].stream = block->stream;
+		index[k].reserved = 0;
+	}
+	*nBlock = k;
+
+	return index;
+}
+
+int32_t file_recReaderOpen(fileRecReader_t **ppSelf, const char *filename) {
+	fileRecReader_t *pSelf;
+	fileRecHeader_t header;
+	fileRecIndex_t *index;
+	fileMapCfg_t mapCfg;
+	fileMapView_t view;
+	FILE *file;
+	uint32_t nBlock, k;
+	uint16_t s;
+	int32_t status;
+
+	file = fopen(filename, "rb");
+	if (NULL == file) {
+		return STATUS_ERROR_FILE_OPEN;
+	}
+	if (fread(&header, sizeof(header), 1, file) != 1 ||
+		memcmp(header.magic, FILE_REC_MAGIC, sizeof(header.magic)) != 0 ||
+		FILE_REC_VERSION != header.version || 0 == header.nStream || header.blockSize < FILE_REC_BLOCK_SIZE_MIN ||
+		(header.blockSize & 7) != 0 ||
+		sizeof(fileRecHeader_t) + (uint64_t) header.nStream * sizeof(fileRecStream_t) > header.blockSize) {
+		fclose(file);
+		return STATUS_ERROR;
+	}
+
+	pSelf = (fileRecReader_t*) calloc(1, sizeof(fileRecReader_t));
+	if (NULL == pSelf) {
+		fclose(file);
+		return STATUS_ERROR_MALLOC;
+	}
+	pSelf->blockSize = header.blockSize;
+	pSelf->nStream = header.nStream;
+	pSelf->stream = (fileRecStream_t*) malloc(header.nStream * sizeof(fileRecStream_t));
+	pSelf->index = (fileRecIndex_t**) calloc(header.nStream, sizeof(fileRecIndex_t*));
+	pSelf->nIndex = (uint32_t*) calloc(header.nStream, sizeof(uint32_t));
+	pSelf->cursor = (uint32_t*) calloc(header.nStream, sizeof(uint32_t));
+	if (NULL == pSelf->stream || NULL == pSelf->index || NULL == pSelf->nIndex || NULL == pSelf->cursor) {
+		fclose(file);
+		file_recReaderClose(&pSelf);
+		return STATUS_ERROR_MALLOC;
+	}
+	if (fread(pSelf->stream, sizeof(fileRecStream_t), header.nStream, file) != header.nStream) {
+		fclose(file);
+		file_recReaderClose(&pSelf);
+		return STATUS_ERROR;
+	}
+	/* Same checks as when written, frame sizes are divided by later */
+	for (s = 0; s < header.nStream; s++) {
+		if (!file_recIsStreamValid(&pSelf->stream[s], header.blockSize - sizeof(fileRecBlock_t))) {
+			fclose(file);
+			file_recReaderClose(&pSelf);
+			return STATUS_ERROR;
+		}
+	}
+
+	/* Blocks, one element each, after the header block */
+	mapCfg.filename = filename;
+	mapCfg.offset = header.blockSize;
+	mapCfg.elemSize = header.blockSize;
+	mapCfg.nChannel = 1;
+	mapCfg.chunkSize = 0;
+	mapCfg.advice = FILE_MAP_ADVICE_RANDOM;
+	status = file_mapOpen(&pSelf->map, &mapCfg);
+	if (STATUS_OK != status) {
+		fclose(file);
+		file_recReaderClose(&pSelf);
+		return status;
+	}
+	if (file_mapGetView(pSelf->map, &view) == STATUS_OK) {
+		pSelf->blockAddr = (const uint8_t*) view.data;
+	}
+
+	index = file_recLoadIndex(pSelf, file, &nBlock);
+	fclose(file);
+	if (NULL == index) {
+		file_recReaderClose(&pSelf);
+		return STATUS_ERROR_MALLOC;
+	}
+
+	/* Split index by stream */
+	for (k = 0; k < nBlock; k++) {
+		if (index[k].stream < pSelf->nStream) {
+			pSelf->nIndex[index[k].stream]++;
+		}
+	}
+	for (s = 0; s < pSelf->nStream; s++) {
+		pSelf->index[s] = (fileRecIndex_t*) malloc((pSelf->nIndex[s] + 1) * sizeof(fileRecIndex_t));
+		if (NULL == pSelf->index[s]) {
+			free(index);
+			file_recReaderClose(&pSelf);
+			return STATUS_ERROR_MALLOC;
+		}
+		pSelf->nIndex[s] = 0;
+	}
+	for (k = 0; k < nBlock; k++) {
+		s = index[k].stream;
+		if (s < pSelf->nStream) {
+			pSelf->index[s][pSelf->nIndex[s]++] = index[k];
+		}
+	}
+	free(index);
+
+	*ppSelf = pSelf;
+	return STATUS_OK;
+}
+
+int32_t file_recReaderClose(fileRecReader_t **ppSelf) {
+	fileRecReader_t *pSelf = *ppSelf;
+	uint16_t s;
+
+	if (NULL != pSelf) {
+		file_mapClose(&pSelf->map);
+		if (NULL != pSelf->index) {
+			for (s = 0; s < pSelf->nStream; s++) {
+				free(pSelf->index[s]);
+			}
+			free(pSelf->index);
+		}
+		free(pSelf->nIndex);
+		free(pSelf->cursor);
+		free(pSelf->stream);
+
+		free(pSelf);
+		*ppSelf = NULL;
+	}
+
+	return STATUS_OK;
+}
+
+uint16_t file_recGetNumStream(const fileRecReader_t *pSelf) {
+	return pSelf->nStream;
+}
+
+const fileRecStream_t* file_recGetStream(const fileRecReader_t *pSelf, uint16_t stream) {
+	if (stream >= pSelf->nStream) {
+		return NULL;
+	}
+
+	return &pSelf->stream[stream];
+}
+
+uint32_t file_recGetMaxFrame(const fileRecReader_t *pSelf, uint16_t stream) {
+	const fileRecStream_t *desc = &pSelf->stream[stream];
+	uint32_t capacity;
+
+	/* At least 1 byte per sample when encoded */
+	capacity = pSelf->blockSize - sizeof(fileRecBlock_t);
+	if (FILE_REC_ENC_DELTA == desc->encoding) {
+		return capacity / desc->nChannel;
+	}
+
+	return capacity / (desc->nChannel * file_recGetElemSize(desc->type));
+}
+
+uint32_t file_recGetNumBlock(const fileRecReader_t *pSelf, uint16_t stream) {
+	return pSelf->nIndex[stream];
+}
+
+int32_t file_recSeek(fileRecReader_t *pSelf, uint16_t stream, uint64_t timestamp) {
+	const fileRecIndex_t *index;
+	uint32_t lo, hi, mid;
+
+	if (stream >= pSelf->nStream) {
+		return STATUS_ERROR_PARAM;
+	}
+
+	/* Binary search of the first block starting after timestamp */
+	index = pSelf->index[stream];
+	lo = 0;
+	hi = pSelf->nIndex[stream];
+	while (lo < hi) {
+		mid = lo + (hi - lo) / 2;
+		if (index[mid].timestamp <= timestamp) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+	pSelf->cursor[stream] = (lo > 0) ? lo - 1 : 0;
+
+	return STATUS_OK;
+}
+
+int32_t file_recNext(fileRecReader_t *pSelf, uint16_t stream, void *buffer, fileRecFrames_t *pFrames) {
+	const fileRecStream_t *desc;
+	const fileRecBlock_t *block;
+	int32_t status;
+
+	if (stream >= pSelf->nStream) {
+		return STATUS_ERROR_PARAM;
+	}
+
+	pFrames->nFrame = 0;
+	pFrames->data = NULL;
+	if (pSelf->cursor[stream] >= pSelf->nIndex[stream]) {
+		return STATUS_OK;
+	}
+
+	desc = &pSelf->stream[stream];
+	if (FILE_REC_ENC_RAW != desc->encoding && NULL == buffer) {
+		return STATUS_ERROR_NULL;
+	}
+
+	block = (const fileRecBlock_t*) file_recGetBlock(pSelf, pSelf->index[stream][pSelf->cursor[stream]].block);
+	if (NULL == block || block->stream != stream || block->nFrame > file_recGetMaxFrame(pSelf, stream) ||
+		block->payloadSize > pSelf->blockSize - sizeof(fileRecBlock_t)) {
+		return STATUS_ERROR;
+	}
+
+	if (FILE_REC_ENC_DELTA == desc->encoding) {
+		status = file_recDecodeDelta((int16_t*) buffer, (const uint8_t*) (block + 1), block->payloadSize,
+				block->nFrame, desc->nChannel);
+		if (STATUS_OK != status) {
+			return status;
+		}
+		pFrames->data = buffer;
+	} else {
+		pFrames->data = block + 1;
+	}
+	pFrames->timestamp = block->timestamp;
+	pFrames->nFrame = block->nFrame;
+	pSelf->cursor[stream]++;
+
+	return STATUS_OK;
+}
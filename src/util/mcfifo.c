@@ -0,0 +1,324 @@
+/*
+ * mcfifo.c
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: chiong
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <time.h>
+#include "util/status.h"
+#include "util/buffer.h"
+#include "util/wav.h"
+#include "util/mcfifo.h"
+
+/* Maximum number of bytes looked at for a WAV header in file source. */
+#define MCFIFO_SRC_HEADER_MAX	(4096)
+
+struct mcfifo_s {
+	/* Read-only after create. Frame storage, one per slot. */
+	mcbuffer_t **slot;
+	/* Read-only after create. nSlot - 1 */
+	uint32_t mask;
+	uint8_t pad0[MCFIFO_CACHE_LINE_SIZE];
+
+	/* Written by producer only. Free running count of committed frames. */
+	uint32_t wrIdx;
+	/* Written by producer only. */
+	uint32_t overrun;
+	uint8_t pad1[MCFIFO_CACHE_LINE_SIZE - 2 * sizeof(uint32_t)];
+
+	/* Written by consumer only. Free running count of released frames. */
+	uint32_t rdIdx;
+	/* Written by consumer only. */
+	uint32_t underrun;
+	uint8_t pad2[MCFIFO_CACHE_LINE_SIZE - 2 * sizeof(uint32_t)];
+};
+
+struct mcfifoSrc_s {
+	mcfifo_t *fifo;
+	FILE *file;
+	/* Offset of first sample in file, and size of samples from there. */
+	long dataStart;
+	uint64_t dataSize;
+	/* Source thread only. Bytes of samples not yet read. */
+	uint64_t dataLeft;
+	/* One interleaved frame read from file. */
+	uint8_t *frame;
+	uint32_t frameSize;
+	uint32_t nChannel;
+	uint32_t elemSize;
+	uint32_t sampleSize;
+	/* Frame period, in ns. */
+	uint64_t periodNs;
+	uint8_t isLoop;
+	/* Accessed by both threads. */
+	uint8_t isStop;
+	uint8_t isDone;
+	pthread_t thread;
+};
+
+int32_t mcfifo_create(mcfifo_t **ppSelf, const mcfifoCfg_t *cfg) {
+	mcfifo_t *pSelf;
+	uint32_t i;
+	int32_t status;
+
+	if (cfg->nSlot < 2 || (cfg->nSlot & (cfg->nSlot - 1)) != 0) {
+		return STATUS_ERROR_PARAM;
+	}
+
+	pSelf = (mcfifo_t*) calloc(1, sizeof(mcfifo_t));
+	if (NULL == pSelf) {
+		return STATUS_ERROR_MALLOC;
+	}
+	pSelf->mask = cfg->nSlot - 1;
+
+	pSelf->slot = (mcbuffer_t**) calloc(cfg->nSlot, sizeof(mcbuffer_t*));
+	if (NULL == pSelf->slot) {
+		mcfifo_destroy(&pSelf);
+		return STATUS_ERROR_MALLOC;
+	}
+
+	for (i = 0; i < cfg->nSlot; i++) {
+		status = MCBUFFER_create(&pSelf->slot[i], cfg->frameSize, cfg->nChannel, cfg->elemSize, cfg->layout);
+		if (STATUS_OK != status) {
+			mcfifo_destroy(&pSelf);
+			return status;
+		}
+	}
+
+	*ppSelf = pSelf;
+	return STATUS_OK;
+}
+
+int32_t mcfifo_destroy(mcfifo_t **ppSelf) {
+	mcfifo_t *pSelf = *ppSelf;
+	uint32_t i;
+
+	if (NULL != pSelf) {
+		if (NULL != pSelf->slot) {
+			for (i = 0; i <= pSelf->mask; i++) {
+				MCBUFFER_destroy(&pSelf->slot[i]);
+			}
+			free(pSelf->slot);
+		}
+
+		free(pSelf);
+		*ppSelf = NULL;
+	}
+
+	return STATUS_OK;
+}
+
+mcbuffer_t* mcfifo_acquireWrite(mcfifo_t *pSelf) {
+	uint32_t wr, rd;
+
+	wr = pSelf->wrIdx;
+	/* Pairs with release in mcfifo_releaseRead(), so that the consumer is done
+	 * with the slot before it is overwritten. */
+	rd = __atomic_load_n(&pSelf->rdIdx, __ATOMIC_ACQUIRE);
+	if (wr - rd > pSelf->mask) {
+		__atomic_store_n(&pSelf->overrun, pSelf->overrun + 1, __ATOMIC_RELAXED);
+		return NULL;
+	}
+
+	return pSelf->slot[wr & pSelf->mask];
+}
+
+void mcfifo_commitWrite(mcfifo_t *pSelf) {
+	/* Publish the frame content together with the index. */
+	__atomic_store_n(&pSelf->wrIdx, pSelf->wrIdx + 1, __ATOMIC_RELEASE);
+}
+
+mcbuffer_t* mcfifo_acquireRead(mcfifo_t *pSelf) {
+	uint32_t wr, rd;
+
+	rd = pSelf->rdIdx;
+	wr = __atomic_load_n(&pSelf->wrIdx, __ATOMIC_ACQUIRE);
+	if (wr == rd) {
+		__atomic_store_n(&pSelf->underrun, pSelf->underrun + 1, __ATOMIC_RELAXED);
+		return NULL;
+	}
+
+	return pSelf->slot[rd & pSelf->mask];
+}
+
+void mcfifo_releaseRead(mcfifo_t *pSelf) {
+	__atomic_store_n(&pSelf->rdIdx, pSelf->rdIdx + 1, __ATOMIC_RELEASE);
+}
+
+uint32_t mcfifo_getCount(const mcfifo_t *pSelf) {
+	uint32_t wr, rd;
+
+	rd = __atomic_load_n(&pSelf->rdIdx, __ATOMIC_ACQUIRE);
+	wr = __atomic_load_n(&pSelf->wrIdx, __ATOMIC_ACQUIRE);
+
+	return wr - rd;
+}
+
+void mcfifo_getStats(const mcfifo_t *pSelf, mcfifoStats_t *stats) {
+	stats->written = __atomic_load_n(&pSelf->wrIdx, __ATOMIC_RELAXED);
+	stats->read = __atomic_load_n(&pSelf->rdIdx, __ATOMIC_RELAXED);
+	stats->overrun = __atomic_load_n(&pSelf->overrun, __ATOMIC_RELAXED);
+	stats->underrun = __atomic_load_n(&pSelf->underrun, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Advance an absolute CLOCK_MONOTONIC time by ns nanoseconds.
+ */
+static void mcfifo_addNs(struct timespec *ts, uint64_t ns) {
+	ns += ts->tv_nsec;
+	ts->tv_sec += ns / 1000000000ull;
+	ts->tv_nsec = ns % 1000000000ull;
+}
+
+static void* mcfifo_fileSourceThread(void *arg) {
+	mcfifoSrc_t *pSrc = (mcfifoSrc_t*) arg;
+	struct timespec next;
+	mcbuffer_t *buf;
+	buffer2dView_t src, dst;
+	uint32_t nWant, nRead;
+	uint32_t frameBytes;
+
+	frameBytes = pSrc->sampleSize * pSrc->frameSize;
+	/* Frame read from file is always interleaved */
+	buffer2dView_init(&src, pSrc->frame, pSrc->frameSize, pSrc->nChannel, pSrc->elemSize,
+			MCBUFFER_LAYOUT_INTERLEAVED);
+	clock_gettime(CLOCK_MONOTONIC, &next);
+
+	while (!__atomic_load_n(&pSrc->isStop, __ATOMIC_ACQUIRE)) {
+		/* Chunks after the samples, e.g. LIST of a WAV file, are not played */
+		nWant = pSrc->frameSize;
+		if (pSrc->dataLeft / pSrc->sampleSize < nWant) {
+			nWant = (uint32_t) (pSrc->dataLeft / pSrc->sampleSize);
+		}
+		nRead = (nWant > 0) ? fread(pSrc->frame, pSrc->sampleSize, nWant, pSrc->file) : 0;
+		pSrc->dataLeft = (nRead < nWant) ? 0 : pSrc->dataLeft - (uint64_t) nRead * pSrc->sampleSize;
+		if (nRead < pSrc->frameSize) {
+			if (0 == nRead && pSrc->isLoop && pSrc->dataSize >= pSrc->sampleSize) {
+				fseek(pSrc->file, pSrc->dataStart, SEEK_SET);
+				pSrc->dataLeft = pSrc->dataSize;
+				continue;
+			}
+			if (0 == nRead) {
+				break;
+			}
+			memset(pSrc->frame + nRead * pSrc->sampleSize, 0, frameBytes - nRead * pSrc->sampleSize);
+		}
+
+		buf = mcfifo_acquireWrite(pSrc->fifo);
+		if (NULL != buf) {
+			buffer2d_getView(buf, &dst);
+			buffer2dView_copy(&dst, &src);
+			mcfifo_commitWrite(pSrc->fifo);
+		}
+
+		/* Absolute deadline so that pacing does not drift with processing time. */
+		mcfifo_addNs(&next, pSrc->periodNs);
+		clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL);
+	}
+
+	__atomic_store_n(&pSrc->isDone, 1, __ATOMIC_RELEASE);
+	return NULL;
+}
+
+int32_t mcfifo_startFileSource(mcfifoSrc_t **ppSrc, mcfifo_t *fifo, const mcfifoSrcCfg_t *cfg) {
+	mcfifoSrc_t *pSrc;
+	mcbuffer_t *slot;
+	uint8_t header[MCFIFO_SRC_HEADER_MAX];
+	const uint8_t *chunkSize;
+	uint32_t nRead;
+	wavInfo_t wav;
+	long fileSize;
+
+	if (0 == cfg->sampleRate) {
+		return STATUS_ERROR_PARAM;
+	}
+
+	pSrc = (mcfifoSrc_t*) calloc(1, sizeof(mcfifoSrc_t));
+	if (NULL == pSrc) {
+		return STATUS_ERROR_MALLOC;
+	}
+
+	/* All slots have the same dimension */
+	slot = fifo->slot[0];
+	pSrc->fifo = fifo;
+	pSrc->isLoop = cfg->isLoop;
+	pSrc->frameSize = MCBUFFER_getNumSamplePerChannel(slot);
+	pSrc->nChannel = MCBUFFER_getNumChannel(slot);
+	pSrc->elemSize = MCBUFFER_getElemSize(slot);
+	pSrc->sampleSize = pSrc->nChannel * pSrc->elemSize;
+	pSrc->periodNs = (uint64_t) pSrc->frameSize * 1000000000ull / cfg->sampleRate;
+
+	pSrc->frame = (uint8_t*) malloc(pSrc->sampleSize * pSrc->frameSize);
+	if (NULL == pSrc->frame) {
+		free(pSrc);
+		return STATUS_ERROR_MALLOC;
+	}
+
+	pSrc->file = fopen(cfg->filename, "rb");
+	if (NULL == pSrc->file) {
+		free(pSrc->frame);
+		free(pSrc);
+		return STATUS_ERROR_FILE_OPEN;
+	}
+
+	fseek(pSrc->file, 0, SEEK_END);
+	fileSize = ftell(pSrc->file);
+	rewind(pSrc->file);
+
+	/* Only the data chunk of WAV file, whole file otherwise */
+	pSrc->dataSize = (fileSize > 0) ? (uint64_t) fileSize : 0;
+	nRead = fread(header, 1, sizeof(header), pSrc->file);
+	if (wav_parseHeader(&wav, header, nRead) == STATUS_OK) {
+		if (wav.channel != pSrc->nChannel || wav.bitsPerSample != pSrc->elemSize * 8) {
+			fclose(pSrc->file);
+			free(pSrc->frame);
+			free(pSrc);
+			return STATUS_ERROR_PARAM;
+		}
+		/* dataSize of wav is clipped to header, size in chunk is clipped to file */
+		chunkSize = header + wav.dataOffset - 4;
+		pSrc->dataStart = wav.dataOffset;
+		pSrc->dataSize = (uint32_t) chunkSize[0] | ((uint32_t) chunkSize[1] << 8) |
+				((uint32_t) chunkSize[2] << 16) | ((uint32_t) chunkSize[3] << 24);
+		if (pSrc->dataSize > (uint64_t) fileSize - wav.dataOffset) {
+			pSrc->dataSize = (uint64_t) fileSize - wav.dataOffset;
+		}
+	}
+	pSrc->dataLeft = pSrc->dataSize;
+	fseek(pSrc->file, pSrc->dataStart, SEEK_SET);
+
+	if (pthread_create(&pSrc->thread, NULL, mcfifo_fileSourceThread, pSrc) != 0) {
+		fclose(pSrc->file);
+		free(pSrc->frame);
+		free(pSrc);
+		return STATUS_ERROR;
+	}
+
+	*ppSrc = pSrc;
+	return STATUS_OK;
+}
+
+uint8_t mcfifo_isFileSourceDone(const mcfifoSrc_t *pSrc) {
+	return __atomic_load_n(&pSrc->isDone, __ATOMIC_ACQUIRE);
+}
+
+int32_t mcfifo_stopFileSource(mcfifoSrc_t **ppSrc) {
+	mcfifoSrc_t *pSrc = *ppSrc;
+
+	if (NULL != pSrc) {
+		__atomic_store_n(&pSrc->isStop, 1, __ATOMIC_RELEASE);
+		pthread_join(pSrc->thread, NULL);
+
+		fclose(pSrc->file);
+		free(pSrc->frame);
+		free(pSrc);
+		*ppSrc = NULL;
+	}
+
+	return STATUS_OK;
+}
@@ -0,0 +1,211 @@
+/*
+ * mcring.c
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: chiong
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "util/status.h"
+#include "util/buffer.h"
+#include "util/mcring.h"
+
+struct mcring_s {
+	/* size + maxWindow samples, the last maxWindow mirror the first. */
+	mcbuffer_t *buf;
+	/* Read-only. As configured. */
+	uint32_t size;
+	uint32_t maxWindow;
+	uint32_t nChannel;
+	uint32_t elemSize;
+	uint8_t isOverwrite;
+
+	/* Position, from 0 to size - 1, of next sample to be written. */
+	uint32_t wrPos;
+	/* Number of unread samples, the oldest is count samples before wrPos. */
+	uint32_t count;
+};
+
+/**
+ * @brief Get the position of the sample n samples before the write position.
+ */
+static inline uint32_t mcring_posBefore(const mcring_t *pSelf, uint32_t n) {
+	return (pSelf->wrPos >= n) ? pSelf->wrPos - n : pSelf->wrPos + pSelf->size - n;
+}
+
+/**
+ * @brief Copy n samples of src, from sample iSrc, to storage at pos, with
+ * 		pos + n <= size, and to the mirror for the part below maxWindow.
+ */
+static void mcring_write(mcring_t *pSelf, uint32_t pos, const buffer2dView_t *pSrc, uint32_t iSrc, uint32_t n) {
+	buffer2dView_t dst, src;
+
+	buffer2dView_getBlock(pSrc, iSrc, 0, n, pSelf->nChannel, &src);
+	MCBUFFER_getViewWindow(pSelf->buf, pos, n, &dst);
+	buffer2dView_copy(&dst, &src);
+
+	if (pos < pSelf->maxWindow) {
+		if (n > pSelf->maxWindow - pos) {
+			n = pSelf->maxWindow - pos;
+		}
+		buffer2dView_getBlock(pSrc, iSrc, 0, n, pSelf->nChannel, &src);
+		MCBUFFER_getViewWindow(pSelf->buf, pSelf->size + pos, n, &dst);
+		buffer2dView_copy(&dst, &src);
+	}
+}
+
+int32_t mcring_create(mcring_t **ppSelf, const mcringCfg_t *cfg) {
+	mcring_t *pSelf;
+	int32_t status;
+
+	if (0 == cfg->size || 0 == cfg->nChannel || cfg->maxWindow > cfg->size) {
+		return STATUS_ERROR_PARAM;
+	}
+
+	pSelf = (mcring_t*) calloc(1, sizeof(mcring_t));
+	if (NULL == pSelf) {
+		return STATUS_ERROR_MALLOC;
+	}
+	pSelf->size = cfg->size;
+	pSelf->maxWindow = (0 == cfg->maxWindow) ? cfg->size : cfg->maxWindow;
+	pSelf->nChannel = cfg->nChannel;
+	pSelf->elemSize = cfg->elemSize;
+	pSelf->isOverwrite = cfg->isOverwrite;
+
+	status = MCBUFFER_create(&pSelf->buf, pSelf->size + pSelf->maxWindow, cfg->nChannel,
+			cfg->elemSize, cfg->layout);
+	if (STATUS_OK != status) {
+		mcring_destroy(&pSelf);
+		return status;
+	}
+
+	*ppSelf = pSelf;
+	return STATUS_OK;
+}
+
+int32_t mcring_destroy(mcring_t **ppSelf) {
+	mcring_t *pSelf = *ppSelf;
+
+	if (NULL != pSelf) {
+		MCBUFFER_destroy(&pSelf->buf);
+		free(pSelf);
+		*ppSelf = NULL;
+	}
+
+	return STATUS_OK;
+}
+
+void mcring_reset(mcring_t *pSelf) {
+	pSelf->wrPos = 0;
+	pSelf->count = 0;
+
+	/* Storage is not padded */
+	memset((void*) MCBUFFER_getBufferAsType(pSelf->buf, uint8_t), 0,
+			(pSelf->size + pSelf->maxWindow) * pSelf->nChannel * pSelf->elemSize);
+}
+
+uint32_t mcring_getCount(const mcring_t *pSelf) {
+	return pSelf->count;
+}
+
+uint32_t mcring_getSpace(const mcring_t *pSelf) {
+	return pSelf->size - pSelf->count;
+}
+
+int32_t mcring_push(mcring_t *pSelf, const buffer2dView_t *pSrc) {
+	uint32_t n, skip, first;
+
+	if (pSrc->nCol != pSelf->nChannel || pSrc->elemSize != pSelf->elemSize) {
+		return STATUS_ERROR_PARAM;
+	}
+
+	n = pSrc->nRow;
+	skip = 0;
+	if (n > pSelf->size - pSelf->count) {
+		if (!pSelf->isOverwrite) {
+			return STATUS_ERROR;
+		}
+		if (n > pSelf->size) {
+			/* Only the last size samples survive */
+			skip = n - pSelf->size;
+			n = pSelf->size;
+		}
+	}
+
+	first = pSelf->size - pSelf->wrPos;
+	if (first > n) {
+		first = n;
+	}
+	mcring_write(pSelf, pSelf->wrPos, pSrc, skip, first);
+	if (n > first) {
+		mcring_write(pSelf, 0, pSrc, skip + first, n - first);
+	}
+
+	pSelf->wrPos = (pSelf->wrPos + n) % pSelf->size;
+	pSelf->count += n;
+	if (pSelf->count > pSelf->size) {
+		/* Oldest overwritten */
+		pSelf->count = pSelf->size;
+	}
+
+	return STATUS_OK;
+}
+
+int32_t mcring_pop(mcring_t *pSelf, buffer2dView_t *pDst) {
+	buffer2dView_t src, dst;
+	uint32_t n, pos, first;
+
+	if (pDst->nCol != pSelf->nChannel || pDst->elemSize != pSelf->elemSize) {
+		return STATUS_ERROR_PARAM;
+	}
+
+	n = pDst->nRow;
+	if (n > pSelf->count) {
+		return STATUS_ERROR;
+	}
+
+	pos = mcring_posBefore(pSelf, pSelf->count);
+	first = pSelf->size - pos;
+	if (first > n) {
+		first = n;
+	}
+	MCBUFFER_getViewWindow(pSelf->buf, pos, first, &src);
+	buffer2dView_getBlock(pDst, 0, 0, first, pSelf->nChannel, &dst);
+	buffer2dView_copy(&dst, &src);
+	if (n > first) {
+		MCBUFFER_getViewWindow(pSelf->buf, 0, n - first, &src);
+		buffer2dView_getBlock(pDst, first, 0, n - first, pSelf->nChannel, &dst);
+		buffer2dView_copy(&dst, &src);
+	}
+
+	pSelf->count -= n;
+	return STATUS_OK;
+}
+
+int32_t mcring_peek(const mcring_t *pSelf, uint32_t nSample, buffer2dView_t *pView) {
+	if (nSample > pSelf->maxWindow || nSample > pSelf->count) {
+		return STATUS_ERROR_PARAM;
+	}
+
+	MCBUFFER_getViewWindow(pSelf->buf, mcring_posBefore(pSelf, pSelf->count), nSample, pView);
+	return STATUS_OK;
+}
+
+int32_t mcring_consume(mcring_t *pSelf, uint32_t nSample) {
+	if (nSample > pSelf->count) {
+		return STATUS_ERROR_PARAM;
+	}
+
+	pSelf->count -= nSample;
+	return STATUS_OK;
+}
+
+int32_t mcring_getLatest(const mcring_t *pSelf, uint32_t nSample, buffer2dView_t *pView) {
+	if (nSample > pSelf->maxWindow) {
+		return STATUS_ERROR_PARAM;
+	}
+
+	MCBUFFER_getViewWindow(pSelf->buf, mcring_posBefore(pSelf, nSample), nSample, pView);
+	return STATUS_OK;
+}
@@ -0,0 +1,202 @@
+/*
+ * mtstack.c
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: chiong
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "util/status.h"
+#include "util/stack.h"
+#include "util/mtstack.h"
+
+struct vMtStack_s {
+	/* Read-only. Raw address as returned by malloc(), used for free-ing only. */
+	void *baseAddr;
+	/* Read-only. Per-thread stacks, carved from baseAddr. */
+	vStack_t **stack;
+	/* Non-zero if stack of the same index is bound to a thread. */
+	uint8_t *isBound;
+	uint32_t nStack;
+
+	/* Read-only. Shared bulk region. */
+	void *bulkAddr;
+	uint32_t bulkSize;
+	/* Offset, in bytes, of next free memory in bulk region. */
+	uint32_t bulkOffset;
+};
+
+/* Binding of the calling thread. */
+static __thread vMtStack_t *mtstack_tlsMts;
+static __thread uint32_t mtstack_tlsIndex;
+
+static uint32_t mtstack_roundUp(uint32_t size, uint32_t alignment) {
+	return (size + alignment - 1) & ~(alignment - 1);
+}
+
+int32_t mtstack_create(vMtStack_t **ppMts, const vMtStackCfg_t *cfg) {
+	vMtStack_t *mts;
+	vStackCfg_t stackCfg;
+	uintptr_t ptr;
+	uint32_t alignment;
+	uint32_t stride;
+	uint32_t i;
+	int32_t status;
+
+	if (0 == cfg->nStack) {
+		return STATUS_ERROR_PARAM;
+	}
+
+	mts = (vMtStack_t*) calloc(1, sizeof(vMtStack_t));
+	if (NULL == mts) {
+		return STATUS_ERROR_MALLOC;
+	}
+
+	mts->stack = (vStack_t**) calloc(cfg->nStack, sizeof(vStack_t*));
+	mts->isBound = (uint8_t*) calloc(cfg->nStack, sizeof(uint8_t));
+	if (NULL == mts->stack || NULL == mts->isBound) {
+		mtstack_destroy(&mts);
+		return STATUS_ERROR_MALLOC;
+	}
+	mts->nStack = cfg->nStack;
+
+	/* Each part starts on its own cache line, each stack with its instance */
+	alignment = cfg->alignment;
+	if (alignment < MTSTACK_CACHE_LINE_SIZE) {
+		alignment = MTSTACK_CACHE_LINE_SIZE;
+	}
+	stackCfg.alignment = alignment;
+	stackCfg.size = cfg->size;
+	stride = mtstack_roundUp(stack_getInPlaceSize(&stackCfg), alignment);
+
+	mts->baseAddr = malloc((size_t) stride * cfg->nStack + cfg->bulkSize + alignment - 1);
+	if (NULL == mts->baseAddr) {
+		mtstack_destroy(&mts);
+		return STATUS_ERROR_MALLOC;
+	}
+
+	/* Perform manual alignment */
+	ptr = ((uintptr_t) mts->baseAddr + alignment - 1) & ~((uintptr_t) alignment - 1);
+
+	for (i = 0; i < cfg->nStack; i++) {
+		status = stack_createInPlace(&mts->stack[i], &stackCfg, (void*) ptr);
+		if (STATUS_OK != status) {
+			mtstack_destroy(&mts);
+			return status;
+		}
+		ptr += stride;
+	}
+
+	mts->bulkAddr = (void*) ptr;
+	mts->bulkSize = cfg->bulkSize;
+	mts->bulkOffset = 0;
+
+	*ppMts = mts;
+	return STATUS_OK;
+}
+
+int32_t mtstack_destroy(vMtStack_t **ppMts) {
+	vMtStack_t *mts;
+	uint32_t i;
+
+	mts = *ppMts;
+	if (NULL != mts) {
+		if (NULL != mts->stack) {
+			for (i = 0; i < mts->nStack; i++) {
+				stack_destroy(&mts->stack[i]);
+			}
+			free(mts->stack);
+		}
+		if (NULL != mts->isBound)
+			free(mts->isBound);
+		if (NULL != mts->baseAddr)
+			free(mts->baseAddr);
+
+		free(mts);
+		*ppMts = NULL;
+	}
+
+	return STATUS_OK;
+}
+
+uint32_t mtstack_getNumStack(const vMtStack_t *mts) {
+	return mts->nStack;
+}
+
+vStack_t* mtstack_getStack(vMtStack_t *mts, uint32_t index) {
+	if (index >= mts->nStack) {
+		return NULL;
+	}
+
+	return mts->stack[index];
+}
+
+vStack_t* mtstack_bind(vMtStack_t *mts) {
+	uint32_t i;
+
+	if (mts == mtstack_tlsMts) {
+		return mts->stack[mtstack_tlsIndex];
+	} else if (NULL != mtstack_tlsMts) {
+		return NULL;
+	}
+
+	for (i = 0; i < mts->nStack; i++) {
+		/* Claim the first stack not bound yet */
+		if (!__atomic_test_and_set(&mts->isBound[i], __ATOMIC_ACQUIRE)) {
+			mtstack_tlsMts = mts;
+			mtstack_tlsIndex = i;
+			return mts->stack[i];
+		}
+	}
+
+	return NULL;
+}
+
+vStack_t* mtstack_getBound(const vMtStack_t *mts) {
+	if (mts != mtstack_tlsMts) {
+		return NULL;
+	}
+
+	return mts->stack[mtstack_tlsIndex];
+}
+
+void mtstack_unbind(vMtStack_t *mts) {
+	if (mts != mtstack_tlsMts) {
+		return;
+	}
+
+	stack_reset(mts->stack[mtstack_tlsIndex]);
+	__atomic_clear(&mts->isBound[mtstack_tlsIndex], __ATOMIC_RELEASE);
+	mtstack_tlsMts = NULL;
+}
+
+void* mtstack_bulkAlloc(vMtStack_t *mts, uint32_t alignment, uint32_t size) {
+	uintptr_t base;
+	uintptr_t ptr;
+	uint32_t offset;
+	uint32_t newOffset;
+
+	base = (uintptr_t) mts->bulkAddr;
+	offset = __atomic_load_n(&mts->bulkOffset, __ATOMIC_RELAXED);
+	do {
+		ptr = (base + offset + alignment - 1) & ~((uintptr_t) alignment - 1);
+		if (ptr - base > mts->bulkSize ||
+			(uint64_t) size * alignment > mts->bulkSize - (ptr - base)) {
+			/* Insufficient size */
+			return NULL;
+		}
+		newOffset = (uint32_t) (ptr - base) + size * alignment;
+	} while (!__atomic_compare_exchange_n(&mts->bulkOffset, &offset, newOffset, 1,
+			__ATOMIC_RELAXED, __ATOMIC_RELAXED));
+
+	return (void*) ptr;
+}
+
+void mtstack_bulkReset(vMtStack_t *mts) {
+	mts->bulkOffset = 0;
+}
+
+uint32_t mtstack_getBulkAvailSize(const vMtStack_t *mts) {
+	return mts->bulkSize - __atomic_load_n(&mts->bulkOffset, __ATOMIC_RELAXED);
+}
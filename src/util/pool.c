@@ -0,0 +1,270 @@
+/*
+ * pool.c
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: chiong
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "util/status.h"
+#include "util/pool.h"
+#ifdef DEBUG
+#include "debug/assert.h"
+#endif
+
+/* End of free list. */
+#define POOL_NIL		(0xFFFFFFFFu)
+
+/* Head of free list is a block index (low 32 bits) and a tag (high 32 bits). The
+ * tag is incremented on every update so that a CAS based on a stale head fails
+ * even if the same index is back on top of the list (ABA). */
+#define POOL_HEAD_INDEX(head)			((uint32_t) (head))
+#define POOL_HEAD_MAKE(index, tag)		(((uint64_t) (tag) << 32) | (uint64_t) (index))
+#define POOL_HEAD_NEXT(head, index)		POOL_HEAD_MAKE(index, ((head) >> 32) + 1)
+
+struct vPool_s {
+	/* Read-only. Raw address as returned by malloc(), used for free-ing only. */
+	void *baseAddr;
+	/* Read-only. Address of block 0, aligned. */
+	void *startAddr;
+	/* Read-only. Distance in bytes between two consecutive blocks. */
+	uint32_t stride;
+	/* Read-only. As configured. */
+	uint32_t blockSize;
+	uint32_t count;
+	uint8_t isThreadSafe;
+	/* Free list link of each block if thread-safe, NULL otherwise. */
+	uint32_t *next;
+
+	/* Tagged index of first free block. */
+	uint64_t head;
+	uint32_t inUse;
+	uint32_t peak;
+	uint32_t nFail;
+};
+
+static inline void* pool_block(const vPool_t *pool, uint32_t index) {
+	return pool->startAddr + (uintptr_t) index * pool->stride;
+}
+
+/* The free list link is stored in the first word of a free block, or out of the
+ * blocks if thread-safe. pool_allocMulti() may read the link of a block another
+ * thread has just taken, which must not race with that thread writing its block. */
+static inline uint32_t* pool_link(const vPool_t *pool, uint32_t index) {
+	if (NULL != pool->next) {
+		return &pool->next[index];
+	}
+	return (uint32_t*) pool_block(pool, index);
+}
+
+#ifdef DEBUG
+static void pool_poisonFree(vPool_t *pool, void *block) {
+	memset(block + sizeof(uint32_t), POOL_POISON_FREE, pool->stride - sizeof(uint32_t));
+}
+
+static void pool_checkPoison(vPool_t *pool, void *block) {
+	const uint8_t *p = (const uint8_t*) block;
+	uint32_t i;
+
+	for (i = sizeof(uint32_t); i < pool->stride; i++) {
+		ASSERT(POOL_POISON_FREE == p[i], "Pool block modified after free.");
+	}
+}
+#endif
+
+int32_t pool_create(vPool_t **ppPool, const vPoolCfg_t *cfg) {
+	vPool_t *pool;
+	uintptr_t mask;
+	uintptr_t ptr;
+	uint32_t alignment;
+	uint32_t i;
+
+	if (0 == cfg->count || cfg->count >= POOL_NIL || 0 == cfg->blockSize) {
+		return STATUS_ERROR_PARAM;
+	}
+
+	pool = (vPool_t*) calloc(1, sizeof(vPool_t));
+	if (NULL == pool) {
+		return STATUS_ERROR_MALLOC;
+	}
+
+	/* Blocks must hold the free list link and keep it aligned. */
+	alignment = cfg->alignment;
+	if (alignment < sizeof(uint32_t)) {
+		alignment = sizeof(uint32_t);
+	}
+	mask = (uintptr_t) (alignment - 1);
+
+	pool->blockSize = cfg->blockSize;
+	pool->count = cfg->count;
+	pool->isThreadSafe = cfg->isThreadSafe;
+	pool->stride = (uint32_t) (((uintptr_t) cfg->blockSize + mask) & ~mask);
+
+	pool->baseAddr = malloc((size_t) pool->stride * cfg->count + mask);
+	if (NULL == pool->baseAddr) {
+		pool_destroy(&pool);
+		return STATUS_ERROR_MALLOC;
+	}
+
+	if (cfg->isThreadSafe) {
+		pool->next = (uint32_t*) malloc((size_t) cfg->count * sizeof(uint32_t));
+		if (NULL == pool->next) {
+			pool_destroy(&pool);
+			return STATUS_ERROR_MALLOC;
+		}
+	}
+
+	/* Perform manual alignment */
+	ptr = ((uintptr_t) pool->baseAddr + mask) & ~mask;
+	pool->startAddr = (void*) ptr;
+
+	/* Link all blocks in address order. */
+	for (i = 0; i < cfg->count; i++) {
+		*pool_link(pool, i) = (i + 1 < cfg->count) ? i + 1 : POOL_NIL;
+#ifdef DEBUG
+		pool_poisonFree(pool, pool_block(pool, i));
+#endif
+	}
+	pool->head = POOL_HEAD_MAKE(0, 0);
+
+	*ppPool = pool;
+	return STATUS_OK;
+}
+
+int32_t pool_destroy(vPool_t **ppPool) {
+	vPool_t *pool;
+
+	pool = *ppPool;
+	if (NULL != pool) {
+		if (NULL != pool->baseAddr)
+			free(pool->baseAddr);
+		if (NULL != pool->next)
+			free(pool->next);
+
+		free(pool);
+		*ppPool = NULL;
+	}
+
+	return STATUS_OK;
+}
+
+static void* pool_allocSingle(vPool_t *pool) {
+	uint32_t index;
+
+	index = POOL_HEAD_INDEX(pool->head);
+	if (POOL_NIL == index) {
+		pool->nFail++;
+		return NULL;
+	}
+	pool->head = POOL_HEAD_NEXT(pool->head, *pool_link(pool, index));
+
+	if (++pool->inUse > pool->peak) {
+		pool->peak = pool->inUse;
+	}
+
+	return pool_block(pool, index);
+}
+
+static void* pool_allocMulti(vPool_t *pool) {
+	uint64_t head;
+	uint64_t next;
+	uint32_t index;
+	uint32_t inUse;
+	uint32_t peak;
+
+	head = __atomic_load_n(&pool->head, __ATOMIC_ACQUIRE);
+	do {
+		index = POOL_HEAD_INDEX(head);
+		if (POOL_NIL == index) {
+			__atomic_fetch_add(&pool->nFail, 1, __ATOMIC_RELAXED);
+			return NULL;
+		}
+		/* The link may be stale if another thread took this block meanwhile,
+		 * but then the tag has changed and the CAS fails. */
+		next = POOL_HEAD_NEXT(head, __atomic_load_n(pool_link(pool, index), __ATOMIC_RELAXED));
+	} while (!__atomic_compare_exchange_n(&pool->head, &head, next, 1,
+			__ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE));
+
+	inUse = __atomic_add_fetch(&pool->inUse, 1, __ATOMIC_RELAXED);
+	peak = __atomic_load_n(&pool->peak, __ATOMIC_RELAXED);
+	while (inUse > peak && !__atomic_compare_exchange_n(&pool->peak, &peak, inUse, 1,
+			__ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+	}
+
+	return pool_block(pool, index);
+}
+
+void* pool_alloc(vPool_t *pool) {
+	void *block;
+
+	if (pool->isThreadSafe) {
+		block = pool_allocMulti(pool);
+	} else {
+		block = pool_allocSingle(pool);
+	}
+
+#ifdef DEBUG
+	if (NULL != block) {
+		pool_checkPoison(pool, block);
+		memset(block, POOL_POISON_ALLOC, pool->stride);
+	}
+#endif
+
+	return block;
+}
+
+void pool_free(vPool_t *pool, void *block) {
+	uint64_t head;
+	uint64_t next;
+	uint32_t index;
+
+	if (NULL == block) {
+		return;
+	}
+
+#ifdef DEBUG
+	ASSERT(pool_isOwner(pool, block), "Block does not belong to pool.");
+	pool_poisonFree(pool, block);
+#endif
+
+	index = (uint32_t) ((uintptr_t) (block - pool->startAddr) / pool->stride);
+
+	if (pool->isThreadSafe) {
+		/* Counted out before the block is visible to other threads, so that
+		 * inUse never exceeds the number of blocks actually held. */
+		__atomic_sub_fetch(&pool->inUse, 1, __ATOMIC_RELAXED);
+		head = __atomic_load_n(&pool->head, __ATOMIC_RELAXED);
+		do {
+			__atomic_store_n(pool_link(pool, index), POOL_HEAD_INDEX(head), __ATOMIC_RELAXED);
+			next = POOL_HEAD_NEXT(head, index);
+		} while (!__atomic_compare_exchange_n(&pool->head, &head, next, 1,
+				__ATOMIC_RELEASE, __ATOMIC_RELAXED));
+	} else {
+		*pool_link(pool, index) = POOL_HEAD_INDEX(pool->head);
+		pool->head = POOL_HEAD_NEXT(pool->head, index);
+		pool->inUse--;
+	}
+}
+
+uint8_t pool_isOwner(const vPool_t *pool, const void *ptr) {
+	uintptr_t offset;
+
+	if (ptr < pool->startAddr) {
+		return 0;
+	}
+
+	offset = (uintptr_t) (ptr - pool->startAddr);
+	return (offset < (uintptr_t) pool->stride * pool->count) && (offset % pool->stride == 0);
+}
+
+uint32_t pool_getBlockSize(const vPool_t *pool) {
+	return pool->blockSize;
+}
+
+void pool_getStats(const vPool_t *pool, vPoolStats_t *stats) {
+	stats->count = pool->count;
+	stats->inUse = __atomic_load_n(&pool->inUse, __ATOMIC_RELAXED);
+	stats->peak = __atomic_load_n(&pool->peak, __ATOMIC_RELAXED);
+	stats->nFail = __atomic_load_n(&pool->nFail, __ATOMIC_RELAXED);
+}
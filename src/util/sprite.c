@@ -0,0 +1,380 @@
+/*
+ * sprite.c
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: chiong
+ */
+
+#include <string.h>
+#include "util/sprite.h"
+
+/**
+ * @brief Convert 0x00RRGGBB into a pixel value of fmt.
+ */
+static uint32_t sprite_toValue(uint32_t color, uint8_t fmt) {
+	switch (fmt) {
+	case BITMAP_PIXEL_FMT_RGB444:
+		return ((color >> 12) & 0x0F00) | ((color >> 8) & 0x00F0) | ((color >> 4) & 0x000F);
+	case BITMAP_PIXEL_FMT_RGB565:
+		return ((color >> 8) & 0xF800) | ((color >> 5) & 0x07E0) | ((color >> 3) & 0x001F);
+	default:
+		return color & 0xFCFCFC;
+	}
+}
+
+static uint32_t sprite_readValue(const uint8_t *p, uint32_t valueSize) {
+	if (3 == valueSize) {
+		return ((uint32_t) p[0] << 16) | ((uint32_t) p[1] << 8) | p[2];
+	}
+	return ((uint32_t) p[0] << 8) | p[1];
+}
+
+/**
+ * @brief Write pixel value of index k of a packed pixel stream starting at dst.
+ * 		With RGB444, pixel k - 1 must be written before an odd k.
+ */
+static inline void sprite_putValue(uint8_t *dst, uint32_t k, uint32_t value, uint8_t fmt) {
+	uint8_t *p;
+
+	switch (fmt) {
+	case BITMAP_PIXEL_FMT_RGB444:
+		p = dst + (k >> 1) * 3;
+		if (k & 1) {
+			p[1] |= (value >> 8) & 0x0F;
+			p[2] = value & 0xFF;
+		} else {
+			p[0] = (value >> 4) & 0xFF;
+			p[1] = (value & 0x0F) << 4;
+		}
+		break;
+	case BITMAP_PIXEL_FMT_RGB565:
+		p = dst + k * 2;
+		p[0] = value >> 8;
+		p[1] = value & 0xFF;
+		break;
+	default:
+		p = dst + k * 3;
+		p[0] = value >> 16;
+		p[1] = (value >> 8) & 0xFF;
+		p[2] = value & 0xFF;
+		break;
+	}
+}
+
+static uint8_t sprite_isValidFmt(uint8_t fmt) {
+	return BITMAP_PIXEL_FMT_RGB444 == fmt || BITMAP_PIXEL_FMT_RGB565 == fmt ||
+			BITMAP_PIXEL_FMT_RGB666 == fmt;
+}
+
+int32_t sprite_sheetInit(spriteSheet_t *pSheet, const void *data, uint32_t size) {
+	const spriteSheetHeader_t *header;
+	const spriteEntry_t *entry;
+	uint64_t nPixel;
+	uint32_t i;
+
+	header = (const spriteSheetHeader_t*) data;
+	if (size < sizeof(spriteSheetHeader_t) ||
+		memcmp(header->magic, SPRITE_MAGIC, sizeof(header->magic)) != 0 ||
+		SPRITE_VERSION != header->version || !sprite_isValidFmt(header->fmt) ||
+		(size - sizeof(spriteSheetHeader_t)) / sizeof(spriteEntry_t) < header->nSprite) {
+		return STATUS_ERROR;
+	}
+
+	/* Check every entry once here, so that drawing never reads outside sheet.
+	 * Sizes are in 64 bits, as up to 65535 x 65535 pixels would wrap in 32. */
+	entry = (const spriteEntry_t*) (header + 1);
+	for (i = 0; i < header->nSprite; i++, entry++) {
+		nPixel = (uint64_t) entry->width * entry->height;
+		if (entry->offset > size || entry->size > size - entry->offset) {
+			return STATUS_ERROR;
+		}
+
+		switch (entry->encoding) {
+		case SPRITE_ENC_RAW:
+			if (entry->size != BITMAP_getPackedSize(header->fmt, nPixel)) {
+				return STATUS_ERROR;
+			}
+			break;
+		case SPRITE_ENC_RLE:
+			break;
+		case SPRITE_ENC_PALETTE:
+			if ((1 != entry->bitPerIndex && 2 != entry->bitPerIndex &&
+				 4 != entry->bitPerIndex && 8 != entry->bitPerIndex) ||
+				0 == entry->nColor || entry->nColor > (1u << entry->bitPerIndex) ||
+				entry->size < (uint64_t) entry->nColor * SPRITE_getValueSize(header->fmt) +
+					(nPixel * entry->bitPerIndex + 7) / 8) {
+				return STATUS_ERROR;
+			}
+			break;
+		default:
+			return STATUS_ERROR;
+		}
+	}
+
+	pSheet->header = header;
+	pSheet->entry = (const spriteEntry_t*) (header + 1);
+	pSheet->base = (const uint8_t*) data;
+	return STATUS_OK;
+}
+
+uint32_t sprite_getNumSprite(const spriteSheet_t *pSheet) {
+	return pSheet->header->nSprite;
+}
+
+const spriteEntry_t* sprite_getEntry(const spriteSheet_t *pSheet, uint32_t idx) {
+	if (idx >= pSheet->header->nSprite) {
+		return NULL;
+	}
+
+	return &pSheet->entry[idx];
+}
+
+int32_t sprite_decoderInit(spriteDecoder_t *pDec, const spriteSheet_t *pSheet, uint32_t idx) {
+	const spriteEntry_t *entry;
+
+	entry = sprite_getEntry(pSheet, idx);
+	if (NULL == entry) {
+		return STATUS_ERROR_PARAM;
+	}
+
+	pDec->entry = entry;
+	pDec->data = pSheet->base + entry->offset;
+	pDec->src = pDec->data;
+	pDec->fmt = pSheet->header->fmt;
+	pDec->index = 0;
+	pDec->nRun = 0;
+	pDec->isRepeat = 0;
+	pDec->value = 0;
+	if (SPRITE_ENC_RAW == entry->encoding) {
+		pDec->nLeft = entry->size;
+	} else {
+		pDec->nLeft = (uint32_t) entry->width * entry->height;
+	}
+
+	return STATUS_OK;
+}
+
+/**
+ * @brief Get the next pixel value of RLE data.
+ * @return STATUS_OK if success, STATUS_ERROR if data ends early.
+ */
+static int32_t sprite_nextRle(spriteDecoder_t *pDec, uint32_t *value) {
+	const uint8_t *end;
+	uint32_t valueSize;
+	uint8_t c;
+
+	end = pDec->data + pDec->entry->size;
+	valueSize = SPRITE_getValueSize(pDec->fmt);
+	if (0 == pDec->nRun) {
+		if (pDec->src >= end) {
+			return STATUS_ERROR;
+		}
+		c = *pDec->src++;
+		pDec->isRepeat = (c & 0x80) != 0;
+		pDec->nRun = (c & 0x7F) + 1;
+		if (pDec->isRepeat) {
+			if ((uint32_t) (end - pDec->src) < valueSize) {
+				return STATUS_ERROR;
+			}
+			pDec->value = sprite_readValue(pDec->src, valueSize);
+			pDec->src += valueSize;
+		}
+	}
+
+	if (!pDec->isRepeat) {
+		if ((uint32_t) (end - pDec->src) < valueSize) {
+			return STATUS_ERROR;
+		}
+		pDec->value = sprite_readValue(pDec->src, valueSize);
+		pDec->src += valueSize;
+	}
+	pDec->nRun--;
+	*value = pDec->value;
+
+	return STATUS_OK;
+}
+
+uint32_t sprite_decode(spriteDecoder_t *pDec, uint8_t *dst, uint32_t size) {
+	const spriteEntry_t *entry;
+	const uint8_t *index;
+	uint32_t valueSize;
+	uint32_t nPixel;
+	uint32_t bits, mask, shift;
+	uint32_t value;
+	uint32_t pos;
+	uint32_t k;
+
+	entry = pDec->entry;
+	if (SPRITE_ENC_RAW == entry->encoding) {
+		/* Copy whole pixels, pairs of pixels for RGB444 */
+		size -= size % (BITMAP_PIXEL_FMT_RGB565 == pDec->fmt? 2 : 3);
+		if (size > pDec->nLeft) {
+			size = pDec->nLeft;
+		}
+		memcpy(dst, pDec->src, size);
+		pDec->src += size;
+		pDec->nLeft -= size;
+		return size;
+	}
+
+	switch (pDec->fmt) {
+	case BITMAP_PIXEL_FMT_RGB444:
+		nPixel = size / 3 * 2;
+		break;
+	case BITMAP_PIXEL_FMT_RGB565:
+		nPixel = size / 2;
+		break;
+	default:
+		nPixel = size / 3;
+		break;
+	}
+	if (nPixel > pDec->nLeft) {
+		nPixel = pDec->nLeft;
+	}
+
+	valueSize = SPRITE_getValueSize(pDec->fmt);
+	if (SPRITE_ENC_PALETTE == entry->encoding) {
+		index = pDec->data + entry->nColor * valueSize;
+		bits = entry->bitPerIndex;
+		mask = (1u << bits) - 1;
+		for (k = 0; k < nPixel; k++) {
+			pos = pDec->index++ * bits;
+			shift = 8 - bits - (pos & 7);
+			value = (index[pos >> 3] >> shift) & mask;
+			/* Index beyond palette, only in corrupted data */
+			if (value >= entry->nColor) {
+				value = 0;
+			}
+			sprite_putValue(dst, k, sprite_readValue(pDec->data + value * valueSize, valueSize), pDec->fmt);
+		}
+	} else {
+		for (k = 0; k < nPixel; k++) {
+			if (sprite_nextRle(pDec, &value) != STATUS_OK) {
+				/* Data ends early, end the sprite with what is decoded */
+				pDec->nLeft = k;
+				nPixel = k;
+				break;
+			}
+			sprite_putValue(dst, k, value, pDec->fmt);
+		}
+	}
+	pDec->nLeft -= nPixel;
+
+	return BITMAP_getPackedSize(pDec->fmt, nPixel);
+}
+
+/**
+ * @brief Write a byte of encoded data, or only count it if dst is NULL or full.
+ */
+static inline void sprite_emit(uint8_t *dst, uint32_t size, uint32_t *pos, uint8_t byte) {
+	if (NULL != dst && *pos < size) {
+		dst[*pos] = byte;
+	}
+	(*pos)++;
+}
+
+static void sprite_emitValue(uint8_t *dst, uint32_t size, uint32_t *pos, uint32_t value, uint32_t valueSize) {
+	if (3 == valueSize) {
+		sprite_emit(dst, size, pos, value >> 16);
+	}
+	sprite_emit(dst, size, pos, (value >> 8) & 0xFF);
+	sprite_emit(dst, size, pos, value & 0xFF);
+}
+
+int32_t sprite_encode(uint8_t *dst, uint32_t size, const uint32_t *pixel, uint32_t count,
+		uint8_t fmt, spriteEntry_t *entry) {
+	uint32_t palette[SPRITE_PALETTE_MAX];
+	uint32_t valueSize;
+	uint32_t nColor;
+	uint32_t value;
+	uint32_t pos;
+	uint32_t i, j, n;
+	uint32_t bits;
+	uint8_t byte;
+
+	if (!sprite_isValidFmt(fmt)) {
+		return STATUS_ERROR_PARAM;
+	}
+
+	valueSize = SPRITE_getValueSize(fmt);
+	pos = 0;
+	switch (entry->encoding) {
+	case SPRITE_ENC_RAW:
+		pos = BITMAP_getPackedSize(fmt, count);
+		if (NULL != dst && pos <= size) {
+			for (i = 0; i < count; i++) {
+				sprite_putValue(dst, i, sprite_toValue(pixel[i], fmt), fmt);
+			}
+		}
+		break;
+
+	case SPRITE_ENC_RLE:
+		for (i = 0; i < count; i += n) {
+			/* Run of the same value */
+			value = sprite_toValue(pixel[i], fmt);
+			for (n = 1; n < SPRITE_RLE_MAX && i + n < count &&
+					sprite_toValue(pixel[i + n], fmt) == value; n++);
+			if (n >= 2) {
+				sprite_emit(dst, size, &pos, 0x80 | (n - 1));
+				sprite_emitValue(dst, size, &pos, value, valueSize);
+				continue;
+			}
+
+			/* Literals until the next run of at least 2 */
+			for (n = 1; n < SPRITE_RLE_MAX && i + n < count; n++) {
+				if (i + n + 1 < count &&
+					sprite_toValue(pixel[i + n], fmt) == sprite_toValue(pixel[i + n + 1], fmt)) {
+					break;
+				}
+			}
+			sprite_emit(dst, size, &pos, n - 1);
+			for (j = 0; j < n; j++) {
+				sprite_emitValue(dst, size, &pos, sprite_toValue(pixel[i + j], fmt), valueSize);
+			}
+		}
+		break;
+
+	case SPRITE_ENC_PALETTE:
+		nColor = 0;
+		for (i = 0; i < count; i++) {
+			value = sprite_toValue(pixel[i], fmt);
+			for (j = 0; j < nColor && palette[j] != value; j++);
+			if (j == nColor) {
+				if (SPRITE_PALETTE_MAX == nColor) {
+					return STATUS_ERROR;
+				}
+				palette[nColor++] = value;
+			}
+		}
+		for (bits = 1; (1u << bits) < nColor; bits <<= 1);
+		entry->nColor = (uint16_t) nColor;
+		entry->bitPerIndex = (uint8_t) bits;
+
+		for (j = 0; j < nColor; j++) {
+			sprite_emitValue(dst, size, &pos, palette[j], valueSize);
+		}
+		byte = 0;
+		for (i = 0; i < count; i++) {
+			value = sprite_toValue(pixel[i], fmt);
+			for (j = 0; palette[j] != value; j++);
+			byte |= j << (8 - bits - (i * bits & 7));
+			if (((i + 1) * bits & 7) == 0) {
+				sprite_emit(dst, size, &pos, byte);
+				byte = 0;
+			}
+		}
+		if (count * bits & 7) {
+			sprite_emit(dst, size, &pos, byte);
+		}
+		break;
+
+	default:
+		return STATUS_ERROR_PARAM;
+	}
+
+	if (NULL != dst && pos > size) {
+		return STATUS_ERROR_PARAM;
+	}
+
+	return (int32_t) pos;
+}
@@ -7,19 +7,37 @@
  *
  */
 
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include "util/status.h"
+#include "util/pool.h"
 #include "util/stack.h"
+#ifdef DEBUG
+#include "debug/assert.h"
+#endif
+
+/* Header at the start of each additional segment in chained mode. Saves the state
+ * of the previous segment, restored once this segment is no longer used. */
+typedef struct stackSeg_s {
+	struct stackSeg_s *prev;
+	void *prevStartAddr;
+	void *prevEndAddr;
+	void *prevCurrAddr;
+	uint32_t prevUsedBase;
+	/* Size, in bytes, of memory after this header, including alignment padding. */
+	uint32_t size;
+} stackSeg_t;
 
 struct vStack_s {
     /* Read-only. This base address is the raw addr as returned by malloc()
      * without any alignment. It is used for free-ing the memory only. */
     void *baseAddr;
-	/* Start address of this stack memory instance. Inclusive. */
+	/* Start address of this stack memory instance. Inclusive. In chained mode,
+	 * start address of current segment. */
 	void *startAddr;
-	/* Read-only. End address of this stack memory instance. Exclusive.
-	 * Used for checking during allocation. */
+	/* End address of this stack memory instance. Exclusive. In chained mode, end
+	 * address of current segment. Used for checking during allocation. */
 	void *endAddr;
 	/* Current start address of remaining memory. */
 	void *currAddr;
@@ -27,14 +45,192 @@ struct vStack_s {
 	void *currFrameAddr;
 	/* Stack frame depth. */
 	uint8_t frameDepth;
+
+	/* Non-zero if this instance sits at the start of memory given to
+	 * stack_createInPlace(), so is not to be freed on destroy. */
+	uint8_t isInPlace;
+
+	/* Chained mode only, see stack_createChained(). */
+	uint8_t isChained;
+	/* Read-only. As configured. */
+	uint32_t alignment;
+	uint32_t segmentSize;
+	uint32_t maxSize;
+	vPool_t *pool;
+	/* Read-only. Size of first segment, i.e. vStackCfg_t.size */
+	uint32_t firstSize;
+	/* Current segment. NULL if in first segment. */
+	stackSeg_t *currSeg;
+	/* Segment no longer used, kept for next growth. */
+	stackSeg_t *spareSeg;
+	/* Number of bytes in segments before current segment. */
+	uint32_t usedBase;
+	/* Number of bytes in all additional segments, including spare. */
+	uint32_t chainSize;
+
+	/* Statistics since created or last stack_resetStats(). */
+	/* Maximum number of bytes used. */
+	uint32_t peak;
+	uint32_t nAlloc;
+	uint32_t nFail;
+	uint32_t nGrow;
+	uint8_t maxFrameDepth;
+#ifdef DEBUG
+	/* Maximum number of bytes used in current frame, including its nested frames. */
+	uint32_t framePeak;
+	uint32_t nFrameStats;
+	vStackFrameStats_t frameStats[STACK_MAX_FRAME_STATS];
+#endif
 };
 
+static inline uint32_t stack_getUsed(const vStack_t *stack) {
+	return stack->usedBase + (uint32_t) (stack->currAddr - stack->startAddr);
+}
+
+static void stack_updatePeak(vStack_t *stack) {
+	uint32_t used = stack_getUsed(stack);
+
+	if (used > stack->peak) {
+		stack->peak = used;
+	}
+#ifdef DEBUG
+	if (used > stack->framePeak) {
+		stack->framePeak = used;
+	}
+#endif
+}
+
+/**
+ * @brief Release memory of a segment, to pool or heap.
+ */
+static void stack_freeSeg(vStack_t *stack, stackSeg_t *seg) {
+	stack->chainSize -= seg->size;
+	if (NULL != stack->pool) {
+		pool_free(stack->pool, seg);
+	} else {
+		free(seg);
+	}
+}
+
+/**
+ * @brief Link a segment with at least minSize bytes after the current segment.
+ * 		Slow path of stack_alignedAlloc() and stack_openFrameWithName().
+ */
+static int32_t stack_grow(vStack_t *stack, uint64_t minSize) {
+	stackSeg_t *seg;
+	uintptr_t mask;
+	uint64_t size;
+
+	seg = stack->spareSeg;
+	stack->spareSeg = NULL;
+	if (NULL != seg && seg->size < minSize) {
+		stack_freeSeg(stack, seg);
+		seg = NULL;
+	}
+
+	if (NULL == seg) {
+		/* Worst case padding after header to keep the stack alignment */
+		if (NULL != stack->pool) {
+			size = pool_getBlockSize(stack->pool) - sizeof(stackSeg_t) - (stack->alignment - 1);
+		} else {
+			size = (minSize > stack->segmentSize) ? minSize : stack->segmentSize;
+		}
+		if (size < minSize ||
+			(stack->maxSize && stack->firstSize + stack->chainSize + size > stack->maxSize)) {
+			return STATUS_ERROR;
+		}
+
+		if (NULL != stack->pool) {
+			seg = (stackSeg_t*) pool_alloc(stack->pool);
+		} else {
+			seg = (stackSeg_t*) malloc(sizeof(stackSeg_t) + stack->alignment - 1 + size);
+		}
+		if (NULL == seg) {
+			return STATUS_ERROR_MALLOC;
+		}
+		seg->size = (uint32_t) size;
+		stack->chainSize += seg->size;
+	}
+
+	seg->prev = stack->currSeg;
+	seg->prevStartAddr = stack->startAddr;
+	seg->prevEndAddr = stack->endAddr;
+	seg->prevCurrAddr = stack->currAddr;
+	seg->prevUsedBase = stack->usedBase;
+
+	/* Unused tail of previous segment counts as used */
+	stack->usedBase += (uint32_t) (stack->endAddr - stack->startAddr);
+	stack->currSeg = seg;
+	mask = (uintptr_t) (stack->alignment - 1);
+	stack->startAddr = (void*) (((uintptr_t) (seg + 1) + mask) & ~mask);
+	stack->endAddr = stack->startAddr + seg->size;
+	stack->currAddr = stack->startAddr;
+	stack->nGrow++;
+
+	return STATUS_OK;
+}
+
+/**
+ * @brief Return to the previous segment. The current segment is kept as spare, so
+ * 		that a stack used around a segment boundary does not allocate and free on
+ * 		every frame.
+ */
+static void stack_shrink(vStack_t *stack) {
+	stackSeg_t *seg = stack->currSeg;
+
+	stack->startAddr = seg->prevStartAddr;
+	stack->endAddr = seg->prevEndAddr;
+	stack->usedBase = seg->prevUsedBase;
+	stack->currSeg = seg->prev;
+
+	if (NULL == stack->spareSeg) {
+		stack->spareSeg = seg;
+	} else {
+		stack_freeSeg(stack, seg);
+	}
+}
+
+#ifdef DEBUG
+/**
+ * @brief Record the peak usage of a closed frame under its name.
+ */
+static void stack_recordFrame(vStack_t *stack, const char *name, uint32_t peak) {
+	vStackFrameStats_t *frame;
+	uint32_t i;
+
+	for (i = 0; i < stack->nFrameStats; i++) {
+		if (strncmp(stack->frameStats[i].name, name, STACK_FRAME_NAME_SIZE - 1) == 0) {
+			break;
+		}
+	}
+
+	if (i == stack->nFrameStats) {
+		if (i == STACK_MAX_FRAME_STATS) {
+			/* Table full, frame not recorded */
+			return;
+		}
+		frame = &stack->frameStats[i];
+		strncpy(frame->name, name, STACK_FRAME_NAME_SIZE - 1);
+		frame->name[STACK_FRAME_NAME_SIZE - 1] = '\0';
+		frame->peak = 0;
+		frame->count = 0;
+		stack->nFrameStats++;
+	}
+
+	frame = &stack->frameStats[i];
+	if (peak > frame->peak) {
+		frame->peak = peak;
+	}
+	frame->count++;
+}
+#endif
+
 int32_t stack_create(vStack_t **ppScratch, const vStackCfg_t *cfg) {
 	vStack_t *stack;
 	uintptr_t mask;
 	uintptr_t ptr;
 
-	stack = (vStack_t*) malloc(sizeof(vStack_t));
+	stack = (vStack_t*) calloc(1, sizeof(vStack_t));
 	if (NULL == stack) {
 		return STATUS_ERROR_MALLOC;
 	}
@@ -45,30 +241,113 @@ int32_t stack_create(vStack_t **ppScratch, const vStackCfg_t *cfg) {
 		return STATUS_ERROR_MALLOC;
 	}
 
-	/* Perform manual alignment */
+	/* Perform manual alignment. Only the alignment - 1 bytes allocated above can
+	 * be skipped. */
 	ptr = (uintptr_t) stack->baseAddr;
 	mask = (uintptr_t) (cfg->alignment - 1);
-	if (mask) {
-	    ptr = (ptr & ~mask) + (uintptr_t) cfg->alignment;
-	}
+	ptr = (ptr + mask) & ~mask;
 
 	stack->startAddr = (void*) ptr;
 	stack->endAddr = stack->startAddr + cfg->size;
+	stack->alignment = cfg->alignment;
+	stack->firstSize = cfg->size;
 	stack_reset(stack);
+	stack_resetStats(stack);
 
 	*ppScratch = stack;
 	return STATUS_OK;
 }
 
+/**
+ * @brief Offset of stack memory from the instance created in place, keeping
+ * 		the stack memory aligned as configured.
+ */
+static uint32_t stack_getInPlaceOffset(const vStackCfg_t *cfg) {
+	uint32_t size = sizeof(vStack_t);
+
+	return (size + cfg->alignment - 1) / cfg->alignment * cfg->alignment;
+}
+
+uint32_t stack_getInPlaceSize(const vStackCfg_t *cfg) {
+	return stack_getInPlaceOffset(cfg) + cfg->size;
+}
+
+int32_t stack_createInPlace(vStack_t **ppScratch, const vStackCfg_t *cfg, void *mem) {
+	vStack_t *stack;
+
+	if (NULL == mem) {
+		return STATUS_ERROR_NULL;
+	}
+	if (((uintptr_t) mem & (__alignof__(vStack_t) - 1)) != 0) {
+		return STATUS_ERROR_PARAM;
+	}
+
+	/* The instance goes first, so that it shares cache lines with nothing but
+	 * its own stack memory */
+	stack = (vStack_t*) mem;
+	memset(stack, 0, sizeof(vStack_t));
+	stack->isInPlace = 1;
+
+	/* Not owned, so nothing to free on destroy */
+	stack->baseAddr = NULL;
+	stack->startAddr = (uint8_t*) mem + stack_getInPlaceOffset(cfg);
+	stack->endAddr = stack->startAddr + cfg->size;
+	stack->alignment = cfg->alignment;
+	stack->firstSize = cfg->size;
+	stack_reset(stack);
+	stack_resetStats(stack);
+
+	*ppScratch = stack;
+	return STATUS_OK;
+}
+
+int32_t stack_createChained(vStack_t **ppScratch, const vStackCfg_t *cfg,
+		const vStackChainCfg_t *chainCfg) {
+	int32_t status;
+
+	if (NULL != chainCfg->pool &&
+		pool_getBlockSize(chainCfg->pool) <= sizeof(stackSeg_t) + cfg->alignment - 1) {
+		/* No room in pool block after segment header */
+		return STATUS_ERROR_PARAM;
+	}
+	if (NULL == chainCfg->pool && 0 == chainCfg->segmentSize) {
+		return STATUS_ERROR_PARAM;
+	}
+
+	status = stack_create(ppScratch, cfg);
+	if (STATUS_OK != status) {
+		return status;
+	}
+
+	(*ppScratch)->isChained = 1;
+	(*ppScratch)->segmentSize = chainCfg->segmentSize;
+	(*ppScratch)->maxSize = chainCfg->maxSize;
+	(*ppScratch)->pool = chainCfg->pool;
+
+	return STATUS_OK;
+}
+
 int32_t stack_destroy(vStack_t **ppScratch) {
 	vStack_t *stack;
 
 	stack = *ppScratch;
 	if (NULL != stack) {
+#ifdef STACK_PRINT_STATS_ON_DESTROY
+		if (NULL != stack->startAddr)
+			stack_printStats(stack);
+#endif
+		/* Return to first segment, then release the spare */
+		while (NULL != stack->currSeg) {
+			stack_shrink(stack);
+		}
+		if (NULL != stack->spareSeg)
+			stack_freeSeg(stack, stack->spareSeg);
+
 		if (NULL != stack->baseAddr)
 			free(stack->baseAddr);
 
-		free(stack);
+		if (!stack->isInPlace)
+			free(stack);
 		*ppScratch = NULL;
 	}
 
@@ -76,45 +355,93 @@ int32_t stack_destroy(vStack_t **ppScratch) {
 }
 
 int32_t stack_openFrameWithName(vStack_t *stack, const char *name) {
-	if (stack_getAvailSize(stack) >= sizeof(void*)) {
-		/* Push current start of frame address to stack, and advance the currAddr
-		 * to next available stack. */
-		memcpy(stack->currAddr, &stack->currFrameAddr, sizeof(void*));
-		stack->currFrameAddr = stack->currAddr;
-		stack->currAddr += sizeof(void*);
-		/* Increment stack frame depth */
-		stack->frameDepth++;
-	} else {
-		return STATUS_ERROR;
-	}
-
+	uint32_t hdrSize;
 #ifdef DEBUG
+	uintptr_t parentPeak;
 	size_t len = strlen(name);
-	if (stack_getAvailSize(stack) >= (len + 1)) {
-		memcpy(stack->currAddr, name, len + 1);
-		stack->currAddr += len + 1;
-	} else {
-		return STATUS_ERROR;
-	}
+
+	/* Previous start of frame address, peak of parent frame, name of this frame */
+	hdrSize = 2 * sizeof(void*) + len + 1;
 #else
 	(void) name;
+
+	/* Previous start of frame address */
+	hdrSize = sizeof(void*);
 #endif
 
+	if (stack_getAvailSize(stack) < hdrSize &&
+		(!stack->isChained || STATUS_OK != stack_grow(stack, hdrSize))) {
+		stack->nFail++;
+		return STATUS_ERROR;
+	}
+
+	/* Push current start of frame address to stack, and advance the currAddr
+	 * to next available stack. */
+	memcpy(stack->currAddr, &stack->currFrameAddr, sizeof(void*));
+	stack->currFrameAddr = stack->currAddr;
+	stack->currAddr += sizeof(void*);
+	/* Increment stack frame depth */
+	stack->frameDepth++;
+	if (stack->frameDepth > stack->maxFrameDepth) {
+		stack->maxFrameDepth = stack->frameDepth;
+	}
+
+#ifdef DEBUG
+	parentPeak = stack->framePeak;
+	memcpy(stack->currAddr, &parentPeak, sizeof(void*));
+	stack->currAddr += sizeof(void*);
+	memcpy(stack->currAddr, name, len + 1);
+	stack->currAddr += len + 1;
+	stack->framePeak = 0;
+#endif
+
+	stack_updatePeak(stack);
 	return STATUS_OK;
 }
 
 int32_t stack_closeFrameWithName(vStack_t *stack, const char *name) {
 #ifdef DEBUG
-	char *ptr = stack->currFrameAddr + sizeof(void*);
-	ASSERT(strcmp(name, ptr) != 0, "Potential stack memory leaks!");
-#else
-	(void) name;
+	uintptr_t parentPeak;
+	uint32_t frameStart;
+	char *ptr;
 #endif
 
 	if (stack->frameDepth > 0) {
+#ifdef DEBUG
+		ptr = stack->currFrameAddr + 2 * sizeof(void*);
+		ASSERT(strcmp(name, ptr) == 0, "Potential stack memory leaks!");
+#else
+		(void) name;
+#endif
+
+		/* Return to the segment where the frame is opened */
+		while (NULL != stack->currSeg &&
+				(stack->currFrameAddr < stack->startAddr ||
+				 stack->currFrameAddr >= stack->endAddr)) {
+			stack_shrink(stack);
+		}
+
+#ifdef DEBUG
+		frameStart = stack->usedBase + (uint32_t) (stack->currFrameAddr - stack->startAddr);
+		stack_recordFrame(stack, name, stack->framePeak - frameStart);
+
+		/* Peak of parent frame includes this frame */
+		memcpy(&parentPeak, stack->currFrameAddr + sizeof(void*), sizeof(void*));
+		if (parentPeak > stack->framePeak) {
+			stack->framePeak = (uint32_t) parentPeak;
+		}
+#endif
+
         stack->currAddr = stack->currFrameAddr;
         memcpy(&stack->currFrameAddr, stack->currFrameAddr, sizeof(void*));
 
+        if (NULL != stack->currSeg && stack->currAddr == stack->startAddr) {
+        	/* The frame is opened at the start of a new segment, which is now
+        	 * empty. Return to where the previous segment was left. */
+        	stack->currAddr = stack->currSeg->prevCurrAddr;
+        	stack_shrink(stack);
+        }
+
         stack->frameDepth--;
         return STATUS_OK;
 	} else {
@@ -135,9 +462,17 @@ int32_t stack_closeFrameWithName(vStack_t *stack, const char *name) {
 }
 
 int32_t stack_reset(vStack_t *stack) {
+	/* Return to first segment */
+	while (NULL != stack->currSeg) {
+		stack_shrink(stack);
+	}
+
 	stack->currAddr = stack->startAddr;
 	stack->currFrameAddr = stack->startAddr;
 	stack->frameDepth = 0;
+#ifdef DEBUG
+	stack->framePeak = 0;
+#endif
 	return STATUS_OK;
 }
 
@@ -155,22 +490,85 @@ void* stack_alignedAlloc(vStack_t *stack, uint32_t alignment, uint32_t size) {
 		ptr = (ptr & ~mask) + (uintptr_t)alignment;
 	}
 
+	/* size is in number of elements of alignment bytes */
 	endPtr = (uintptr_t) stack->endAddr;
-	if (endPtr - ptr >= size) {
+	if (ptr <= endPtr && (endPtr - ptr) / alignment >= size) {
 		/* Has enough size */
-		stack->currAddr = (void*)(ptr + size * alignment);
+		stack->currAddr = (void*)(ptr + (uintptr_t) size * alignment);
+		stack->nAlloc++;
+		stack_updatePeak(stack);
+	} else if (stack->isChained &&
+			STATUS_OK == stack_grow(stack, STACK_ALIGNED_ALLOC_SIZE((uint64_t) alignment, size))) {
+		/* Retry in new segment, which always has enough size */
+		return stack_alignedAlloc(stack, alignment, size);
 	} else {
 		/* Insufficient size */
 		ptr = (uintptr_t) NULL;
+		stack->nFail++;
 	}
 
 	return (void*) ptr;
 }
 
 uint32_t stack_getSize(const vStack_t *stack) {
-	return (stack->endAddr - stack->startAddr);
+	return stack->usedBase + (stack->endAddr - stack->startAddr);
 }
 
 uint32_t stack_getAvailSize(const vStack_t *stack) {
 	return (stack->endAddr - stack->currAddr);
 }
+
+void stack_getStats(const vStack_t *stack, vStackStats_t *stats) {
+	stats->size = stack->firstSize + stack->chainSize;
+	stats->used = stack_getUsed(stack);
+	stats->peak = stack->peak;
+	stats->nAlloc = stack->nAlloc;
+	stats->nFail = stack->nFail;
+	stats->nGrow = stack->nGrow;
+	stats->maxFrameDepth = stack->maxFrameDepth;
+}
+
+uint32_t stack_getFrameStats(const vStack_t *stack, vStackFrameStats_t *stats, uint32_t maxStats) {
+#ifdef DEBUG
+	uint32_t n;
+
+	n = (stack->nFrameStats < maxStats) ? stack->nFrameStats : maxStats;
+	memcpy(stats, stack->frameStats, n * sizeof(vStackFrameStats_t));
+	return n;
+#else
+	(void) stack;
+	(void) stats;
+	(void) maxStats;
+	return 0;
+#endif
+}
+
+int32_t stack_resetStats(vStack_t *stack) {
+	stack->peak = stack_getUsed(stack);
+	stack->nAlloc = 0;
+	stack->nFail = 0;
+	stack->nGrow = 0;
+	stack->maxFrameDepth = stack->frameDepth;
+#ifdef DEBUG
+	stack->nFrameStats = 0;
+#endif
+	return STATUS_OK;
+}
+
+void stack_printStats(const vStack_t *stack) {
+	vStackStats_t stats;
+#ifdef DEBUG
+	uint32_t i;
+#endif
+
+	stack_getStats(stack, &stats);
+	fprintf(stdout, "stack %p: size %u, used %u, peak %u, alloc %u, fail %u, grow %u, max depth %u\n",
+			(const void*) stack, stats.size, stats.used, stats.peak, stats.nAlloc,
+			stats.nFail, stats.nGrow, stats.maxFrameDepth);
+#ifdef DEBUG
+	for (i = 0; i < stack->nFrameStats; i++) {
+		fprintf(stdout, "  frame %s: peak %u, count %u\n", stack->frameStats[i].name,
+				stack->frameStats[i].peak, stack->frameStats[i].count);
+	}
+#endif
+}
@@ -0,0 +1,135 @@
+/*
+ * wav.c
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: chiong
+ */
+
+#include <string.h>
+#include "util/wav.h"
+#include "util/status.h"
+
+/* Size of fmt chunk body for plain PCM/float, and offset of the sub-format GUID
+ * in the extensible fmt chunk body. */
+#define WAV_FMT_SIZE				(16)
+#define WAV_FMT_EXT_SUBFORMAT_OFF	(24)
+
+static uint16_t wav_read16(const uint8_t *p) {
+	return (uint16_t) (p[0] | (p[1] << 8));
+}
+
+static uint32_t wav_read32(const uint8_t *p) {
+	return (uint32_t) p[0] | ((uint32_t) p[1] << 8) |
+			((uint32_t) p[2] << 16) | ((uint32_t) p[3] << 24);
+}
+
+static void wav_write16(uint8_t *p, uint16_t val) {
+	p[0] = val & 0xFF;
+	p[1] = (val >> 8) & 0xFF;
+}
+
+static void wav_write32(uint8_t *p, uint32_t val) {
+	p[0] = val & 0xFF;
+	p[1] = (val >> 8) & 0xFF;
+	p[2] = (val >> 16) & 0xFF;
+	p[3] = (val >> 24) & 0xFF;
+}
+
+int32_t wav_parseHeader(wavInfo_t *info, const uint8_t *data, uint32_t size) {
+	uint32_t pos;
+	uint32_t chunkSize;
+	uint8_t hasFmt = 0;
+
+	if (size < 12 || memcmp(data, "RIFF", 4) != 0 || memcmp(data + 8, "WAVE", 4) != 0) {
+		return STATUS_ERROR_PARAM;
+	}
+
+	/* Walk the chunk list. Chunks are word aligned, i.e. odd sizes are padded. */
+	pos = 12;
+	while (pos + 8 <= size) {
+		chunkSize = wav_read32(data + pos + 4);
+
+		if (memcmp(data + pos, "fmt ", 4) == 0) {
+			if (chunkSize < WAV_FMT_SIZE || pos + 8 + WAV_FMT_SIZE > size) {
+				return STATUS_ERROR_PARAM;
+			}
+			info->format = wav_read16(data + pos + 8);
+			info->channel = wav_read16(data + pos + 10);
+			info->sampleRate = wav_read32(data + pos + 12);
+			info->bitsPerSample = wav_read16(data + pos + 22);
+			if (WAV_FORMAT_EXTENSIBLE == info->format) {
+				if (chunkSize < WAV_FMT_EXT_SUBFORMAT_OFF + 2 ||
+					pos + 8 + WAV_FMT_EXT_SUBFORMAT_OFF + 2 > size) {
+					return STATUS_ERROR_PARAM;
+				}
+				/* First 2 bytes of the sub-format GUID is the format tag */
+				info->format = wav_read16(data + pos + 8 + WAV_FMT_EXT_SUBFORMAT_OFF);
+			}
+			hasFmt = 1;
+		} else if (memcmp(data + pos, "data", 4) == 0) {
+			if (!hasFmt) {
+				return STATUS_ERROR_PARAM;
+			}
+			info->dataOffset = pos + 8;
+			info->dataSize = chunkSize;
+			if (info->dataSize > size - info->dataOffset) {
+				info->dataSize = size - info->dataOffset;
+			}
+			break;
+		}
+
+		if (chunkSize > size - pos - 8) {
+			/* Chunk runs past the end of file, e.g. truncated or corrupt. Checked
+			 * before advancing, so that a hostile size cannot wrap pos around. */
+			return STATUS_ERROR_PARAM;
+		}
+		pos += 8 + chunkSize;
+		if ((chunkSize & 0x1) && pos < size) {
+			pos++;
+		}
+	}
+
+	if (!hasFmt || pos + 8 > size) {
+		/* Missing fmt or data chunk */
+		return STATUS_ERROR_PARAM;
+	}
+
+	if (!((WAV_FORMAT_PCM == info->format && 16 == info->bitsPerSample) ||
+		  (WAV_FORMAT_IEEE_FLOAT == info->format && 32 == info->bitsPerSample)) ||
+		info->channel == 0) {
+		return STATUS_ERROR_PARAM;
+	}
+
+	return STATUS_OK;
+}
+
+int32_t wav_writeHeader(FILE *f, const wavInfo_t *info) {
+	uint8_t header[WAV_HEADER_SIZE];
+	uint32_t frameSize;
+
+	frameSize = wav_getFrameSize(info);
+
+	memcpy(header, "RIFF", 4);
+	wav_write32(header + 4, WAV_HEADER_SIZE - 8 + info->dataSize);
+	memcpy(header + 8, "WAVE", 4);
+	memcpy(header + 12, "fmt ", 4);
+	wav_write32(header + 16, WAV_FMT_SIZE);
+	wav_write16(header + 20, info->format);
+	wav_write16(header + 22, info->channel);
+	wav_write32(header + 24, info->sampleRate);
+	wav_write32(header + 28, info->sampleRate * frameSize);
+	wav_write16(header + 32, (uint16_t) frameSize);
+	wav_write16(header + 34, info->bitsPerSample);
+	memcpy(header + 36, "data", 4);
+	wav_write32(header + 40, info->dataSize);
+
+	if (fwrite(header, 1, WAV_HEADER_SIZE, f) != WAV_HEADER_SIZE) {
+		return STATUS_ERROR;
+	}
+
+	return STATUS_OK;
+}
+
+uint32_t wav_getFrameSize(const wavInfo_t *info) {
+	return info->channel * (info->bitsPerSample >> 3);
+}
@@ -0,0 +1,500 @@
+/*
+ * apsigm_batch.c
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: chiong
+ *
+ *  Offline batch runner for apsigm. Each input file is memory-mapped, streamed
+ *  through apsigm_process() frame by frame as fast as possible and the enhanced
+ *  single channel output is written next to the input (or to -o directory) with
+ *  "_enh" appended to the name. Processing time and realtime factor are printed
+ *  per file so that apsigmCfg_t parameter sweeps can be compared.
+ *
+ *  Supported input:
+ *  1. WAV, 16-bit PCM or 32-bit float, any number of channels.
+ *  2. RAW interleaved samples. Channel count, sample rate and sample type must be
+ *     given with -c, -r and -t since there is no header.
+ *
+ *  Multiple files can be processed in parallel with -j. Each worker owns its own
+ *  apsigm_t instance; only FFTW planning is serialised since the planner is not
+ *  thread safe.
+ *
+ *  Build (host), from repository root:
+ *  	gcc -O2 -Iinc -I.. -o apsigm_batch tool/apsigm_batch/apsigm_batch.c \
+ *  		src/dsp/apsigm.c src/util/stack.c src/util/wav.c \
+ *  		-lfftw3f -lcblas -lblas -lgfortran -lpthread -lm
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "util/status.h"
+#include "util/wav.h"
+#include "dsp/apsigm.h"
+
+/* Number of output samples converted before handing them to stdio. */
+#define BATCH_OUT_BLOCK			(4096)
+/* stdio buffer size for output file. */
+#define BATCH_OUT_STDIO_SIZE	(1 << 20)
+/* Suffix appended to output file name. */
+#define BATCH_OUT_SUFFIX		"_enh"
+
+typedef enum {
+	BATCH_SAMPLE_S16 = 0,
+	BATCH_SAMPLE_F32 = 1
+} batchSample_t;
+
+typedef struct {
+	/* Output directory, NULL to write next to the input file. */
+	const char *outDir;
+	/* Number of worker threads. */
+	uint32_t nJob;
+	/* Configuration for RAW input. Ignored for WAV input. */
+	uint32_t rawChannel;
+	uint32_t rawSampleRate;
+	batchSample_t rawSample;
+	/* Base apsigm configuration. channel and sampleRate are set per file. */
+	apsigmCfg_t cfg;
+	/* Do not write output, only measure processing speed. */
+	uint8_t isDryRun;
+} batchOpt_t;
+
+typedef struct {
+	const char *inPath;
+	/* Results, filled by worker */
+	int32_t status;
+	double audioSec;
+	double procSec;
+} batchJob_t;
+
+typedef struct {
+	const batchOpt_t *opt;
+	batchJob_t *jobs;
+	uint32_t nFile;
+	/* Index of next job to be picked up by a worker. */
+	uint32_t nextJob;
+	pthread_mutex_t lock;
+} batchCtx_t;
+
+/* FFTW planner is not re-entrant, so apsigm_create()/apsigm_destroy() are
+ * serialised among workers. */
+static pthread_mutex_t planLock = PTHREAD_MUTEX_INITIALIZER;
+
+static double batch_now(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void batch_usage(const char *prog) {
+	fprintf(stderr,
+		"Usage: %s [options] file [file ...]\n"
+		"  -o dir    Output directory (default: next to input)\n"
+		"  -j n      Number of files processed in parallel (default 1)\n"
+		"  -n n      Frame size in samples (default %u)\n"
+		"  -g gain   Output gain, linear (default %.2f)\n"
+		"  -m idx    Reference mic channel index (default %u)\n"
+		"  -i n      Initialisation duration in frames (default %u)\n"
+		"  -P        Disable post filter\n"
+		"  -c n      RAW input: number of channels\n"
+		"  -r hz     RAW input: sample rate\n"
+		"  -t type   RAW input: sample type, s16 (default) or f32\n"
+		"  -d        Dry run, do not write output\n",
+		prog, APSIGM_DEFAULT_CFG.frameSize, APSIGM_DEFAULT_CFG.gain,
+		APSIGM_DEFAULT_CFG.refMic, APSIGM_DEFAULT_CFG.initDuration);
+}
+
+/**
+ * @brief Build output path from input path, i.e. [outDir/]basename_enh.ext
+ */
+static void batch_getOutPath(char *outPath, size_t len, const char *inPath, const char *outDir) {
+	const char *base;
+	const char *ext;
+	int dirLen;
+
+	base = strrchr(inPath, '/');
+	base = (NULL == base)? inPath : base + 1;
+	ext = strrchr(base, '.');
+	if (NULL == ext) {
+		ext = base + strlen(base);
+	}
+
+	if (NULL != outDir) {
+		snprintf(outPath, len, "%s/%.*s%s%s", outDir, (int) (ext - base), base, BATCH_OUT_SUFFIX, ext);
+	} else {
+		dirLen = (int) (base - inPath);
+		snprintf(outPath, len, "%.*s%.*s%s%s", dirLen, inPath, (int) (ext - base), base, BATCH_OUT_SUFFIX, ext);
+	}
+}
+
+/**
+ * @brief De-interleave one frame into per channel float buffers. Samples beyond
+ * 		nValid are zero padded.
+ */
+static void batch_deinterleave(float **in, const uint8_t *src, batchSample_t type,
+		uint32_t nChannel, uint32_t nSample, uint32_t nValid) {
+	uint32_t i, c;
+	const int16_t *s16;
+	const float *f32;
+
+	switch (type) {
+	case BATCH_SAMPLE_S16:
+		s16 = (const int16_t*) src;
+		for (i = 0; i < nValid; i++) {
+			for (c = 0; c < nChannel; c++) {
+				in[c][i] = *s16++ * (1.0f / 32768.0f);
+			}
+		}
+		break;
+
+	case BATCH_SAMPLE_F32:
+		f32 = (const float*) src;
+		for (i = 0; i < nValid; i++) {
+			for (c = 0; c < nChannel; c++) {
+				in[c][i] = *f32++;
+			}
+		}
+		break;
+	}
+
+	for (c = 0; c < nChannel; c++) {
+		memset(in[c] + nValid, 0, (nSample - nValid) * sizeof(float));
+	}
+}
+
+/**
+ * @brief Convert float output to the output sample type.
+ */
+static void batch_convertOut(void *dst, const float *src, batchSample_t type, uint32_t count) {
+	uint32_t i;
+	float val;
+	int16_t *s16;
+
+	switch (type) {
+	case BATCH_SAMPLE_S16:
+		s16 = (int16_t*) dst;
+		for (i = 0; i < count; i++) {
+			val = src[i] * 32768.0f;
+			val = val < -32768.0f? -32768.0f : val;
+			val = val > 32767.0f? 32767.0f : val;
+			s16[i] = (int16_t) val;
+		}
+		break;
+
+	case BATCH_SAMPLE_F32:
+		memcpy(dst, src, count * sizeof(float));
+		break;
+	}
+}
+
+static int32_t batch_processFile(batchJob_t *job, const batchOpt_t *opt) {
+	int fd;
+	struct stat st;
+	uint8_t *map;
+	const uint8_t *samples;
+	wavInfo_t wav;
+	uint8_t isWav;
+	batchSample_t type;
+	uint32_t frameBytes;
+	uint64_t nFrameTotal, n, nValid;
+	apsigmCfg_t cfg;
+	apsigm_t *apsigm = NULL;
+	float *inMem = NULL;
+	float **in = NULL;
+	float *out = NULL;
+	uint8_t *outConv = NULL;
+	uint32_t outFill, sampleSize, c;
+	FILE *fOut = NULL;
+	char outPath[1024];
+	double t0;
+	int32_t status;
+
+	fd = open(job->inPath, O_RDONLY);
+	if (fd < 0) {
+		fprintf(stderr, "%s: %s\n", job->inPath, strerror(errno));
+		return STATUS_ERROR_FILE_OPEN;
+	}
+	if (fstat(fd, &st) != 0 || st.st_size == 0) {
+		close(fd);
+		fprintf(stderr, "%s: empty or unreadable file\n", job->inPath);
+		return STATUS_ERROR_FILE_OPEN;
+	}
+	map = (uint8_t*) mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (MAP_FAILED == map) {
+		fprintf(stderr, "%s: mmap failed, %s\n", job->inPath, strerror(errno));
+		return STATUS_ERROR;
+	}
+	/* Input is read exactly once from start to end. */
+	madvise(map, st.st_size, MADV_SEQUENTIAL);
+
+	isWav = (st.st_size >= 12 && memcmp(map, "RIFF", 4) == 0);
+	if (isWav) {
+		/* Sizes in WAV are 32-bit, samples past 4 GB cannot be part of data */
+		if (wav_parseHeader(&wav, map, (st.st_size > UINT32_MAX)? UINT32_MAX : (uint32_t) st.st_size) != STATUS_OK) {
+			fprintf(stderr, "%s: unsupported WAV format\n", job->inPath);
+			munmap(map, st.st_size);
+			return STATUS_ERROR_PARAM;
+		}
+		type = (WAV_FORMAT_PCM == wav.format)? BATCH_SAMPLE_S16 : BATCH_SAMPLE_F32;
+	} else {
+		if (0 == opt->rawChannel || 0 == opt->rawSampleRate) {
+			fprintf(stderr, "%s: RAW input requires -c and -r\n", job->inPath);
+			munmap(map, st.st_size);
+			return STATUS_ERROR_PARAM;
+		}
+		if (st.st_size > UINT32_MAX) {
+			/* Output is WAV-sized as well, see wavInfo_t */
+			fprintf(stderr, "%s: RAW input of 4 GB or more not supported\n", job->inPath);
+			munmap(map, st.st_size);
+			return STATUS_ERROR_PARAM;
+		}
+		type = opt->rawSample;
+		wav.format = (BATCH_SAMPLE_S16 == type)? WAV_FORMAT_PCM : WAV_FORMAT_IEEE_FLOAT;
+		wav.bitsPerSample = (BATCH_SAMPLE_S16 == type)? 16 : 32;
+		wav.channel = opt->rawChannel;
+		wav.sampleRate = opt->rawSampleRate;
+		wav.dataOffset = 0;
+		wav.dataSize = (uint32_t) st.st_size;
+	}
+
+	samples = map + wav.dataOffset;
+	sampleSize = wav.bitsPerSample >> 3;
+	frameBytes = wav_getFrameSize(&wav);
+	nFrameTotal = wav.dataSize / frameBytes;
+	job->audioSec = (double) nFrameTotal / wav.sampleRate;
+
+	cfg = opt->cfg;
+	cfg.channel = wav.channel;
+	cfg.sampleRate = wav.sampleRate;
+	if (cfg.refMic >= cfg.channel) {
+		fprintf(stderr, "%s: reference mic %u out of range\n", job->inPath, cfg.refMic);
+		munmap(map, st.st_size);
+		return STATUS_ERROR_PARAM;
+	}
+
+	pthread_mutex_lock(&planLock);
+	status = apsigm_create(&apsigm, &cfg);
+	pthread_mutex_unlock(&planLock);
+	if (STATUS_OK != status) {
+		/* apsigm_create() has released whatever it allocated. */
+		apsigm = NULL;
+	}
+
+	inMem = (float*) malloc(sizeof(float) * cfg.channel * cfg.frameSize);
+	in = (float**) malloc(sizeof(float*) * cfg.channel);
+	out = (float*) malloc(sizeof(float) * cfg.frameSize);
+	outConv = (uint8_t*) malloc(sampleSize * (BATCH_OUT_BLOCK + cfg.frameSize));
+	if (STATUS_OK != status || NULL == inMem || NULL == in || NULL == out || NULL == outConv) {
+		status = (STATUS_OK != status)? status : STATUS_ERROR_MALLOC;
+		goto cleanup;
+	}
+	for (c = 0; c < cfg.channel; c++) {
+		in[c] = inMem + c * cfg.frameSize;
+	}
+
+	if (!opt->isDryRun) {
+		batch_getOutPath(outPath, sizeof(outPath), job->inPath, opt->outDir);
+		fOut = fopen(outPath, "wb");
+		if (NULL == fOut) {
+			fprintf(stderr, "%s: %s\n", outPath, strerror(errno));
+			status = STATUS_ERROR_FILE_OPEN;
+			goto cleanup;
+		}
+		setvbuf(fOut, NULL, _IOFBF, BATCH_OUT_STDIO_SIZE);
+		if (isWav) {
+			/* Placeholder header, rewritten with actual size once done */
+			wav.channel = 1;
+			wav.dataSize = 0;
+			if (wav_writeHeader(fOut, &wav) != STATUS_OK) {
+				status = STATUS_ERROR;
+				goto cleanup;
+			}
+		}
+	}
+
+	t0 = batch_now();
+	outFill = 0;
+	for (n = 0; n < nFrameTotal; n += cfg.frameSize) {
+		nValid = nFrameTotal - n;
+		nValid = nValid > cfg.frameSize? cfg.frameSize : nValid;
+
+		batch_deinterleave(in, samples + n * frameBytes, type, cfg.channel, cfg.frameSize, (uint32_t) nValid);
+		apsigm_process(apsigm, out, in, cfg.frameSize);
+
+		if (NULL != fOut) {
+			batch_convertOut(outConv + outFill * sampleSize, out, type, (uint32_t) nValid);
+			outFill += (uint32_t) nValid;
+			if (outFill >= BATCH_OUT_BLOCK) {
+				if (fwrite(outConv, sampleSize, outFill, fOut) != outFill) {
+					status = STATUS_ERROR;
+					goto cleanup;
+				}
+				outFill = 0;
+			}
+		}
+	}
+	if (NULL != fOut && outFill > 0 && fwrite(outConv, sampleSize, outFill, fOut) != outFill) {
+		status = STATUS_ERROR;
+		goto cleanup;
+	}
+	job->procSec = batch_now() - t0;
+
+	if (NULL != fOut && isWav) {
+		wav.dataSize = (uint32_t) (nFrameTotal * sampleSize);
+		rewind(fOut);
+		if (wav_writeHeader(fOut, &wav) != STATUS_OK) {
+			status = STATUS_ERROR;
+			goto cleanup;
+		}
+	}
+	status = STATUS_OK;
+
+cleanup:
+	if (NULL != fOut) {
+		/* Buffered samples are only written here, e.g. disk full */
+		if (fclose(fOut) != 0 && STATUS_OK == status) {
+			status = STATUS_ERROR;
+		}
+		if (STATUS_ERROR == status) {
+			fprintf(stderr, "%s: write failed, %s\n", outPath, strerror(errno));
+			remove(outPath);
+		}
+	}
+	pthread_mutex_lock(&planLock);
+	apsigm_destroy(&apsigm);
+	pthread_mutex_unlock(&planLock);
+	free(inMem);
+	free(in);
+	free(out);
+	free(outConv);
+	munmap(map, st.st_size);
+
+	return status;
+}
+
+static void* batch_worker(void *arg) {
+	batchCtx_t *ctx = (batchCtx_t*) arg;
+	batchJob_t *job;
+	uint32_t idx;
+
+	while (1) {
+		pthread_mutex_lock(&ctx->lock);
+		idx = ctx->nextJob++;
+		pthread_mutex_unlock(&ctx->lock);
+		if (idx >= ctx->nFile) {
+			break;
+		}
+
+		job = &ctx->jobs[idx];
+		job->status = batch_processFile(job, ctx->opt);
+		if (STATUS_OK == job->status) {
+			/* Realtime factor < 1 means faster than realtime. */
+			fprintf(stdout, "%s: %.2f s audio in %.3f s, RTF %.4f (%.1fx realtime)\n",
+					job->inPath, job->audioSec, job->procSec,
+					job->audioSec > 0.0? job->procSec / job->audioSec : 0.0,
+					job->procSec > 0.0? job->audioSec / job->procSec : 0.0);
+			fflush(stdout);
+		}
+	}
+
+	return NULL;
+}
+
+int main(int argc, char **argv) {
+	batchOpt_t opt;
+	batchCtx_t ctx;
+	pthread_t *threads;
+	double audioSec = 0.0, t0, wallSec;
+	uint32_t i, nFail = 0;
+	int c;
+
+	memset(&opt, 0, sizeof(opt));
+	opt.nJob = 1;
+	opt.rawSample = BATCH_SAMPLE_S16;
+	opt.cfg = APSIGM_DEFAULT_CFG;
+
+	while ((c = getopt(argc, argv, "o:j:n:g:m:i:Pc:r:t:dh")) != -1) {
+		switch (c) {
+		case 'o': opt.outDir = optarg; break;
+		case 'j': opt.nJob = (uint32_t) atoi(optarg); break;
+		case 'n': opt.cfg.frameSize = (uint32_t) atoi(optarg); break;
+		case 'g': opt.cfg.gain = (float) atof(optarg); break;
+		case 'm': opt.cfg.refMic = (uint32_t) atoi(optarg); break;
+		case 'i': opt.cfg.initDuration = (uint32_t) atoi(optarg); break;
+		case 'P': opt.cfg.wpost = 0; break;
+		case 'c': opt.rawChannel = (uint32_t) atoi(optarg); break;
+		case 'r': opt.rawSampleRate = (uint32_t) atoi(optarg); break;
+		case 't':
+			if (strcmp(optarg, "s16") == 0) {
+				opt.rawSample = BATCH_SAMPLE_S16;
+			} else if (strcmp(optarg, "f32") == 0) {
+				opt.rawSample = BATCH_SAMPLE_F32;
+			} else {
+				batch_usage(argv[0]);
+				return EXIT_FAILURE;
+			}
+			break;
+		case 'd': opt.isDryRun = 1; break;
+		default:
+			batch_usage(argv[0]);
+			return EXIT_FAILURE;
+		}
+	}
+
+	if (optind >= argc || 0 == opt.nJob || 0 == opt.cfg.frameSize) {
+		batch_usage(argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	ctx.opt = &opt;
+	ctx.nFile = argc - optind;
+	ctx.nextJob = 0;
+	ctx.jobs = (batchJob_t*) calloc(ctx.nFile, sizeof(batchJob_t));
+	if (opt.nJob > ctx.nFile) {
+		opt.nJob = ctx.nFile;
+	}
+	threads = (pthread_t*) malloc(sizeof(pthread_t) * opt.nJob);
+	if (NULL == ctx.jobs || NULL == threads) {
+		fprintf(stderr, "Out of memory\n");
+		return EXIT_FAILURE;
+	}
+	pthread_mutex_init(&ctx.lock, NULL);
+	for (i = 0; i < ctx.nFile; i++) {
+		ctx.jobs[i].inPath = argv[optind + i];
+	}
+
+	t0 = batch_now();
+	for (i = 0; i < opt.nJob; i++) {
+		pthread_create(&threads[i], NULL, batch_worker, &ctx);
+	}
+	for (i = 0; i < opt.nJob; i++) {
+		pthread_join(threads[i], NULL);
+	}
+	wallSec = batch_now() - t0;
+
+	for (i = 0; i < ctx.nFile; i++) {
+		if (STATUS_OK == ctx.jobs[i].status) {
+			audioSec += ctx.jobs[i].audioSec;
+		} else {
+			nFail++;
+		}
+	}
+	fprintf(stdout, "Total: %u file(s), %u failed, %.2f s audio in %.3f s wall (%.1fx realtime)\n",
+			ctx.nFile, nFail, audioSec, wallSec, wallSec > 0.0? audioSec / wallSec : 0.0);
+
+	pthread_mutex_destroy(&ctx.lock);
+	free(threads);
+	free(ctx.jobs);
+
+	return nFail? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,218 @@
+/*
+ * bufferbench.c
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: chiong
+ *
+ *  Timing bench of util/buffer.h on the host. The time per sample of the
+ *  channel access paths of a multi-channel buffer, generic against typed, and
+ *  of deinterleave, per channel against buffer2d_copyLayout() and the fused
+ *  int16 to float conversion, is printed. The data is checked after each run,
+ *  and a corrupted run fails the bench.
+ *
+ *  Correctness of the same paths is covered by unit_test/util/test_buffer.c.
+ *
+ *  Build (host), from repository root:
+ *  	gcc -O2 -Iinc -o bufferbench tool/bufferbench/bufferbench.c src/util/buffer.c
+ *
+ *  Example:
+ *  	bufferbench -n 1000
+ */
+
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "util/status.h"
+#include "util/buffer.h"
+
+/* Samples per channel, e.g. 8 channels of 1024 samples. */
+#define BENCH_NSAMPLE			(1024)
+#define BENCH_NCH				(8)
+#define BENCH_NREPEAT_DEFAULT	(200)
+
+static int16_t bench_data[BENCH_NSAMPLE];
+
+static double bench_elapsedNs(const struct timespec *start) {
+	struct timespec end;
+
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	return (end.tv_sec - start->tv_sec) * 1e9 + (end.tv_nsec - start->tv_nsec);
+}
+
+/**
+ * @brief Fill buffer with element (i, j) = i * 1000 + j.
+ */
+static void bench_fillIndex(buffer2d_t *pBuffer) {
+	int16_t val;
+	uint32_t i, j;
+
+	for (i = 0; i < buffer2d_getNumRow(pBuffer); i++) {
+		for (j = 0; j < buffer2d_getNumCol(pBuffer); j++) {
+			val = (int16_t) (i * 1000 + j);
+			buffer2d_putDataSingle(pBuffer, i, j, &val);
+		}
+	}
+}
+
+static uint8_t bench_checkIndex(buffer2d_t *pBuffer) {
+	int16_t val;
+	uint32_t i, j;
+
+	for (i = 0; i < buffer2d_getNumRow(pBuffer); i++) {
+		for (j = 0; j < buffer2d_getNumCol(pBuffer); j++) {
+			buffer2d_getDataSingle(pBuffer, i, j, &val);
+			if (val != (int16_t) (i * 1000 + j)) {
+				return 0;
+			}
+		}
+	}
+
+	return 1;
+}
+
+/**
+ * @brief Time the generic and typed channel put and get.
+ */
+static int32_t bench_typed(uint32_t nRepeat) {
+	const uint32_t layout[2] = { MCBUFFER_LAYOUT_INTERLEAVED, MCBUFFER_LAYOUT_NON_INTERLEAVED };
+	const char *name[2] = { "interleaved", "non-interleaved" };
+	buffer2d_t *pBuffer = NULL;
+	struct timespec start;
+	double tGeneric, tTyped, nTotal;
+	uint32_t i, k, n;
+
+	nTotal = (double) nRepeat * BENCH_NCH * BENCH_NSAMPLE;
+	for (k = 0; k < 2; k++) {
+		for (i = 0; i < BENCH_NSAMPLE; i++) {
+			bench_data[i] = (int16_t) i;
+		}
+		if (STATUS_OK != buffer2d_create(&pBuffer, BENCH_NSAMPLE, BENCH_NCH, sizeof(int16_t), layout[k])) {
+			return STATUS_ERROR_MALLOC;
+		}
+
+		clock_gettime(CLOCK_MONOTONIC, &start);
+		for (n = 0; n < nRepeat; n++) {
+			for (i = 0; i < BENCH_NCH; i++) {
+				MCBUFFER_putDataAtChannel(pBuffer, i, bench_data);
+				MCBUFFER_getDataAtChannel(pBuffer, i, bench_data);
+			}
+		}
+		tGeneric = bench_elapsedNs(&start);
+
+		clock_gettime(CLOCK_MONOTONIC, &start);
+		for (n = 0; n < nRepeat; n++) {
+			for (i = 0; i < BENCH_NCH; i++) {
+				MCBUFFER_putDataAtChannelAs(pBuffer, i, bench_data, I16);
+				MCBUFFER_getDataAtChannelAs(pBuffer, i, bench_data, I16);
+			}
+		}
+		tTyped = bench_elapsedNs(&start);
+		MCBUFFER_destroy(&pBuffer);
+
+		for (i = 0; i < BENCH_NSAMPLE; i++) {
+			if (bench_data[i] != (int16_t) i) {
+				fprintf(stderr, "Data corrupted in channel put+get, %s\n", name[k]);
+				return STATUS_ERROR;
+			}
+		}
+
+		printf("buffer2d channel put+get, %s, %u x %u int16: generic %.2f ns/sample, typed %.2f ns/sample\n",
+				name[k], BENCH_NSAMPLE, BENCH_NCH, tGeneric / nTotal, tTyped / nTotal);
+	}
+
+	return STATUS_OK;
+}
+
+/**
+ * @brief Time deinterleave per channel, by buffer2d_copyLayout() and by the
+ * 		fused conversion to float.
+ */
+static int32_t bench_layout(uint32_t nRepeat) {
+	const uint32_t nCh[] = { 2, 8, 20 };
+	buffer2d_t *pInter = NULL, *pNonInter = NULL, *pF32 = NULL;
+	struct timespec start;
+	double tCol, tCopy, tConv, nTotal;
+	int32_t status = STATUS_OK;
+	uint32_t c, i, n;
+
+	for (c = 0; c < sizeof(nCh) / sizeof(nCh[0]) && STATUS_OK == status; c++) {
+		if (STATUS_OK != buffer2d_create(&pInter, BENCH_NSAMPLE, nCh[c], sizeof(int16_t), MCBUFFER_LAYOUT_INTERLEAVED) ||
+				STATUS_OK != buffer2d_create(&pNonInter, BENCH_NSAMPLE, nCh[c], sizeof(int16_t),
+						MCBUFFER_LAYOUT_NON_INTERLEAVED) ||
+				STATUS_OK != buffer2d_create(&pF32, BENCH_NSAMPLE, nCh[c], sizeof(float),
+						MCBUFFER_LAYOUT_NON_INTERLEAVED)) {
+			status = STATUS_ERROR_MALLOC;
+			goto next;
+		}
+		bench_fillIndex(pInter);
+
+		clock_gettime(CLOCK_MONOTONIC, &start);
+		for (n = 0; n < nRepeat; n++) {
+			for (i = 0; i < nCh[c]; i++) {
+				MCBUFFER_getDataAtChannel(pInter, i, bench_data);
+				MCBUFFER_putDataAtChannel(pNonInter, i, bench_data);
+			}
+		}
+		tCol = bench_elapsedNs(&start);
+
+		clock_gettime(CLOCK_MONOTONIC, &start);
+		for (n = 0; n < nRepeat; n++) {
+			buffer2d_copyLayout(pNonInter, pInter);
+		}
+		tCopy = bench_elapsedNs(&start);
+		if (!bench_checkIndex(pNonInter)) {
+			fprintf(stderr, "Data corrupted in deinterleave, %u channels\n", nCh[c]);
+			status = STATUS_ERROR;
+			goto next;
+		}
+
+		clock_gettime(CLOCK_MONOTONIC, &start);
+		for (n = 0; n < nRepeat; n++) {
+			buffer2d_convertI16ToF32(pF32, pInter, 1.0f / 32768);
+		}
+		tConv = bench_elapsedNs(&start);
+
+		nTotal = (double) nRepeat * BENCH_NSAMPLE * nCh[c];
+		printf("mcbuffer deinterleave, %u x %u int16: per channel %.2f, copyLayout %.2f, to float %.2f ns/sample\n",
+				BENCH_NSAMPLE, nCh[c], tCol / nTotal, tCopy / nTotal, tConv / nTotal);
+
+next:
+		MCBUFFER_destroy(&pInter);
+		MCBUFFER_destroy(&pNonInter);
+		MCBUFFER_destroy(&pF32);
+	}
+
+	return status;
+}
+
+static void bench_usage(const char *prog) {
+	fprintf(stderr, "Usage: %s [-n repeat]\n", prog);
+	fprintf(stderr, "  -n repeat  Number of runs over the buffers timed (default %u)\n", BENCH_NREPEAT_DEFAULT);
+}
+
+int main(int argc, char **argv) {
+	uint32_t nRepeat = BENCH_NREPEAT_DEFAULT;
+	int c;
+
+	while ((c = getopt(argc, argv, "n:h")) != -1) {
+		switch (c) {
+		case 'n':
+			nRepeat = (uint32_t) strtoul(optarg, NULL, 0);
+			if (0 == nRepeat) {
+				bench_usage(argv[0]);
+				return EXIT_FAILURE;
+			}
+			break;
+		default:
+			bench_usage(argv[0]);
+			return EXIT_FAILURE;
+		}
+	}
+
+	if (STATUS_OK != bench_typed(nRepeat) || STATUS_OK != bench_layout(nRepeat)) {
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
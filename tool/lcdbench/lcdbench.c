@@ -0,0 +1,381 @@
+/*
+ * lcdbench.c
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: chiong
+ *
+ *  Bus traffic and rendering regression bench for st7735-lcd on the host. Each
+ *  primitive is drawn on a virtual panel, see module/st7735-lcd/st7735sim.h, from
+ *  a black screen, and the SPI transfers, bytes, commands, address windows,
+ *  pixels and DCX changes it takes are printed, with the bus time at the given
+ *  SPI clock and a hash of the resulting screen.
+ *
+ *  Screens are written as PPM images with -o, one per primitive named after it
+ *  and upright in the orientation of drawing, and compared with those of a
+ *  reference run with -r, e.g. before and after a change of the drivers. Any
+ *  difference is reported and fails the run.
+ *
+ *  Build (host), from repository root:
+ *  	gcc -O2 -Iinc -o lcdbench tool/lcdbench/lcdbench.c src/module/st7735-lcd/st7735.c \
+ *  		src/module/st7735-lcd/st7735sim.c src/module/st7735-lcd/lcd.c \
+ *  		src/module/st7735-lcd/chart.c src/module/st7735-lcd/glcdfont.c \
+ *  		src/hw/sim/spi_sim.c src/hw/sim/gpio_sim.c \
+ *  		src/util/bitmap.c src/util/sprite.c src/util/file.c src/util/buffer.c -lm
+ *
+ *  Example:
+ *  	lcdbench -f 16 -o ref
+ *  	lcdbench -f 16 -b -r ref
+ *
+ *  Screen hashes of the drivers as they are live in tool/lcdbench/ref.txt, one
+ *  line per primitive and set of options, e.g. f16-b-l for -f 16 -b -l. All of
+ *  them are checked, or written after an intended change, by
+ *  script/lcdbench_check.sh, which writes the images of a set that differs.
+ */
+
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "util/status.h"
+#include "module/st7735-lcd/st7735.h"
+#include "module/st7735-lcd/lcd.h"
+#include "module/st7735-lcd/chart.h"
+#include "module/st7735-lcd/st7735sim.h"
+
+/* Bus and pins of virtual panel. */
+#define BENCH_SPI_IDX			(0)
+#define BENCH_CS				(0)
+#define BENCH_DCX_PIN			(25)
+/* Maximum length of path of image. */
+#define BENCH_PATH_MAX			(512)
+
+typedef struct {
+	const char *name;
+	void (*draw)(lcd_t *lcd);
+} benchScene_t;
+
+typedef struct {
+	/* Directory to write images to, NULL for none. */
+	const char *outDir;
+	/* Directory of reference images, NULL for none. */
+	const char *refDir;
+	/* SPI clock, in Hz. */
+	uint32_t clock;
+	st7735_color_t fmt;
+	uint8_t orient;
+	uint8_t isFrameBuffer;
+} benchOpt_t;
+
+static void bench_fillScreen(lcd_t *lcd) {
+	LCD_fillScreen(lcd, 0x2060A0);
+}
+
+static void bench_fillRect(lcd_t *lcd) {
+	lcd_fillRect(lcd, 10, 20, 60, 40, 0xFF8000);
+}
+
+static void bench_drawRect(lcd_t *lcd) {
+	lcd_drawRect(lcd, 10, 20, 60, 40, 0x00FF00);
+}
+
+static void bench_pixels(lcd_t *lcd) {
+	uint16_t i;
+
+	for (i = 0; i < 100; i++) {
+		lcd_drawPixel(lcd, (i * 37) % lcd->width, (i * 53) % lcd->height, 0xFFFFFF);
+	}
+}
+
+static void bench_lines(lcd_t *lcd) {
+	uint16_t i;
+
+	for (i = 0; i < 8; i++) {
+		lcd_drawLine(lcd, lcd->width / 2, lcd->height / 2, i * (lcd->width - 1) / 7, (i & 1)? lcd->height - 1 : 0,
+				0xFFFF00);
+	}
+}
+
+static void bench_linesAA(lcd_t *lcd) {
+	uint16_t i;
+
+	for (i = 0; i < 8; i++) {
+		lcd_drawLineAA(lcd, lcd->width / 2, lcd->height / 2, i * (lcd->width - 1) / 7, (i & 1)? lcd->height - 1 : 0,
+				0xFFFF00);
+	}
+}
+
+static void bench_thickLine(lcd_t *lcd) {
+	lcd_drawThickLine(lcd, 10, 10, lcd->width - 10, lcd->height - 30, 5, 0x00FFFF);
+}
+
+static void bench_circle(lcd_t *lcd) {
+	lcd_drawCircle(lcd, lcd->width / 2, lcd->height / 2, 40, 0xFF00FF);
+}
+
+static void bench_circleAA(lcd_t *lcd) {
+	lcd_drawCircleAA(lcd, lcd->width / 2, lcd->height / 2, 40, 0xFF00FF);
+}
+
+static void bench_fillCircle(lcd_t *lcd) {
+	lcd_fillCircle(lcd, lcd->width / 2, lcd->height / 2, 40, 0xFF00FF);
+}
+
+static void bench_fillTriangle(lcd_t *lcd) {
+	lcd_fillTriangle(lcd, 5, 5, lcd->width - 5, 30, 40, lcd->height - 5, 0x8080FF);
+}
+
+static void bench_fillRoundRect(lcd_t *lcd) {
+	lcd_fillRoundRect(lcd, 10, 20, 90, 60, 12, 0x80FF80);
+}
+
+static void bench_textOpaque(lcd_t *lcd) {
+	char str[] = "Hello, ST7735!\n0123456789";
+
+	lcd_setTextStroke(lcd, 0xFFFFFF, 0x0000FF, 1, 1);
+	LCD_write(lcd, 2, 2, str);
+}
+
+static void bench_textTransparent(lcd_t *lcd) {
+	char str[] = "Hello, ST7735!\n0123456789";
+
+	lcd_setTextStroke(lcd, 0xFFFFFF, 0x000000, 0, 2);
+	LCD_write(lcd, 2, 2, str);
+}
+
+static void bench_bitmap(lcd_t *lcd) {
+	static uint32_t color[48 * 32];
+	uint32_t x, y;
+
+	for (y = 0; y < 32; y++) {
+		for (x = 0; x < 48; x++) {
+			color[y * 48 + x] = ((x * 5) << 16) | ((y * 8) << 8) | ((x + y) * 3);
+		}
+	}
+	lcd_drawBitmap(lcd, 7, 9, 48, 32, color);
+}
+
+/**
+ * @brief Fill lines of scroll area, i.e. rows in portrait and columns in landscape.
+ */
+static void bench_fillLines(lcd_t *lcd, uint16_t line, uint16_t n, uint32_t color) {
+	if (lcd->width > lcd->height) {
+		lcd_fillRect(lcd, line, 0, n, lcd->height, color);
+	} else {
+		lcd_fillRect(lcd, 0, line, lcd->width, n, color);
+	}
+}
+
+static void bench_scroll(lcd_t *lcd) {
+	uint16_t i;
+
+	/* Bands of 8 lines, then the 20 lines scrolled back in at the end redrawn */
+	lcd_setScrollArea(lcd, 16, 96);
+	for (i = 0; i < 96; i += 8) {
+		bench_fillLines(lcd, lcd_getScrollLine(lcd, i), 8, ((i * 2) << 16) | 0x4000 | (255 - i * 2));
+	}
+	lcd_scroll(lcd, 20);
+	for (i = 76; i < 96; i++) {
+		bench_fillLines(lcd, lcd_getScrollLine(lcd, i), 1, (i & 1)? 0xFFFF00 : 0x808000);
+	}
+}
+
+static void bench_chart(lcd_t *lcd) {
+	chart_t chart;
+	uint16_t i;
+
+	/* Sawtooth wrapping round the chart, clipped at both edges */
+	chart_init(&chart, lcd, 20, 100, -1.0f, 1.0f, 0x00FF00, 0x000040);
+	for (i = 0; i < 150; i++) {
+		chart_push(&chart, (i * 7 % 50) / 20.0f - 1.2f);
+	}
+}
+
+static void bench_partial(lcd_t *lcd) {
+	LCD_fillScreen(lcd, 0x2060A0);
+	lcd_setPartialArea(lcd, 30, 60);
+}
+
+static const benchScene_t benchScene[] = {
+	{"fill_screen", bench_fillScreen},
+	{"fill_rect", bench_fillRect},
+	{"draw_rect", bench_drawRect},
+	{"pixels", bench_pixels},
+	{"lines", bench_lines},
+	{"lines_aa", bench_linesAA},
+	{"thick_line", bench_thickLine},
+	{"circle", bench_circle},
+	{"circle_aa", bench_circleAA},
+	{"fill_circle", bench_fillCircle},
+	{"fill_triangle", bench_fillTriangle},
+	{"fill_round_rect", bench_fillRoundRect},
+	{"text_opaque", bench_textOpaque},
+	{"text_transparent", bench_textTransparent},
+	{"bitmap", bench_bitmap},
+	{"scroll", bench_scroll},
+	{"chart", bench_chart},
+	{"partial", bench_partial},
+};
+
+static void bench_usage(const char *prog) {
+	fprintf(stderr,
+		"Usage: %s [options]\n"
+		"  -f bits   Panel color format, 12, 16 or 18 (default 16)\n"
+		"  -b        Draw in frame buffer, see lcd_enableFrameBuffer()\n"
+		"  -l        Landscape orientation\n"
+		"  -c MHz    SPI clock for bus time (default 16)\n"
+		"  -o dir    Write screen of each primitive as <dir>/<name>.ppm\n"
+		"  -r dir    Compare screens with <dir>/<name>.ppm\n",
+		prog);
+}
+
+/**
+ * @brief Compare the screen with a PPM image written by st7735sim_writePpm().
+ * @return Number of pixels different, -1 if the image cannot be read.
+ */
+static int32_t bench_compare(const st7735sim_t *sim, uint8_t orient, const char *path) {
+	unsigned int width, height, maxValue;
+	uint8_t rgb[3];
+	uint32_t color;
+	int32_t nDiff = 0;
+	uint16_t x, y;
+	FILE *f;
+
+	f = fopen(path, "rb");
+	if (NULL == f) {
+		return -1;
+	}
+	if (fscanf(f, "P6 %u %u %u", &width, &height, &maxValue) != 3 || fgetc(f) == EOF ||
+		width != ST7735SIM_getWidth(orient) || height != ST7735SIM_getHeight(orient) || maxValue != 255) {
+		fclose(f);
+		return -1;
+	}
+
+	for (y = 0; y < height; y++) {
+		for (x = 0; x < width; x++) {
+			if (fread(rgb, 1, 3, f) != 3) {
+				fclose(f);
+				return -1;
+			}
+			color = st7735sim_getPixel(sim, orient, x, y);
+			if (color != (((uint32_t) rgb[0] << 16) | (rgb[1] << 8) | rgb[2])) {
+				nDiff++;
+			}
+		}
+	}
+
+	fclose(f);
+	return nDiff;
+}
+
+int main(int argc, char **argv) {
+	static st7735sim_t sim;
+	const st7735simStat_t *stat = &sim.stat;
+	char path[BENCH_PATH_MAX];
+	benchOpt_t opt;
+	st7735Cfg_t cfg;
+	st7735_t *st7735;
+	lcd_t *lcd;
+	uint32_t nFail = 0;
+	uint32_t i;
+	int32_t nDiff;
+	int c;
+
+	memset(&opt, 0, sizeof(opt));
+	opt.clock = 16000000;
+	opt.fmt = ST7735_PANEL_COLOR_16_BIT;
+	opt.orient = LCD_ORIENT_PORTRAIT_NORMAL;
+
+	while ((c = getopt(argc, argv, "f:blc:o:r:h")) != -1) {
+		switch (c) {
+		case 'b': opt.isFrameBuffer = 1; break;
+		case 'l': opt.orient = LCD_ORIENT_LANDSCAPE_NORMAL; break;
+		case 'o': opt.outDir = optarg; break;
+		case 'r': opt.refDir = optarg; break;
+		case 'c':
+			opt.clock = (uint32_t) (atof(optarg) * 1e6);
+			if (0 == opt.clock) {
+				bench_usage(argv[0]);
+				return EXIT_FAILURE;
+			}
+			break;
+		case 'f':
+			if (strcmp(optarg, "12") == 0) {
+				opt.fmt = ST7735_PANEL_COLOR_12_BIT;
+			} else if (strcmp(optarg, "16") == 0) {
+				opt.fmt = ST7735_PANEL_COLOR_16_BIT;
+			} else if (strcmp(optarg, "18") == 0) {
+				opt.fmt = ST7735_PANEL_COLOR_18_BIT;
+			} else {
+				bench_usage(argv[0]);
+				return EXIT_FAILURE;
+			}
+			break;
+		default:
+			bench_usage(argv[0]);
+			return EXIT_FAILURE;
+		}
+	}
+
+	memset(&cfg, 0, sizeof(cfg));
+	cfg.model = ST7735_MODEL_B;
+	cfg.spiIdx = BENCH_SPI_IDX;
+	cfg.csPin = BENCH_CS;
+	cfg.dcxPin = BENCH_DCX_PIN;
+	cfg.delayMs = NULL;
+	cfg.colorFmt = opt.fmt;
+	if (st7735sim_init(&sim, BENCH_SPI_IDX, BENCH_CS, BENCH_DCX_PIN) != STATUS_OK ||
+		st7735_create(&st7735, &cfg) != ST7735_STATUS_OK ||
+		lcd_create(&lcd, st7735) != STATUS_OK) {
+		fprintf(stderr, "Failed to set up virtual panel\n");
+		return EXIT_FAILURE;
+	}
+	lcd_setOrientation(lcd, opt.orient);
+	if (opt.isFrameBuffer && lcd_enableFrameBuffer(lcd) != STATUS_OK) {
+		fprintf(stderr, "Failed to enable frame buffer\n");
+		return EXIT_FAILURE;
+	}
+
+	fprintf(stdout, "%-18s %9s %9s %7s %7s %8s %6s %9s %8s\n", "primitive", "transfer", "byte", "command",
+			"window", "pixel", "dcx", "bus(us)", "hash");
+	for (i = 0; i < sizeof(benchScene) / sizeof(benchScene[0]); i++) {
+		LCD_fillScreen(lcd, 0x000000);
+		lcd_flush(lcd);
+
+		st7735sim_resetStat(&sim);
+		benchScene[i].draw(lcd);
+		lcd_flush(lcd);
+
+		fprintf(stdout, "%-18s %9u %9u %7u %7u %8u %6u %9.1f %08X\n", benchScene[i].name, stat->nTransfer,
+				stat->nByte, stat->nCommand, stat->nWindow, stat->nPixel, stat->nDcToggle,
+				stat->nByte * 8e6 / opt.clock, st7735sim_getHash(&sim));
+
+		if (NULL != opt.outDir) {
+			snprintf(path, sizeof(path), "%s/%s.ppm", opt.outDir, benchScene[i].name);
+			if (st7735sim_writePpm(&sim, opt.orient, path) != STATUS_OK) {
+				fprintf(stderr, "%s: write failed\n", path);
+				nFail++;
+			}
+		}
+		if (NULL != opt.refDir) {
+			snprintf(path, sizeof(path), "%s/%s.ppm", opt.refDir, benchScene[i].name);
+			nDiff = bench_compare(&sim, opt.orient, path);
+			if (nDiff != 0) {
+				if (nDiff < 0) {
+					fprintf(stderr, "%s: cannot read reference\n", path);
+				} else {
+					fprintf(stderr, "%s: %d pixel(s) differ\n", benchScene[i].name, nDiff);
+				}
+				nFail++;
+			}
+		}
+
+		/* Back to normal display for the next scene */
+		lcd_setScrollArea(lcd, 0, 0);
+		lcd_setPartialArea(lcd, 0, 0);
+	}
+
+	lcd_destroy(&lcd);
+	st7735_destroy(&st7735);
+	st7735sim_deinit(&sim);
+	return nFail > 0? EXIT_FAILURE : EXIT_SUCCESS;
+}
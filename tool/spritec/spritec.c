@@ -0,0 +1,291 @@
+/*
+ * spritec.c
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: chiong
+ *
+ *  Offline sprite sheet compiler. BMP files, in any format supported by
+ *  bitmap_readerOpen(), are converted into a single sprite sheet in the wire
+ *  pixel format of the ST7735 panel, see util/sprite.h, so that icons are drawn
+ *  with lcd_drawSprite() without any parsing or color conversion at runtime.
+ *
+ *  Each sprite is encoded as RAW, RLE or PALETTE, by default whichever is the
+ *  smallest. Sprites are indexed in the order of the input files.
+ *
+ *  The sheet is written as a binary file, to be mapped with file_mapOpen(), and
+ *  with -c also as a C source with a const array and one index macro per sprite
+ *  named after the input file, e.g. icon/wifi-on.bmp gives <NAME>_WIFI_ON.
+ *
+ *  Build (host), from repository root:
+ *  	gcc -O2 -Iinc -o spritec tool/spritec/spritec.c src/util/bitmap.c src/util/sprite.c
+ *
+ *  Example:
+ *  	spritec -f 16 -o icons.bin -c icons.c -n icons icon/ok.bmp icon/wifi.bmp
+ */
+
+#include <ctype.h>
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "util/status.h"
+#include "util/bitmap.h"
+#include "util/sprite.h"
+
+/* Encoding option to pick the smallest encoding per sprite. */
+#define SPRITEC_ENC_AUTO		(0xFF)
+/* Number of bytes per line of C array. */
+#define SPRITEC_C_LINE_SIZE		(16)
+
+typedef struct {
+	const char *outPath;
+	/* Path of C source, NULL for binary only. */
+	const char *cPath;
+	/* Name of array and prefix of macros in C source. */
+	const char *name;
+	/* BITMAP_PIXEL_FMT_RGB444, RGB565 or RGB666. */
+	uint8_t fmt;
+	/* SPRITE_ENC_* or SPRITEC_ENC_AUTO. */
+	uint8_t encoding;
+} spritecOpt_t;
+
+static const char *spritecEncName[] = {"raw", "rle", "palette"};
+
+static void spritec_usage(const char *prog) {
+	fprintf(stderr,
+		"Usage: %s [options] -o sheet.bin file.bmp [file.bmp ...]\n"
+		"  -o path   Output sprite sheet\n"
+		"  -f bits   Panel color format, 12, 16 or 18 (default 16)\n"
+		"  -e enc    Encoding, auto (default), raw, rle or palette\n"
+		"  -c path   Also write sheet as C source\n"
+		"  -n name   Array name and macro prefix in C source (default sprite)\n",
+		prog);
+}
+
+/**
+ * @brief Read a BMP and encode it into a newly allocated buffer.
+ * @return Encoded data, NULL on error.
+ */
+static uint8_t* spritec_encodeFile(const char *path, const spritecOpt_t *opt, spriteEntry_t *entry) {
+	bitmap_t *pBitmap;
+	spriteEntry_t trial;
+	uint8_t *data;
+	uint32_t count;
+	int32_t size, best;
+	uint8_t enc;
+
+	if (bitmap_readFile(&pBitmap, path) != STATUS_OK) {
+		fprintf(stderr, "%s: not a supported BMP\n", path);
+		return NULL;
+	}
+	/* bitmap_readFile() caps dimensions well within 16 bits */
+	memset(entry, 0, sizeof(spriteEntry_t));
+	entry->width = (uint16_t) pBitmap->imageHeader.width;
+	entry->height = (uint16_t) pBitmap->imageHeader.height;
+	count = (uint32_t) entry->width * entry->height;
+
+	/* Size of every encoding without writing, PALETTE fails beyond 256 colors */
+	best = -1;
+	for (enc = SPRITE_ENC_RAW; enc <= SPRITE_ENC_PALETTE; enc++) {
+		if (SPRITEC_ENC_AUTO != opt->encoding && enc != opt->encoding) {
+			continue;
+		}
+		memset(&trial, 0, sizeof(trial));
+		trial.encoding = enc;
+		size = sprite_encode(NULL, 0, pBitmap->image, count, opt->fmt, &trial);
+		if (size >= 0 && (best < 0 || size < best)) {
+			best = size;
+			entry->encoding = enc;
+		}
+	}
+	if (best < 0) {
+		fprintf(stderr, "%s: more than %u colors for palette\n", path, SPRITE_PALETTE_MAX);
+		bitmap_destroy(&pBitmap);
+		return NULL;
+	}
+
+	data = (uint8_t*) malloc(best > 0? best : 1);
+	if (NULL == data ||
+		sprite_encode(data, (uint32_t) best, pBitmap->image, count, opt->fmt, entry) != best) {
+		fprintf(stderr, "%s: failed to encode\n", path);
+		free(data);
+		bitmap_destroy(&pBitmap);
+		return NULL;
+	}
+	entry->size = (uint32_t) best;
+
+	fprintf(stdout, "%-24s %4u x %-4u %-8s %7u bytes (%.1f%% of raw)\n", path,
+			entry->width, entry->height, spritecEncName[entry->encoding], entry->size,
+			count > 0? 100.0 * entry->size / BITMAP_getPackedSize(opt->fmt, count) : 100.0);
+	bitmap_destroy(&pBitmap);
+	return data;
+}
+
+/**
+ * @brief Write macro name for a sprite, i.e. <NAME>_<BASENAME> in upper case
+ * 		with anything but letters and digits replaced by '_'.
+ */
+static void spritec_writeMacro(FILE *f, const char *name, const char *path) {
+	const char *base;
+	const char *ext;
+
+	base = strrchr(path, '/');
+	base = NULL != base? base + 1 : path;
+	ext = strrchr(base, '.');
+	if (NULL == ext) {
+		ext = base + strlen(base);
+	}
+
+	for (; *name != '\0'; name++) {
+		fputc(isalnum((unsigned char) *name)? toupper((unsigned char) *name) : '_', f);
+	}
+	fputc('_', f);
+	for (; base < ext; base++) {
+		fputc(isalnum((unsigned char) *base)? toupper((unsigned char) *base) : '_', f);
+	}
+}
+
+static int32_t spritec_writeC(const spritecOpt_t *opt, const uint8_t *sheet, uint32_t size,
+		char **paths, uint32_t nSprite) {
+	FILE *f;
+	uint32_t i;
+
+	f = fopen(opt->cPath, "w");
+	if (NULL == f) {
+		fprintf(stderr, "%s: cannot create\n", opt->cPath);
+		return STATUS_ERROR_FILE_OPEN;
+	}
+
+	fprintf(f, "/*\n * Sprite sheet generated by spritec, do not edit.\n"
+			" * Use with sprite_sheetInit(&sheet, %s, sizeof(%s)).\n */\n\n", opt->name, opt->name);
+	fprintf(f, "#include <stdint.h>\n\n");
+	for (i = 0; i < nSprite; i++) {
+		fprintf(f, "#define ");
+		spritec_writeMacro(f, opt->name, paths[i]);
+		fprintf(f, "\t(%u)\n", i);
+	}
+	fprintf(f, "\nconst uint8_t %s[%u] __attribute__((aligned(4))) = {", opt->name, size);
+	for (i = 0; i < size; i++) {
+		if (i % SPRITEC_C_LINE_SIZE == 0) {
+			fprintf(f, "\n\t");
+		}
+		fprintf(f, "0x%02X,%s", sheet[i], (i + 1) % SPRITEC_C_LINE_SIZE == 0? "" : " ");
+	}
+	fprintf(f, "\n};\n");
+
+	if (fclose(f) != 0) {
+		fprintf(stderr, "%s: write failed\n", opt->cPath);
+		return STATUS_ERROR;
+	}
+	return STATUS_OK;
+}
+
+int main(int argc, char **argv) {
+	spritecOpt_t opt;
+	spriteSheetHeader_t *header;
+	spriteEntry_t *entry;
+	uint8_t **data;
+	uint8_t *sheet;
+	uint32_t nSprite, size, offset;
+	uint32_t i;
+	FILE *f;
+	int c;
+
+	memset(&opt, 0, sizeof(opt));
+	opt.fmt = BITMAP_PIXEL_FMT_RGB565;
+	opt.encoding = SPRITEC_ENC_AUTO;
+	opt.name = "sprite";
+
+	while ((c = getopt(argc, argv, "o:f:e:c:n:h")) != -1) {
+		switch (c) {
+		case 'o': opt.outPath = optarg; break;
+		case 'c': opt.cPath = optarg; break;
+		case 'n': opt.name = optarg; break;
+		case 'f':
+			if (strcmp(optarg, "12") == 0) {
+				opt.fmt = BITMAP_PIXEL_FMT_RGB444;
+			} else if (strcmp(optarg, "16") == 0) {
+				opt.fmt = BITMAP_PIXEL_FMT_RGB565;
+			} else if (strcmp(optarg, "18") == 0) {
+				opt.fmt = BITMAP_PIXEL_FMT_RGB666;
+			} else {
+				spritec_usage(argv[0]);
+				return EXIT_FAILURE;
+			}
+			break;
+		case 'e':
+			if (strcmp(optarg, "auto") == 0) {
+				opt.encoding = SPRITEC_ENC_AUTO;
+			} else if (strcmp(optarg, "raw") == 0) {
+				opt.encoding = SPRITE_ENC_RAW;
+			} else if (strcmp(optarg, "rle") == 0) {
+				opt.encoding = SPRITE_ENC_RLE;
+			} else if (strcmp(optarg, "palette") == 0) {
+				opt.encoding = SPRITE_ENC_PALETTE;
+			} else {
+				spritec_usage(argv[0]);
+				return EXIT_FAILURE;
+			}
+			break;
+		default:
+			spritec_usage(argv[0]);
+			return EXIT_FAILURE;
+		}
+	}
+
+	nSprite = argc - optind;
+	if (NULL == opt.outPath || 0 == nSprite || nSprite > 0xFFFF) {
+		spritec_usage(argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	entry = (spriteEntry_t*) calloc(nSprite, sizeof(spriteEntry_t));
+	data = (uint8_t**) calloc(nSprite, sizeof(uint8_t*));
+	if (NULL == entry || NULL == data) {
+		fprintf(stderr, "Out of memory\n");
+		return EXIT_FAILURE;
+	}
+
+	/* Data of each sprite starts 4-byte aligned */
+	offset = sizeof(spriteSheetHeader_t) + nSprite * sizeof(spriteEntry_t);
+	for (i = 0; i < nSprite; i++) {
+		data[i] = spritec_encodeFile(argv[optind + i], &opt, &entry[i]);
+		if (NULL == data[i]) {
+			return EXIT_FAILURE;
+		}
+		entry[i].offset = offset;
+		offset += (entry[i].size + 3) & ~3u;
+	}
+	size = offset;
+
+	sheet = (uint8_t*) calloc(1, size);
+	if (NULL == sheet) {
+		fprintf(stderr, "Out of memory\n");
+		return EXIT_FAILURE;
+	}
+	header = (spriteSheetHeader_t*) sheet;
+	memcpy(header->magic, SPRITE_MAGIC, sizeof(header->magic));
+	header->version = SPRITE_VERSION;
+	header->nSprite = (uint16_t) nSprite;
+	header->fmt = opt.fmt;
+	memcpy(header + 1, entry, nSprite * sizeof(spriteEntry_t));
+	for (i = 0; i < nSprite; i++) {
+		memcpy(sheet + entry[i].offset, data[i], entry[i].size);
+		free(data[i]);
+	}
+
+	f = fopen(opt.outPath, "wb");
+	if (NULL == f || fwrite(sheet, 1, size, f) != size || fclose(f) != 0) {
+		fprintf(stderr, "%s: write failed\n", opt.outPath);
+		return EXIT_FAILURE;
+	}
+	if (NULL != opt.cPath && spritec_writeC(&opt, sheet, size, argv + optind, nSprite) != STATUS_OK) {
+		return EXIT_FAILURE;
+	}
+	fprintf(stdout, "Sheet: %u sprite(s), %u bytes\n", nSprite, size);
+
+	free(sheet);
+	free(data);
+	free(entry);
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,143 @@
+/*
+ * test_chart.c
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: chiong
+ */
+
+#include <math.h>
+#include <string.h>
+#include "module/st7735-lcd/st7735.h"
+#include "module/st7735-lcd/lcd.h"
+#include "module/st7735-lcd/chart.h"
+#include "module/st7735-lcd/st7735sim.h"
+#include "debug/assert.h"
+#include "test_chart.h"
+
+/* Bus and pins of virtual panel. */
+#define TEST_CHART_SPI_IDX		(0)
+#define TEST_CHART_CS			(0)
+#define TEST_CHART_DCX_PIN		(25)
+/* Lines of chart, and values pushed, i.e. scrolled around once and more. */
+#define TEST_CHART_START		(16)
+#define TEST_CHART_LEN			(96)
+#define TEST_CHART_NVALUE		(TEST_CHART_LEN + 37)
+/* Width of panel across chart in either orientation, so that value is level. */
+#define TEST_CHART_EXTENT		(ST7735_WIDTH)
+
+static st7735sim_t test_chartSim;
+
+/**
+ * @brief Get value k pushed, the last ones beyond min and max and NaN.
+ */
+static float test_chartValue(uint32_t k) {
+	switch (TEST_CHART_NVALUE - 1 - k) {
+	case 2:
+		return -5.0f;
+	case 1:
+		return INFINITY;
+	case 0:
+		return NAN;
+	default:
+		return (float) ((k * 37) % TEST_CHART_EXTENT);
+	}
+}
+
+/**
+ * @brief Get the level value k is drawn at.
+ */
+static uint16_t test_chartLevel(uint32_t k) {
+	float value = test_chartValue(k);
+
+	if (isnan(value) || value < 0.0f) {
+		return 0;
+	}
+	return (value > TEST_CHART_EXTENT - 1)? TEST_CHART_EXTENT - 1 : (uint16_t) value;
+}
+
+/**
+ * @brief Check the lines shown, the newest value last.
+ */
+static void test_chartCheck(const lcd_t *lcd) {
+	uint32_t pos, k, i;
+	uint16_t lo, hi, level;
+	uint32_t color, expected;
+
+	for (pos = 0; pos < TEST_CHART_LEN; pos++) {
+		k = TEST_CHART_NVALUE - TEST_CHART_LEN + pos;
+		lo = test_chartLevel(k - 1) < test_chartLevel(k)? test_chartLevel(k - 1) : test_chartLevel(k);
+		hi = test_chartLevel(k - 1) > test_chartLevel(k)? test_chartLevel(k - 1) : test_chartLevel(k);
+		for (i = 0; i < TEST_CHART_EXTENT; i++) {
+			/* Values upward in landscape, to the right in portrait */
+			if (lcd->width > lcd->height) {
+				level = TEST_CHART_EXTENT - 1 - i;
+				color = st7735sim_getPixel(&test_chartSim, lcd->orientation, TEST_CHART_START + pos, i);
+			} else {
+				level = i;
+				color = st7735sim_getPixel(&test_chartSim, lcd->orientation, i, TEST_CHART_START + pos);
+			}
+			expected = (level >= lo && level <= hi)? LCD_COLOR_YELLOW : LCD_COLOR_BLUE;
+			ASSERT(color == expected, "Incorrect line of chart.");
+		}
+	}
+}
+
+void test_chartAll(void) {
+	test_chartPush();
+}
+
+void test_chartPush(void) {
+	const uint8_t orient[] = {LCD_ORIENT_PORTRAIT_NORMAL, LCD_ORIENT_LANDSCAPE_NORMAL};
+	chart_t chart;
+	st7735Cfg_t cfg;
+	st7735_t *st7735 = NULL;
+	lcd_t *lcd = NULL;
+	uint16_t scrollStart;
+	uint32_t o, isFrameBuffer, k;
+
+	for (o = 0; o < sizeof(orient) / sizeof(orient[0]); o++) {
+		for (isFrameBuffer = 0; isFrameBuffer < 2; isFrameBuffer++) {
+			memset(&cfg, 0, sizeof(cfg));
+			cfg.model = ST7735_MODEL_B;
+			cfg.spiIdx = TEST_CHART_SPI_IDX;
+			cfg.csPin = TEST_CHART_CS;
+			cfg.dcxPin = TEST_CHART_DCX_PIN;
+			cfg.colorFmt = ST7735_PANEL_COLOR_16_BIT;
+			ASSERT(st7735sim_init(&test_chartSim, TEST_CHART_SPI_IDX, TEST_CHART_CS, TEST_CHART_DCX_PIN) == STATUS_OK,
+					"Virtual panel not set up.");
+			ASSERT(st7735_create(&st7735, &cfg) == ST7735_STATUS_OK, "Driver not created.");
+			ASSERT(lcd_create(&lcd, st7735) == STATUS_OK, "LCD not created.");
+			lcd_setOrientation(lcd, orient[o]);
+			if (isFrameBuffer) {
+				ASSERT(lcd_enableFrameBuffer(lcd) == STATUS_OK, "Frame buffer not enabled.");
+			}
+
+			ASSERT(chart_init(&chart, lcd, TEST_CHART_START, TEST_CHART_LEN, 0.0f, TEST_CHART_EXTENT - 1,
+					LCD_COLOR_YELLOW, LCD_COLOR_BLUE) == STATUS_OK, "Chart not set up.");
+			lcd_flush(lcd);
+			for (k = 0; k < TEST_CHART_NVALUE; k++) {
+				scrollStart = test_chartSim.scrollStart;
+				ASSERT(chart_push(&chart, test_chartValue(k)) == STATUS_OK, "Value not pushed.");
+				if (isFrameBuffer) {
+					ASSERT(test_chartSim.scrollStart == scrollStart, "Scroll sent before flush.");
+					/* A few values at a time */
+					if (k % 5 == 4) {
+						lcd_flush(lcd);
+					}
+				} else {
+					ASSERT(test_chartSim.scrollStart != scrollStart, "Scroll not sent with value.");
+				}
+			}
+			lcd_flush(lcd);
+			test_chartCheck(lcd);
+
+			lcd_setScrollArea(lcd, 0, TEST_CHART_LEN);
+			ASSERT(chart_push(&chart, 0.0f) == STATUS_ERROR, "Value pushed to changed scroll area.");
+			lcd_setScrollArea(lcd, 0, 0);
+
+			lcd_destroy(&lcd);
+			st7735_destroy(&st7735);
+			st7735sim_deinit(&test_chartSim);
+		}
+	}
+}
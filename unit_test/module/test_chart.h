@@ -0,0 +1,31 @@
+/*
+ * test_chart.h
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: chiong
+ *
+ *  Runs against the virtual panel of module/st7735-lcd/st7735sim.h, so it is
+ *  built with src/hw/sim in place of the target backend.
+ */
+
+#ifndef TEST_TEST_CHART_H_
+#define TEST_TEST_CHART_H_
+
+/**
+ * @details Test all
+ */
+void test_chartAll(void);
+
+/**
+ * @details Test includes:
+ * 		1. Values pushed past the length of chart are shown scrolled, the newest
+ * 		   last, each line joined to the previous value, in portrait and
+ * 		   landscape, with and without frame buffer.
+ * 		2. The scroll is sent with each value, or with lcd_flush() in frame
+ * 		   buffer mode.
+ * 		3. Values beyond min and max are clipped, NaN is drawn as min.
+ * 		4. chart_push() fails once the scroll area has been changed.
+ */
+void test_chartPush(void);
+
+#endif /* TEST_TEST_CHART_H_ */
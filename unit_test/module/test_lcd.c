@@ -0,0 +1,158 @@
+/*
+ * test_lcd.c
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: chiong
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "module/st7735-lcd/st7735.h"
+#include "module/st7735-lcd/lcd.h"
+#include "module/st7735-lcd/st7735sim.h"
+#include "util/sprite.h"
+#include "debug/assert.h"
+#include "test_lcd.h"
+
+/* Bus and pins of virtual panel. */
+#define TEST_LCD_SPI_IDX		(0)
+#define TEST_LCD_CS				(0)
+#define TEST_LCD_DCX_PIN		(25)
+/* Number of disjoint rectangles drawn, well over LCD_DIRTY_RECT_MAX. */
+#define TEST_LCD_NRECT			(3 * LCD_DIRTY_RECT_MAX)
+/* Odd-sized sprite, RAW and RLE encoded. */
+#define TEST_LCD_SPRITE_WIDTH	(13)
+#define TEST_LCD_SPRITE_HEIGHT	(7)
+#define TEST_LCD_SPRITE_NPIXEL	(TEST_LCD_SPRITE_WIDTH * TEST_LCD_SPRITE_HEIGHT)
+#define TEST_LCD_SHEET_SIZE		(1024)
+
+static st7735sim_t test_lcdSim;
+static uint32_t test_lcdSheetData[TEST_LCD_SHEET_SIZE / sizeof(uint32_t)];
+
+/**
+ * @brief Build a sheet of a RAW and a RLE sprite of the same image.
+ */
+static void test_lcdBuildSheet(spriteSheet_t *sheet, uint8_t fmt) {
+	uint32_t pixel[TEST_LCD_SPRITE_NPIXEL];
+	uint8_t *data = (uint8_t*) test_lcdSheetData;
+	spriteSheetHeader_t *header;
+	spriteEntry_t *entry;
+	uint32_t offset;
+	uint32_t i;
+	int32_t size;
+
+	/* Runs of 4 pixels, crossing rows */
+	for (i = 0; i < TEST_LCD_SPRITE_NPIXEL; i++) {
+		pixel[i] = 0x305070 * (i / 4) ^ 0xC0C0C0;
+	}
+
+	memset(data, 0, TEST_LCD_SHEET_SIZE);
+	header = (spriteSheetHeader_t*) data;
+	memcpy(header->magic, SPRITE_MAGIC, sizeof(header->magic));
+	header->version = SPRITE_VERSION;
+	header->nSprite = 2;
+	header->fmt = fmt;
+
+	entry = (spriteEntry_t*) (header + 1);
+	offset = sizeof(spriteSheetHeader_t) + 2 * sizeof(spriteEntry_t);
+	for (i = 0; i < 2; i++) {
+		entry[i].width = TEST_LCD_SPRITE_WIDTH;
+		entry[i].height = TEST_LCD_SPRITE_HEIGHT;
+		entry[i].encoding = (0 == i)? SPRITE_ENC_RAW : SPRITE_ENC_RLE;
+		size = sprite_encode(data + offset, TEST_LCD_SHEET_SIZE - offset, pixel, TEST_LCD_SPRITE_NPIXEL,
+				fmt, &entry[i]);
+		ASSERT(size > 0, "Failed to encode sprite.");
+		entry[i].offset = offset;
+		entry[i].size = (uint32_t) size;
+		offset += (size + 3) & ~3;
+	}
+	ASSERT(sprite_sheetInit(sheet, data, offset) == STATUS_OK, "Failed to init sheet.");
+}
+
+/**
+ * @brief Draw rectangles far enough apart not to be merged by cost, then
+ * 		sprites and a bitmap, so that the dirty rectangles run out.
+ */
+static void test_lcdDrawRects(lcd_t *lcd, const spriteSheet_t *sheet) {
+	uint32_t color[9 * 5];
+	uint32_t i;
+
+	for (i = 0; i < TEST_LCD_NRECT; i++) {
+		lcd_fillRect(lcd, (i % 4) * 30 + 3, (i / 4) * 20 + 2, 5 + i % 3, 3 + i % 2, 0x0F1E2D * (i + 1));
+	}
+	ASSERT(lcd_drawSprite(lcd, 101, 30, sheet, 0) == STATUS_OK, "RAW sprite not drawn.");
+	ASSERT(lcd_drawSprite(lcd, 11, 111, sheet, 1) == STATUS_OK, "RLE sprite not drawn.");
+	for (i = 0; i < 9 * 5; i++) {
+		color[i] = 0x010305 * i;
+	}
+	lcd_drawBitmap(lcd, 70, 85, 9, 5, color);
+}
+
+/**
+ * @brief Draw full-width rectangles, of an odd number of pixels with 12-bit
+ * 		color, and nothing else.
+ */
+static void test_lcdDrawBands(lcd_t *lcd) {
+	lcd_fillRect(lcd, 0, 41, lcd->width, 3, 0x80FF40);
+	lcd_fillRect(lcd, 0, 97, lcd->width, 1, 0x4080FF);
+}
+
+void test_lcdAll(void) {
+	test_lcdFrameBuffer();
+}
+
+void test_lcdFrameBuffer(void) {
+	const st7735_color_t colorFmt[] = {ST7735_PANEL_COLOR_12_BIT, ST7735_PANEL_COLOR_16_BIT,
+			ST7735_PANEL_COLOR_18_BIT};
+	const uint8_t pixelFmt[] = {BITMAP_PIXEL_FMT_RGB444, BITMAP_PIXEL_FMT_RGB565, BITMAP_PIXEL_FMT_RGB666};
+	const uint8_t orient[] = {LCD_ORIENT_PORTRAIT_NORMAL, LCD_ORIENT_LANDSCAPE_NORMAL};
+	uint32_t refHash[2], blackHash;
+	spriteSheet_t sheet;
+	st7735Cfg_t cfg;
+	st7735_t *st7735 = NULL;
+	lcd_t *lcd = NULL;
+	uint32_t f, o;
+
+	for (f = 0; f < sizeof(colorFmt) / sizeof(colorFmt[0]); f++) {
+		for (o = 0; o < sizeof(orient) / sizeof(orient[0]); o++) {
+			memset(&cfg, 0, sizeof(cfg));
+			cfg.model = ST7735_MODEL_B;
+			cfg.spiIdx = TEST_LCD_SPI_IDX;
+			cfg.csPin = TEST_LCD_CS;
+			cfg.dcxPin = TEST_LCD_DCX_PIN;
+			cfg.colorFmt = colorFmt[f];
+			ASSERT(st7735sim_init(&test_lcdSim, TEST_LCD_SPI_IDX, TEST_LCD_CS, TEST_LCD_DCX_PIN) == STATUS_OK,
+					"Virtual panel not set up.");
+			ASSERT(st7735_create(&st7735, &cfg) == ST7735_STATUS_OK, "Driver not created.");
+			ASSERT(lcd_create(&lcd, st7735) == STATUS_OK, "LCD not created.");
+			lcd_setOrientation(lcd, orient[o]);
+			test_lcdBuildSheet(&sheet, pixelFmt[f]);
+
+			/* Reference drawn straight to panel */
+			LCD_fillScreen(lcd, LCD_COLOR_BLACK);
+			blackHash = st7735sim_getHash(&test_lcdSim);
+			test_lcdDrawRects(lcd, &sheet);
+			refHash[0] = st7735sim_getHash(&test_lcdSim);
+			test_lcdDrawBands(lcd);
+			refHash[1] = st7735sim_getHash(&test_lcdSim);
+
+			/* Same in frame buffer, black as the panel */
+			LCD_fillScreen(lcd, LCD_COLOR_BLACK);
+			ASSERT(lcd_enableFrameBuffer(lcd) == STATUS_OK, "Frame buffer not enabled.");
+			test_lcdDrawRects(lcd, &sheet);
+			ASSERT(lcd->nDirty > 0 && lcd->nDirty <= LCD_DIRTY_RECT_MAX, "Incorrect number of dirty rectangles.");
+			ASSERT(st7735sim_getHash(&test_lcdSim) == blackHash, "Frame buffer sent before flush.");
+			ASSERT(lcd_flush(lcd) == STATUS_OK && 0 == lcd->nDirty, "Frame buffer not flushed.");
+			ASSERT(st7735sim_getHash(&test_lcdSim) == refHash[0], "Flushed rectangles differ from drawn.");
+
+			test_lcdDrawBands(lcd);
+			ASSERT(lcd->nDirty == 2 && lcd->dirty[0].x1 == lcd->width - 1, "Full-width rectangles merged.");
+			ASSERT(lcd_flush(lcd) == STATUS_OK, "Frame buffer not flushed.");
+			ASSERT(st7735sim_getHash(&test_lcdSim) == refHash[1], "Flushed full-width rectangles differ from drawn.");
+
+			lcd_destroy(&lcd);
+			st7735_destroy(&st7735);
+			st7735sim_deinit(&test_lcdSim);
+		}
+	}
+}
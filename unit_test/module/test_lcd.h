@@ -0,0 +1,30 @@
+/*
+ * test_lcd.h
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: chiong
+ *
+ *  Runs against the virtual panel of module/st7735-lcd/st7735sim.h, so it is
+ *  built with src/hw/sim in place of the target backend.
+ */
+
+#ifndef TEST_TEST_LCD_H_
+#define TEST_TEST_LCD_H_
+
+/**
+ * @details Test all
+ */
+void test_lcdAll(void);
+
+/**
+ * @details Test includes:
+ * 		1. More disjoint rectangles, sprites and bitmaps drawn than
+ * 		   LCD_DIRTY_RECT_MAX, merged into no more dirty rectangles, are on
+ * 		   panel after lcd_flush() as drawn without frame buffer, in 12, 16 and
+ * 		   18-bit, portrait and landscape.
+ * 		2. Full-width rectangles, odd-sized with 12-bit color.
+ * 		3. Nothing is sent to panel before lcd_flush().
+ */
+void test_lcdFrameBuffer(void);
+
+#endif /* TEST_TEST_LCD_H_ */
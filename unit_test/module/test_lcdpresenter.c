@@ -0,0 +1,217 @@
+/*
+ * test_lcdpresenter.c
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: chiong
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "module/st7735-lcd/st7735.h"
+#include "module/st7735-lcd/lcd.h"
+#include "module/st7735-lcd/lcdpresenter.h"
+#include "module/st7735-lcd/st7735sim.h"
+#include "debug/assert.h"
+#include "test_lcdpresenter.h"
+
+/* Bus and pins of virtual panel. */
+#define TEST_LCDPRESENTER_SPI_IDX	(0)
+#define TEST_LCDPRESENTER_CS		(0)
+#define TEST_LCDPRESENTER_DCX_PIN	(25)
+/* Number of draws, a frame presented every 3 of them. */
+#define TEST_LCDPRESENTER_NDRAW		(120)
+
+typedef struct {
+	/* Number of calls to onFrame, and non-zero while frames come in order. */
+	uint32_t nCall;
+	uint8_t isOrdered;
+} test_lcdpresenterCount_t;
+
+static st7735sim_t test_lcdpresenterSim;
+static uint32_t test_lcdpresenterRef[ST7735_HEIGHT][ST7735_WIDTH];
+
+static void test_lcdpresenterOnFrame(void *arg, uint32_t frame) {
+	test_lcdpresenterCount_t *count = (test_lcdpresenterCount_t*) arg;
+
+	if (frame != count->nCall) {
+		count->isOrdered = 0;
+	}
+	count->nCall++;
+}
+
+/**
+ * @brief Draw i of a sequence, a few primitives overlapping those before.
+ */
+static void test_lcdpresenterDraw(lcd_t *lcd, uint32_t i) {
+	char str[12];
+
+	lcd_fillRect(lcd, (i * 7) % 100, (i * 13) % 110, 20, 15, 0x010203 * i);
+	lcd_fillCircle(lcd, (i * 31) % 128, (i * 17) % 128, 6, 0xFF00FF ^ i);
+	snprintf(str, sizeof(str), "%u", i);
+	lcd_writeText(lcd, (i * 5) % 100, (i * 3) % 120, str, -1);
+}
+
+void test_lcdpresenterAll(void) {
+	test_lcdpresenterFrame();
+	test_lcdpresenterHandshake();
+}
+
+void test_lcdpresenterFrame(void) {
+	const st7735_color_t fmt[] = {ST7735_PANEL_COLOR_18_BIT, ST7735_PANEL_COLOR_16_BIT,
+			ST7735_PANEL_COLOR_12_BIT, ST7735_PANEL_COLOR_18_BIT};
+	const uint8_t orient[] = {LCD_ORIENT_PORTRAIT_NORMAL, LCD_ORIENT_LANDSCAPE_NORMAL,
+			LCD_ORIENT_PORTRAIT_NORMAL, LCD_ORIENT_LANDSCAPE_INVERTED};
+	const uint32_t periodUs[] = {0, 0, 2000, 500};
+	const uint8_t isDropLate[] = {0, 1, 1, 0};
+	test_lcdpresenterCount_t count;
+	lcdPresenterStats_t stats;
+	lcdPresenterCfg_t presenterCfg;
+	lcdPresenter_t *presenter = NULL;
+	st7735Cfg_t cfg;
+	st7735_t *st7735 = NULL;
+	lcd_t *lcd = NULL;
+	uint32_t i, k;
+
+	for (k = 0; k < sizeof(fmt) / sizeof(fmt[0]); k++) {
+		memset(&cfg, 0, sizeof(cfg));
+		cfg.model = ST7735_MODEL_B;
+		cfg.spiIdx = TEST_LCDPRESENTER_SPI_IDX;
+		cfg.csPin = TEST_LCDPRESENTER_CS;
+		cfg.dcxPin = TEST_LCDPRESENTER_DCX_PIN;
+		cfg.colorFmt = fmt[k];
+		ASSERT(st7735sim_init(&test_lcdpresenterSim, TEST_LCDPRESENTER_SPI_IDX, TEST_LCDPRESENTER_CS,
+				TEST_LCDPRESENTER_DCX_PIN) == STATUS_OK, "Virtual panel not set up.");
+		ASSERT(st7735_create(&st7735, &cfg) == ST7735_STATUS_OK, "Driver not created.");
+		ASSERT(lcd_create(&lcd, st7735) == STATUS_OK, "LCD not created.");
+		lcd_setOrientation(lcd, orient[k]);
+
+		/* Reference drawn without presenter */
+		ASSERT(lcd_enableFrameBuffer(lcd) == STATUS_OK, "Frame buffer not enabled.");
+		for (i = 0; i < TEST_LCDPRESENTER_NDRAW; i++) {
+			test_lcdpresenterDraw(lcd, i);
+			if (i % 3 == 0) {
+				lcd_flush(lcd);
+			}
+		}
+		lcd_flush(lcd);
+		memcpy(test_lcdpresenterRef, test_lcdpresenterSim.ram, sizeof(test_lcdpresenterRef));
+
+		/* Same draws from a black screen, presented instead */
+		lcd_disableFrameBuffer(lcd);
+		lcd_enableFrameBuffer(lcd);
+		LCD_fillScreen(lcd, 0x000000);
+		lcd_flush(lcd);
+
+		count.nCall = 0;
+		count.isOrdered = 1;
+		presenterCfg.periodUs = periodUs[k];
+		presenterCfg.isDropLate = isDropLate[k];
+		presenterCfg.onFrame = test_lcdpresenterOnFrame;
+		presenterCfg.arg = &count;
+		ASSERT(lcdpresenter_create(&presenter, lcd, &presenterCfg) == STATUS_OK, "Presenter not created.");
+		for (i = 0; i < TEST_LCDPRESENTER_NDRAW; i++) {
+			test_lcdpresenterDraw(lcd, i);
+			if (i % 3 == 0) {
+				lcdpresenter_present(presenter);
+			}
+		}
+		/* The last frame is not to be dropped */
+		while (lcdpresenter_present(presenter) != STATUS_OK) {
+		}
+		lcdpresenter_wait(presenter);
+		lcdpresenter_getStats(presenter, &stats);
+		lcdpresenter_destroy(&presenter);
+		ASSERT(NULL == presenter, "Presenter not destroyed.");
+
+		ASSERT(stats.nFrame + stats.nDrop == stats.nPresent && 0 == stats.nError, "Incorrect counters.");
+		ASSERT(isDropLate[k] || 0 == stats.nDrop, "Frame dropped without isDropLate.");
+		ASSERT(count.nCall == stats.nFrame && count.isOrdered, "Incorrect calls to onFrame.");
+		ASSERT(memcmp(test_lcdpresenterSim.ram, test_lcdpresenterRef, sizeof(test_lcdpresenterRef)) == 0,
+				"Presented frames differ from flushed frames.");
+
+		/* Frame buffer stays with lcd */
+		test_lcdpresenterDraw(lcd, TEST_LCDPRESENTER_NDRAW);
+		ASSERT(lcd_flush(lcd) == STATUS_OK, "LCD not usable after presenter.");
+
+		lcd_destroy(&lcd);
+		st7735_destroy(&st7735);
+		st7735sim_deinit(&test_lcdpresenterSim);
+	}
+}
+
+void test_lcdpresenterHandshake(void) {
+	lcdPresenterStats_t stats;
+	lcdPresenterCfg_t presenterCfg;
+	lcdPresenter_t *presenter = NULL;
+	st7735Cfg_t cfg;
+	st7735_t *st7735 = NULL;
+	lcd_t *lcd = NULL;
+	const st7735sim_t *sim = &test_lcdpresenterSim;
+	uint16_t scrollStart;
+
+	memset(&cfg, 0, sizeof(cfg));
+	cfg.model = ST7735_MODEL_B;
+	cfg.spiIdx = TEST_LCDPRESENTER_SPI_IDX;
+	cfg.csPin = TEST_LCDPRESENTER_CS;
+	cfg.dcxPin = TEST_LCDPRESENTER_DCX_PIN;
+	cfg.colorFmt = ST7735_PANEL_COLOR_16_BIT;
+	ASSERT(st7735sim_init(&test_lcdpresenterSim, TEST_LCDPRESENTER_SPI_IDX, TEST_LCDPRESENTER_CS,
+			TEST_LCDPRESENTER_DCX_PIN) == STATUS_OK, "Virtual panel not set up.");
+	ASSERT(st7735_create(&st7735, &cfg) == ST7735_STATUS_OK, "Driver not created.");
+	ASSERT(lcd_create(&lcd, st7735) == STATUS_OK, "LCD not created.");
+
+	/* Paced at 50 ms, so that a frame presented right after another is pending */
+	memset(&presenterCfg, 0, sizeof(presenterCfg));
+	presenterCfg.periodUs = 50000;
+	ASSERT(lcdpresenter_create(&presenter, lcd, &presenterCfg) == STATUS_OK, "Presenter not created.");
+	LCD_fillScreen(lcd, 0xFF0000);
+	lcdpresenter_present(presenter);
+	lcdpresenter_wait(presenter);
+	ASSERT(st7735sim_getPixel(sim, lcd->orientation, 64, 80) == 0xFF0000, "Frame not on panel after wait.");
+
+	lcd_fillRect(lcd, 0, 0, 10, 10, 0x00FF00);
+	ASSERT(lcdpresenter_present(presenter) == STATUS_OK, "Frame not presented.");
+	lcd_fillRect(lcd, 20, 20, 10, 10, 0x0000FF);
+	ASSERT(lcdpresenter_present(presenter) == STATUS_OK, "Frame not presented after waiting.");
+	lcd_fillRect(lcd, 40, 40, 10, 10, 0xFFFFFF);
+	lcdpresenter_wait(presenter);
+	lcdpresenter_getStats(presenter, &stats);
+	ASSERT(1 == stats.nWait && 3 == stats.nFrame && 0 == stats.nDrop, "Pending frame not waited for.");
+	ASSERT(st7735sim_getPixel(sim, lcd->orientation, 5, 5) == 0x00FF00 &&
+		   st7735sim_getPixel(sim, lcd->orientation, 25, 25) == 0x0000FF, "Frames not on panel after wait.");
+	ASSERT(st7735sim_getPixel(sim, lcd->orientation, 45, 45) == 0xFF0000, "Frame not presented is on panel.");
+
+	/* Scroll only with the next frame */
+	ASSERT(lcd_setScrollArea(lcd, 0, 160) == STATUS_OK, "Scroll area not set.");
+	scrollStart = sim->scrollStart;
+	lcd_scroll(lcd, 10);
+	ASSERT(sim->scrollStart == scrollStart, "Scroll sent before frame.");
+	lcdpresenter_present(presenter);
+	lcdpresenter_wait(presenter);
+	ASSERT(sim->scrollStart != scrollStart, "Scroll not sent with frame.");
+	lcd_setScrollArea(lcd, 0, 0);
+	lcdpresenter_destroy(&presenter);
+
+	/* Frame dropped while another is pending, its changes go with the next */
+	presenterCfg.isDropLate = 1;
+	ASSERT(lcdpresenter_create(&presenter, lcd, &presenterCfg) == STATUS_OK, "Presenter not created.");
+	lcdpresenter_present(presenter);
+	lcdpresenter_wait(presenter);
+	lcd_fillRect(lcd, 60, 60, 10, 10, 0x00FF00);
+	lcdpresenter_present(presenter);
+	lcd_fillRect(lcd, 80, 80, 10, 10, 0x0000FF);
+	ASSERT(lcdpresenter_present(presenter) == STATUS_ERROR, "Late frame not dropped.");
+	lcdpresenter_wait(presenter);
+	ASSERT(st7735sim_getPixel(sim, lcd->orientation, 85, 85) == 0xFF0000, "Dropped frame on panel.");
+	ASSERT(lcdpresenter_present(presenter) == STATUS_OK, "Frame not presented.");
+	lcdpresenter_wait(presenter);
+	lcdpresenter_getStats(presenter, &stats);
+	ASSERT(1 == stats.nDrop && 3 == stats.nFrame, "Incorrect counters of dropped frame.");
+	ASSERT(st7735sim_getPixel(sim, lcd->orientation, 65, 65) == 0x00FF00 &&
+		   st7735sim_getPixel(sim, lcd->orientation, 85, 85) == 0x0000FF, "Changes of dropped frame lost.");
+	lcdpresenter_destroy(&presenter);
+
+	lcd_destroy(&lcd);
+	st7735_destroy(&st7735);
+	st7735sim_deinit(&test_lcdpresenterSim);
+}
@@ -0,0 +1,38 @@
+/*
+ * test_lcdpresenter.h
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: chiong
+ *
+ *  Runs against the virtual panel of module/st7735-lcd/st7735sim.h, so it is
+ *  built with src/hw/sim in place of the target backend.
+ */
+
+#ifndef TEST_TEST_LCDPRESENTER_H_
+#define TEST_TEST_LCDPRESENTER_H_
+
+/**
+ * @details Test all
+ */
+void test_lcdpresenterAll(void);
+
+/**
+ * @details Test includes:
+ * 		1. Frames drawn and presented end up on panel as drawn with lcd_flush(),
+ * 		   in 12, 16 and 18-bit, portrait and landscape, paced or not.
+ * 		2. Counters add up, onFrame called once per frame in order.
+ * 		3. LCD keeps working in frame buffer mode after destroy.
+ */
+void test_lcdpresenterFrame(void);
+
+/**
+ * @details Test includes:
+ * 		1. present() while a frame is pending waits for it, or with isDropLate
+ * 		   drops the frame and carries its changes over to the next one.
+ * 		2. After lcdpresenter_wait(), the panel shows the last frame presented
+ * 		   and nothing drawn since.
+ * 		3. A scroll goes to panel with the next frame presented.
+ */
+void test_lcdpresenterHandshake(void);
+
+#endif /* TEST_TEST_LCDPRESENTER_H_ */
@@ -0,0 +1,172 @@
+/*
+ * test_st7735.c
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: chiong
+ */
+
+#include <string.h>
+#include "module/st7735-lcd/st7735.h"
+#include "module/st7735-lcd/st7735sim.h"
+#include "debug/assert.h"
+#include "test_st7735.h"
+
+/* Bus and pins of virtual panel. */
+#define TEST_ST7735_SPI_IDX		(0)
+#define TEST_ST7735_CS			(0)
+#define TEST_ST7735_DCX_PIN		(25)
+/* Windows of test, the last ones small so that segments run out. */
+#define TEST_ST7735_NWINDOW		(12)
+#define TEST_ST7735_NPIXEL_MAX	(128 * 40)
+
+typedef struct {
+	uint16_t x;
+	uint16_t y;
+	uint16_t w;
+	uint16_t h;
+	/* Pixels of first color, then of pattern, then of second color to the end. */
+	uint32_t nFirst;
+	uint32_t nPattern;
+	uint32_t color[2];
+} test_st7735Window_t;
+
+static const test_st7735Window_t test_st7735Window[TEST_ST7735_NWINDOW] = {
+	{3, 2, 7, 5, 5, 9, {0xFF8000, 0x2080FF}},
+	{20, 10, 4, 4, 1, 3, {0x00FF00, 0xFF00FF}},
+	{14, 30, 101, 39, 2001, 7, {0x8040C0, 0x40C080}},
+	{0, 75, 128, 20, 0, 1, {0xFFFFFF, 0x102030}},
+	{0, 100, 5, 3, 3, 5, {0xF0F000, 0x0000F0}},
+	{13, 106, 5, 3, 3, 5, {0xF0F000, 0x0000F0}},
+	{26, 112, 5, 3, 3, 5, {0xF0F000, 0x0000F0}},
+	{39, 118, 5, 3, 3, 5, {0xF0F000, 0x0000F0}},
+	{52, 124, 5, 3, 3, 5, {0xF0F000, 0x0000F0}},
+	{65, 130, 5, 3, 3, 5, {0xF0F000, 0x0000F0}},
+	{78, 136, 5, 3, 3, 5, {0xF0F000, 0x0000F0}},
+	{91, 142, 5, 3, 3, 5, {0xF0F000, 0x0000F0}},
+};
+
+static st7735sim_t test_st7735Sim;
+static uint32_t test_st7735Color[TEST_ST7735_NPIXEL_MAX];
+
+static uint32_t test_st7735Pattern(uint32_t i) {
+	return (0x10E070 * (i + 1)) & 0xFFFFFF;
+}
+
+/**
+ * @brief Convert pattern to the pixels of st7735_cmdListPushPixels().
+ */
+static void test_st7735PatternPixels(st7735_color_t fmt, uint8_t *pixel, uint32_t count) {
+	uint32_t i, c;
+	uint16_t value;
+
+	for (i = 0; i < count; i++) {
+		c = test_st7735Pattern(i);
+		if (ST7735_PANEL_COLOR_18_BIT == fmt) {
+			pixel[i * 3] = (c >> 16) & 0xFF;
+			pixel[i * 3 + 1] = (c >> 8) & 0xFF;
+			pixel[i * 3 + 2] = c & 0xFF;
+		} else {
+			value = (ST7735_PANEL_COLOR_12_BIT == fmt)?
+					ST7735_rgb444((c >> 16) & 0xFF, (c >> 8) & 0xFF, c & 0xFF) :
+					ST7735_rgb565((c >> 16) & 0xFF, (c >> 8) & 0xFF, c & 0xFF);
+			pixel[i * 2] = value >> 8;
+			pixel[i * 2 + 1] = value & 0xFF;
+		}
+	}
+}
+
+/**
+ * @brief Write the windows of test, one color at a time, without command list.
+ */
+static void test_st7735WriteRef(const st7735_t *st7735) {
+	const test_st7735Window_t *win;
+	uint32_t count;
+	uint32_t i, k;
+
+	for (k = 0; k < TEST_ST7735_NWINDOW; k++) {
+		win = &test_st7735Window[k];
+		count = win->w * win->h;
+		for (i = 0; i < count; i++) {
+			if (i < win->nFirst) {
+				test_st7735Color[i] = win->color[0];
+			} else if (i < win->nFirst + win->nPattern) {
+				test_st7735Color[i] = test_st7735Pattern(i - win->nFirst);
+			} else {
+				test_st7735Color[i] = win->color[1];
+			}
+		}
+		st7735_setAddress(st7735, win->x, win->y, win->x + win->w - 1, win->y + win->h - 1);
+		st7735_panel_pushColorArray(st7735, test_st7735Color, count);
+	}
+}
+
+/**
+ * @brief Record the windows of test into a command list with a buffer of size bytes.
+ */
+static void test_st7735WriteList(const st7735_t *st7735, st7735_color_t fmt, uint32_t size) {
+	uint8_t buffer[512];
+	uint8_t pixel[16 * 3];
+	const test_st7735Window_t *win;
+	st7735CmdList_t list;
+	uint32_t k;
+
+	test_st7735PatternPixels(fmt, pixel, 16);
+	ASSERT(st7735_cmdListInit(&list, st7735, buffer, size) == ST7735_STATUS_OK, "Command list not set up.");
+	for (k = 0; k < TEST_ST7735_NWINDOW; k++) {
+		win = &test_st7735Window[k];
+		st7735_cmdListSetWindow(&list, win->x, win->y, win->x + win->w - 1, win->y + win->h - 1);
+		st7735_cmdListPushColor(&list, win->color[0], win->nFirst);
+		st7735_cmdListPushPixels(&list, pixel, win->nPattern);
+		st7735_cmdListPushColor(&list, win->color[1], win->w * win->h - win->nFirst - win->nPattern);
+	}
+	st7735_cmdListFlush(&list);
+}
+
+void test_st7735All(void) {
+	test_st7735CmdList();
+}
+
+void test_st7735CmdList(void) {
+	const st7735_color_t fmt[] = {ST7735_PANEL_COLOR_12_BIT, ST7735_PANEL_COLOR_16_BIT,
+			ST7735_PANEL_COLOR_18_BIT};
+	const uint32_t size[] = {16, 512};
+	uint8_t buffer[16];
+	st7735CmdList_t list;
+	st7735Cfg_t cfg;
+	st7735_t *st7735 = NULL;
+	uint32_t refHash, blackHash;
+	uint32_t f, s;
+
+	for (f = 0; f < sizeof(fmt) / sizeof(fmt[0]); f++) {
+		memset(&cfg, 0, sizeof(cfg));
+		cfg.model = ST7735_MODEL_B;
+		cfg.spiIdx = TEST_ST7735_SPI_IDX;
+		cfg.csPin = TEST_ST7735_CS;
+		cfg.dcxPin = TEST_ST7735_DCX_PIN;
+		cfg.colorFmt = fmt[f];
+		ASSERT(st7735sim_init(&test_st7735Sim, TEST_ST7735_SPI_IDX, TEST_ST7735_CS, TEST_ST7735_DCX_PIN) == STATUS_OK,
+				"Virtual panel not set up.");
+		ASSERT(st7735_create(&st7735, &cfg) == ST7735_STATUS_OK, "Driver not created.");
+
+		blackHash = st7735sim_getHash(&test_st7735Sim);
+		test_st7735WriteRef(st7735);
+		refHash = st7735sim_getHash(&test_st7735Sim);
+		ASSERT(refHash != blackHash, "Nothing written to panel.");
+
+		for (s = 0; s < sizeof(size) / sizeof(size[0]); s++) {
+			/* Back to black */
+			st7735_setAddress(st7735, 0, 0, ST7735_WIDTH - 1, ST7735_HEIGHT - 1);
+			st7735_panel_pushColor(st7735, 0x000000, ST7735_WIDTH * ST7735_HEIGHT);
+			ASSERT(st7735sim_getHash(&test_st7735Sim) == blackHash, "Panel not cleared.");
+
+			test_st7735WriteList(st7735, fmt[f], size[s]);
+			ASSERT(st7735sim_getHash(&test_st7735Sim) == refHash, "Command list differs from direct write.");
+		}
+
+		ASSERT(st7735_cmdListInit(&list, st7735, buffer, sizeof(buffer) - 1) == ST7735_STATUS_ERROR,
+				"Buffer too small accepted.");
+
+		st7735_destroy(&st7735);
+		st7735sim_deinit(&test_st7735Sim);
+	}
+}
@@ -0,0 +1,32 @@
+/*
+ * test_st7735.h
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: chiong
+ *
+ *  Runs against the virtual panel of module/st7735-lcd/st7735sim.h, so it is
+ *  built with src/hw/sim in place of the target backend.
+ */
+
+#ifndef TEST_TEST_ST7735_H_
+#define TEST_TEST_ST7735_H_
+
+/**
+ * @details Test all
+ */
+void test_st7735All(void);
+
+/**
+ * @details Test includes:
+ * 		1. Windows recorded into a command list of 16 bytes, i.e. sent in many
+ * 		   parts, and of 512 bytes are on panel as written with
+ * 		   st7735_setAddress() and st7735_panel_pushColorArray(), in 12, 16 and
+ * 		   18-bit.
+ * 		2. Long repeats of a color across full buffers, and colors and pixels
+ * 		   of odd counts continuing each other with 12-bit color.
+ * 		3. More commands than ST7735_CMDLIST_SEGMENT_MAX segments in a list.
+ * 		4. Buffer too small.
+ */
+void test_st7735CmdList(void);
+
+#endif /* TEST_TEST_ST7735_H_ */
@@ -10,15 +10,40 @@
 #include "util/test_util.h"
 #include "util/test_buffer.h"
 #include "util/test_stack.h"
+#include "util/test_mcfifo.h"
+#include "util/test_pool.h"
+#include "util/test_mtstack.h"
+#include "util/test_mcring.h"
+#include "util/test_file.h"
+#include "util/test_binlog.h"
+#include "util/test_bitmap.h"
+#include "util/test_sprite.h"
 
 #include "math/test_fimath.h"
 
+#include "module/test_chart.h"
+#include "module/test_lcd.h"
+#include "module/test_lcdpresenter.h"
+#include "module/test_st7735.h"
+
 
 int main(int argc, char** argv) {
 //	test_bitAll();
 //	test_utilAll();
 //	test_bufferAll();
 //	test_stackAll();
+//	test_mcfifoAll();
+//	test_poolAll();
+//	test_mtstackAll();
+//	test_mcringAll();
+//	test_fileAll();
+//	test_binlogAll();
+//	test_bitmapAll();
+//	test_spriteAll();
+//	test_chartAll();
+//	test_lcdAll();
+//	test_lcdpresenterAll();
+//	test_st7735All();
 
     test_fimathAll();
 
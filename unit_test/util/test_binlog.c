@@ -0,0 +1,265 @@
+/*
+ * test_binlog.c
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: chiong
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "util/binlog.h"
+#include "util/file.h"
+#include "debug/assert.h"
+#include "test_binlog.h"
+
+#define TEST_BINLOG_FORMAT		"test_binlog_%02u.bin"
+#define TEST_BINLOG_NTHREAD		(4)
+#define TEST_BINLOG_NRECORD		(3000)
+#define TEST_BINLOG_MAX_SIZE	(40)
+#define TEST_BINLOG_FILE_SIZE	(32768)
+
+typedef struct {
+	binlog_t *log;
+	uint16_t id;
+} test_binlogArg_t;
+
+/**
+ * @brief Payload of record n of a thread: n, then n % 29 bytes of n & 0xFF.
+ */
+static uint32_t test_binlogPayload(uint8_t *payload, uint32_t n) {
+	uint32_t size;
+
+	memcpy(payload, &n, sizeof(n));
+	size = sizeof(n) + n % (TEST_BINLOG_MAX_SIZE - sizeof(n) - 7);
+	memset(payload + sizeof(n), n & 0xFF, size - sizeof(n));
+
+	return size;
+}
+
+static void* test_binlogProducer(void *arg) {
+	test_binlogArg_t *pArg = (test_binlogArg_t*) arg;
+	uint8_t payload[TEST_BINLOG_MAX_SIZE];
+	uint32_t n, size;
+
+	for (n = 0; n < TEST_BINLOG_NRECORD; n++) {
+		size = test_binlogPayload(payload, n);
+		/* Retry dropped records, so that all can be checked */
+		while (binlog_write(pArg->log, pArg->id, payload, size) != STATUS_OK) {
+			sched_yield();
+		}
+	}
+
+	return NULL;
+}
+
+/**
+ * @brief Wait, up to 5 s, until the writer thread has written n records.
+ */
+static void test_binlogWaitRecord(binlog_t *pLog, uint32_t n, binlogStats_t *stats) {
+	struct timespec period = { 0, 1000000 };
+	uint32_t i;
+
+	for (i = 0; i < 5000; i++) {
+		binlog_getStats(pLog, stats);
+		if (stats->nRecord >= n) {
+			break;
+		}
+		nanosleep(&period, NULL);
+	}
+}
+
+/**
+ * @brief Read back all files and check the records of every thread are complete
+ * 		and in order. Files are removed.
+ */
+static void test_binlogCheckFiles(uint32_t nFile) {
+	char filename[64];
+	uint8_t expected[TEST_BINLOG_MAX_SIZE];
+	uint32_t next[TEST_BINLOG_NTHREAD] = { 0 };
+	uint64_t lastTime[TEST_BINLOG_NTHREAD] = { 0 };
+	fileMapCfg_t cfg;
+	fileMap_t *pMap;
+	fileMapView_t view;
+	const binlogRecord_t *rec;
+	const uint8_t *p;
+	uint64_t pos;
+	uint32_t i, size;
+
+	memset(&cfg, 0, sizeof(cfg));
+	cfg.filename = filename;
+	cfg.elemSize = 1;
+	for (i = 0; i < nFile; i++) {
+		snprintf(filename, sizeof(filename), TEST_BINLOG_FORMAT, i);
+		ASSERT(file_mapOpen(&pMap, &cfg) == STATUS_OK, "Log file not found.");
+		file_mapGetView(pMap, &view);
+		ASSERT(view.count <= TEST_BINLOG_FILE_SIZE, "Log file too large.");
+
+		p = FILEMAPVIEW_getDataAsType(&view, uint8_t);
+		for (pos = 0; pos < view.count; pos += BINLOG_getRecordSize(rec->size)) {
+			ASSERT(0 == pos % BINLOG_RECORD_ALIGN, "Record not aligned.");
+			rec = (const binlogRecord_t*) (p + pos);
+			ASSERT(rec->id < TEST_BINLOG_NTHREAD, "Incorrect record id.");
+			ASSERT(rec->timestamp >= lastTime[rec->id], "Records out of order.");
+			size = test_binlogPayload(expected, next[rec->id]);
+			ASSERT(rec->size == size && memcmp(rec + 1, expected, size) == 0, "Incorrect record payload.");
+			lastTime[rec->id] = rec->timestamp;
+			next[rec->id]++;
+		}
+		ASSERT(pos == view.count, "Partial record in file.");
+		file_mapClose(&pMap);
+		remove(filename);
+	}
+
+	for (i = 0; i < TEST_BINLOG_NTHREAD; i++) {
+		ASSERT(next[i] == TEST_BINLOG_NRECORD, "Records missing.");
+	}
+}
+
+void test_binlogWrite(void) {
+	binlogCfg_t cfg;
+	binlogStats_t stats;
+	binlog_t *pLog = NULL;
+	pthread_t thread[TEST_BINLOG_NTHREAD];
+	test_binlogArg_t arg[TEST_BINLOG_NTHREAD];
+	uint32_t i, k;
+
+	cfg.filenameFormat = TEST_BINLOG_FORMAT;
+	cfg.nSlot = 256;
+	cfg.maxRecordSize = TEST_BINLOG_MAX_SIZE;
+	cfg.batchSize = 4096;
+	cfg.maxFileSize = TEST_BINLOG_FILE_SIZE;
+	cfg.maxFileMs = 0;
+	cfg.flushMs = 10;
+
+	for (k = 0; k < 2; k++) {
+		cfg.isDirect = k;
+		ASSERT(binlog_create(&pLog, &cfg) == STATUS_OK, "Failed to create log.");
+		for (i = 0; i < TEST_BINLOG_NTHREAD; i++) {
+			arg[i].log = pLog;
+			arg[i].id = i;
+			pthread_create(&thread[i], NULL, test_binlogProducer, &arg[i]);
+		}
+		for (i = 0; i < TEST_BINLOG_NTHREAD; i++) {
+			pthread_join(thread[i], NULL);
+		}
+
+		/* Counters are gone once destroyed */
+		test_binlogWaitRecord(pLog, TEST_BINLOG_NTHREAD * TEST_BINLOG_NRECORD, &stats);
+		ASSERT(stats.nRecord == TEST_BINLOG_NTHREAD * TEST_BINLOG_NRECORD, "Records not written.");
+		ASSERT(stats.nError == 0, "Write error.");
+		binlog_destroy(&pLog);
+		ASSERT(NULL == pLog, "Log not destroyed.");
+
+		ASSERT(stats.nFile > 1, "Files not rotated.");
+		test_binlogCheckFiles(stats.nFile);
+	}
+}
+
+void test_binlogDrop(void) {
+	binlogCfg_t cfg;
+	binlogStats_t stats;
+	binlog_t *pLog = NULL;
+	uint32_t i, nOk;
+	char filename[64];
+
+	cfg.filenameFormat = TEST_BINLOG_FORMAT;
+	cfg.nSlot = 4;
+	cfg.maxRecordSize = sizeof(i);
+	cfg.batchSize = 4096;
+	cfg.maxFileSize = 0;
+	cfg.maxFileMs = 0;
+	cfg.flushMs = 0;
+	cfg.isDirect = 0;
+	ASSERT(binlog_create(&pLog, &cfg) == STATUS_OK, "Failed to create log.");
+
+	/* Much faster than the writer thread polls */
+	nOk = 0;
+	for (i = 0; i < 1000; i++) {
+		nOk += (binlog_write(pLog, 0, &i, sizeof(i)) == STATUS_OK);
+	}
+	ASSERT(binlog_write(pLog, 0, &i, sizeof(i) + 1) == STATUS_ERROR_PARAM, "Oversized record accepted.");
+
+	test_binlogWaitRecord(pLog, nOk, &stats);
+	ASSERT(nOk < 1000 && stats.nDrop == 1000 - nOk, "Incorrect drop count.");
+	ASSERT(stats.nRecord == nOk && stats.nFile == 1, "Incorrect record count.");
+	binlog_destroy(&pLog);
+	snprintf(filename, sizeof(filename), TEST_BINLOG_FORMAT, 0);
+	remove(filename);
+
+	cfg.nSlot = 6;
+	ASSERT(binlog_create(&pLog, &cfg) == STATUS_ERROR_PARAM, "Invalid number of slots accepted.");
+	cfg.nSlot = 4;
+	cfg.batchSize = 1000;
+	ASSERT(binlog_create(&pLog, &cfg) == STATUS_ERROR_PARAM, "Invalid batch size accepted.");
+	cfg.batchSize = 4096;
+	cfg.filenameFormat = "no_such_dir/test_%u.bin";
+	ASSERT(binlog_create(&pLog, &cfg) == STATUS_ERROR_FILE_OPEN, "Missing directory accepted.");
+	ASSERT(NULL == pLog, "Log created on error.");
+}
+
+/**
+ * @brief Write n records of 4 bytes, waiting for the writer thread if dropped.
+ */
+static void test_binlogWriteN(binlog_t *pLog, uint32_t n) {
+	uint32_t i;
+
+	for (i = 0; i < n; i++) {
+		while (binlog_write(pLog, 0, &i, sizeof(i)) != STATUS_OK) {
+			sched_yield();
+		}
+	}
+}
+
+void test_binlogRotateFail(void) {
+	binlogCfg_t cfg;
+	binlogStats_t stats;
+	binlog_t *pLog = NULL;
+	struct stat st;
+	char filename[64];
+	uint32_t i;
+
+	cfg.filenameFormat = TEST_BINLOG_FORMAT;
+	cfg.nSlot = 64;
+	cfg.maxRecordSize = sizeof(i);
+	cfg.batchSize = 4096;
+	/* 10 records per file */
+	cfg.maxFileSize = 10 * BINLOG_getRecordSize(sizeof(i));
+	cfg.maxFileMs = 0;
+	cfg.flushMs = 0;
+	cfg.isDirect = 0;
+
+	/* A directory in place of the second file, so that it fails to open */
+	snprintf(filename, sizeof(filename), TEST_BINLOG_FORMAT, 1);
+	ASSERT(mkdir(filename, 0755) == 0, "Failed to create directory.");
+	ASSERT(binlog_create(&pLog, &cfg) == STATUS_OK, "Failed to create log.");
+
+	test_binlogWriteN(pLog, 55);
+	test_binlogWaitRecord(pLog, 55, &stats);
+	ASSERT(stats.nRecord == 55 && stats.nFile == 1, "Incorrect record count.");
+	/* Once when file 0 is full, then after each 10 records without file */
+	ASSERT(stats.nOpenFail == 5, "Incorrect number of failed rotations.");
+
+	/* The next rotation opens file 1 again */
+	rmdir(filename);
+	test_binlogWriteN(pLog, 10);
+	test_binlogWaitRecord(pLog, 65, &stats);
+	ASSERT(stats.nFile == 2 && stats.nOpenFail == 5, "File not opened after failed rotation.");
+	binlog_destroy(&pLog);
+
+	ASSERT(stat(filename, &st) == 0 && S_ISREG(st.st_mode), "Rotation skipped file index.");
+	for (i = 0; i < 2; i++) {
+		snprintf(filename, sizeof(filename), TEST_BINLOG_FORMAT, i);
+		remove(filename);
+	}
+}
+
+void test_binlogAll(void) {
+	test_binlogWrite();
+	test_binlogDrop();
+	test_binlogRotateFail();
+}
@@ -0,0 +1,38 @@
+/*
+ * test_binlog.h
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: chiong
+ */
+
+#ifndef TEST_TEST_BINLOG_H_
+#define TEST_TEST_BINLOG_H_
+
+/**
+ * @details Test all
+ */
+void test_binlogAll(void);
+
+/**
+ * @details Test includes:
+ * 		1. Concurrent binlog_write() from several threads, read back in order
+ * 		   from files rotated by size, with and without O_DIRECT.
+ * 		2. Record alignment and padding in file.
+ */
+void test_binlogWrite(void);
+
+/**
+ * @details Test includes:
+ * 		1. Records dropped and counted when the queue is full, never blocking.
+ * 		2. Oversized record and invalid configurations.
+ */
+void test_binlogDrop(void);
+
+/**
+ * @details Test includes:
+ * 		1. A file that fails to open on rotation is counted once per rotation,
+ * 		   and is opened with the same file index at the next rotation.
+ */
+void test_binlogRotateFail(void);
+
+#endif /* TEST_TEST_BINLOG_H_ */
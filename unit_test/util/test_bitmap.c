@@ -0,0 +1,316 @@
+/*
+ * test_bitmap.c
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: chiong
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include "util/bitmap.h"
+#include "debug/assert.h"
+#include "test_bitmap.h"
+
+#define TEST_BITMAP_NAME		"test_bitmap.bmp"
+/* Odd width so that rows of every depth are padded. */
+#define TEST_BITMAP_WIDTH		(13)
+#define TEST_BITMAP_HEIGHT		(7)
+/* Number of colors in palette of 8-bit BMP, less than 256 to test colorUsed. */
+#define TEST_BITMAP_NCOLOR_8	(40)
+/* 16-bit BMP with 5-6-5 bit fields instead of default 5-5-5. */
+#define TEST_BITMAP_DEPTH_565	(17)
+
+static void test_bitmapPut16(FILE *f, uint16_t val) {
+	fputc(val & 0xFF, f);
+	fputc(val >> 8, f);
+}
+
+static void test_bitmapPut32(FILE *f, uint32_t val) {
+	test_bitmapPut16(f, val & 0xFFFF);
+	test_bitmapPut16(f, val >> 16);
+}
+
+static uint32_t test_bitmapNumColor(uint32_t depth) {
+	return 8 == depth? TEST_BITMAP_NCOLOR_8 : 1u << depth;
+}
+
+static uint32_t test_bitmapPalette(uint32_t i) {
+	return (((i * 37) & 0xFF) << 16) | (((i * 91) & 0xFF) << 8) | (255 - i);
+}
+
+/**
+ * @brief Value of pixel (x, y) as stored in file, palette index for depth up to 8.
+ */
+static uint32_t test_bitmapRaw(uint32_t depth, uint32_t x, uint32_t y) {
+	switch (depth) {
+	case 1:
+	case 4:
+	case 8:
+		return (x * 3 + y * 5) % test_bitmapNumColor(depth);
+	case 16:
+		return (x * 1021 + y * 331) & 0x7FFF;
+	case TEST_BITMAP_DEPTH_565:
+		return (x * 1021 + y * 331) & 0xFFFF;
+	case 24:
+		return (x * 40503 + y * 9973 + 0x123456) & 0xFFFFFF;
+	default:
+		return ((x * 40503 + y * 9973 + 0x123456) & 0xFFFFFF) | 0xAB000000;
+	}
+}
+
+/**
+ * @brief Expected 0x00RRGGBB of pixel (x, y).
+ */
+static uint32_t test_bitmapColor(uint32_t depth, uint32_t x, uint32_t y) {
+	uint32_t raw, r, g, b;
+
+	raw = test_bitmapRaw(depth, x, y);
+	switch (depth) {
+	case 1:
+	case 4:
+	case 8:
+		return test_bitmapPalette(raw);
+	case 16:
+		r = (raw >> 10) & 0x1F;
+		g = (raw >> 5) & 0x1F;
+		b = raw & 0x1F;
+		return (((r << 3) | (r >> 2)) << 16) | (((g << 3) | (g >> 2)) << 8) | ((b << 3) | (b >> 2));
+	case TEST_BITMAP_DEPTH_565:
+		r = (raw >> 11) & 0x1F;
+		g = (raw >> 5) & 0x3F;
+		b = raw & 0x1F;
+		return (((r << 3) | (r >> 2)) << 16) | (((g << 2) | (g >> 4)) << 8) | ((b << 3) | (b >> 2));
+	default:
+		return raw & 0xFFFFFF;
+	}
+}
+
+/**
+ * @brief Write a TEST_BITMAP_WIDTH x TEST_BITMAP_HEIGHT BMP with padding bytes of 0xEE.
+ * @param[in] depth Bits per pixel, or TEST_BITMAP_DEPTH_565.
+ * @param[in] isTopDown Non-zero to store top row first, with negative height.
+ * @param[in] compression Compression written to header, -1 for the right one.
+ */
+static void test_bitmapWrite(uint32_t depth, uint8_t isTopDown, int32_t compression) {
+	FILE *f;
+	uint32_t bitCount, stride, nColor, offBits, headerSize;
+	uint32_t x, y, row, i;
+	uint32_t raw;
+	uint8_t line[TEST_BITMAP_WIDTH * 4 + 4];
+
+	bitCount = TEST_BITMAP_DEPTH_565 == depth? 16 : depth;
+	stride = (TEST_BITMAP_WIDTH * bitCount + 31) / 32 * 4;
+	nColor = bitCount <= 8? test_bitmapNumColor(depth) : 0;
+	headerSize = BITMAP_HEADER_SIZE + (TEST_BITMAP_DEPTH_565 == depth? 12 : 0);
+	offBits = headerSize + nColor * 4;
+	if (compression < 0) {
+		compression = TEST_BITMAP_DEPTH_565 == depth? BITMAP_COMPRESSION_BITFIELDS : BITMAP_COMPRESSION_RGB;
+	}
+
+	f = fopen(TEST_BITMAP_NAME, "wb");
+	fputc('B', f);
+	fputc('M', f);
+	test_bitmapPut32(f, offBits + stride * TEST_BITMAP_HEIGHT);
+	test_bitmapPut32(f, 0);
+	test_bitmapPut32(f, offBits);
+	test_bitmapPut32(f, BITMAP_IMAGE_HEADER_SIZE);
+	test_bitmapPut32(f, TEST_BITMAP_WIDTH);
+	test_bitmapPut32(f, isTopDown? (uint32_t) -TEST_BITMAP_HEIGHT : TEST_BITMAP_HEIGHT);
+	test_bitmapPut16(f, 1);
+	test_bitmapPut16(f, bitCount);
+	test_bitmapPut32(f, (uint32_t) compression);
+	test_bitmapPut32(f, stride * TEST_BITMAP_HEIGHT);
+	test_bitmapPut32(f, 2835);
+	test_bitmapPut32(f, 2835);
+	test_bitmapPut32(f, 8 == depth? nColor : 0);
+	test_bitmapPut32(f, 0);
+	if (TEST_BITMAP_DEPTH_565 == depth) {
+		test_bitmapPut32(f, 0xF800);
+		test_bitmapPut32(f, 0x07E0);
+		test_bitmapPut32(f, 0x001F);
+	}
+	for (i = 0; i < nColor; i++) {
+		test_bitmapPut32(f, test_bitmapPalette(i) | 0xCC000000);
+	}
+
+	for (row = 0; row < TEST_BITMAP_HEIGHT; row++) {
+		y = isTopDown? row : TEST_BITMAP_HEIGHT - 1 - row;
+		memset(line, 0, sizeof(line));
+		for (x = 0; x < TEST_BITMAP_WIDTH; x++) {
+			raw = test_bitmapRaw(depth, x, y);
+			switch (bitCount) {
+			case 1:
+				line[x >> 3] |= raw << (7 - (x & 7));
+				break;
+			case 4:
+				line[x >> 1] |= raw << ((x & 1)? 0 : 4);
+				break;
+			default:
+				for (i = 0; i < bitCount / 8; i++) {
+					line[x * bitCount / 8 + i] = (raw >> (i * 8)) & 0xFF;
+				}
+				break;
+			}
+		}
+		for (i = (TEST_BITMAP_WIDTH * bitCount + 7) / 8; i < stride; i++) {
+			line[i] = 0xEE;
+		}
+		fwrite(line, 1, stride, f);
+	}
+	fclose(f);
+}
+
+/**
+ * @brief Check that pixels equal the expected colors of columns x to x + w - 1
+ * 		of rows y to y + h - 1.
+ */
+static uint8_t test_bitmapCheck(const uint32_t *pixel, uint32_t depth, uint32_t x, uint32_t y, uint32_t w, uint32_t h) {
+	uint32_t i, j;
+
+	for (j = 0; j < h; j++) {
+		for (i = 0; i < w; i++) {
+			if (*pixel++ != test_bitmapColor(depth, x + i, y + j)) {
+				return 0;
+			}
+		}
+	}
+	return 1;
+}
+
+void test_bitmapDecode(void) {
+	const uint32_t depth[] = {1, 4, 8, 16, TEST_BITMAP_DEPTH_565, 24, 32};
+	uint32_t pixel[TEST_BITMAP_WIDTH * TEST_BITMAP_HEIGHT];
+	bitmapReader_t *pReader;
+	bitmap_t *pBitmap;
+	uint32_t d, isTopDown;
+	int32_t n;
+	FILE *f;
+
+	for (d = 0; d < sizeof(depth) / sizeof(depth[0]); d++) {
+		for (isTopDown = 0; isTopDown < 2; isTopDown++) {
+			test_bitmapWrite(depth[d], isTopDown, -1);
+			ASSERT(bitmap_readerOpen(&pReader, TEST_BITMAP_NAME) == STATUS_OK, "Failed to open BMP.");
+			ASSERT(bitmap_readerGetWidth(pReader) == TEST_BITMAP_WIDTH &&
+					bitmap_readerGetHeight(pReader) == TEST_BITMAP_HEIGHT, "Incorrect dimension.");
+
+			memset(pixel, 0, sizeof(pixel));
+			n = bitmap_readRows(pReader, pixel, 1, BITMAP_PIXEL_FMT_ARGB32);
+			ASSERT(n == 1 && test_bitmapCheck(pixel, depth[d], 0, 0, TEST_BITMAP_WIDTH, 1),
+					"Incorrect first row.");
+			n = bitmap_readRows(pReader, pixel, 3, BITMAP_PIXEL_FMT_ARGB32);
+			ASSERT(n == 3 && test_bitmapCheck(pixel, depth[d], 0, 1, TEST_BITMAP_WIDTH, 3),
+					"Incorrect middle rows.");
+			n = bitmap_readRows(pReader, pixel, TEST_BITMAP_HEIGHT, BITMAP_PIXEL_FMT_ARGB32);
+			ASSERT(n == TEST_BITMAP_HEIGHT - 4 && test_bitmapCheck(pixel, depth[d], 0, 4, TEST_BITMAP_WIDTH, n),
+					"Incorrect last rows.");
+			ASSERT(bitmap_readRows(pReader, pixel, 1, BITMAP_PIXEL_FMT_ARGB32) == 0, "Read past last row.");
+			bitmap_readerClose(&pReader);
+			ASSERT(pReader == NULL, "Reader not NULL after close.");
+		}
+	}
+
+	test_bitmapWrite(24, 0, -1);
+	ASSERT(bitmap_readFile(&pBitmap, TEST_BITMAP_NAME) == STATUS_OK, "Failed to read BMP.");
+	ASSERT(pBitmap->imageHeader.width == TEST_BITMAP_WIDTH &&
+			pBitmap->imageHeader.height == TEST_BITMAP_HEIGHT &&
+			pBitmap->imageHeader.bitCount == 24, "Incorrect header.");
+	ASSERT(test_bitmapCheck(pBitmap->image, 24, 0, 0, TEST_BITMAP_WIDTH, TEST_BITMAP_HEIGHT),
+			"Incorrect image.");
+	bitmap_destroy(&pBitmap);
+
+	/* Truncated after 2 rows */
+	ASSERT(truncate(TEST_BITMAP_NAME, BITMAP_HEADER_SIZE + 2 * 40) == 0, "Failed to truncate.");
+	ASSERT(bitmap_readerOpen(&pReader, TEST_BITMAP_NAME) == STATUS_OK, "Failed to open truncated BMP.");
+	ASSERT(bitmap_readRows(pReader, pixel, TEST_BITMAP_HEIGHT, BITMAP_PIXEL_FMT_ARGB32) == STATUS_ERROR,
+			"Truncated BMP read.");
+	ASSERT(bitmap_readRows(pReader, pixel, 1, 99) == STATUS_ERROR_PARAM, "Invalid format accepted.");
+	bitmap_readerClose(&pReader);
+
+	/* RLE8 */
+	test_bitmapWrite(8, 0, 1);
+	ASSERT(bitmap_readerOpen(&pReader, TEST_BITMAP_NAME) == STATUS_ERROR, "Compressed BMP opened.");
+
+	f = fopen(TEST_BITMAP_NAME, "wb");
+	fputs("not a bitmap", f);
+	fclose(f);
+	ASSERT(bitmap_readerOpen(&pReader, TEST_BITMAP_NAME) == STATUS_ERROR, "Not a BMP opened.");
+
+	remove(TEST_BITMAP_NAME);
+	ASSERT(bitmap_readerOpen(&pReader, TEST_BITMAP_NAME) == STATUS_ERROR_FILE_OPEN, "Missing file opened.");
+}
+
+void test_bitmapPack(void) {
+	uint32_t pixel[TEST_BITMAP_WIDTH * TEST_BITMAP_HEIGHT];
+	uint8_t packed[TEST_BITMAP_WIDTH * TEST_BITMAP_HEIGHT * 3];
+	uint8_t expect[TEST_BITMAP_WIDTH * TEST_BITMAP_HEIGHT * 3];
+	uint8_t nibble[TEST_BITMAP_WIDTH * TEST_BITMAP_HEIGHT * 3 + 1];
+	bitmapReader_t *pReader;
+	uint32_t i, c, size;
+	int32_t n;
+
+	test_bitmapWrite(24, 0, -1);
+	for (i = 0; i < TEST_BITMAP_WIDTH * TEST_BITMAP_HEIGHT; i++) {
+		pixel[i] = test_bitmapColor(24, i % TEST_BITMAP_WIDTH, i / TEST_BITMAP_WIDTH);
+	}
+
+	/* RGB565 */
+	for (i = 0; i < TEST_BITMAP_WIDTH * TEST_BITMAP_HEIGHT; i++) {
+		c = ((pixel[i] >> 8) & 0xF800) | ((pixel[i] >> 5) & 0x07E0) | ((pixel[i] >> 3) & 0x001F);
+		expect[i * 2] = c >> 8;
+		expect[i * 2 + 1] = c & 0xFF;
+	}
+	ASSERT(bitmap_readerOpen(&pReader, TEST_BITMAP_NAME) == STATUS_OK, "Failed to open BMP.");
+	n = bitmap_readRows(pReader, packed, TEST_BITMAP_HEIGHT, BITMAP_PIXEL_FMT_RGB565);
+	size = BITMAP_getPackedSize(BITMAP_PIXEL_FMT_RGB565, TEST_BITMAP_WIDTH * TEST_BITMAP_HEIGHT);
+	ASSERT(n == TEST_BITMAP_HEIGHT && memcmp(packed, expect, size) == 0, "Incorrect RGB565.");
+	bitmap_readerClose(&pReader);
+
+	/* RGB666 */
+	for (i = 0; i < TEST_BITMAP_WIDTH * TEST_BITMAP_HEIGHT; i++) {
+		expect[i * 3] = (pixel[i] >> 16) & 0xFC;
+		expect[i * 3 + 1] = (pixel[i] >> 8) & 0xFC;
+		expect[i * 3 + 2] = pixel[i] & 0xFC;
+	}
+	ASSERT(bitmap_readerOpen(&pReader, TEST_BITMAP_NAME) == STATUS_OK, "Failed to open BMP.");
+	n = bitmap_readRows(pReader, packed, TEST_BITMAP_HEIGHT, BITMAP_PIXEL_FMT_RGB666);
+	size = BITMAP_getPackedSize(BITMAP_PIXEL_FMT_RGB666, TEST_BITMAP_WIDTH * TEST_BITMAP_HEIGHT);
+	ASSERT(n == TEST_BITMAP_HEIGHT && memcmp(packed, expect, size) == 0, "Incorrect RGB666.");
+	bitmap_readerClose(&pReader);
+
+	/* RGB444 is a stream of nibbles R G B R G B ..., pairs of rows hold an
+	 * even number of pixels, the last odd row ends with a half byte. */
+	for (i = 0; i < TEST_BITMAP_WIDTH * TEST_BITMAP_HEIGHT; i++) {
+		nibble[i * 3] = (pixel[i] >> 20) & 0x0F;
+		nibble[i * 3 + 1] = (pixel[i] >> 12) & 0x0F;
+		nibble[i * 3 + 2] = (pixel[i] >> 4) & 0x0F;
+	}
+	nibble[TEST_BITMAP_WIDTH * TEST_BITMAP_HEIGHT * 3] = 0;
+	ASSERT(bitmap_readerOpen(&pReader, TEST_BITMAP_NAME) == STATUS_OK, "Failed to open BMP.");
+	for (i = 0; i < TEST_BITMAP_HEIGHT; i += n) {
+		n = bitmap_readRows(pReader, packed, 2, BITMAP_PIXEL_FMT_RGB444);
+		size = BITMAP_getPackedSize(BITMAP_PIXEL_FMT_RGB444, TEST_BITMAP_WIDTH * n);
+		for (c = 0; c < size; c++) {
+			expect[c] = (nibble[i * TEST_BITMAP_WIDTH * 3 + c * 2] << 4) | nibble[i * TEST_BITMAP_WIDTH * 3 + c * 2 + 1];
+		}
+		ASSERT(n > 0 && memcmp(packed, expect, size) == 0, "Incorrect RGB444.");
+	}
+	bitmap_readerClose(&pReader);
+
+	/* Columns 3 to 7 only */
+	ASSERT(bitmap_readerOpen(&pReader, TEST_BITMAP_NAME) == STATUS_OK, "Failed to open BMP.");
+	ASSERT(bitmap_readerSetColumns(pReader, 3, TEST_BITMAP_WIDTH) == STATUS_ERROR_PARAM,
+			"Columns beyond image accepted.");
+	ASSERT(bitmap_readerSetColumns(pReader, 3, 5) == STATUS_OK, "Failed to set columns.");
+	n = bitmap_readRows(pReader, pixel, TEST_BITMAP_HEIGHT, BITMAP_PIXEL_FMT_ARGB32);
+	ASSERT(n == TEST_BITMAP_HEIGHT && test_bitmapCheck(pixel, 24, 3, 0, 5, TEST_BITMAP_HEIGHT),
+			"Incorrect columns.");
+	bitmap_readerClose(&pReader);
+
+	remove(TEST_BITMAP_NAME);
+}
+
+void test_bitmapAll(void) {
+	test_bitmapDecode();
+	test_bitmapPack();
+}
@@ -0,0 +1,34 @@
+/*
+ * test_bitmap.h
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: chiong
+ */
+
+#ifndef TEST_TEST_BITMAP_H_
+#define TEST_TEST_BITMAP_H_
+
+/**
+ * @details Test all
+ */
+void test_bitmapAll(void);
+
+/**
+ * @details Test includes:
+ * 		1. bitmap_readRows() of 1, 4, 8, 16, 24 and 32-bit BMP with odd width, both
+ * 		   bottom-up and top-down, read in parts of different sizes.
+ * 		2. 16-bit BMP with 5-6-5 bit fields.
+ * 		3. bitmap_readFile() of 24-bit BMP.
+ * 		4. Missing file, truncated file and unsupported compression.
+ */
+void test_bitmapDecode(void);
+
+/**
+ * @details Test includes:
+ * 		1. Conversion into RGB565 and RGB666.
+ * 		2. Conversion into RGB444 with an odd number of pixels per row.
+ * 		3. bitmap_readerSetColumns().
+ */
+void test_bitmapPack(void);
+
+#endif /* TEST_TEST_BITMAP_H_ */
@@ -6,6 +6,8 @@
  */
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include "util/buffer.h"
 #include "debug/assert.h"
 #include "test_buffer.h"
@@ -155,8 +157,11 @@ void test_buffer2dPutGetCol(void) {
 }
 
 void test_buffer2dFill(void) {
+	const uint32_t elemSize[] = { 1, 2, 3, 4, 8, 12, 16 };
 	buffer2d_t *pBuffer = NULL;
-	uint32_t i, count;
+	const uint8_t *pByte;
+	uint8_t elem[16];
+	uint32_t i, k, count;
 	float val;
 	float *pData;
 
@@ -171,6 +176,479 @@ void test_buffer2dFill(void) {
 	}
 	buffer2d_destroy(&pBuffer);
 
+	/* Element sizes not power of 2, repeated bytes, and more than a fill chunk */
+	for (k = 0; k < sizeof(elemSize) / sizeof(elemSize[0]); k++) {
+		for (i = 0; i < elemSize[k]; i++) {
+			elem[i] = (uint8_t) (0 == (k & 1) ? i + 1 : 0x5A);
+		}
+		buffer2d_create(&pBuffer, 1000, 3, elemSize[k], BUFFER2D_LAYOUT_COLUMN_WISE);
+		buffer2d_fill(pBuffer, elem);
+		pByte = (const uint8_t*) buffer2d_getBuffer(pBuffer);
+		for (i = 0; i < 1000 * 3 * elemSize[k]; i++) {
+			ASSERT(pByte[i] == elem[i % elemSize[k]], "Incorrect fill() of element size.");
+		}
+		buffer2d_destroy(&pBuffer);
+	}
+}
+
+void test_buffer2dView(void) {
+	buffer2d_t *pRowWise = NULL;
+	buffer2d_t *pColWise = NULL;
+	buffer2dView_t view, src;
+	uint32_t i, j;
+	uint16_t val;
+	uint16_t col[TEST_BUFFER2D_NROW];
+
+	buffer2d_create(&pRowWise, TEST_BUFFER2D_NROW, TEST_BUFFER2D_NCOL, sizeof(val), BUFFER2D_LAYOUT_ROW_WISE);
+	buffer2d_create(&pColWise, TEST_BUFFER2D_NROW, TEST_BUFFER2D_NCOL, sizeof(val), BUFFER2D_LAYOUT_COLUMN_WISE);
+	for (i = 0; i < TEST_BUFFER2D_NROW; i++) {
+		for (j = 0; j < TEST_BUFFER2D_NCOL; j++) {
+			val = i * 100 + j;
+			buffer2d_putDataSingle(pRowWise, i, j, &val);
+		}
+	}
+
+	/* Views refer to the buffer, without copy */
+	buffer2d_getViewRow(pRowWise, 1, &view);
+	ASSERT(buffer2dView_isContiguous(&view), "Row of row wise buffer must be contiguous.");
+	ASSERT(*(uint16_t*) BUFFER2DVIEW_getElemAddr(&view, 0, 3) == 103, "Incorrect row view.");
+	buffer2d_getViewCol(pRowWise, 2, &view);
+	ASSERT(!buffer2dView_isContiguous(&view), "Column of row wise buffer must not be contiguous.");
+	ASSERT(*(uint16_t*) BUFFER2DVIEW_getElemAddr(&view, 2, 0) == 202, "Incorrect column view.");
+	buffer2d_getViewBlock(pRowWise, 1, 2, 2, 3, &view);
+	ASSERT(*(uint16_t*) BUFFER2DVIEW_getElemAddr(&view, 1, 2) == 204, "Incorrect block view.");
+	buffer2dView_getBlock(&view, 1, 1, 1, 1, &view);
+	ASSERT(*(uint16_t*) view.data == 203, "Incorrect block of block view.");
+
+	/* Copy between different layouts */
+	buffer2d_getView(pRowWise, &src);
+	buffer2d_getView(pColWise, &view);
+	buffer2dView_copy(&view, &src);
+	for (i = 0; i < TEST_BUFFER2D_NROW; i++) {
+		for (j = 0; j < TEST_BUFFER2D_NCOL; j++) {
+			buffer2d_getDataSingle(pColWise, i, j, &val);
+			ASSERT(val == i * 100 + j, "Incorrect copy between layouts.");
+		}
+	}
+
+	/* Copy a column to plain array */
+	buffer2d_getViewCol(pRowWise, 4, &src);
+	buffer2dView_init(&view, col, TEST_BUFFER2D_NROW, 1, sizeof(val), BUFFER2D_LAYOUT_COLUMN_WISE);
+	buffer2dView_copy(&view, &src);
+	for (i = 0; i < TEST_BUFFER2D_NROW; i++) {
+		ASSERT(col[i] == i * 100 + 4, "Incorrect copy of column.");
+	}
+
+	/* Fill a block only */
+	val = 0xFFFF;
+	buffer2d_getViewBlock(pColWise, 0, 1, 2, 2, &view);
+	buffer2dView_fill(&view, &val);
+	for (i = 0; i < TEST_BUFFER2D_NROW; i++) {
+		for (j = 0; j < TEST_BUFFER2D_NCOL; j++) {
+			buffer2d_getDataSingle(pColWise, i, j, &val);
+			if (i < 2 && (j == 1 || j == 2)) {
+				ASSERT(val == 0xFFFF, "Block not filled.");
+			} else {
+				ASSERT(val == i * 100 + j, "Fill outside of block.");
+			}
+		}
+	}
+
+	buffer2d_destroy(&pRowWise);
+	buffer2d_destroy(&pColWise);
+}
+
+void test_buffer2dTyped(void) {
+	buffer2d_t *pBuffer[2] = { NULL, NULL };
+	uint32_t layout[2] = { BUFFER2D_LAYOUT_ROW_WISE, BUFFER2D_LAYOUT_COLUMN_WISE };
+	int16_t row16[TEST_BUFFER2D_NCOL], col16[TEST_BUFFER2D_NROW];
+	float rowF[TEST_BUFFER2D_NCOL], colF[TEST_BUFFER2D_NROW];
+	complexf_t rowC[TEST_BUFFER2D_NCOL];
+	complexf_t valC;
+	int32_t val32;
+	float valF;
+	uint32_t i, j, k;
+
+	for (k = 0; k < 2; k++) {
+		buffer2d_create(&pBuffer[k], TEST_BUFFER2D_NROW, TEST_BUFFER2D_NCOL, sizeof(int16_t), layout[k]);
+
+		/* Single, checked against generic path */
+		for (i = 0; i < TEST_BUFFER2D_NROW; i++) {
+			for (j = 0; j < TEST_BUFFER2D_NCOL; j++) {
+				buffer2d_putDataSingleI16(pBuffer[k], i, j, (int16_t) (i * 100 + j - 200));
+			}
+		}
+		for (i = 0; i < TEST_BUFFER2D_NROW; i++) {
+			for (j = 0; j < TEST_BUFFER2D_NCOL; j++) {
+				buffer2d_getDataSingle(pBuffer[k], i, j, &row16[0]);
+				ASSERT(row16[0] == (int16_t) (i * 100 + j - 200), "Incorrect typed single put.");
+				ASSERT(buffer2d_getDataSingleI16(pBuffer[k], i, j) == row16[0], "Incorrect typed single get.");
+			}
+		}
+
+		/* Row and column */
+		for (j = 0; j < TEST_BUFFER2D_NCOL; j++) {
+			row16[j] = (int16_t) (-j);
+		}
+		buffer2d_putDataRowI16(pBuffer[k], 1, row16);
+		MCBUFFER_getDataAtChannelAs(pBuffer[k], 3, col16, I16);
+		ASSERT(col16[0] == -197 && col16[1] == -3 && col16[2] == 3, "Incorrect typed column get.");
+
+		for (i = 0; i < TEST_BUFFER2D_NROW; i++) {
+			col16[i] = (int16_t) (1000 + i);
+		}
+		buffer2d_putDataColI16(pBuffer[k], 4, col16);
+		buffer2d_getDataRowI16(pBuffer[k], 1, row16);
+		for (j = 0; j < TEST_BUFFER2D_NCOL; j++) {
+			ASSERT(row16[j] == ((j == 4) ? 1001 : (int16_t) (-j)), "Incorrect typed row get.");
+		}
+		buffer2d_destroy(&pBuffer[k]);
+
+		/* float and complex float */
+		buffer2d_create(&pBuffer[k], TEST_BUFFER2D_NROW, TEST_BUFFER2D_NCOL, sizeof(float), layout[k]);
+		for (i = 0; i < TEST_BUFFER2D_NROW; i++) {
+			colF[i] = 0.5f * i;
+		}
+		MCBUFFER_putDataAtChannelAs(pBuffer[k], 2, colF, F32);
+		buffer2d_getDataRowF32(pBuffer[k], 2, rowF);
+		ASSERT(rowF[2] == 1.0f, "Incorrect typed float access.");
+		val32 = buffer2d_getDataSingleI32(pBuffer[k], 1, 2);
+		memcpy(&valF, &val32, sizeof(valF));
+		ASSERT(valF == 0.5f, "Incorrect typed int32 access.");
+		buffer2d_destroy(&pBuffer[k]);
+
+		buffer2d_create(&pBuffer[k], TEST_BUFFER2D_NROW, TEST_BUFFER2D_NCOL, sizeof(complexf_t), layout[k]);
+		for (j = 0; j < TEST_BUFFER2D_NCOL; j++) {
+			rowC[j].r = (float) j;
+			rowC[j].i = 2.0f * j;
+		}
+		MCBUFFER_putDataAtIndexAs(pBuffer[k], 2, rowC, CF32);
+		valC = buffer2d_getDataSingleCF32(pBuffer[k], 2, 3);
+		ASSERT(valC.r == 3.0f && valC.i == 6.0f, "Incorrect typed complex access.");
+		buffer2d_destroy(&pBuffer[k]);
+	}
+}
+
+/**
+ * @brief Fill buffer with element (i, j) = i * 1000 + j, truncated to elemSize bytes.
+ */
+static void test_buffer2dFillIndex(buffer2d_t *pBuffer) {
+	uint64_t val;
+	uint32_t i, j;
+
+	for (i = 0; i < buffer2d_getNumRow(pBuffer); i++) {
+		for (j = 0; j < buffer2d_getNumCol(pBuffer); j++) {
+			/* Little endian, the low bytes are kept */
+			val = (uint64_t) i * 1000 + j;
+			buffer2d_putDataSingle(pBuffer, i, j, &val);
+		}
+	}
+}
+
+static uint8_t test_buffer2dCheckIndex(buffer2d_t *pBuffer) {
+	uint64_t val, ref;
+	uint32_t elemSize = buffer2d_getElemSize(pBuffer);
+	uint32_t i, j;
+
+	for (i = 0; i < buffer2d_getNumRow(pBuffer); i++) {
+		for (j = 0; j < buffer2d_getNumCol(pBuffer); j++) {
+			val = 0;
+			ref = 0;
+			buffer2d_getDataSingle(pBuffer, i, j, &val);
+			memcpy(&ref, &(uint64_t) { (uint64_t) i * 1000 + j }, elemSize);
+			if (val != ref) {
+				return 0;
+			}
+		}
+	}
+
+	return 1;
+}
+
+void test_buffer2dLayout(void) {
+	const uint32_t nCh[] = { 1, 2, 3, 4, 6, 8, 16, 20 };
+	const uint32_t elemSize[] = { 1, 2, 3, 4, 8 };
+	/* More than one block of samples, and not a multiple of the unrolling */
+	const uint32_t nFrame = 301;
+	const uint32_t nSample = 37;
+	buffer2d_t *pInter = NULL, *pNonInter = NULL, *pCopy = NULL;
+	buffer2d_t *pF32 = NULL, *pI16 = NULL;
+	float valF;
+	int16_t val16;
+	uint32_t c, e, i;
+
+	for (c = 0; c < sizeof(nCh) / sizeof(nCh[0]); c++) {
+		for (e = 0; e < sizeof(elemSize) / sizeof(elemSize[0]); e++) {
+			MCBUFFER_create(&pInter, nFrame, nCh[c], elemSize[e], MCBUFFER_LAYOUT_INTERLEAVED);
+			MCBUFFER_create(&pNonInter, nFrame, nCh[c], elemSize[e], MCBUFFER_LAYOUT_NON_INTERLEAVED);
+			MCBUFFER_create(&pCopy, nFrame, nCh[c], elemSize[e], MCBUFFER_LAYOUT_INTERLEAVED);
+
+			test_buffer2dFillIndex(pInter);
+			ASSERT(buffer2d_copyLayout(pNonInter, pInter) == STATUS_OK, "Failed to deinterleave.");
+			ASSERT(test_buffer2dCheckIndex(pNonInter), "Incorrect deinterleave.");
+			ASSERT(buffer2d_copyLayout(pCopy, pNonInter) == STATUS_OK, "Failed to interleave.");
+			ASSERT(test_buffer2dCheckIndex(pCopy), "Incorrect interleave.");
+			ASSERT(memcmp(buffer2d_getBuffer(pCopy), buffer2d_getBuffer(pInter),
+					nFrame * nCh[c] * elemSize[e]) == 0, "Interleave round trip differs.");
+
+			/* In place, both directions */
+			ASSERT(MCBUFFER_setLayout(pCopy, MCBUFFER_LAYOUT_NON_INTERLEAVED) == STATUS_OK, "Failed to set layout.");
+			ASSERT(buffer2d_getLayout(pCopy) == MCBUFFER_LAYOUT_NON_INTERLEAVED, "Layout not changed.");
+			ASSERT(test_buffer2dCheckIndex(pCopy), "Incorrect in-place deinterleave.");
+			ASSERT(memcmp(buffer2d_getBuffer(pCopy), buffer2d_getBuffer(pNonInter),
+					nFrame * nCh[c] * elemSize[e]) == 0, "In-place deinterleave differs.");
+			ASSERT(MCBUFFER_setLayout(pCopy, MCBUFFER_LAYOUT_INTERLEAVED) == STATUS_OK, "Failed to set layout.");
+			ASSERT(test_buffer2dCheckIndex(pCopy), "Incorrect in-place interleave.");
+
+			MCBUFFER_destroy(&pInter);
+			MCBUFFER_destroy(&pNonInter);
+			MCBUFFER_destroy(&pCopy);
+		}
+
+		/* Fused conversion, int16 interleaved <-> float non-interleaved */
+		MCBUFFER_create(&pI16, nSample, nCh[c], sizeof(int16_t), MCBUFFER_LAYOUT_INTERLEAVED);
+		MCBUFFER_create(&pF32, nSample, nCh[c], sizeof(float), MCBUFFER_LAYOUT_NON_INTERLEAVED);
+		for (i = 0; i < nSample; i++) {
+			val16 = (int16_t) (i * 1000 - 18000 + c);
+			buffer2d_putDataSingle(pI16, i, nCh[c] - 1, &val16);
+		}
+		ASSERT(buffer2d_convertI16ToF32(pF32, pI16, 1.0f / 32768) == STATUS_OK, "Failed to convert to float.");
+		for (i = 0; i < nSample; i++) {
+			buffer2d_getDataSingle(pF32, i, nCh[c] - 1, &valF);
+			ASSERT(valF == (float) (int16_t) (i * 1000 - 18000 + c) / 32768, "Incorrect conversion to float.");
+		}
+
+		/* Scale by 2 so that the last samples saturate */
+		valF = 0.25f;
+		buffer2d_putDataSingle(pF32, 0, 0, &valF);
+		ASSERT(buffer2d_convertF32ToI16(pI16, pF32, 65536.0f) == STATUS_OK, "Failed to convert to int16.");
+		buffer2d_getDataSingle(pI16, 0, 0, &val16);
+		ASSERT(val16 == 16384, "Incorrect conversion to int16.");
+		for (i = 0; i < nSample; i++) {
+			buffer2d_getDataSingle(pI16, i, nCh[c] - 1, &val16);
+			if (0 == i && 1 == nCh[c]) {
+				/* Overwritten by 0.25 above */
+				continue;
+			} else if (i * 1000 + c >= 34384) {
+				ASSERT(val16 == 32767, "Conversion to int16 not saturated.");
+			} else if (i * 1000 + c <= 1616) {
+				ASSERT(val16 == -32768, "Conversion to int16 not saturated.");
+			} else {
+				ASSERT(val16 == (int16_t) (2 * (i * 1000 - 18000 + c)), "Incorrect conversion to int16.");
+			}
+		}
+		MCBUFFER_destroy(&pI16);
+		MCBUFFER_destroy(&pF32);
+	}
+
+	/* Mismatched dimension */
+	MCBUFFER_create(&pInter, 4, 2, sizeof(int16_t), MCBUFFER_LAYOUT_INTERLEAVED);
+	MCBUFFER_create(&pF32, 4, 3, sizeof(float), MCBUFFER_LAYOUT_NON_INTERLEAVED);
+	ASSERT(buffer2d_convertI16ToF32(pF32, pInter, 1.0f) == STATUS_ERROR_PARAM, "Mismatched dimension accepted.");
+	ASSERT(buffer2d_copyLayout(pF32, pInter) == STATUS_ERROR_PARAM, "Mismatched element size accepted.");
+	MCBUFFER_destroy(&pInter);
+	MCBUFFER_destroy(&pF32);
+}
+
+void test_buffer2dCreateEx(void) {
+	uint32_t layout[2] = { BUFFER2D_LAYOUT_ROW_WISE, BUFFER2D_LAYOUT_COLUMN_WISE };
+	buffer2dCfg_t cfg;
+	buffer2d_t *pBuffer = NULL, *pPlain = NULL;
+	buffer2dView_t view;
+	uint8_t *mem;
+	uint8_t *raw;
+	int16_t col[TEST_BUFFER2D_NROW];
+	int16_t val;
+	uint32_t size, nLine, lineSize;
+	uint32_t i, j, k;
+
+	for (k = 0; k < 2; k++) {
+		cfg.nRow = TEST_BUFFER2D_NROW;
+		cfg.nCol = TEST_BUFFER2D_NCOL;
+		cfg.elemSize = sizeof(int16_t);
+		cfg.layout = layout[k];
+		cfg.alignment = 32;
+		cfg.pad = 1;
+		cfg.mem = NULL;
+
+		/* Owned memory, zeroed */
+		ASSERT(buffer2d_createEx(&pBuffer, &cfg) == STATUS_OK, "Failed to create padded buffer.");
+		ASSERT(buffer2d_getLeadingDim(pBuffer) == 16, "Incorrect leading dimension.");
+		ASSERT(buffer2d_getMemSize(&cfg) == 16 * sizeof(int16_t) * ((0 == k) ? TEST_BUFFER2D_NROW : TEST_BUFFER2D_NCOL),
+				"Incorrect memory size.");
+		for (j = 0; j < TEST_BUFFER2D_NCOL; j++) {
+			for (i = 0; i < TEST_BUFFER2D_NROW; i++) {
+				ASSERT(buffer2d_getDataSingleI16(pBuffer, i, j) == 0, "Memory not zeroed.");
+			}
+			buffer2d_getViewCol(pBuffer, j, &view);
+			ASSERT(1 != k || ((uintptr_t) view.data & 31) == 0, "Column not aligned.");
+		}
+		for (i = 0; i < TEST_BUFFER2D_NROW; i++) {
+			buffer2d_getViewRow(pBuffer, i, &view);
+			ASSERT(0 != k || ((uintptr_t) view.data & 31) == 0, "Row not aligned.");
+		}
+		buffer2d_destroy(&pBuffer);
+
+		/* External memory with a pattern in the padding */
+		size = buffer2d_getMemSize(&cfg);
+		raw = (uint8_t*) malloc(size + 32);
+		mem = (uint8_t*) (((uintptr_t) raw + 31) & ~(uintptr_t) 31);
+		memset(mem, 0xAB, size);
+		cfg.mem = mem;
+		ASSERT(buffer2d_createEx(&pBuffer, &cfg) == STATUS_OK, "Failed to create on external memory.");
+		ASSERT(buffer2d_getBuffer(pBuffer) == mem, "External memory not used.");
+
+		val = 7;
+		buffer2d_fill(pBuffer, &val);
+		for (i = 0; i < TEST_BUFFER2D_NROW; i++) {
+			for (j = 0; j < TEST_BUFFER2D_NCOL; j++) {
+				val = (int16_t) (i * 100 + j);
+				buffer2d_putDataSingle(pBuffer, i, j, &val);
+			}
+		}
+		buffer2d_getDataCol(pBuffer, 3, col);
+		ASSERT(col[0] == 3 && col[1] == 103 && col[2] == 203, "Incorrect column of padded buffer.");
+		buffer2d_getDataColI16(pBuffer, 4, col);
+		ASSERT(col[0] == 4 && col[1] == 104 && col[2] == 204, "Incorrect typed column of padded buffer.");
+
+		/* Same content once converted to a plain buffer */
+		buffer2d_create(&pPlain, TEST_BUFFER2D_NROW, TEST_BUFFER2D_NCOL, sizeof(int16_t), layout[1 - k]);
+		ASSERT(buffer2d_copyLayout(pPlain, pBuffer) == STATUS_OK, "Failed to copy padded buffer.");
+		for (i = 0; i < TEST_BUFFER2D_NROW; i++) {
+			for (j = 0; j < TEST_BUFFER2D_NCOL; j++) {
+				buffer2d_getDataSingle(pPlain, i, j, &val);
+				ASSERT(val == (int16_t) (i * 100 + j), "Incorrect copy of padded buffer.");
+			}
+		}
+		ASSERT(buffer2d_setLayout(pBuffer, layout[1 - k]) == STATUS_ERROR_PARAM, "In-place layout of padded buffer.");
+		buffer2d_destroy(&pPlain);
+
+		/* Nothing written after the end of each line */
+		nLine = (0 == k) ? TEST_BUFFER2D_NROW : TEST_BUFFER2D_NCOL;
+		lineSize = ((0 == k) ? TEST_BUFFER2D_NCOL : TEST_BUFFER2D_NROW) * sizeof(int16_t);
+		for (i = 0; i < nLine; i++) {
+			for (j = lineSize; j < 16 * sizeof(int16_t); j++) {
+				ASSERT(mem[i * 16 * sizeof(int16_t) + j] == 0xAB, "Padding modified.");
+			}
+		}
+		buffer2d_destroy(&pBuffer);
+
+		/* Misaligned external memory */
+		cfg.mem = mem + 2;
+		ASSERT(buffer2d_createEx(&pBuffer, &cfg) == STATUS_ERROR_PARAM, "Misaligned memory accepted.");
+		ASSERT(NULL == pBuffer, "Buffer created on error.");
+		free(raw);
+	}
+
+	/* Invalid alignment and layout */
+	cfg.mem = NULL;
+	cfg.alignment = 24;
+	ASSERT(buffer2d_createEx(&pBuffer, &cfg) == STATUS_ERROR_PARAM, "Invalid alignment accepted.");
+	cfg.alignment = 0;
+	cfg.layout = 2;
+	ASSERT(buffer2d_createEx(&pBuffer, &cfg) == STATUS_ERROR_PARAM, "Invalid layout accepted.");
+}
+
+void test_buffer2dBulk(void) {
+	uint32_t layout[2] = { BUFFER2D_LAYOUT_ROW_WISE, BUFFER2D_LAYOUT_COLUMN_WISE };
+	buffer2dCfg_t cfg;
+	buffer2d_t *pI16 = NULL, *pAcc = NULL, *pI32 = NULL, *pF32 = NULL;
+	int16_t val;
+	uint32_t i, j, k;
+
+	for (k = 0; k < 2; k++) {
+		/* Padded destination, so that each line is a separate run */
+		cfg.nRow = TEST_BUFFER2D_NROW;
+		cfg.nCol = TEST_BUFFER2D_NCOL;
+		cfg.elemSize = sizeof(int16_t);
+		cfg.layout = layout[k];
+		cfg.alignment = 16;
+		cfg.pad = 0;
+		cfg.mem = NULL;
+		buffer2d_createEx(&pI16, &cfg);
+		buffer2d_create(&pAcc, TEST_BUFFER2D_NROW, TEST_BUFFER2D_NCOL, sizeof(int16_t), layout[k]);
+		for (i = 0; i < TEST_BUFFER2D_NROW; i++) {
+			for (j = 0; j < TEST_BUFFER2D_NCOL; j++) {
+				buffer2d_putDataSingleI16(pI16, i, j, (int16_t) (i * 100 + j - 100));
+				buffer2d_putDataSingleI16(pAcc, i, j, (int16_t) (10000 * i));
+			}
+		}
+
+		/* Scale with rounding and saturation */
+		ASSERT(buffer2d_scaleI16(pI16, 0.5f) == STATUS_OK, "Failed to scale.");
+		ASSERT(buffer2d_getDataSingleI16(pI16, 0, 1) == -50, "Incorrect scale.");
+		ASSERT(buffer2d_getDataSingleI16(pI16, 1, 3) == 2, "Incorrect scale rounding.");
+		ASSERT(buffer2d_getDataSingleI16(pI16, 2, 4) == 52, "Incorrect scale.");
+		buffer2d_scaleI16(pI16, 1000.0f);
+		ASSERT(buffer2d_getDataSingleI16(pI16, 0, 0) == -32768, "Incorrect negative saturation.");
+		ASSERT(buffer2d_getDataSingleI16(pI16, 2, 4) == 32767, "Incorrect positive saturation.");
+		ASSERT(buffer2d_getDataSingleI16(pI16, 1, 0) == 0, "Incorrect scale.");
+
+		/* Clip */
+		ASSERT(buffer2d_clipI16(pI16, 1, -1) == STATUS_ERROR_PARAM, "Invalid clip range accepted.");
+		buffer2d_clipI16(pI16, -1000, 2000);
+		ASSERT(buffer2d_getDataSingleI16(pI16, 0, 0) == -1000, "Incorrect clip low.");
+		ASSERT(buffer2d_getDataSingleI16(pI16, 1, 2) == 1000, "Incorrect clip within range.");
+		ASSERT(buffer2d_getDataSingleI16(pI16, 2, 4) == 2000, "Incorrect clip high.");
+
+		/* Accumulate between differently padded buffers, with saturation */
+		ASSERT(buffer2d_accumulateI16(pAcc, pI16, 10.0f) == STATUS_OK, "Failed to accumulate.");
+		ASSERT(buffer2d_getDataSingleI16(pAcc, 0, 0) == -10000, "Incorrect accumulate.");
+		ASSERT(buffer2d_getDataSingleI16(pAcc, 1, 2) == 20000, "Incorrect accumulate.");
+		ASSERT(buffer2d_getDataSingleI16(pAcc, 2, 4) == 32767, "Incorrect accumulate saturation.");
+
+		/* The padding is left alone */
+		val = 0x1234;
+		buffer2d_fill(pI16, &val);
+		for (i = 0; i < ((0 == k) ? TEST_BUFFER2D_NROW : TEST_BUFFER2D_NCOL); i++) {
+			ASSERT(((int16_t*) buffer2d_getBuffer(pI16))[i * buffer2d_getLeadingDim(pI16) + 7] == 0,
+					"Padding modified.");
+		}
+		buffer2d_destroy(&pI16);
+
+		/* Mismatch */
+		buffer2d_create(&pI16, TEST_BUFFER2D_NROW, TEST_BUFFER2D_NCOL, sizeof(int16_t), layout[1 - k]);
+		ASSERT(buffer2d_accumulateI16(pAcc, pI16, 1.0f) == STATUS_ERROR_PARAM, "Different layout accepted.");
+		ASSERT(buffer2d_scaleF32(pAcc, 1.0f) == STATUS_ERROR_PARAM, "Wrong element size accepted.");
+		buffer2d_destroy(&pI16);
+		buffer2d_destroy(&pAcc);
+
+		/* int32 and float, and the conversions between them */
+		buffer2d_create(&pI32, TEST_BUFFER2D_NROW, TEST_BUFFER2D_NCOL, sizeof(int32_t), BUFFER2D_LAYOUT_ROW_WISE);
+		buffer2d_create(&pF32, TEST_BUFFER2D_NROW, TEST_BUFFER2D_NCOL, sizeof(float), layout[k]);
+		for (i = 0; i < TEST_BUFFER2D_NROW; i++) {
+			for (j = 0; j < TEST_BUFFER2D_NCOL; j++) {
+				buffer2d_putDataSingleI32(pI32, i, j, (int32_t) (i * 1000000 + j) * (0 == (j & 1) ? 1 : -1));
+			}
+		}
+		buffer2d_scaleI32(pI32, 2000.0f);
+		ASSERT(buffer2d_getDataSingleI32(pI32, 0, 4) == 8000, "Incorrect int32 scale.");
+		ASSERT(buffer2d_getDataSingleI32(pI32, 2, 3) == INT32_MIN, "Incorrect int32 saturation.");
+		ASSERT(buffer2d_getDataSingleI32(pI32, 2, 4) == INT32_MAX, "Incorrect int32 saturation.");
+
+		ASSERT(buffer2d_convertI32ToF32(pF32, pI32, 0.5f) == STATUS_OK, "Failed to convert int32 to float.");
+		ASSERT(buffer2d_getDataSingleF32(pF32, 0, 3) == -3000.0f, "Incorrect int32 to float.");
+		ASSERT(buffer2d_getDataSingleF32(pF32, 0, 4) == 4000.0f, "Incorrect int32 to float.");
+		buffer2d_accumulateF32(pF32, pF32, 1.0f);
+		buffer2d_clipF32(pF32, -4000.0f, 1e9f);
+		ASSERT(buffer2d_getDataSingleF32(pF32, 0, 4) == 8000.0f, "Incorrect float accumulate.");
+		ASSERT(buffer2d_getDataSingleF32(pF32, 0, 3) == -4000.0f, "Incorrect float clip.");
+		ASSERT(buffer2d_getDataSingleF32(pF32, 2, 3) == -4000.0f, "Incorrect float clip.");
+		ASSERT(buffer2d_getDataSingleF32(pF32, 2, 4) == 1e9f, "Incorrect float clip.");
+		buffer2d_putDataSingleF32(pF32, 0, 0, 1.5f);
+		buffer2d_putDataSingleF32(pF32, 0, 1, -2.5f);
+		buffer2d_putDataSingleF32(pF32, 0, 2, 3e9f);
+
+		ASSERT(buffer2d_convertF32ToI32(pI32, pF32, 1.0f) == STATUS_OK, "Failed to convert float to int32.");
+		ASSERT(buffer2d_getDataSingleI32(pI32, 0, 0) == 2, "Incorrect float to int32 rounding.");
+		ASSERT(buffer2d_getDataSingleI32(pI32, 0, 1) == -3, "Incorrect float to int32 rounding.");
+		ASSERT(buffer2d_getDataSingleI32(pI32, 0, 2) == INT32_MAX, "Incorrect float to int32 saturation.");
+		ASSERT(buffer2d_getDataSingleI32(pI32, 0, 4) == 8000, "Incorrect float to int32.");
+		ASSERT(buffer2d_getDataSingleI32(pI32, 2, 3) == -4000, "Incorrect float to int32.");
+		ASSERT(buffer2d_clipI16(pI32, 0, 1) == STATUS_ERROR_PARAM, "Wrong element size accepted.");
+		buffer2d_destroy(&pI32);
+		buffer2d_destroy(&pF32);
+	}
 }
 
 void test_bufferAll(void) {
@@ -179,4 +657,9 @@ void test_bufferAll(void) {
 	test_buffer2dPutGetRow();
 	test_buffer2dPutGetCol();
 	test_buffer2dFill();
+	test_buffer2dView();
+	test_buffer2dTyped();
+	test_buffer2dLayout();
+	test_buffer2dCreateEx();
+	test_buffer2dBulk();
 }
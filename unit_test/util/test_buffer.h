@@ -45,7 +45,51 @@ void test_buffer2dPutGetCol(void);
 /**
  * @details Test includes:
  * 		1. fill()
+ * 		2. fill() of element sizes 1 to 16 bytes, with and without repeated bytes.
  */
 void test_buffer2dFill(void);
 
+/**
+ * @details Test includes:
+ * 		1. getView(), getViewRow(), getViewCol(), getViewBlock()
+ * 		2. View copy between layouts and to plain array.
+ * 		3. View fill.
+ */
+void test_buffer2dView(void);
+
+/**
+ * @details Test includes:
+ * 		1. Typed put/get of single, row and column, for both layouts.
+ * 		2. Consistency with generic put/get.
+ */
+void test_buffer2dTyped(void);
+
+/**
+ * @details Test includes:
+ * 		1. copyLayout() between all layouts, for element sizes 1, 2, 4, 8 and 3,
+ * 		   and channel counts with and without unrolled kernel.
+ * 		2. setLayout() in place.
+ * 		3. convertI16ToF32() and convertF32ToI16(), with rounding and saturation.
+ */
+void test_buffer2dLayout(void);
+
+/**
+ * @details Test includes:
+ * 		1. createEx() with alignment and padding, owned and external memory.
+ * 		2. Alignment of every line and leading dimension.
+ * 		3. put/get, typed put/get, views, fill and copyLayout() on padded buffers
+ * 		   without touching the padding.
+ * 		4. Invalid configurations.
+ */
+void test_buffer2dCreateEx(void);
+
+/**
+ * @details Test includes:
+ * 		1. scale(), clip() and accumulate() of int16, int32 and float, with rounding
+ * 		   and saturation, on padded and unpadded buffers of both layouts.
+ * 		2. convertI32ToF32() and convertF32ToI32().
+ * 		3. Invalid element sizes, dimensions and layouts.
+ */
+void test_buffer2dBulk(void);
+
 #endif /* TEST_TEST_BUFFER_H_ */
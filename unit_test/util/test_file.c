@@ -0,0 +1,345 @@
+/*
+ * test_file.c
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: chiong
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include "util/file.h"
+#include "debug/assert.h"
+#include "test_file.h"
+
+#define TEST_FILE_NAME			"test_file.bin"
+#define TEST_FILE_HEADER_SIZE	(44)
+#define TEST_FILE_NFRAME		(5000)
+#define TEST_FILE_NCHANNEL		(3)
+#define TEST_FILE_REC_NAME		"test_file.rec"
+/* Number of IMU samples in decoding buffer. */
+#define TEST_FILE_REC_NIMU		(512)
+
+/**
+ * @brief Write a header of 0xFF, then TEST_FILE_NFRAME frames with element c of
+ * 		frame k = k * 10 + c, then a partial frame.
+ */
+static void test_fileWrite(void) {
+	FILE *f;
+	int32_t val;
+	uint32_t k, c;
+
+	f = fopen(TEST_FILE_NAME, "wb");
+	for (k = 0; k < TEST_FILE_HEADER_SIZE; k++) {
+		fputc(0xFF, f);
+	}
+	for (k = 0; k < TEST_FILE_NFRAME; k++) {
+		for (c = 0; c < TEST_FILE_NCHANNEL; c++) {
+			val = (int32_t) (k * 10 + c);
+			fwrite(&val, sizeof(val), 1, f);
+		}
+	}
+	fwrite(&val, sizeof(val), 1, f);
+	fclose(f);
+}
+
+void test_fileMap(void) {
+	fileMapCfg_t cfg;
+	fileMap_t *pMap = NULL;
+	fileMapView_t view;
+	buffer2dView_t frame;
+	const int32_t *pData;
+	uint64_t i, total;
+
+	test_fileWrite();
+	cfg.filename = TEST_FILE_NAME;
+	cfg.offset = TEST_FILE_HEADER_SIZE;
+	cfg.elemSize = sizeof(int32_t);
+	cfg.nChannel = TEST_FILE_NCHANNEL;
+	cfg.chunkSize = 0;
+	cfg.advice = FILE_MAP_ADVICE_SEQUENTIAL;
+
+	/* Whole file */
+	ASSERT(file_mapOpen(&pMap, &cfg) == STATUS_OK, "Failed to map file.");
+	ASSERT(file_mapGetCount(pMap) == TEST_FILE_NFRAME * TEST_FILE_NCHANNEL, "Incorrect count.");
+	ASSERT(file_mapGetView(pMap, &view) == STATUS_OK, "Failed to get view of whole file.");
+	ASSERT(view.count == TEST_FILE_NFRAME * TEST_FILE_NCHANNEL && 0 == view.index, "Incorrect view.");
+	pData = FILEMAPVIEW_getDataAsType(&view, int32_t);
+	ASSERT(pData[0] == 0 && pData[2] == 2 && pData[3 * 4999 + 1] == 49991, "Incorrect data.");
+
+	file_mapViewAsBuffer2d(&view, &frame);
+	ASSERT(frame.nRow == TEST_FILE_NFRAME && frame.nCol == TEST_FILE_NCHANNEL, "Incorrect 2D buffer view.");
+	ASSERT(*(const int32_t*) BUFFER2DVIEW_getElemAddr(&frame, 123, 2) == 1232, "Incorrect 2D buffer view.");
+
+	ASSERT(file_mapNext(pMap, &view) == STATUS_OK && view.count == TEST_FILE_NFRAME * TEST_FILE_NCHANNEL,
+			"Incorrect next of whole file.");
+	ASSERT(file_mapNext(pMap, &view) == STATUS_OK && 0 == view.count, "Incorrect end of file.");
+	file_mapClose(&pMap);
+	ASSERT(NULL == pMap, "Map not closed.");
+
+	/* Chunks of 1000 bytes, i.e. 83 frames, rarely on page boundary */
+	cfg.chunkSize = 1000;
+	file_mapOpen(&pMap, &cfg);
+	ASSERT(file_mapGetView(pMap, &view) == STATUS_ERROR_PARAM, "View of whole file when in chunks.");
+	total = 0;
+	while (file_mapNext(pMap, &view) == STATUS_OK && view.count > 0) {
+		ASSERT(view.index == total, "Incorrect index of chunk.");
+		ASSERT(view.count % TEST_FILE_NCHANNEL == 0 && view.count <= 83 * TEST_FILE_NCHANNEL,
+				"Incorrect count of chunk.");
+		pData = FILEMAPVIEW_getDataAsType(&view, int32_t);
+		for (i = 0; i < view.count; i++) {
+			ASSERT(pData[i] == (int32_t) ((total + i) / TEST_FILE_NCHANNEL * 10 + (total + i) % TEST_FILE_NCHANNEL),
+					"Incorrect data of chunk.");
+		}
+		total += view.count;
+	}
+	ASSERT(total == TEST_FILE_NFRAME * TEST_FILE_NCHANNEL, "Incorrect total of chunks.");
+
+	/* Seek is rounded down to frame */
+	ASSERT(file_mapSeek(pMap, 3001) == STATUS_OK, "Failed to seek.");
+	file_mapNext(pMap, &view);
+	file_mapViewAsBuffer2d(&view, &frame);
+	ASSERT(view.index == 3000 && *(const int32_t*) BUFFER2DVIEW_getElemAddr(&frame, 1, 0) == 10010,
+			"Incorrect seek.");
+	ASSERT(file_mapSeek(pMap, total + 1) == STATUS_ERROR_PARAM, "Seek beyond end of file.");
+	file_mapClose(&pMap);
+
+	/* Only the header, i.e. empty */
+	cfg.offset = TEST_FILE_HEADER_SIZE + TEST_FILE_NFRAME * TEST_FILE_NCHANNEL * sizeof(int32_t);
+	cfg.chunkSize = 0;
+	ASSERT(file_mapOpen(&pMap, &cfg) == STATUS_OK, "Failed to map empty file.");
+	ASSERT(0 == file_mapGetCount(pMap), "Incorrect count of empty file.");
+	ASSERT(file_mapNext(pMap, &view) == STATUS_OK && 0 == view.count, "Incorrect empty file.");
+	file_mapClose(&pMap);
+
+	cfg.offset = 1 << 20;
+	ASSERT(file_mapOpen(&pMap, &cfg) == STATUS_ERROR_PARAM, "Offset beyond end of file accepted.");
+	cfg.offset = 0;
+	cfg.elemSize = 0;
+	ASSERT(file_mapOpen(&pMap, &cfg) == STATUS_ERROR_PARAM, "Element size of 0 accepted.");
+	cfg.elemSize = sizeof(int32_t);
+	cfg.filename = "test_file_missing.bin";
+	ASSERT(file_mapOpen(&pMap, &cfg) == STATUS_ERROR_FILE_OPEN, "Missing file opened.");
+	ASSERT(NULL == pMap, "Map created on error.");
+
+	remove(TEST_FILE_NAME);
+}
+
+/**
+ * @brief Sample of channel c of frame k of each stream of test recording.
+ */
+static int16_t test_fileImuSample(uint32_t k, uint32_t c) {
+	return (int16_t) (1000 * c - 500 + (k * (c + 1)) % 97 - ((k / 50) % 2 ? 30000 : 0));
+}
+
+static int16_t test_fileAudioSample(uint32_t k, uint32_t c) {
+	return (int16_t) (k * 31 + c * 7);
+}
+
+/**
+ * @brief Write a recording of an IMU (6 x int16, 100 Hz, delta encoded), audio
+ * 		(2 x int16, 8 kHz) and compass (3 x float, irregular) over 10 s.
+ */
+static void test_fileWriteRec(const char *filename) {
+	fileRecStream_t stream[3];
+	fileRecCfg_t cfg;
+	fileRecWriter_t *pRec = NULL;
+	int16_t imu[TEST_FILE_REC_NIMU];
+	int16_t audio[80 * 2];
+	float compass[3];
+	uint32_t t, k, c;
+
+	memset(stream, 0, sizeof(stream));
+	strcpy(stream[0].name, "mpu6050");
+	stream[0].rate = 100.0f;
+	stream[0].nChannel = 6;
+	stream[0].type = FILE_REC_TYPE_I16;
+	stream[0].encoding = FILE_REC_ENC_DELTA;
+	strcpy(stream[1].name, "audio");
+	stream[1].rate = 8000.0f;
+	stream[1].nChannel = 2;
+	stream[1].type = FILE_REC_TYPE_I16;
+	stream[1].encoding = FILE_REC_ENC_RAW;
+	strcpy(stream[2].name, "hmc5883");
+	stream[2].rate = 0.0f;
+	stream[2].nChannel = 3;
+	stream[2].type = FILE_REC_TYPE_F32;
+	stream[2].encoding = FILE_REC_ENC_RAW;
+
+	cfg.filename = filename;
+	cfg.blockSize = 512;
+	cfg.nStream = 3;
+	cfg.stream = stream;
+	ASSERT(file_recOpen(&pRec, &cfg) == STATUS_OK, "Failed to create recording.");
+
+	/* 10 ms per iteration */
+	for (t = 0; t < 1000; t++) {
+		for (c = 0; c < 6; c++) {
+			imu[c] = test_fileImuSample(t, c);
+		}
+		ASSERT(file_recWrite(pRec, 0, t * 10000000ull, imu, 1) == STATUS_OK, "Failed to write IMU.");
+		for (k = 0; k < 80; k++) {
+			for (c = 0; c < 2; c++) {
+				audio[2 * k + c] = test_fileAudioSample(t * 80 + k, c);
+			}
+		}
+		ASSERT(file_recWrite(pRec, 1, t * 10000000ull, audio, 80) == STATUS_OK, "Failed to write audio.");
+		if (t % 7 == 0) {
+			compass[0] = t;
+			compass[1] = -1.0f * t;
+			compass[2] = 0.5f;
+			file_recWrite(pRec, 2, t * 10000000ull + 123, compass, 1);
+		}
+	}
+	ASSERT(file_recWrite(pRec, 3, 0, compass, 1) == STATUS_ERROR_PARAM, "Invalid stream accepted.");
+	ASSERT(file_recClose(&pRec) == STATUS_OK && NULL == pRec, "Failed to close recording.");
+}
+
+/**
+ * @brief Overwrite a stream descriptor of test recording, after its header.
+ */
+static void test_fileWriteRecStream(const char *filename, uint16_t stream, const fileRecStream_t *desc) {
+	FILE *f;
+
+	f = fopen(filename, "r+b");
+	ASSERT(NULL != f, "Failed to open recording.");
+	fseek(f, (long) (sizeof(fileRecHeader_t) + stream * sizeof(fileRecStream_t)), SEEK_SET);
+	ASSERT(fwrite(desc, sizeof(fileRecStream_t), 1, f) == 1, "Failed to write stream descriptor.");
+	fclose(f);
+}
+
+/**
+ * @brief Read and check all streams of test recording.
+ */
+static void test_fileCheckRec(const char *filename) {
+	fileRecReader_t *pRec = NULL;
+	fileRecFrames_t frames;
+	int16_t imu[TEST_FILE_REC_NIMU];
+	const int16_t *pAudio;
+	const float *pCompass;
+	uint32_t n, k, c;
+
+	ASSERT(file_recReaderOpen(&pRec, filename) == STATUS_OK, "Failed to open recording.");
+	ASSERT(file_recGetNumStream(pRec) == 3, "Incorrect number of streams.");
+	ASSERT(strcmp(file_recGetStream(pRec, 1)->name, "audio") == 0 && file_recGetStream(pRec, 1)->rate == 8000.0f,
+			"Incorrect stream descriptor.");
+	ASSERT(NULL == file_recGetStream(pRec, 3), "Invalid stream found.");
+	ASSERT(file_recGetMaxFrame(pRec, 0) * 6 <= TEST_FILE_REC_NIMU, "Buffer too small for test.");
+
+	ASSERT(file_recNext(pRec, 0, NULL, &frames) == STATUS_ERROR_NULL, "Delta decoded without buffer.");
+	n = 0;
+	while (file_recNext(pRec, 0, imu, &frames) == STATUS_OK && frames.nFrame > 0) {
+		ASSERT(frames.timestamp == n * 10000000ull, "Incorrect IMU timestamp.");
+		for (k = 0; k < frames.nFrame; k++) {
+			for (c = 0; c < 6; c++) {
+				ASSERT(imu[k * 6 + c] == test_fileImuSample(n + k, c), "Incorrect IMU sample.");
+			}
+		}
+		n += frames.nFrame;
+	}
+	ASSERT(1000 == n, "Incorrect number of IMU frames.");
+
+	n = 0;
+	while (file_recNext(pRec, 1, NULL, &frames) == STATUS_OK && frames.nFrame > 0) {
+		ASSERT(frames.timestamp == n * 125000ull, "Incorrect audio timestamp.");
+		pAudio = (const int16_t*) frames.data;
+		for (k = 0; k < frames.nFrame; k++) {
+			ASSERT(pAudio[2 * k + 1] == test_fileAudioSample(n + k, 1), "Incorrect audio sample.");
+		}
+		n += frames.nFrame;
+	}
+	ASSERT(80000 == n, "Incorrect number of audio frames.");
+
+	/* Delta encoding takes fewer blocks than raw would */
+	ASSERT(file_recGetNumBlock(pRec, 0) < 1000 * 12 / (512 - 24) + 1, "IMU not compressed.");
+
+	/* Seek to 5.0037 s, i.e. inside a block */
+	file_recSeek(pRec, 1, 5003700000ull);
+	file_recNext(pRec, 1, NULL, &frames);
+	ASSERT(frames.timestamp <= 5003700000ull && frames.timestamp + frames.nFrame * 125000ull > 5003700000ull,
+			"Incorrect seek.");
+	file_recSeek(pRec, 2, 0);
+	file_recNext(pRec, 2, NULL, &frames);
+	pCompass = (const float*) frames.data;
+	ASSERT(frames.timestamp == 123 && pCompass[0] == 0.0f && pCompass[3] == 7.0f && pCompass[4] == -7.0f,
+			"Incorrect irregular stream.");
+	ASSERT(file_recSeek(pRec, 3, 0) == STATUS_ERROR_PARAM, "Invalid stream accepted.");
+
+	file_recReaderClose(&pRec);
+	ASSERT(NULL == pRec, "Recording not closed.");
+}
+
+void test_fileRec(void) {
+	fileRecReader_t *pRec = NULL;
+	fileRecFrames_t frames;
+	fileRecStream_t desc, bad;
+	FILE *f;
+	long size;
+	uint64_t offset;
+	uint32_t n;
+
+	test_fileWriteRec(TEST_FILE_REC_NAME);
+	test_fileCheckRec(TEST_FILE_REC_NAME);
+
+	/* Corrupt stream descriptors: no channel, unknown type, delta encoded float
+	 * and frame larger than block */
+	ASSERT(file_recReaderOpen(&pRec, TEST_FILE_REC_NAME) == STATUS_OK, "Failed to open recording.");
+	desc = *file_recGetStream(pRec, 2);
+	file_recReaderClose(&pRec);
+	bad = desc;
+	bad.nChannel = 0;
+	test_fileWriteRecStream(TEST_FILE_REC_NAME, 2, &bad);
+	ASSERT(file_recReaderOpen(&pRec, TEST_FILE_REC_NAME) == STATUS_ERROR && NULL == pRec,
+			"Stream without channel opened.");
+	bad = desc;
+	bad.type = 0xFF;
+	test_fileWriteRecStream(TEST_FILE_REC_NAME, 2, &bad);
+	ASSERT(file_recReaderOpen(&pRec, TEST_FILE_REC_NAME) == STATUS_ERROR, "Stream of unknown type opened.");
+	bad = desc;
+	bad.encoding = FILE_REC_ENC_DELTA;
+	test_fileWriteRecStream(TEST_FILE_REC_NAME, 2, &bad);
+	ASSERT(file_recReaderOpen(&pRec, TEST_FILE_REC_NAME) == STATUS_ERROR, "Delta encoded float opened.");
+	bad = desc;
+	bad.nChannel = 1000;
+	test_fileWriteRecStream(TEST_FILE_REC_NAME, 2, &bad);
+	ASSERT(file_recReaderOpen(&pRec, TEST_FILE_REC_NAME) == STATUS_ERROR, "Frame larger than block opened.");
+	test_fileWriteRecStream(TEST_FILE_REC_NAME, 2, &desc);
+	test_fileCheckRec(TEST_FILE_REC_NAME);
+
+	/* Index entry pointing past the blocks, index rebuilt from blocks instead.
+	 * Block number of first entry, after its timestamp. Offset of index is
+	 * the last 8 bytes of footer. */
+	f = fopen(TEST_FILE_REC_NAME, "r+b");
+	fseek(f, -8, SEEK_END);
+	ASSERT(fread(&offset, sizeof(offset), 1, f) == 1, "Failed to read footer.");
+	fseek(f, (long) offset + 8, SEEK_SET);
+	n = 0xFFFFFFF0;
+	fwrite(&n, sizeof(n), 1, f);
+	fclose(f);
+	test_fileCheckRec(TEST_FILE_REC_NAME);
+
+	/* Index lost and last block torn, e.g. power loss */
+	f = fopen(TEST_FILE_REC_NAME, "rb");
+	fseek(f, 0, SEEK_END);
+	size = ftell(f);
+	fclose(f);
+	ASSERT(truncate(TEST_FILE_REC_NAME, size / 10 * 9 + 100) == 0, "Failed to truncate recording.");
+	ASSERT(file_recReaderOpen(&pRec, TEST_FILE_REC_NAME) == STATUS_OK, "Failed to open recording without index.");
+	n = 0;
+	while (file_recNext(pRec, 1, NULL, &frames) == STATUS_OK && frames.nFrame > 0) {
+		n += frames.nFrame;
+	}
+	ASSERT(n > 60000 && n < 80000 && n % 122 == 0, "Incorrect recovery of recording without index.");
+	file_recReaderClose(&pRec);
+
+	ASSERT(file_recReaderOpen(&pRec, TEST_FILE_NAME) == STATUS_ERROR_FILE_OPEN, "Missing file opened.");
+	test_fileWrite();
+	ASSERT(file_recReaderOpen(&pRec, TEST_FILE_NAME) == STATUS_ERROR, "Not a recording opened.");
+	remove(TEST_FILE_NAME);
+	remove(TEST_FILE_REC_NAME);
+}
+
+void test_fileAll(void) {
+	test_fileMap();
+	test_fileRec();
+}
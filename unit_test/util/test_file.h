@@ -0,0 +1,37 @@
+/*
+ * test_file.h
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: chiong
+ */
+
+#ifndef TEST_TEST_FILE_H_
+#define TEST_TEST_FILE_H_
+
+/**
+ * @details Test all
+ */
+void test_fileAll(void);
+
+/**
+ * @details Test includes:
+ * 		1. file_mapOpen() of whole file with header offset, file_mapGetView().
+ * 		2. file_mapNext() in chunks not aligned to page size, without splitting
+ * 		   frames, and file_mapSeek().
+ * 		3. file_mapViewAsBuffer2d() and typed access.
+ * 		4. Empty file, missing file and invalid configuration.
+ */
+void test_fileMap(void);
+
+/**
+ * @details Test includes:
+ * 		1. Recording of 3 streams: delta encoded int16, raw int16 and irregular
+ * 		   float, read back completely with timestamps.
+ * 		2. file_recSeek() into the middle of a block.
+ * 		3. Recording without index and with a torn last block.
+ * 		4. Missing file and file that is not a recording.
+ * 		5. Corrupt stream descriptors, e.g. no channel or unknown type.
+ */
+void test_fileRec(void);
+
+#endif /* TEST_TEST_FILE_H_ */
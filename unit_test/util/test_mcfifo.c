@@ -0,0 +1,250 @@
+/*
+ * test_mcfifo.c
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: chiong
+ */
+
+#include <stdio.h>
+#include <pthread.h>
+#include <time.h>
+#include "util/mcfifo.h"
+#include "util/wav.h"
+#include "debug/assert.h"
+#include "test_mcfifo.h"
+
+#define TEST_MCFIFO_NSLOT		(4)
+#define TEST_MCFIFO_FRAME_SIZE	(8)
+#define TEST_MCFIFO_NCHANNEL	(2)
+#define TEST_MCFIFO_NFRAME		(10000)
+#define TEST_MCFIFO_WAV_NAME	"test_mcfifo.wav"
+/* Samples of test WAV file, i.e. 5 frames and a partial one. */
+#define TEST_MCFIFO_WAV_NSAMPLE	(TEST_MCFIFO_FRAME_SIZE * 5 + 3)
+
+void test_mcfifoSingleThread(void) {
+	mcfifo_t *fifo = NULL;
+	mcfifoCfg_t cfg;
+	mcbuffer_t *buf;
+	mcbuffer_t *slot[TEST_MCFIFO_NSLOT];
+	mcfifoStats_t stats;
+	uint32_t i;
+
+	cfg.nSlot = TEST_MCFIFO_NSLOT;
+	cfg.frameSize = TEST_MCFIFO_FRAME_SIZE;
+	cfg.nChannel = TEST_MCFIFO_NCHANNEL;
+	cfg.elemSize = sizeof(uint32_t);
+	cfg.layout = MCBUFFER_LAYOUT_NON_INTERLEAVED;
+	mcfifo_create(&fifo, &cfg);
+	ASSERT(NULL != fifo, "FIFO not created.");
+
+	ASSERT(NULL == mcfifo_acquireRead(fifo), "Empty FIFO must not return a frame.");
+	for (i = 0; i < TEST_MCFIFO_NSLOT; i++) {
+		slot[i] = mcfifo_acquireWrite(fifo);
+		ASSERT(NULL != slot[i], "Unexpected full FIFO.");
+		ASSERT(slot[i] == mcfifo_acquireWrite(fifo), "Repeated acquire must return same frame.");
+		mcfifo_commitWrite(fifo);
+	}
+	ASSERT(mcfifo_getCount(fifo) == TEST_MCFIFO_NSLOT, "Incorrect count.");
+	ASSERT(NULL == mcfifo_acquireWrite(fifo), "Full FIFO must not return a frame.");
+
+	for (i = 0; i < TEST_MCFIFO_NSLOT; i++) {
+		buf = mcfifo_acquireRead(fifo);
+		ASSERT(buf == slot[i], "Frames not read in order.");
+		mcfifo_releaseRead(fifo);
+	}
+	ASSERT(mcfifo_getCount(fifo) == 0, "Incorrect count.");
+
+	/* Wrap around to first slot */
+	ASSERT(mcfifo_acquireWrite(fifo) == slot[0], "Slot not reused after wrap around.");
+
+	mcfifo_getStats(fifo, &stats);
+	ASSERT(stats.written == TEST_MCFIFO_NSLOT, "Incorrect written count.");
+	ASSERT(stats.read == TEST_MCFIFO_NSLOT, "Incorrect read count.");
+	ASSERT(stats.overrun == 1, "Incorrect overrun count.");
+	ASSERT(stats.underrun == 1, "Incorrect underrun count.");
+
+	mcfifo_destroy(&fifo);
+	ASSERT(NULL == fifo, "FIFO not destroyed.");
+}
+
+static void* test_mcfifoProducer(void *arg) {
+	mcfifo_t *fifo = (mcfifo_t*) arg;
+	mcbuffer_t *buf;
+	uint32_t n = 0;
+	uint32_t seq;
+
+	while (n < TEST_MCFIFO_NFRAME) {
+		buf = mcfifo_acquireWrite(fifo);
+		if (NULL != buf) {
+			seq = n;
+			buffer2d_fill(buf, &seq);
+			mcfifo_commitWrite(fifo);
+			n++;
+		}
+	}
+
+	return NULL;
+}
+
+void test_mcfifoProducerConsumer(void) {
+	mcfifo_t *fifo = NULL;
+	mcfifoCfg_t cfg;
+	mcbuffer_t *buf;
+	pthread_t thread;
+	const uint32_t *data;
+	uint32_t n = 0;
+	uint32_t i;
+
+	cfg.nSlot = TEST_MCFIFO_NSLOT;
+	cfg.frameSize = TEST_MCFIFO_FRAME_SIZE;
+	cfg.nChannel = TEST_MCFIFO_NCHANNEL;
+	cfg.elemSize = sizeof(uint32_t);
+	cfg.layout = MCBUFFER_LAYOUT_NON_INTERLEAVED;
+	mcfifo_create(&fifo, &cfg);
+	ASSERT(NULL != fifo, "FIFO not created.");
+	pthread_create(&thread, NULL, test_mcfifoProducer, fifo);
+
+	while (n < TEST_MCFIFO_NFRAME) {
+		buf = mcfifo_acquireRead(fifo);
+		if (NULL != buf) {
+			data = MCBUFFER_getBufferAsType(buf, const uint32_t);
+			for (i = 0; i < TEST_MCFIFO_FRAME_SIZE * TEST_MCFIFO_NCHANNEL; i++) {
+				ASSERT(data[i] == n, "Frame out of order or torn.");
+			}
+			mcfifo_releaseRead(fifo);
+			n++;
+		}
+	}
+
+	pthread_join(thread, NULL);
+	mcfifo_destroy(&fifo);
+}
+
+static int16_t test_mcfifoWavSample(uint32_t k, uint32_t c) {
+	return (int16_t) (k * 10 + c + 1);
+}
+
+/**
+ * @brief Write a 16-bit stereo WAV file followed by a LIST chunk.
+ */
+static void test_mcfifoWriteWav(const char *filename) {
+	const uint8_t list[] = {'L', 'I', 'S', 'T', 4, 0, 0, 0, 0x55, 0x55, 0x55, 0x55};
+	int16_t sample[TEST_MCFIFO_NCHANNEL];
+	wavInfo_t wav;
+	FILE *f;
+	uint32_t k, c;
+
+	wav.format = WAV_FORMAT_PCM;
+	wav.channel = TEST_MCFIFO_NCHANNEL;
+	wav.sampleRate = 800;
+	wav.bitsPerSample = 16;
+	wav.dataSize = TEST_MCFIFO_WAV_NSAMPLE * sizeof(sample);
+	f = fopen(filename, "wb");
+	ASSERT(NULL != f, "Failed to create WAV file.");
+	ASSERT(wav_writeHeader(f, &wav) == STATUS_OK, "Failed to write WAV header.");
+	for (k = 0; k < TEST_MCFIFO_WAV_NSAMPLE; k++) {
+		for (c = 0; c < TEST_MCFIFO_NCHANNEL; c++) {
+			sample[c] = test_mcfifoWavSample(k, c);
+		}
+		ASSERT(fwrite(sample, sizeof(sample), 1, f) == 1, "Failed to write WAV samples.");
+	}
+	ASSERT(fwrite(list, sizeof(list), 1, f) == 1, "Failed to write LIST chunk.");
+	fclose(f);
+}
+
+/**
+ * @brief Check frame n of test WAV file, zero padded past its last sample.
+ */
+static void test_mcfifoCheckWavFrame(mcbuffer_t *buf, uint32_t n) {
+	const int16_t *data;
+	uint32_t k, c;
+	int16_t expected;
+
+	/* Non-interleaved, i.e. channel after channel */
+	data = MCBUFFER_getBufferAsType(buf, const int16_t);
+	for (c = 0; c < TEST_MCFIFO_NCHANNEL; c++) {
+		for (k = 0; k < TEST_MCFIFO_FRAME_SIZE; k++) {
+			expected = (n * TEST_MCFIFO_FRAME_SIZE + k < TEST_MCFIFO_WAV_NSAMPLE) ?
+					test_mcfifoWavSample(n * TEST_MCFIFO_FRAME_SIZE + k, c) : 0;
+			ASSERT(data[c * TEST_MCFIFO_FRAME_SIZE + k] == expected, "Incorrect sample from file source.");
+		}
+	}
+}
+
+void test_mcfifoFileSource(void) {
+	const struct timespec ms = {0, 1000000};
+	const uint32_t nFrame = (TEST_MCFIFO_WAV_NSAMPLE + TEST_MCFIFO_FRAME_SIZE - 1) / TEST_MCFIFO_FRAME_SIZE;
+	mcfifo_t *fifo = NULL;
+	mcfifoSrc_t *pSrc = NULL;
+	mcfifoCfg_t cfg;
+	mcfifoSrcCfg_t srcCfg;
+	mcfifoStats_t stats;
+	mcbuffer_t *buf;
+	uint32_t n;
+
+	test_mcfifoWriteWav(TEST_MCFIFO_WAV_NAME);
+	srcCfg.filename = TEST_MCFIFO_WAV_NAME;
+	srcCfg.sampleRate = 800;
+	srcCfg.isLoop = 0;
+
+	/* Channels and sample size must match */
+	cfg.nSlot = 8;
+	cfg.frameSize = TEST_MCFIFO_FRAME_SIZE;
+	cfg.nChannel = 1;
+	cfg.elemSize = sizeof(int16_t);
+	cfg.layout = MCBUFFER_LAYOUT_NON_INTERLEAVED;
+	mcfifo_create(&fifo, &cfg);
+	ASSERT(mcfifo_startFileSource(&pSrc, fifo, &srcCfg) == STATUS_ERROR_PARAM, "Mono FIFO fed with stereo.");
+	mcfifo_destroy(&fifo);
+	cfg.nChannel = TEST_MCFIFO_NCHANNEL;
+	cfg.elemSize = sizeof(int32_t);
+	mcfifo_create(&fifo, &cfg);
+	ASSERT(mcfifo_startFileSource(&pSrc, fifo, &srcCfg) == STATUS_ERROR_PARAM, "32-bit FIFO fed with 16-bit.");
+	mcfifo_destroy(&fifo);
+
+	/* Whole file fits in FIFO, so that nothing is dropped */
+	cfg.elemSize = sizeof(int16_t);
+	mcfifo_create(&fifo, &cfg);
+	ASSERT(NULL != fifo, "FIFO not created.");
+	ASSERT(mcfifo_startFileSource(&pSrc, fifo, &srcCfg) == STATUS_OK, "File source not started.");
+	while (!mcfifo_isFileSourceDone(pSrc)) {
+		nanosleep(&ms, NULL);
+	}
+	mcfifo_getStats(fifo, &stats);
+	ASSERT(stats.written == nFrame && 0 == stats.overrun, "Incorrect number of frames from file.");
+	for (n = 0; n < nFrame; n++) {
+		buf = mcfifo_acquireRead(fifo);
+		ASSERT(NULL != buf, "Frame from file missing.");
+		test_mcfifoCheckWavFrame(buf, n);
+		mcfifo_releaseRead(fifo);
+	}
+	ASSERT(mcfifo_stopFileSource(&pSrc) == STATUS_OK && NULL == pSrc, "File source not stopped.");
+
+	/* Looped from first sample, read as it comes and stopped while running */
+	srcCfg.isLoop = 1;
+	ASSERT(mcfifo_startFileSource(&pSrc, fifo, &srcCfg) == STATUS_OK, "File source not started.");
+	n = 0;
+	while (n < nFrame * 2 + 1) {
+		buf = mcfifo_acquireRead(fifo);
+		if (NULL != buf) {
+			test_mcfifoCheckWavFrame(buf, n % nFrame);
+			mcfifo_releaseRead(fifo);
+			n++;
+		} else {
+			nanosleep(&ms, NULL);
+		}
+	}
+	ASSERT(!mcfifo_isFileSourceDone(pSrc), "Looping file source done.");
+	ASSERT(mcfifo_stopFileSource(&pSrc) == STATUS_OK && NULL == pSrc, "File source not stopped.");
+	mcfifo_getStats(fifo, &stats);
+	ASSERT(0 == stats.overrun, "Frames from file dropped.");
+
+	mcfifo_destroy(&fifo);
+	remove(TEST_MCFIFO_WAV_NAME);
+}
+
+void test_mcfifoAll(void) {
+	test_mcfifoSingleThread();
+	test_mcfifoProducerConsumer();
+	test_mcfifoFileSource();
+}
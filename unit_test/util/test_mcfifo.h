@@ -0,0 +1,40 @@
+/*
+ * test_mcfifo.h
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: chiong
+ */
+
+#ifndef TEST_TEST_MCFIFO_H_
+#define TEST_TEST_MCFIFO_H_
+
+/**
+ * @details Test all
+ */
+void test_mcfifoAll(void);
+
+/**
+ * @details Test includes:
+ * 		1. acquire/commit write and acquire/release read return slots in order.
+ * 		2. Full FIFO returns NULL on write and counts overrun.
+ * 		3. Empty FIFO returns NULL on read and counts underrun.
+ */
+void test_mcfifoSingleThread(void);
+
+/**
+ * @details Test frames written by a producer thread are received in order and
+ * 		intact by the consumer thread.
+ */
+void test_mcfifoProducerConsumer(void);
+
+/**
+ * @details Test includes:
+ * 		1. File source plays the samples of a WAV file and not the chunks after,
+ * 		   with the last frame zero padded, then is done.
+ * 		2. Looping file source restarts from the first sample and is stopped
+ * 		   while running.
+ * 		3. WAV file of other channels or sample size than the FIFO is rejected.
+ */
+void test_mcfifoFileSource(void);
+
+#endif /* TEST_TEST_MCFIFO_H_ */
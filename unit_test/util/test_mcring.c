@@ -0,0 +1,178 @@
+/*
+ * test_mcring.c
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: chiong
+ */
+
+#include <stdio.h>
+#include "util/mcring.h"
+#include "debug/assert.h"
+#include "test_mcring.h"
+
+#define TEST_MCRING_SIZE		(10)
+#define TEST_MCRING_WINDOW		(4)
+#define TEST_MCRING_NCHANNEL	(3)
+
+/**
+ * @brief Fill a block of n samples with sample k of channel c = (first + k) * 10 + c.
+ */
+static void test_mcringFillBlock(mcbuffer_t *buf, uint32_t first, uint32_t n) {
+	uint32_t k, c;
+
+	for (k = 0; k < n; k++) {
+		for (c = 0; c < TEST_MCRING_NCHANNEL; c++) {
+			buffer2d_putDataSingleI32(buf, k, c, (int32_t) ((first + k) * 10 + c));
+		}
+	}
+}
+
+/**
+ * @brief Check a view of n samples starting with sample first.
+ */
+static uint8_t test_mcringCheckView(const buffer2dView_t *view, uint32_t first, uint32_t n) {
+	uint32_t k, c;
+
+	if (view->nRow != n || view->nCol != TEST_MCRING_NCHANNEL) {
+		return 0;
+	}
+	for (k = 0; k < n; k++) {
+		for (c = 0; c < TEST_MCRING_NCHANNEL; c++) {
+			if (*(int32_t*) BUFFER2DVIEW_getElemAddr(view, k, c) != (int32_t) ((first + k) * 10 + c)) {
+				return 0;
+			}
+		}
+	}
+
+	return 1;
+}
+
+void test_mcringPushPop(void) {
+	uint8_t layout[2] = { MCBUFFER_LAYOUT_INTERLEAVED, MCBUFFER_LAYOUT_NON_INTERLEAVED };
+	mcring_t *ring;
+	mcringCfg_t cfg;
+	mcbuffer_t *in, *out;
+	buffer2dView_t inView, outView, view;
+	uint32_t wr, rd;
+	uint32_t i, k;
+
+	cfg.size = TEST_MCRING_SIZE;
+	cfg.maxWindow = TEST_MCRING_WINDOW;
+	cfg.nChannel = TEST_MCRING_NCHANNEL;
+	cfg.elemSize = sizeof(int32_t);
+	cfg.isOverwrite = 0;
+	for (k = 0; k < 2; k++) {
+		cfg.layout = layout[k];
+		ring = NULL;
+		mcring_create(&ring, &cfg);
+		ASSERT(NULL != ring, "Ring not created.");
+		/* Opposite layout for user buffers */
+		MCBUFFER_create(&in, 3, TEST_MCRING_NCHANNEL, sizeof(int32_t), layout[1 - k]);
+		MCBUFFER_create(&out, 3, TEST_MCRING_NCHANNEL, sizeof(int32_t), layout[k]);
+		buffer2d_getView(in, &inView);
+		buffer2d_getView(out, &outView);
+
+		ASSERT(mcring_pop(ring, &outView) == STATUS_ERROR, "Pop from empty ring.");
+
+		/* Push 3, pop 3, so that every position is crossed several times */
+		wr = 0;
+		rd = 0;
+		for (i = 0; i < 20; i++) {
+			test_mcringFillBlock(in, wr, 3);
+			ASSERT(mcring_push(ring, &inView) == STATUS_OK, "Failed to push.");
+			wr += 3;
+			if (i % 2 == 0) {
+				test_mcringFillBlock(in, wr, 3);
+				ASSERT(mcring_push(ring, &inView) == STATUS_OK, "Failed to push.");
+				wr += 3;
+			}
+			ASSERT(mcring_getCount(ring) == wr - rd, "Incorrect count.");
+
+			/* Oldest samples as a contiguous window, then popped */
+			ASSERT(mcring_peek(ring, TEST_MCRING_WINDOW, &view) == STATUS_OK, "Failed to peek.");
+			ASSERT(test_mcringCheckView(&view, rd, TEST_MCRING_WINDOW), "Incorrect peek.");
+			ASSERT(mcring_pop(ring, &outView) == STATUS_OK, "Failed to pop.");
+			ASSERT(test_mcringCheckView(&outView, rd, 3), "Incorrect pop.");
+			rd += 3;
+			if (mcring_getCount(ring) >= 6) {
+				ASSERT(mcring_consume(ring, 3) == STATUS_OK, "Failed to consume.");
+				rd += 3;
+			}
+		}
+
+		/* Fill up */
+		while (mcring_getSpace(ring) >= 3) {
+			test_mcringFillBlock(in, wr, 3);
+			mcring_push(ring, &inView);
+			wr += 3;
+		}
+		ASSERT(mcring_getSpace(ring) < 3, "Incorrect space.");
+		ASSERT(mcring_push(ring, &inView) == STATUS_ERROR, "Push into full ring.");
+		ASSERT(mcring_peek(ring, TEST_MCRING_WINDOW + 1, &view) == STATUS_ERROR_PARAM, "Window too large.");
+		ASSERT(mcring_consume(ring, TEST_MCRING_SIZE + 1) == STATUS_ERROR_PARAM, "Consume too many.");
+
+		mcring_reset(ring);
+		ASSERT(mcring_getCount(ring) == 0, "Not empty after reset.");
+
+		MCBUFFER_destroy(&in);
+		MCBUFFER_destroy(&out);
+		mcring_destroy(&ring);
+		ASSERT(NULL == ring, "Ring not destroyed.");
+	}
+}
+
+void test_mcringHistory(void) {
+	uint8_t layout[2] = { MCBUFFER_LAYOUT_INTERLEAVED, MCBUFFER_LAYOUT_NON_INTERLEAVED };
+	mcring_t *ring;
+	mcringCfg_t cfg;
+	mcbuffer_t *in;
+	buffer2dView_t inView, view;
+	uint32_t wr;
+	uint32_t i, k;
+
+	cfg.size = TEST_MCRING_SIZE;
+	cfg.maxWindow = TEST_MCRING_WINDOW;
+	cfg.nChannel = TEST_MCRING_NCHANNEL;
+	cfg.elemSize = sizeof(int32_t);
+	cfg.isOverwrite = 1;
+	for (k = 0; k < 2; k++) {
+		cfg.layout = layout[k];
+		ring = NULL;
+		mcring_create(&ring, &cfg);
+		ASSERT(NULL != ring, "Ring not created.");
+		MCBUFFER_create(&in, 2 * TEST_MCRING_SIZE + 1, TEST_MCRING_NCHANNEL, sizeof(int32_t), layout[k]);
+
+		/* Sliding window of 4 with hop of 1 and 3 */
+		wr = 0;
+		for (i = 0; i < 30; i++) {
+			MCBUFFER_getViewWindow(in, 0, 1 + 2 * (i % 2), &inView);
+			test_mcringFillBlock(in, wr, inView.nRow);
+			ASSERT(mcring_push(ring, &inView) == STATUS_OK, "Failed to push with overwrite.");
+			wr += inView.nRow;
+			if (wr >= TEST_MCRING_WINDOW) {
+				ASSERT(mcring_getLatest(ring, TEST_MCRING_WINDOW, &view) == STATUS_OK, "Failed to get window.");
+				ASSERT(test_mcringCheckView(&view, wr - TEST_MCRING_WINDOW, TEST_MCRING_WINDOW), "Incorrect window.");
+			}
+			ASSERT(mcring_getCount(ring) == ((wr < TEST_MCRING_SIZE) ? wr : TEST_MCRING_SIZE), "Incorrect count.");
+		}
+
+		/* Larger than the ring, only the last samples are kept */
+		buffer2d_getView(in, &inView);
+		test_mcringFillBlock(in, wr, inView.nRow);
+		ASSERT(mcring_push(ring, &inView) == STATUS_OK, "Failed to push more than size.");
+		wr += inView.nRow;
+		ASSERT(mcring_getCount(ring) == TEST_MCRING_SIZE, "Incorrect count.");
+		ASSERT(mcring_peek(ring, TEST_MCRING_WINDOW, &view) == STATUS_OK, "Failed to peek.");
+		ASSERT(test_mcringCheckView(&view, wr - TEST_MCRING_SIZE, TEST_MCRING_WINDOW), "Incorrect oldest samples.");
+		ASSERT(mcring_getLatest(ring, TEST_MCRING_WINDOW, &view) == STATUS_OK, "Failed to get window.");
+		ASSERT(test_mcringCheckView(&view, wr - TEST_MCRING_WINDOW, TEST_MCRING_WINDOW), "Incorrect latest samples.");
+
+		MCBUFFER_destroy(&in);
+		mcring_destroy(&ring);
+	}
+}
+
+void test_mcringAll(void) {
+	test_mcringPushPop();
+	test_mcringHistory();
+}
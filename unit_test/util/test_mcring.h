@@ -0,0 +1,31 @@
+/*
+ * test_mcring.h
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: chiong
+ */
+
+#ifndef TEST_TEST_MCRING_H_
+#define TEST_TEST_MCRING_H_
+
+/**
+ * @details Test all
+ */
+void test_mcringAll(void);
+
+/**
+ * @details Test includes:
+ * 		1. push() and pop() across the wrap-around, for both layouts.
+ * 		2. peek() and consume() give contiguous windows across the wrap-around.
+ * 		3. Full ring fails push() and empty ring fails pop().
+ */
+void test_mcringPushPop(void);
+
+/**
+ * @details Test includes:
+ * 		1. getLatest() windows of a sliding analysis, across the wrap-around.
+ * 		2. Overwrite mode, including a push larger than the ring.
+ */
+void test_mcringHistory(void);
+
+#endif /* TEST_TEST_MCRING_H_ */
@@ -0,0 +1,168 @@
+/*
+ * test_mtstack.c
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: chiong
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <pthread.h>
+#include "util/mtstack.h"
+#include "debug/assert.h"
+#include "test_mtstack.h"
+
+#define TEST_MTSTACK_NSTACK		(4)
+#define TEST_MTSTACK_SIZE		(1000)
+#define TEST_MTSTACK_ALIGNMENT	(128)
+#define TEST_MTSTACK_BULK_SIZE	(4096)
+#define TEST_MTSTACK_BULK_ELEM	(16)
+
+void test_mtstackCreate(void) {
+	vMtStack_t *mts = NULL;
+	vMtStackCfg_t cfg;
+	vStack_t *stack;
+	uint8_t *ptr[TEST_MTSTACK_NSTACK];
+	uint32_t i;
+
+	cfg.nStack = TEST_MTSTACK_NSTACK;
+	cfg.size = TEST_MTSTACK_SIZE;
+	cfg.alignment = TEST_MTSTACK_ALIGNMENT;
+	cfg.bulkSize = TEST_MTSTACK_BULK_SIZE;
+	mtstack_create(&mts, &cfg);
+	ASSERT(NULL != mts, "Instance not created.");
+	ASSERT(mtstack_getNumStack(mts) == TEST_MTSTACK_NSTACK, "Incorrect number of stacks.");
+	ASSERT(NULL == mtstack_getStack(mts, TEST_MTSTACK_NSTACK), "Out of range index must fail.");
+
+	for (i = 0; i < TEST_MTSTACK_NSTACK; i++) {
+		stack = mtstack_getStack(mts, i);
+		ASSERT(stack_getSize(stack) == TEST_MTSTACK_SIZE, "Stack created with incorrect size.");
+		ptr[i] = (uint8_t*) stack_alloc(stack, TEST_MTSTACK_SIZE);
+		ASSERT(NULL != ptr[i], "Stack smaller than configured.");
+		ASSERT(((uintptr_t) ptr[i] & (TEST_MTSTACK_ALIGNMENT - 1)) == 0, "Stack not aligned.");
+		memset(ptr[i], i, TEST_MTSTACK_SIZE);
+	}
+
+	for (i = 0; i < TEST_MTSTACK_NSTACK; i++) {
+		ASSERT(ptr[i][0] == i && ptr[i][TEST_MTSTACK_SIZE - 1] == i, "Stacks overlap.");
+	}
+
+	mtstack_destroy(&mts);
+	ASSERT(NULL == mts, "Instance not destroyed.");
+}
+
+typedef struct {
+	vMtStack_t *mts;
+	pthread_barrier_t *barrier;
+	vStack_t *stack;
+} test_mtstackArg_t;
+
+static void* test_mtstackBindWorker(void *arg) {
+	test_mtstackArg_t *pArg = (test_mtstackArg_t*) arg;
+
+	pArg->stack = mtstack_bind(pArg->mts);
+	ASSERT(NULL != pArg->stack, "Bind failed with free stacks.");
+	ASSERT(mtstack_bind(pArg->mts) == pArg->stack, "Bind again must return same stack.");
+	ASSERT(mtstack_getBound(pArg->mts) == pArg->stack, "Incorrect bound stack.");
+
+	/* Hold the binding until all threads are bound */
+	pthread_barrier_wait(pArg->barrier);
+	mtstack_unbind(pArg->mts);
+	ASSERT(NULL == mtstack_getBound(pArg->mts), "Stack still bound after unbind.");
+
+	return NULL;
+}
+
+void test_mtstackBind(void) {
+	vMtStack_t *mts = NULL;
+	vMtStackCfg_t cfg;
+	pthread_t thread[TEST_MTSTACK_NSTACK];
+	pthread_barrier_t barrier;
+	test_mtstackArg_t arg[TEST_MTSTACK_NSTACK];
+	uint32_t i, j;
+
+	cfg.nStack = TEST_MTSTACK_NSTACK;
+	cfg.size = TEST_MTSTACK_SIZE;
+	cfg.alignment = TEST_MTSTACK_ALIGNMENT;
+	cfg.bulkSize = TEST_MTSTACK_BULK_SIZE;
+	mtstack_create(&mts, &cfg);
+	ASSERT(NULL != mts, "Instance not created.");
+	pthread_barrier_init(&barrier, NULL, TEST_MTSTACK_NSTACK + 1);
+
+	for (i = 0; i < TEST_MTSTACK_NSTACK; i++) {
+		arg[i].mts = mts;
+		arg[i].barrier = &barrier;
+		pthread_create(&thread[i], NULL, test_mtstackBindWorker, &arg[i]);
+	}
+
+	/* All stacks are bound by now */
+	pthread_barrier_wait(&barrier);
+	ASSERT(NULL == mtstack_getBound(mts), "Main thread must not be bound.");
+
+	for (i = 0; i < TEST_MTSTACK_NSTACK; i++) {
+		pthread_join(thread[i], NULL);
+		for (j = 0; j < i; j++) {
+			ASSERT(arg[i].stack != arg[j].stack, "Same stack bound to two threads.");
+		}
+	}
+
+	/* All released */
+	ASSERT(NULL != mtstack_bind(mts), "Bind failed after unbind.");
+	mtstack_unbind(mts);
+
+	pthread_barrier_destroy(&barrier);
+	mtstack_destroy(&mts);
+}
+
+static void* test_mtstackBulkWorker(void *arg) {
+	vMtStack_t *mts = (vMtStack_t*) arg;
+	uintptr_t id = (uintptr_t) pthread_self();
+	uintptr_t *ptr;
+	uint32_t i;
+
+	while (NULL != (ptr = (uintptr_t*) mtstack_bulkAlloc(mts, sizeof(uintptr_t), TEST_MTSTACK_BULK_ELEM))) {
+		for (i = 0; i < TEST_MTSTACK_BULK_ELEM; i++) {
+			ptr[i] = id;
+		}
+		for (i = 0; i < TEST_MTSTACK_BULK_ELEM; i++) {
+			ASSERT(ptr[i] == id, "Bulk allocations overlap.");
+		}
+	}
+
+	return NULL;
+}
+
+void test_mtstackBulkAlloc(void) {
+	vMtStack_t *mts = NULL;
+	vMtStackCfg_t cfg;
+	pthread_t thread[TEST_MTSTACK_NSTACK];
+	uint32_t i;
+
+	cfg.nStack = TEST_MTSTACK_NSTACK;
+	cfg.size = TEST_MTSTACK_SIZE;
+	cfg.alignment = TEST_MTSTACK_ALIGNMENT;
+	cfg.bulkSize = TEST_MTSTACK_BULK_SIZE;
+	mtstack_create(&mts, &cfg);
+	ASSERT(NULL != mts, "Instance not created.");
+
+	for (i = 0; i < TEST_MTSTACK_NSTACK; i++) {
+		pthread_create(&thread[i], NULL, test_mtstackBulkWorker, mts);
+	}
+	for (i = 0; i < TEST_MTSTACK_NSTACK; i++) {
+		pthread_join(thread[i], NULL);
+	}
+
+	ASSERT(mtstack_getBulkAvailSize(mts) < TEST_MTSTACK_BULK_ELEM * sizeof(uintptr_t),
+			"Bulk region not used up.");
+	mtstack_bulkReset(mts);
+	ASSERT(mtstack_getBulkAvailSize(mts) == TEST_MTSTACK_BULK_SIZE, "Bulk region not reset.");
+
+	mtstack_destroy(&mts);
+}
+
+void test_mtstackAll(void) {
+	test_mtstackCreate();
+	test_mtstackBind();
+	test_mtstackBulkAlloc();
+}
@@ -0,0 +1,33 @@
+/*
+ * test_mtstack.h
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: chiong
+ */
+
+#ifndef TEST_TEST_MTSTACK_H_
+#define TEST_TEST_MTSTACK_H_
+
+/**
+ * @details Test all
+ */
+void test_mtstackAll(void);
+
+/**
+ * @details Test per-thread stacks are aligned, of correct size and do not overlap.
+ */
+void test_mtstackCreate(void);
+
+/**
+ * @details Test threads bound concurrently get distinct stacks, and the binding
+ * 		is looked up correctly and released on unbind.
+ */
+void test_mtstackBind(void);
+
+/**
+ * @details Test concurrent bulk allocations do not overlap and fail once the bulk
+ * 		region is exhausted.
+ */
+void test_mtstackBulkAlloc(void);
+
+#endif /* TEST_TEST_MTSTACK_H_ */
@@ -0,0 +1,125 @@
+/*
+ * test_pool.c
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: chiong
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <pthread.h>
+#include "util/pool.h"
+#include "debug/assert.h"
+#include "test_pool.h"
+
+#define TEST_POOL_COUNT			(16)
+#define TEST_POOL_BLOCK_SIZE	(24)
+#define TEST_POOL_ALIGNMENT		(16)
+#define TEST_POOL_NTHREAD		(4)
+#define TEST_POOL_NITER			(100000)
+
+void test_poolSingleThread(void) {
+	vPool_t *pool = NULL;
+	vPoolCfg_t cfg;
+	vPoolStats_t stats;
+	void *block[TEST_POOL_COUNT];
+	uint32_t i, j;
+
+	cfg.blockSize = TEST_POOL_BLOCK_SIZE;
+	cfg.count = TEST_POOL_COUNT;
+	cfg.alignment = TEST_POOL_ALIGNMENT;
+	cfg.isThreadSafe = 0;
+	pool_create(&pool, &cfg);
+	ASSERT(NULL != pool, "Pool not created.");
+	ASSERT(pool_getBlockSize(pool) == TEST_POOL_BLOCK_SIZE, "Incorrect block size.");
+
+	for (i = 0; i < TEST_POOL_COUNT; i++) {
+		block[i] = pool_alloc(pool);
+		ASSERT(NULL != block[i], "Unexpected exhausted pool.");
+		ASSERT(((uintptr_t) block[i] & (TEST_POOL_ALIGNMENT - 1)) == 0, "Block not aligned.");
+		ASSERT(pool_isOwner(pool, block[i]), "Block not owned by pool.");
+		for (j = 0; j < i; j++) {
+			ASSERT(block[i] != block[j], "Same block allocated twice.");
+		}
+	}
+	ASSERT(NULL == pool_alloc(pool), "Exhausted pool must not return a block.");
+	ASSERT(!pool_isOwner(pool, block[0] + 1), "Misaligned address must not be owned.");
+
+	/* Last freed is first reused */
+	pool_free(pool, block[3]);
+	pool_free(pool, block[5]);
+	ASSERT(pool_alloc(pool) == block[5], "Freed block not reused.");
+	ASSERT(pool_alloc(pool) == block[3], "Freed block not reused.");
+
+	for (i = 0; i < TEST_POOL_COUNT / 2; i++) {
+		pool_free(pool, block[i]);
+	}
+	pool_free(pool, NULL);
+
+	pool_getStats(pool, &stats);
+	ASSERT(stats.count == TEST_POOL_COUNT, "Incorrect count.");
+	ASSERT(stats.inUse == TEST_POOL_COUNT / 2, "Incorrect in use count.");
+	ASSERT(stats.peak == TEST_POOL_COUNT, "Incorrect high-water mark.");
+	ASSERT(stats.nFail == 1, "Incorrect failure count.");
+
+	pool_destroy(&pool);
+	ASSERT(NULL == pool, "Pool not destroyed.");
+}
+
+static void* test_poolWorker(void *arg) {
+	vPool_t *pool = (vPool_t*) arg;
+	uintptr_t id = (uintptr_t) pthread_self();
+	uintptr_t *held[2];
+	uint32_t i, j;
+
+	for (i = 0; i < TEST_POOL_NITER; i++) {
+		for (j = 0; j < 2; j++) {
+			held[j] = (uintptr_t*) pool_alloc(pool);
+			if (NULL != held[j]) {
+				*held[j] = id + j;
+			}
+		}
+		for (j = 0; j < 2; j++) {
+			if (NULL != held[j]) {
+				ASSERT(*held[j] == id + j, "Block shared between threads.");
+				pool_free(pool, held[j]);
+			}
+		}
+	}
+
+	return NULL;
+}
+
+void test_poolMultiThread(void) {
+	vPool_t *pool = NULL;
+	vPoolCfg_t cfg;
+	vPoolStats_t stats;
+	pthread_t thread[TEST_POOL_NTHREAD];
+	uint32_t i;
+
+	/* Fewer blocks than threads x 2, so that exhaustion is exercised too */
+	cfg.blockSize = sizeof(uintptr_t);
+	cfg.count = TEST_POOL_NTHREAD + 1;
+	cfg.alignment = sizeof(uintptr_t);
+	cfg.isThreadSafe = 1;
+	pool_create(&pool, &cfg);
+	ASSERT(NULL != pool, "Pool not created.");
+
+	for (i = 0; i < TEST_POOL_NTHREAD; i++) {
+		pthread_create(&thread[i], NULL, test_poolWorker, pool);
+	}
+	for (i = 0; i < TEST_POOL_NTHREAD; i++) {
+		pthread_join(thread[i], NULL);
+	}
+
+	pool_getStats(pool, &stats);
+	ASSERT(stats.inUse == 0, "Blocks leaked.");
+	ASSERT(stats.peak <= TEST_POOL_NTHREAD + 1, "High-water mark exceeds pool size.");
+
+	pool_destroy(&pool);
+}
+
+void test_poolAll(void) {
+	test_poolSingleThread();
+	test_poolMultiThread();
+}
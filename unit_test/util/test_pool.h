@@ -0,0 +1,30 @@
+/*
+ * test_pool.h
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: chiong
+ */
+
+#ifndef TEST_TEST_POOL_H_
+#define TEST_TEST_POOL_H_
+
+/**
+ * @details Test all
+ */
+void test_poolAll(void);
+
+/**
+ * @details Test includes:
+ * 		1. All blocks are distinct, aligned and owned by the pool.
+ * 		2. Exhausted pool returns NULL and counts the failure.
+ * 		3. Freed blocks are reused, and high-water mark is kept.
+ */
+void test_poolSingleThread(void);
+
+/**
+ * @details Test concurrent alloc and free from multiple threads on a thread safe
+ * 		pool never hand the same block to two threads.
+ */
+void test_poolMultiThread(void);
+
+#endif /* TEST_TEST_POOL_H_ */
@@ -0,0 +1,234 @@
+/*
+ * test_sprite.c
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: chiong
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "util/sprite.h"
+#include "debug/assert.h"
+#include "test_sprite.h"
+
+/* Odd pixel count to test the half byte of RGB444. */
+#define TEST_SPRITE_WIDTH		(11)
+#define TEST_SPRITE_HEIGHT		(9)
+#define TEST_SPRITE_NPIXEL		(TEST_SPRITE_WIDTH * TEST_SPRITE_HEIGHT)
+/* Size, in bytes, of buffers for sheet and encoded data. */
+#define TEST_SPRITE_SHEET_SIZE	(4096)
+
+/**
+ * @brief Image with runs of 5 colors, and every third row of distinct colors.
+ */
+static void test_spriteImage(uint32_t *pixel) {
+	const uint32_t color[] = {0x000000, 0xFFFFFF, 0xFF8000, 0x1234AB, 0x80FF40};
+	uint32_t x, y;
+
+	for (y = 0; y < TEST_SPRITE_HEIGHT; y++) {
+		for (x = 0; x < TEST_SPRITE_WIDTH; x++) {
+			if (y % 3 == 0) {
+				/* Distinct even in RGB444, with low bits of each channel set */
+				*pixel++ = 0x800000 | (y << 12) | (x << 4) | 0x0B0503;
+			} else {
+				*pixel++ = color[(x / 3 + y) % 5];
+			}
+		}
+	}
+}
+
+/**
+ * @brief Pack pixels into the panel wire format, one pixel at a time.
+ * @return Size, in bytes.
+ */
+static uint32_t test_spritePack(uint8_t *dst, const uint32_t *pixel, uint32_t count, uint8_t fmt) {
+	uint8_t nibble[TEST_SPRITE_NPIXEL * 3 + 1];
+	uint32_t c;
+	uint32_t i;
+
+	switch (fmt) {
+	case BITMAP_PIXEL_FMT_RGB444:
+		for (i = 0; i < count; i++) {
+			nibble[i * 3] = (pixel[i] >> 20) & 0x0F;
+			nibble[i * 3 + 1] = (pixel[i] >> 12) & 0x0F;
+			nibble[i * 3 + 2] = (pixel[i] >> 4) & 0x0F;
+		}
+		nibble[count * 3] = 0;
+		for (i = 0; i < (count * 3 + 1) / 2; i++) {
+			dst[i] = (nibble[i * 2] << 4) | nibble[i * 2 + 1];
+		}
+		return i;
+	case BITMAP_PIXEL_FMT_RGB565:
+		for (i = 0; i < count; i++) {
+			c = ((pixel[i] >> 8) & 0xF800) | ((pixel[i] >> 5) & 0x07E0) | ((pixel[i] >> 3) & 0x001F);
+			dst[i * 2] = c >> 8;
+			dst[i * 2 + 1] = c & 0xFF;
+		}
+		return count * 2;
+	default:
+		for (i = 0; i < count; i++) {
+			dst[i * 3] = (pixel[i] >> 16) & 0xFC;
+			dst[i * 3 + 1] = (pixel[i] >> 8) & 0xFC;
+			dst[i * 3 + 2] = pixel[i] & 0xFC;
+		}
+		return count * 3;
+	}
+}
+
+/**
+ * @brief Build a sheet of the test image as RAW, RLE and PALETTE sprites.
+ * @return Size, in bytes, of sheet.
+ */
+static uint32_t test_spriteBuild(uint8_t *sheet, uint8_t fmt) {
+	uint32_t pixel[TEST_SPRITE_NPIXEL];
+	spriteSheetHeader_t *header;
+	spriteEntry_t *entry;
+	uint32_t offset;
+	uint32_t i;
+	int32_t size;
+
+	test_spriteImage(pixel);
+	memset(sheet, 0, TEST_SPRITE_SHEET_SIZE);
+	header = (spriteSheetHeader_t*) sheet;
+	memcpy(header->magic, SPRITE_MAGIC, sizeof(header->magic));
+	header->version = SPRITE_VERSION;
+	header->nSprite = 3;
+	header->fmt = fmt;
+
+	entry = (spriteEntry_t*) (header + 1);
+	offset = sizeof(spriteSheetHeader_t) + 3 * sizeof(spriteEntry_t);
+	for (i = 0; i < 3; i++) {
+		entry[i].width = TEST_SPRITE_WIDTH;
+		entry[i].height = TEST_SPRITE_HEIGHT;
+		entry[i].encoding = SPRITE_ENC_RAW + i;
+		size = sprite_encode(sheet + offset, TEST_SPRITE_SHEET_SIZE - offset, pixel, TEST_SPRITE_NPIXEL,
+				fmt, &entry[i]);
+		ASSERT(size > 0, "Failed to encode.");
+		entry[i].offset = offset;
+		entry[i].size = (uint32_t) size;
+		offset += (size + 3) & ~3;
+	}
+
+	return offset;
+}
+
+void test_spriteEncode(void) {
+	const uint8_t fmt[] = {BITMAP_PIXEL_FMT_RGB444, BITMAP_PIXEL_FMT_RGB565, BITMAP_PIXEL_FMT_RGB666};
+	uint32_t sheetBuffer[TEST_SPRITE_SHEET_SIZE / sizeof(uint32_t)];
+	uint32_t pixel[TEST_SPRITE_NPIXEL];
+	uint8_t expect[TEST_SPRITE_NPIXEL * 3];
+	uint8_t decoded[TEST_SPRITE_NPIXEL * 3];
+	uint8_t *sheetData;
+	spriteSheet_t sheet;
+	spriteDecoder_t dec;
+	spriteEntry_t entry;
+	const spriteEntry_t *pEntry;
+	uint32_t size, expectSize, n;
+	uint32_t f, i, part;
+
+	test_spriteImage(pixel);
+	sheetData = (uint8_t*) sheetBuffer;
+	for (f = 0; f < sizeof(fmt); f++) {
+		expectSize = test_spritePack(expect, pixel, TEST_SPRITE_NPIXEL, fmt[f]);
+		size = test_spriteBuild(sheetData, fmt[f]);
+		ASSERT(sprite_sheetInit(&sheet, sheetData, size) == STATUS_OK, "Failed to init sheet.");
+
+		pEntry = sprite_getEntry(&sheet, SPRITE_ENC_RAW);
+		ASSERT(pEntry->size == expectSize && memcmp(sheetData + pEntry->offset, expect, expectSize) == 0,
+				"Incorrect RAW data.");
+		pEntry = sprite_getEntry(&sheet, SPRITE_ENC_RLE);
+		ASSERT(pEntry->size < expectSize, "RLE not smaller than RAW.");
+		pEntry = sprite_getEntry(&sheet, SPRITE_ENC_PALETTE);
+		ASSERT(pEntry->bitPerIndex == 8 && pEntry->nColor == 5 + 3 * TEST_SPRITE_WIDTH, "Incorrect palette.");
+
+		/* Destination of 6 to 15 bytes, i.e. only a few pixels per part */
+		for (i = 0; i < 3; i++) {
+			for (part = 6; part < 16; part += 3) {
+				ASSERT(sprite_decoderInit(&dec, &sheet, i) == STATUS_OK, "Failed to init decoder.");
+				size = 0;
+				while ((n = sprite_decode(&dec, decoded + size, part)) > 0) {
+					ASSERT(n <= part, "Decoded more than destination.");
+					size += n;
+				}
+				ASSERT(size == expectSize && memcmp(decoded, expect, expectSize) == 0, "Incorrect decoding.");
+			}
+		}
+	}
+
+	/* Every pixel a different color in RGB666 */
+	for (i = 0; i < TEST_SPRITE_NPIXEL; i++) {
+		pixel[i] = ((i & 0x3F) << 2) | ((i >> 6) << 10);
+	}
+	memset(&entry, 0, sizeof(entry));
+	entry.encoding = SPRITE_ENC_PALETTE;
+	ASSERT(sprite_encode(NULL, 0, pixel, TEST_SPRITE_NPIXEL, BITMAP_PIXEL_FMT_RGB666, &entry) > 0,
+			"Failed to encode palette.");
+	ASSERT(entry.bitPerIndex == 8 && entry.nColor == TEST_SPRITE_NPIXEL, "Incorrect palette.");
+
+	entry.encoding = SPRITE_ENC_RAW;
+	ASSERT(sprite_encode(decoded, 10, pixel, TEST_SPRITE_NPIXEL, BITMAP_PIXEL_FMT_RGB565, &entry) == STATUS_ERROR_PARAM,
+			"Encoded into too small destination.");
+	entry.encoding = 7;
+	ASSERT(sprite_encode(NULL, 0, pixel, TEST_SPRITE_NPIXEL, BITMAP_PIXEL_FMT_RGB565, &entry) == STATUS_ERROR_PARAM,
+			"Invalid encoding accepted.");
+}
+
+void test_spriteSheet(void) {
+	uint32_t sheetBuffer[TEST_SPRITE_SHEET_SIZE / sizeof(uint32_t)];
+	uint32_t big[SPRITE_PALETTE_MAX + 1];
+	uint8_t decoded[TEST_SPRITE_NPIXEL * 3];
+	uint8_t *sheetData;
+	spriteSheetHeader_t *header;
+	spriteEntry_t *entry;
+	spriteEntry_t bigEntry;
+	spriteSheet_t sheet;
+	spriteDecoder_t dec;
+	uint32_t size, total, n;
+	uint32_t i;
+
+	sheetData = (uint8_t*) sheetBuffer;
+	header = (spriteSheetHeader_t*) sheetData;
+	entry = (spriteEntry_t*) (header + 1);
+	size = test_spriteBuild(sheetData, BITMAP_PIXEL_FMT_RGB565);
+	ASSERT(sprite_sheetInit(&sheet, sheetData, size) == STATUS_OK, "Failed to init sheet.");
+	ASSERT(sprite_getNumSprite(&sheet) == 3, "Incorrect number of sprites.");
+	ASSERT(sprite_getEntry(&sheet, 2)->width == TEST_SPRITE_WIDTH && sprite_getEntry(&sheet, 3) == NULL,
+			"Incorrect entry.");
+	ASSERT(sprite_decoderInit(&dec, &sheet, 3) == STATUS_ERROR_PARAM, "Decoder of invalid index.");
+
+	ASSERT(sprite_sheetInit(&sheet, sheetData, sizeof(spriteSheetHeader_t) + sizeof(spriteEntry_t)) == STATUS_ERROR,
+			"Truncated index accepted.");
+	ASSERT(sprite_sheetInit(&sheet, sheetData, entry[2].offset + entry[2].size - 1) == STATUS_ERROR,
+			"Data beyond sheet accepted.");
+	entry[0].size--;
+	ASSERT(sprite_sheetInit(&sheet, sheetData, size) == STATUS_ERROR, "Incorrect RAW size accepted.");
+	entry[0].size++;
+	header->magic[0] = 'X';
+	ASSERT(sprite_sheetInit(&sheet, sheetData, size) == STATUS_ERROR, "Bad magic accepted.");
+	header->magic[0] = SPRITE_MAGIC[0];
+
+	/* RLE data cut short */
+	entry[1].size /= 2;
+	ASSERT(sprite_sheetInit(&sheet, sheetData, size) == STATUS_OK, "Failed to init sheet.");
+	sprite_decoderInit(&dec, &sheet, 1);
+	total = 0;
+	while ((n = sprite_decode(&dec, decoded + total, sizeof(decoded) - total)) > 0) {
+		total += n;
+	}
+	ASSERT(total > 0 && total < TEST_SPRITE_NPIXEL * 2, "Decoding of short RLE data not stopped.");
+
+	/* More colors than palette */
+	for (i = 0; i < SPRITE_PALETTE_MAX + 1; i++) {
+		/* Distinct colors in RGB565 */
+		big[i] = ((i & 0x1F) << 3) | ((i >> 5) << 10);
+	}
+	memset(&bigEntry, 0, sizeof(bigEntry));
+	bigEntry.encoding = SPRITE_ENC_PALETTE;
+	ASSERT(sprite_encode(NULL, 0, big, SPRITE_PALETTE_MAX + 1, BITMAP_PIXEL_FMT_RGB565, &bigEntry) == STATUS_ERROR,
+			"Palette of too many colors.");
+}
+
+void test_spriteAll(void) {
+	test_spriteEncode();
+	test_spriteSheet();
+}
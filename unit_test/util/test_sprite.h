@@ -0,0 +1,34 @@
+/*
+ * test_sprite.h
+ *
+ *  Created on: 19 Oct 2026
+ *      Author: chiong
+ */
+
+#ifndef TEST_TEST_SPRITE_H_
+#define TEST_TEST_SPRITE_H_
+
+/**
+ * @details Test all
+ */
+void test_spriteAll(void);
+
+/**
+ * @details Test includes:
+ * 		1. sprite_encode() of RAW gives the panel wire format, for RGB444 with
+ * 		   an odd pixel count, RGB565 and RGB666.
+ * 		2. RLE and PALETTE sprites decode to the same bytes as RAW, with a
+ * 		   destination of only a few pixels.
+ * 		3. PALETTE of more than 256 colors and destination too small.
+ */
+void test_spriteEncode(void);
+
+/**
+ * @details Test includes:
+ * 		1. sprite_sheetInit() of a sheet of 3 sprites, sprite_getEntry().
+ * 		2. Sheets with bad magic, truncated index and data beyond sheet.
+ * 		3. RLE data that ends early stops decoding.
+ */
+void test_spriteSheet(void);
+
+#endif /* TEST_TEST_SPRITE_H_ */
@@ -6,6 +6,7 @@
  */
 
 #include <stdio.h>
+#include <string.h>
 #include "util/stack.h"
 #include "debug/assert.h"
 #include "test_stack.h"
@@ -148,10 +149,158 @@ void test_stackAlloc(void) {
     stack_destroy(&stack);
 }
 
+static void test_stackStatsInner(vStack_t *stack) {
+    stack_openFrame(stack);
+    stack_alignedAlloc(stack, 4, 10);
+    stack_closeFrame(stack);
+}
+
+void test_stackStats(void) {
+    vStack_t *stack;
+    vStackCfg_t cfg;
+    vStackStats_t stats;
+    vStackFrameStats_t frameStats[2];
+    uint32_t expectedPeak;
+    uint32_t n;
+
+    cfg.alignment = 4;
+    cfg.size = 1024;
+    stack_create(&stack, &cfg);
+
+    stack_openFrame(stack);
+    stack_alloc(stack, 3);
+    test_stackStatsInner(stack);
+    /* Peak is reached in inner frame */
+    expectedPeak = STACK_FRAME_OVERHEAD("test_stackStats") + 3 +
+            STACK_FRAME_OVERHEAD("test_stackStatsInner");
+    expectedPeak = ((expectedPeak + 3) & ~3) + 10 * 4;
+    stack_alloc(stack, 1);
+    stack_closeFrame(stack);
+
+    ASSERT(NULL == stack_alloc(stack, cfg.size + 1), "Expected NULL, but did not get it.");
+
+    stack_getStats(stack, &stats);
+    ASSERT(stats.size == cfg.size, "Incorrect size.");
+    ASSERT(stats.used == 0, "Incorrect used size.");
+    ASSERT(stats.peak == expectedPeak, "Incorrect peak.");
+    ASSERT(stats.nAlloc == 3, "Incorrect number of allocations.");
+    ASSERT(stats.nFail == 1, "Incorrect number of failed allocations.");
+    ASSERT(stats.maxFrameDepth == 2, "Incorrect maximum frame depth.");
+
+    n = stack_getFrameStats(stack, frameStats, 2);
+#ifdef DEBUG
+    ASSERT(n == 2, "Incorrect number of frames recorded.");
+    ASSERT(strcmp(frameStats[0].name, "test_stackStatsInner") == 0, "Incorrect frame name.");
+    ASSERT(strcmp(frameStats[1].name, "test_stackStats") == 0, "Incorrect frame name.");
+    ASSERT(frameStats[1].peak == expectedPeak, "Incorrect frame peak.");
+    ASSERT(frameStats[1].count == 1, "Incorrect frame count.");
+#else
+    ASSERT(n == 0, "Frame statistics only available in DEBUG.");
+#endif
+
+    stack_resetStats(stack);
+    stack_getStats(stack, &stats);
+    ASSERT(stats.peak == 0 && stats.nAlloc == 0 && stats.nFail == 0, "Statistics not reset.");
+
+    stack_destroy(&stack);
+}
+
+static void test_stackChainedInner(vStack_t *stack, uint8_t *outer) {
+    uint8_t *ptr;
+    uint32_t i;
+
+    stack_openFrame(stack);
+    /* Does not fit in first segment */
+    ptr = (uint8_t*) stack_alignedAlloc(stack, 8, 16);
+    ASSERT(NULL != ptr, "Chained stack must grow.");
+    ASSERT(((uintptr_t) ptr & 7) == 0, "Incorrect alignment in new segment.");
+    for (i = 0; i < 16 * 8; i++) {
+        ptr[i] = 0xA5;
+    }
+    for (i = 0; i < 32; i++) {
+        ASSERT(outer[i] == i, "Allocation in new segment overlaps previous segment.");
+    }
+    stack_closeFrame(stack);
+}
+
+void test_stackChained(void) {
+    vStack_t *stack;
+    vStackCfg_t cfg;
+    vStackChainCfg_t chainCfg;
+    vStackStats_t stats;
+    vPool_t *pool;
+    vPoolCfg_t poolCfg;
+    vPoolStats_t poolStats;
+    uint8_t *outer;
+    void *ptr;
+    uint32_t i;
+
+    cfg.alignment = 8;
+    cfg.size = 48 + STACK_FRAME_OVERHEAD("test_stackChained");
+    chainCfg.segmentSize = 256;
+    chainCfg.maxSize = cfg.size + 2 * 256;
+    chainCfg.pool = NULL;
+    stack_createChained(&stack, &cfg, &chainCfg);
+    ASSERT(NULL != stack, "Stack not created.");
+
+    stack_openFrame(stack);
+    outer = (uint8_t*) stack_alloc(stack, 32);
+    for (i = 0; i < 32; i++) {
+        outer[i] = i;
+    }
+
+    /* Repeated growth and release around the boundary reuses the spare segment */
+    for (i = 0; i < 4; i++) {
+        test_stackChainedInner(stack, outer);
+    }
+    stack_getStats(stack, &stats);
+    ASSERT(stats.nGrow == 4, "Incorrect number of growth.");
+    ASSERT(stats.size == cfg.size + 256, "Spare segment not reused.");
+
+    /* Back in first segment */
+    ptr = stack_alloc(stack, 1);
+    ASSERT(ptr == outer + 32, "Closed frame not returned to first segment.");
+
+    /* Allocation bigger than segment size gets its own segment, within the cap */
+    ASSERT(NULL != stack_alloc(stack, 300), "Chained stack must grow for big allocation.");
+    ASSERT(NULL == stack_alloc(stack, 600), "Maximum size must not be exceeded.");
+    stack_closeFrame(stack);
+
+    stack_getStats(stack, &stats);
+    ASSERT(stats.used == 0, "Incorrect used size.");
+    ASSERT(stats.nFail == 1, "Incorrect number of failed allocations.");
+    stack_destroy(&stack);
+
+    /* Segments from pool */
+    poolCfg.blockSize = 128;
+    poolCfg.count = 2;
+    poolCfg.alignment = 8;
+    poolCfg.isThreadSafe = 0;
+    pool_create(&pool, &poolCfg);
+    chainCfg.maxSize = 0;
+    chainCfg.pool = pool;
+    stack_createChained(&stack, &cfg, &chainCfg);
+    ASSERT(NULL != stack, "Stack not created.");
+
+    stack_openFrame(stack);
+    ASSERT(NULL != stack_alloc(stack, 64), "Chained stack must grow from pool.");
+    ASSERT(NULL != stack_alloc(stack, 64), "Chained stack must grow from pool.");
+    ASSERT(NULL == stack_alloc(stack, 64), "Exhausted pool must fail.");
+    ASSERT(NULL == stack_alloc(stack, 128), "Allocation bigger than pool block must fail.");
+    stack_closeFrame(stack);
+
+    stack_destroy(&stack);
+    pool_getStats(pool, &poolStats);
+    ASSERT(poolStats.inUse == 0, "Segments not returned to pool.");
+    pool_destroy(&pool);
+}
+
 void test_stackAll(void) {
     test_stackCreate();
     test_stackOpenCloseFrameMatch();
     test_stackOpenCloseFrameNonMatch();
     test_stackAlloc();
+    test_stackStats();
+    test_stackChained();
 }
 
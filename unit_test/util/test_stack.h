@@ -37,5 +37,17 @@ void test_stackOpenCloseFrameNonMatch(void);
  */
 void test_stackAlloc(void);
 
+/**
+ * @details Test peak, allocation counts and frame depth are recorded, and per-frame
+ * 		peak when DEBUG is #defined.
+ */
+void test_stackStats(void);
+
+/**
+ * @details Test chained stack grows into new segments, from heap and pool, returns
+ * 		to previous segment on close frame, and respects maximum size.
+ */
+void test_stackChained(void);
+
 
 #endif /* TEST_TEST_STACK_H_ */